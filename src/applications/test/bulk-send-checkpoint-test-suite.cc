@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-checkpoint.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/string.h"
+#include "ns3/data-rate.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/packet-sink-helper.h"
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ *
+ * Check that the branches forked from a checkpoint in the middle of a
+ * TCP transfer give the results of the runs which were not forked.
+ *
+ * A BulkSendApplication sends to a PacketSink over a link of two
+ * SimpleNetDevice.  At the end of the warm-up, with segments in flight,
+ * the simulation is forked into three branches: two keep the data rate
+ * of the link, the third lowers it.  The bytes and packets received by
+ * the sink of each branch are compared with those of the runs which
+ * change the data rate, or not, without forking.
+ */
+class BulkSendCheckpointTestCase : public TestCase
+{
+public:
+  BulkSendCheckpointTestCase ();
+  virtual ~BulkSendCheckpointTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the simulation.
+   * \param newRate The data rate of the link after the warm-up.
+   * \param fork Whether to fork at the end of the warm-up, the data rate
+   *        changing in the last branch only.
+   */
+  void Simulate (DataRate newRate, bool fork);
+  /**
+   * Fork the simulation, or change the data rate of the link.
+   * \param fork Whether to fork.
+   */
+  void EndOfWarmUp (bool fork);
+  /**
+   * Count the bytes received by the sink.
+   * \param p The packet received.
+   * \param addr The address of the sender.
+   */
+  void ReceiveRx (Ptr<const Packet> p, const Address &addr);
+
+  NetDeviceContainer m_devices;   //!< The devices of the link
+  DataRate m_newRate;             //!< The data rate after the warm-up
+  uint64_t m_received;            //!< The bytes received by the sink
+  uint32_t m_packets;             //!< The packets received by the sink
+};
+
+BulkSendCheckpointTestCase::BulkSendCheckpointTestCase ()
+  : TestCase ("Check the branches forked from a checkpoint during a transfer")
+{
+}
+
+BulkSendCheckpointTestCase::~BulkSendCheckpointTestCase ()
+{
+}
+
+void
+BulkSendCheckpointTestCase::ReceiveRx (Ptr<const Packet> p, const Address &addr)
+{
+  m_received += p->GetSize ();
+  ++m_packets;
+}
+
+void
+BulkSendCheckpointTestCase::EndOfWarmUp (bool fork)
+{
+  if (!fork || SimulatorCheckpoint::Fork (3, 2) == 2)
+    {
+      m_devices.Get (0)->SetAttribute ("DataRate", DataRateValue (m_newRate));
+      m_devices.Get (1)->SetAttribute ("DataRate", DataRateValue (m_newRate));
+    }
+}
+
+void
+BulkSendCheckpointTestCase::Simulate (DataRate newRate, bool fork)
+{
+  m_newRate = newRate;
+  m_received = 0;
+  m_packets = 0;
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simpleHelper;
+  simpleHelper.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simpleHelper.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  m_devices = simpleHelper.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  internet.AssignStreams (nodes, 0);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (m_devices);
+  uint16_t port = 9;
+  BulkSendHelper sourceHelper ("ns3::TcpSocketFactory",
+                               InetSocketAddress (i.GetAddress (1), port));
+  ApplicationContainer sourceApp = sourceHelper.Install (nodes.Get (0));
+  sourceApp.Start (Seconds (0.0));
+  sourceApp.Stop (Seconds (4.0));
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory",
+                               InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApp = sinkHelper.Install (nodes.Get (1));
+  sinkApp.Start (Seconds (0.0));
+  sinkApp.Stop (Seconds (4.0));
+
+  Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinkApp.Get (0));
+  sink->TraceConnectWithoutContext ("Rx", MakeCallback (&BulkSendCheckpointTestCase::ReceiveRx, this));
+
+  Simulator::Schedule (Seconds (1.5), &BulkSendCheckpointTestCase::EndOfWarmUp, this, fork);
+  Simulator::Stop (Seconds (4.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_devices = NetDeviceContainer ();
+}
+
+void
+BulkSendCheckpointTestCase::DoRun (void)
+{
+  Simulate (DataRate ("10Mbps"), false);
+  uint64_t reference = m_received;
+  uint32_t referencePackets = m_packets;
+  Simulate (DataRate ("2Mbps"), false);
+  uint64_t changed = m_received;
+  uint32_t changedPackets = m_packets;
+  NS_TEST_ASSERT_MSG_NE (reference, changed, "The data rate has no effect");
+
+  std::string prefix = CreateTempDirFilename ("branch-");
+  Simulate (DataRate ("2Mbps"), true);
+  if (SimulatorCheckpoint::GetBranch () != 0)
+    {
+      std::ostringstream name;
+      name << prefix << SimulatorCheckpoint::GetBranch ();
+      std::ofstream file (name.str ().c_str ());
+      file << m_received << " " << m_packets << std::endl;
+      SimulatorCheckpoint::EndBranch (file ? 0 : 1);
+    }
+  NS_TEST_ASSERT_MSG_EQ (SimulatorCheckpoint::GetFailedBranches (), 0, "Branches failed");
+  NS_TEST_EXPECT_MSG_EQ (m_received, reference, "The checkpoint process differs");
+  NS_TEST_EXPECT_MSG_EQ (m_packets, referencePackets, "The checkpoint process differs");
+
+  uint64_t expected[3] = {reference, reference, changed};
+  uint32_t expectedPackets[3] = {referencePackets, referencePackets, changedPackets};
+  for (uint32_t branch = 1; branch < 3; ++branch)
+    {
+      std::ostringstream name;
+      name << prefix << branch;
+      std::ifstream file (name.str ().c_str ());
+      uint64_t branchReceived = 0;
+      uint32_t branchPackets = 0;
+      file >> branchReceived >> branchPackets;
+      NS_TEST_ASSERT_MSG_EQ (bool (file), true, "Missing result of branch " << branch);
+      NS_TEST_EXPECT_MSG_EQ (branchReceived, expected[branch], "Branch " << branch << " differs");
+      NS_TEST_EXPECT_MSG_EQ (branchPackets, expectedPackets[branch], "Branch " << branch << " differs");
+    }
+}
+
+/**
+ * \ingroup applications-test
+ *
+ * SimulatorCheckpoint test suite of a network scenario.
+ */
+class BulkSendCheckpointTestSuite : public TestSuite
+{
+public:
+  BulkSendCheckpointTestSuite ();
+};
+
+BulkSendCheckpointTestSuite::BulkSendCheckpointTestSuite ()
+  : TestSuite ("bulk-send-checkpoint", UNIT)
+{
+  AddTestCase (new BulkSendCheckpointTestCase, TestCase::QUICK);
+}
+
+static BulkSendCheckpointTestSuite g_bulkSendCheckpointTestSuite; //!< Static variable for test initialization
@@ -181,18 +181,12 @@ OutdoorPositionAllocator::GetNext () const
 
       NS_LOG_INFO ("Position " << position);
 
-      bool inside = false;
-      for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+      std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsContaining (position);
+      bool inside = !buildings.empty ();
+      if (inside)
         {
-          if ((*bit)->IsInside (position))
-            {
-              NS_LOG_INFO ("Position " << position << " is inside the building with boundaries "
-                                       << (*bit)->GetBoundaries ().xMin << " " << (*bit)->GetBoundaries ().xMax << " "
-                                       << (*bit)->GetBoundaries ().yMin << " " << (*bit)->GetBoundaries ().yMax << " "
-                                       << (*bit)->GetBoundaries ().zMin << " " << (*bit)->GetBoundaries ().zMax);
-              inside = true;
-              break;
-            }
+          NS_LOG_INFO ("Position " << position << " is inside the building with boundaries "
+                                   << buildings.front ()->GetBoundaries ());
         }
 
       if (inside)
@@ -27,11 +27,293 @@
 #include "ns3/assert.h"
 #include "building-list.h"
 #include "building.h"
+#include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("BuildingList");
 
+/**
+ * \brief private implementation detail of the BuildingList API: a
+ * bounding volume hierarchy over the boundaries of the buildings.
+ *
+ * The nodes are stored in depth-first order: the left child of an inner
+ * node follows it, and the node stores the index of its right child.
+ * The bounds of the nodes are slightly enlarged, so that the rounding
+ * errors of their tests cannot exclude a building which Building::IsInside
+ * or Building::IsIntersect would accept.
+ */
+class BuildingIndex
+{
+public:
+  /**
+   * Build the hierarchy.
+   * \param buildings the buildings.
+   */
+  void Build (const std::vector<Ptr<Building> > &buildings);
+  /**
+   * \param buildings the buildings of the last Build.
+   * \param position a position.
+   * \param found the indexes of the buildings which contain the position.
+   */
+  void FindContaining (const std::vector<Ptr<Building> > &buildings,
+                       const Vector &position, std::vector<uint32_t> &found) const;
+  /**
+   * \param buildings the buildings of the last Build.
+   * \param l1 one end of a line segment.
+   * \param l2 the other end of the line segment.
+   * \param firstOnly whether to stop at the first intersecting building.
+   * \param found the indexes of the buildings which the segment intersects.
+   */
+  void FindIntersecting (const std::vector<Ptr<Building> > &buildings,
+                         const Vector &l1, const Vector &l2, bool firstOnly,
+                         std::vector<uint32_t> &found) const;
+
+private:
+  /** The maximum number of buildings of a leaf. */
+  static const uint32_t LEAF_SIZE = 4;
+
+  /** A node of the hierarchy. */
+  struct Node
+  {
+    double min[3];   //!< The lower corner of the bounds
+    double max[3];   //!< The upper corner of the bounds
+    uint32_t first;  //!< The first building of a leaf, or the right child
+    uint32_t count;  //!< The number of buildings of a leaf, or 0
+  };
+
+  /**
+   * Build the node of a range of m_items.
+   * \param begin the first item.
+   * \param end past the last item.
+   */
+  void BuildNode (uint32_t begin, uint32_t end);
+  /**
+   * \param node a node.
+   * \param position a position.
+   * \returns whether the enlarged bounds of the node contain the position.
+   */
+  static bool Contains (const Node &node, const Vector &position);
+  /**
+   * \param node a node.
+   * \param l1 one end of a line segment.
+   * \param l2 the other end of the line segment.
+   * \returns whether the segment intersects the enlarged bounds of the node.
+   */
+  static bool Intersects (const Node &node, const Vector &l1, const Vector &l2);
+
+  std::vector<Node> m_nodes;              //!< The nodes, the root first
+  std::vector<uint32_t> m_items;          //!< The building indexes, by leaf
+  std::vector<Box> m_bounds;              //!< The boundaries, by building index
+};
+
+void
+BuildingIndex::Build (const std::vector<Ptr<Building> > &buildings)
+{
+  NS_LOG_FUNCTION (this << buildings.size ());
+  m_nodes.clear ();
+  m_items.resize (buildings.size ());
+  m_bounds.resize (buildings.size ());
+  for (uint32_t i = 0; i < buildings.size (); ++i)
+    {
+      m_items[i] = i;
+      m_bounds[i] = buildings[i]->GetBoundaries ();
+    }
+  if (!buildings.empty ())
+    {
+      m_nodes.reserve (2 * buildings.size () / LEAF_SIZE + 1);
+      BuildNode (0, buildings.size ());
+    }
+}
+
+void
+BuildingIndex::BuildNode (uint32_t begin, uint32_t end)
+{
+  uint32_t index = m_nodes.size ();
+  m_nodes.push_back (Node ());
+  double min[3] = {m_bounds[m_items[begin]].xMin, m_bounds[m_items[begin]].yMin, m_bounds[m_items[begin]].zMin};
+  double max[3] = {m_bounds[m_items[begin]].xMax, m_bounds[m_items[begin]].yMax, m_bounds[m_items[begin]].zMax};
+  double cMin[3] = {1e300, 1e300, 1e300};
+  double cMax[3] = {-1e300, -1e300, -1e300};
+  for (uint32_t i = begin; i < end; ++i)
+    {
+      const Box &b = m_bounds[m_items[i]];
+      double bMin[3] = {b.xMin, b.yMin, b.zMin};
+      double bMax[3] = {b.xMax, b.yMax, b.zMax};
+      for (uint32_t d = 0; d < 3; ++d)
+        {
+          min[d] = std::min (min[d], bMin[d]);
+          max[d] = std::max (max[d], bMax[d]);
+          double center = 0.5 * (bMin[d] + bMax[d]);
+          cMin[d] = std::min (cMin[d], center);
+          cMax[d] = std::max (cMax[d], center);
+        }
+    }
+  for (uint32_t d = 0; d < 3; ++d)
+    {
+      // larger than the rounding errors of Box::IsIntersect
+      double margin = 1e-9 * (1 + std::max (std::abs (min[d]), std::abs (max[d])));
+      m_nodes[index].min[d] = min[d] - margin;
+      m_nodes[index].max[d] = max[d] + margin;
+    }
+
+  uint32_t axis = 0;
+  for (uint32_t d = 1; d < 3; ++d)
+    {
+      if (cMax[d] - cMin[d] > cMax[axis] - cMin[axis])
+        {
+          axis = d;
+        }
+    }
+  if (end - begin <= LEAF_SIZE || cMax[axis] == cMin[axis])
+    {
+      m_nodes[index].first = begin;
+      m_nodes[index].count = end - begin;
+      return;
+    }
+
+  // split at the median of the centers along the longest axis
+  uint32_t middle = begin + (end - begin) / 2;
+  const std::vector<Box> &bounds = m_bounds;
+  std::nth_element (m_items.begin () + begin, m_items.begin () + middle, m_items.begin () + end,
+                    [&bounds, axis] (uint32_t a, uint32_t b)
+    {
+      const Box &ba = bounds[a];
+      const Box &bb = bounds[b];
+      switch (axis)
+        {
+        case 0:
+          return ba.xMin + ba.xMax < bb.xMin + bb.xMax;
+        case 1:
+          return ba.yMin + ba.yMax < bb.yMin + bb.yMax;
+        default:
+          return ba.zMin + ba.zMax < bb.zMin + bb.zMax;
+        }
+    });
+  BuildNode (begin, middle);
+  m_nodes[index].first = m_nodes.size ();
+  m_nodes[index].count = 0;
+  BuildNode (middle, end);
+}
+
+bool
+BuildingIndex::Contains (const Node &node, const Vector &position)
+{
+  return position.x >= node.min[0] && position.x <= node.max[0]
+         && position.y >= node.min[1] && position.y <= node.max[1]
+         && position.z >= node.min[2] && position.z <= node.max[2];
+}
+
+bool
+BuildingIndex::Intersects (const Node &node, const Vector &l1, const Vector &l2)
+{
+  // slab test of the segment l1 + t (l2 - l1), t in [0, 1]
+  double p[3] = {l1.x, l1.y, l1.z};
+  double dir[3] = {l2.x - l1.x, l2.y - l1.y, l2.z - l1.z};
+  double tMin = 0;
+  double tMax = 1;
+  for (uint32_t d = 0; d < 3; ++d)
+    {
+      if (dir[d] == 0)
+        {
+          if (p[d] < node.min[d] || p[d] > node.max[d])
+            {
+              return false;
+            }
+          continue;
+        }
+      double t1 = (node.min[d] - p[d]) / dir[d];
+      double t2 = (node.max[d] - p[d]) / dir[d];
+      if (t1 > t2)
+        {
+          std::swap (t1, t2);
+        }
+      tMin = std::max (tMin, t1);
+      tMax = std::min (tMax, t2);
+      if (tMin > tMax)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+BuildingIndex::FindContaining (const std::vector<Ptr<Building> > &buildings,
+                               const Vector &position, std::vector<uint32_t> &found) const
+{
+  if (m_nodes.empty ())
+    {
+      return;
+    }
+  uint32_t stack[64];
+  uint32_t depth = 0;
+  stack[depth++] = 0;
+  while (depth > 0)
+    {
+      const Node &node = m_nodes[stack[--depth]];
+      if (!Contains (node, position))
+        {
+          continue;
+        }
+      if (node.count == 0)
+        {
+          stack[depth++] = node.first;
+          stack[depth++] = &node - &m_nodes[0] + 1;
+          continue;
+        }
+      for (uint32_t i = node.first; i < node.first + node.count; ++i)
+        {
+          if (buildings[m_items[i]]->IsInside (position))
+            {
+              found.push_back (m_items[i]);
+            }
+        }
+    }
+  std::sort (found.begin (), found.end ());
+}
+
+void
+BuildingIndex::FindIntersecting (const std::vector<Ptr<Building> > &buildings,
+                                 const Vector &l1, const Vector &l2, bool firstOnly,
+                                 std::vector<uint32_t> &found) const
+{
+  if (m_nodes.empty ())
+    {
+      return;
+    }
+  uint32_t stack[64];
+  uint32_t depth = 0;
+  stack[depth++] = 0;
+  while (depth > 0)
+    {
+      const Node &node = m_nodes[stack[--depth]];
+      if (!Intersects (node, l1, l2))
+        {
+          continue;
+        }
+      if (node.count == 0)
+        {
+          stack[depth++] = node.first;
+          stack[depth++] = &node - &m_nodes[0] + 1;
+          continue;
+        }
+      for (uint32_t i = node.first; i < node.first + node.count; ++i)
+        {
+          if (buildings[m_items[i]]->IsIntersect (l1, l2))
+            {
+              found.push_back (m_items[i]);
+              if (firstOnly)
+                {
+                  return;
+                }
+            }
+        }
+    }
+  std::sort (found.begin (), found.end ());
+}
+
 /**
  * \brief private implementation detail of the BuildingList API.
  */
@@ -47,6 +329,23 @@ public:
   BuildingList::Iterator End (void) const;
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
+  /**
+   * Mark the index as out of date.
+   */
+  void NotifyBoundariesChanged (void);
+  /**
+   * \param position a position.
+   * \returns the buildings which contain the position.
+   */
+  std::vector<Ptr<Building> > GetBuildingsContaining (const Vector &position);
+  /**
+   * \param l1 one end of a line segment.
+   * \param l2 the other end of the line segment.
+   * \param firstOnly whether to stop at the first intersecting building.
+   * \returns the buildings which the segment intersects.
+   */
+  std::vector<Ptr<Building> > GetBuildingsIntersecting (const Vector &l1, const Vector &l2,
+                                                        bool firstOnly);
 
   static Ptr<BuildingListPriv> Get (void);
 
@@ -54,7 +353,14 @@ private:
   virtual void DoDispose (void);
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
+  /**
+   * Build the index if it is out of date.
+   */
+  void UpdateIndex (void);
   std::vector<Ptr<Building> > m_buildings;
+  BuildingIndex m_index;          //!< the index of the buildings
+  bool m_indexValid;              //!< whether the index is up to date
+  std::vector<uint32_t> m_found;  //!< the buildings found by the last query
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
@@ -100,6 +406,7 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_indexValid (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -118,6 +425,8 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  m_index.Build (m_buildings);
+  m_indexValid = true;
   Object::DoDispose ();
 }
 
@@ -127,6 +436,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  m_indexValid = false;
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -155,6 +465,50 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::NotifyBoundariesChanged (void)
+{
+  m_indexValid = false;
+}
+
+void
+BuildingListPriv::UpdateIndex (void)
+{
+  if (!m_indexValid)
+    {
+      m_index.Build (m_buildings);
+      m_indexValid = true;
+    }
+}
+
+std::vector<Ptr<Building> >
+BuildingListPriv::GetBuildingsContaining (const Vector &position)
+{
+  UpdateIndex ();
+  m_found.clear ();
+  m_index.FindContaining (m_buildings, position, m_found);
+  std::vector<Ptr<Building> > buildings;
+  for (std::vector<uint32_t>::const_iterator i = m_found.begin (); i != m_found.end (); ++i)
+    {
+      buildings.push_back (m_buildings[*i]);
+    }
+  return buildings;
+}
+
+std::vector<Ptr<Building> >
+BuildingListPriv::GetBuildingsIntersecting (const Vector &l1, const Vector &l2, bool firstOnly)
+{
+  UpdateIndex ();
+  m_found.clear ();
+  m_index.FindIntersecting (m_buildings, l1, l2, firstOnly, m_found);
+  std::vector<Ptr<Building> > buildings;
+  for (std::vector<uint32_t>::const_iterator i = m_found.begin (); i != m_found.end (); ++i)
+    {
+      buildings.push_back (m_buildings[*i]);
+    }
+  return buildings;
+}
+
 }
 
 /**
@@ -190,4 +544,28 @@ BuildingList::GetNBuildings (void)
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
 
+void
+BuildingList::NotifyBoundariesChanged (void)
+{
+  BuildingListPriv::Get ()->NotifyBoundariesChanged ();
+}
+
+std::vector<Ptr<Building> >
+BuildingList::GetBuildingsContaining (const Vector &position)
+{
+  return BuildingListPriv::Get ()->GetBuildingsContaining (position);
+}
+
+std::vector<Ptr<Building> >
+BuildingList::GetBuildingsIntersecting (const Vector &l1, const Vector &l2)
+{
+  return BuildingListPriv::Get ()->GetBuildingsIntersecting (l1, l2, false);
+}
+
+bool
+BuildingList::IsIntersectingAnyBuilding (const Vector &l1, const Vector &l2)
+{
+  return !BuildingListPriv::Get ()->GetBuildingsIntersecting (l1, l2, true).empty ();
+}
+
 } // namespace ns3
@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -62,6 +63,36 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * Notify the list that the boundaries of a building changed.
+   *
+   * This method is called automatically from Building::SetBoundaries so
+   * the user has little reason to call it himself.
+   */
+  static void NotifyBoundariesChanged (void);
+
+  /**
+   * \param position a position.
+   * \returns the buildings which contain the position, by increasing id.
+   *
+   * The buildings are found with a bounding volume hierarchy over their
+   * boundaries, which is built at the first query after a building was
+   * added or moved, so that a query costs O(log n) for n buildings.
+   */
+  static std::vector<Ptr<Building> > GetBuildingsContaining (const Vector &position);
+  /**
+   * \param l1 one end of a line segment.
+   * \param l2 the other end of the line segment.
+   * \returns the buildings which the line segment intersects, by
+   *          increasing id, as found by Building::IsIntersect.
+   */
+  static std::vector<Ptr<Building> > GetBuildingsIntersecting (const Vector &l1, const Vector &l2);
+  /**
+   * \param l1 one end of a line segment.
+   * \param l2 the other end of the line segment.
+   * \returns true if the line segment intersects any building.
+   */
+  static bool IsIntersectingAnyBuilding (const Vector &l1, const Vector &l2);
 };
 
 } // namespace ns3
@@ -177,23 +177,20 @@ MobilityBuildingInfo::GetBuilding ()
 void
 MobilityBuildingInfo::MakeConsistent (Ptr<MobilityModel> mm)
 {
-  bool found = false;
   Vector pos = mm->GetPosition ();
-  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+  std::vector<Ptr<Building> > buildings = BuildingList::GetBuildingsContaining (pos);
+  bool found = !buildings.empty ();
+  if (found)
     {
-      NS_LOG_LOGIC ("checking building " << (*bit)->GetId () << " with boundaries " << (*bit)->GetBoundaries ());
-      if ((*bit)->IsInside (pos))
-        {
-          NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << pos << " falls inside building " << (*bit)->GetId ());
-          NS_ABORT_MSG_UNLESS (found == false, " MobilityBuildingInfo already inside another building!");
-          found = true;
-          uint16_t floor = (*bit)->GetFloor (pos);
-          uint16_t roomX = (*bit)->GetRoomX (pos);
-          uint16_t roomY = (*bit)->GetRoomY (pos);
-          SetIndoor (*bit, floor, roomX, roomY);
-        }
+      Ptr<Building> building = buildings.front ();
+      NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << pos << " falls inside building " << building->GetId ());
+      NS_ABORT_MSG_UNLESS (buildings.size () == 1, " MobilityBuildingInfo already inside another building!");
+      uint16_t floor = building->GetFloor (pos);
+      uint16_t roomX = building->GetRoomX (pos);
+      uint16_t roomY = building->GetRoomY (pos);
+      SetIndoor (building, floor, roomX, roomY);
     }
-  if (!found)
+  else
     {
       NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << pos  << " is outdoor");
       SetOutdoor ();
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/building.h"
+#include "ns3/building-list.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BuildingListTest");
+
+/**
+ * Test case for the queries of the BuildingList. It checks that the
+ * buildings found through the index are the buildings found by testing
+ * every building, for random positions and line segments in a city of
+ * random buildings, including after some buildings were moved.
+ */
+class BuildingListIndexTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  BuildingListIndexTestCase ();
+
+private:
+  /**
+   * Builds the simulation scenario and perform the tests
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Compare the queries with the scans of all the buildings.
+   * \param n the number of random positions and segments
+   */
+  void CheckQueries (uint32_t n);
+
+  Ptr<UniformRandomVariable> m_random; //!< the random positions
+};
+
+BuildingListIndexTestCase::BuildingListIndexTestCase ()
+  : TestCase ("Test case for the index of the BuildingList")
+{
+}
+
+void
+BuildingListIndexTestCase::CheckQueries (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Vector a (m_random->GetValue (-50, 1050), m_random->GetValue (-50, 1050), m_random->GetValue (0, 40));
+      Vector b (m_random->GetValue (-50, 1050), m_random->GetValue (-50, 1050), m_random->GetValue (0, 40));
+      if (i % 4 == 0)
+        {
+          // short segments, as the steps of the random walk
+          b = Vector (a.x + m_random->GetValue (-20, 20), a.y + m_random->GetValue (-20, 20), a.z);
+        }
+
+      std::vector<Ptr<Building> > inside;
+      std::vector<Ptr<Building> > intersecting;
+      for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+        {
+          if ((*bit)->IsInside (a))
+            {
+              inside.push_back (*bit);
+            }
+          if ((*bit)->IsIntersect (a, b))
+            {
+              intersecting.push_back (*bit);
+            }
+        }
+
+      std::vector<Ptr<Building> > found = BuildingList::GetBuildingsContaining (a);
+      NS_TEST_ASSERT_MSG_EQ (found.size (), inside.size (), "wrong buildings containing " << a);
+      for (uint32_t j = 0; j < found.size (); ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ (found[j], inside[j], "wrong buildings containing " << a);
+        }
+      found = BuildingList::GetBuildingsIntersecting (a, b);
+      NS_TEST_ASSERT_MSG_EQ (found.size (), intersecting.size (), "wrong buildings intersecting " << a << " " << b);
+      for (uint32_t j = 0; j < found.size (); ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ (found[j], intersecting[j], "wrong buildings intersecting " << a << " " << b);
+        }
+      NS_TEST_ASSERT_MSG_EQ (BuildingList::IsIntersectingAnyBuilding (a, b), !intersecting.empty (),
+                             "wrong blockage between " << a << " " << b);
+    }
+}
+
+void
+BuildingListIndexTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+
+  // no building, from a fresh list
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::GetBuildingsContaining (Vector (0, 0, 0)).size (), 0, "no building expected");
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::IsIntersectingAnyBuilding (Vector (0, 0, 0), Vector (1, 1, 1)), false,
+                         "no building expected");
+
+  // a city of 30 x 30 blocks of 35 m, with buildings of random sizes and heights
+  for (uint32_t x = 0; x < 30; ++x)
+    {
+      for (uint32_t y = 0; y < 30; ++y)
+        {
+          Ptr<Building> b = CreateObject<Building> ();
+          double xMin = 35.0 * x + m_random->GetValue (0, 5);
+          double yMin = 35.0 * y + m_random->GetValue (0, 5);
+          b->SetBoundaries (Box (xMin, xMin + m_random->GetValue (5, 30),
+                                 yMin, yMin + m_random->GetValue (5, 30),
+                                 0, m_random->GetValue (3, 30)));
+        }
+    }
+  // touching buildings
+  Ptr<Building> left = CreateObject<Building> ();
+  left->SetBoundaries (Box (1100, 1110, 0, 10, 0, 10));
+  Ptr<Building> right = CreateObject<Building> ();
+  right->SetBoundaries (Box (1110, 1120, 0, 10, 0, 10));
+  std::vector<Ptr<Building> > found = BuildingList::GetBuildingsContaining (Vector (1110, 5, 5));
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 2, "the shared wall is in both buildings");
+  found = BuildingList::GetBuildingsIntersecting (Vector (1090, 5, 5), Vector (1130, 5, 5));
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 2, "the segment crosses both buildings");
+
+  CheckQueries (2000);
+
+  // moved buildings are found at their new place
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Ptr<Building> b = BuildingList::GetBuilding (i * 9);
+      Box box = b->GetBoundaries ();
+      b->SetBoundaries (Box (box.xMin + 7, box.xMax + 7, box.yMin + 3, box.yMax + 3, box.zMin, box.zMax + 10));
+    }
+  CheckQueries (2000);
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Test suite for the BuildingList
+ */
+class BuildingListTestSuite : public TestSuite
+{
+public:
+  BuildingListTestSuite ();
+};
+
+BuildingListTestSuite::BuildingListTestSuite ()
+  : TestSuite ("building-list", UNIT)
+{
+  AddTestCase (new BuildingListIndexTestCase, TestCase::QUICK);
+}
+
+static BuildingListTestSuite g_buildingListTestSuite; //!< the test suite
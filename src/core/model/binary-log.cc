@@ -0,0 +1,420 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-log.h"
+#include "abort.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::BinaryLog implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryLog");
+
+namespace {
+
+/** The binary log file format version. */
+const uint32_t BINARY_LOG_VERSION = 1;
+
+/**
+ * \ingroup logging
+ * The ring of records of a thread.
+ *
+ * The owning thread is the only producer, and advances m_tail; the
+ * records are consumed, with the BinaryLogState lock held, either by
+ * the owning thread when the ring is full or by BinaryLog::Flush.
+ */
+struct BinaryLogRing
+{
+  /**
+   * Constructor.
+   * \param [in] size The number of records.
+   * \param [in] thread The thread identifier.
+   */
+  BinaryLogRing (uint32_t size, uint16_t thread)
+    : m_records (size),
+      m_head (0),
+      m_tail (0),
+      m_thread (thread)
+  {}
+  std::vector<BinaryLog::Record> m_records; //!< The records
+  std::atomic<uint64_t> m_head;  //!< The number of records consumed
+  std::atomic<uint64_t> m_tail;  //!< The number of records produced
+  uint16_t m_thread;             //!< The thread identifier
+};
+
+/**
+ * \ingroup logging
+ * The state of the binary log shared by all the threads.
+ */
+struct BinaryLogState
+{
+  /** Destructor: close the log file at exit. */
+  ~BinaryLogState ()
+  {
+    BinaryLog::Disable ();
+  }
+  std::mutex m_mutex;          //!< Lock of the state and of the file
+  std::FILE *m_file = 0;       //!< The log file
+  uint32_t m_ringSize = 0;     //!< The size of the new rings
+  /** The rings of all the threads, of the current file. */
+  std::vector<std::unique_ptr<BinaryLogRing> > m_rings;
+  /** The log component identifiers. */
+  std::map<std::string, uint16_t> m_components;
+  /** The dictionary lines of the call sites. */
+  std::vector<std::string> m_sites;
+  /** The generation of the rings, incremented when a file is closed. */
+  std::atomic<uint32_t> m_generation {0};
+};
+
+/**
+ * \ingroup logging
+ * \returns The state of the binary log.
+ */
+BinaryLogState &
+GetState (void)
+{
+  static BinaryLogState state;
+  return state;
+}
+
+/** The ring of the calling thread. */
+thread_local BinaryLogRing *t_ring = 0;
+/** The generation of the ring of the calling thread. */
+thread_local uint32_t t_generation = 0;
+
+/**
+ * Write the records of a ring to the log file.
+ * The state lock must be held.
+ * \param [in] state The binary log state.
+ * \param [in] ring The ring.
+ */
+void
+DrainRing (BinaryLogState &state, BinaryLogRing *ring)
+{
+  uint64_t head = ring->m_head.load (std::memory_order_relaxed);
+  uint64_t tail = ring->m_tail.load (std::memory_order_acquire);
+  uint64_t size = ring->m_records.size ();
+  while (head != tail)
+    {
+      // write the contiguous part of the ring at once
+      uint64_t start = head % size;
+      uint64_t n = std::min (tail - head, size - start);
+      std::fwrite (&ring->m_records[start], sizeof (BinaryLog::Record), n, state.m_file);
+      head += n;
+    }
+  ring->m_head.store (head, std::memory_order_release);
+}
+
+} // unnamed namespace
+
+std::atomic<bool> BinaryLog::m_enabled (false);
+
+bool
+BinaryLog::Enable (std::string filename, uint32_t ringSize)
+{
+  NS_LOG_FUNCTION (filename << ringSize);
+  Disable ();
+  BinaryLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.m_mutex);
+  state.m_file = std::fopen (filename.c_str (), "wb");
+  if (state.m_file == 0)
+    {
+      NS_LOG_WARN ("Could not open binary log file " << filename);
+      return false;
+    }
+  FileHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::strncpy (header.magic, "NS3BLOG", sizeof (header.magic));
+  header.version = BINARY_LOG_VERSION;
+  header.recordSize = sizeof (Record);
+  header.timeStepsPerSecond = Seconds (1).GetTimeStep ();
+  std::fwrite (&header, sizeof (header), 1, state.m_file);
+  state.m_ringSize = std::max<uint32_t> (ringSize, 2);
+  m_enabled.store (true, std::memory_order_release);
+  return true;
+}
+
+void
+BinaryLog::Disable (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  BinaryLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.m_mutex);
+  m_enabled.store (false, std::memory_order_release);
+  if (state.m_file == 0)
+    {
+      return;
+    }
+  for (std::unique_ptr<BinaryLogRing> &ring : state.m_rings)
+    {
+      DrainRing (state, ring.get ());
+    }
+
+  // the dictionary of all the components and call sites registered so far
+  std::ostringstream dictionary;
+  for (const std::pair<const std::string, uint16_t> &component : state.m_components)
+    {
+      dictionary << "C " << component.second << " " << component.first << "\n";
+    }
+  for (const std::string &site : state.m_sites)
+    {
+      dictionary << site << "\n";
+    }
+  std::string text = dictionary.str ();
+  Record end;
+  std::memset (&end, 0, sizeof (end));
+  end.component = END_COMPONENT;
+  end.args[0] = text.size ();
+  std::fwrite (&end, sizeof (end), 1, state.m_file);
+  std::fwrite (text.data (), 1, text.size (), state.m_file);
+  std::fclose (state.m_file);
+  state.m_file = 0;
+
+  // the threads will allocate new rings for the next file
+  state.m_rings.clear ();
+  state.m_generation.fetch_add (1, std::memory_order_release);
+}
+
+void
+BinaryLog::Flush (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  BinaryLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.m_mutex);
+  if (state.m_file == 0)
+    {
+      return;
+    }
+  for (std::unique_ptr<BinaryLogRing> &ring : state.m_rings)
+    {
+      DrainRing (state, ring.get ());
+    }
+  std::fflush (state.m_file);
+}
+
+uint32_t
+BinaryLog::DoRegisterSite (const char *component, const char *format, const char *types)
+{
+  NS_LOG_FUNCTION (component << format << types);
+  BinaryLogState &state = GetState ();
+  std::lock_guard<std::mutex> lock (state.m_mutex);
+  std::map<std::string, uint16_t>::iterator it = state.m_components.find (component);
+  if (it == state.m_components.end ())
+    {
+      uint16_t id = static_cast<uint16_t> (state.m_components.size ());
+      NS_ABORT_MSG_IF (id == END_COMPONENT, "Too many binary log components");
+      it = state.m_components.insert (std::make_pair (std::string (component), id)).first;
+    }
+  uint32_t site = static_cast<uint32_t> (state.m_sites.size ());
+  NS_ABORT_MSG_IF (site > 0xffff, "Too many binary log call sites");
+  std::ostringstream line;
+  // the format is the end of the line, so it may contain spaces
+  line << "S " << site << " " << it->second << " " << (*types ? types : "-") << " " << format;
+  NS_ABORT_MSG_IF (line.str ().find ('\n') != std::string::npos,
+                   "Binary log formats cannot contain new lines: " << format);
+  state.m_sites.push_back (line.str ());
+  // the identifier carries the component, so that the threads do not
+  // need to look it up
+  return (static_cast<uint32_t> (it->second) << 16) | site;
+}
+
+BinaryLog::Record *
+BinaryLog::BeginRecord (uint32_t site)
+{
+  BinaryLogState &state = GetState ();
+  if (t_ring == 0 || t_generation != state.m_generation.load (std::memory_order_acquire))
+    {
+      std::lock_guard<std::mutex> lock (state.m_mutex);
+      if (state.m_file == 0)
+        {
+          return 0;
+        }
+      uint16_t thread = static_cast<uint16_t> (state.m_rings.size ());
+      state.m_rings.emplace_back (new BinaryLogRing (state.m_ringSize, thread));
+      t_ring = state.m_rings.back ().get ();
+      t_generation = state.m_generation.load (std::memory_order_relaxed);
+    }
+  BinaryLogRing *ring = t_ring;
+  uint64_t tail = ring->m_tail.load (std::memory_order_relaxed);
+  if (tail - ring->m_head.load (std::memory_order_acquire) == ring->m_records.size ())
+    {
+      std::lock_guard<std::mutex> lock (state.m_mutex);
+      if (state.m_file == 0)
+        {
+          return 0;
+        }
+      DrainRing (state, ring);
+    }
+  Record *record = &ring->m_records[tail % ring->m_records.size ()];
+  // the simulation time is available once the simulator exists,
+  // that is once it has installed the time printer of the logs
+  record->timestamp = LogGetTimePrinter () != 0 ? Simulator::Now ().GetTimeStep () : 0;
+  record->component = static_cast<uint16_t> (site >> 16);
+  record->thread = ring->m_thread;
+  record->site = site & 0xffff;
+  return record;
+}
+
+void
+BinaryLog::EndRecord (void)
+{
+  BinaryLogRing *ring = t_ring;
+  ring->m_tail.store (ring->m_tail.load (std::memory_order_relaxed) + 1,
+                      std::memory_order_release);
+}
+
+bool
+BinaryLog::Decode (std::string filename, std::ostream &os)
+{
+  NS_LOG_FUNCTION (filename << &os);
+  std::ifstream is (filename.c_str (), std::ios::binary);
+  FileHeader header;
+  if (!is.read (reinterpret_cast<char *> (&header), sizeof (header))
+      || std::strncmp (header.magic, "NS3BLOG", sizeof (header.magic)) != 0
+      || header.version != BINARY_LOG_VERSION
+      || header.recordSize != sizeof (Record))
+    {
+      return false;
+    }
+
+  // find and parse the dictionary at the end of the records
+  std::streampos first = is.tellg ();
+  Record record;
+  bool found = false;
+  while (is.read (reinterpret_cast<char *> (&record), sizeof (record)))
+    {
+      if (record.component == END_COMPONENT)
+        {
+          found = true;
+          break;
+        }
+    }
+  if (!found)
+    {
+      return false;
+    }
+  std::string text (record.args[0], '\0');
+  if (!is.read (&text[0], text.size ()))
+    {
+      return false;
+    }
+  std::map<uint16_t, std::string> components;
+  std::map<uint32_t, std::pair<std::string, std::string> > sites;
+  std::istringstream dictionary (text);
+  std::string line;
+  while (std::getline (dictionary, line))
+    {
+      std::istringstream fields (line);
+      std::string kind;
+      fields >> kind;
+      if (kind == "C")
+        {
+          uint16_t id;
+          std::string name;
+          fields >> id >> name;
+          components[id] = name;
+        }
+      else if (kind == "S")
+        {
+          uint32_t id;
+          uint16_t component;
+          std::string types;
+          fields >> id >> component >> types;
+          std::string format;
+          std::getline (fields, format);
+          if (!format.empty () && format[0] == ' ')
+            {
+              format.erase (0, 1);
+            }
+          sites[id] = std::make_pair (types == "-" ? std::string () : types, format);
+        }
+    }
+
+  is.clear ();
+  is.seekg (first);
+  while (is.read (reinterpret_cast<char *> (&record), sizeof (record))
+         && record.component != END_COMPONENT)
+    {
+      std::map<uint32_t, std::pair<std::string, std::string> >::const_iterator site =
+        sites.find (record.site);
+      if (site == sites.end ())
+        {
+          return false;
+        }
+      const std::string &types = site->second.first;
+      const std::string &format = site->second.second;
+      std::ostringstream message;
+      std::string::size_type cur = 0;
+      for (std::size_t i = 0; i < types.size (); ++i)
+        {
+          std::string::size_type next = format.find ("{}", cur);
+          if (next == std::string::npos)
+            {
+              break;
+            }
+          message << format.substr (cur, next - cur);
+          uint64_t raw = record.args[i];
+          switch (types[i])
+            {
+            case 'i':
+              message << static_cast<int64_t> (raw);
+              break;
+            case 'd':
+              {
+                double d;
+                std::memcpy (&d, &raw, sizeof (d));
+                message << d;
+              }
+              break;
+            case 'p':
+              message << "0x" << std::hex << raw << std::dec;
+              break;
+            case 't':
+              message << static_cast<double> (static_cast<int64_t> (raw)) / header.timeStepsPerSecond << "s";
+              break;
+            default:
+              message << raw;
+              break;
+            }
+          cur = next + 2;
+        }
+      message << format.substr (cur);
+      os << std::fixed << std::setprecision (9)
+         << static_cast<double> (record.timestamp) / header.timeStepsPerSecond
+         << std::defaultfloat
+         << " " << record.thread << " " << components[record.component]
+         << " " << message.str () << std::endl;
+    }
+  return true;
+}
+
+} // namespace ns3
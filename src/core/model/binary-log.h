@@ -0,0 +1,284 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include "nstime.h"
+
+#include <atomic>
+#include <cstring>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::BinaryLog declaration and the NS_BINLOG macro.
+ */
+
+/**
+ * \ingroup logging
+ *
+ * Record a message in the binary log, if it is enabled.
+ *
+ * The message is stored as the simulation time, the log component of
+ * the calling file, the call site and the raw values of the arguments,
+ * without any formatting; BinaryLog::Decode, or the
+ * \c binary-log-decoder program of \c utils/, replaces the \c {}
+ * placeholders of the format with the argument values offline.
+ * The arguments can be integers, floating point numbers, enums,
+ * booleans, pointers and ns3::Time values, up to
+ * BinaryLog::MAX_ARGS of them.
+ *
+ * \code
+ *   NS_BINLOG ("cwnd {} ssthresh {} of socket {}", m_cWnd.Get (), m_ssThresh.Get (), this);
+ * \endcode
+ *
+ * The call site is registered on its first execution, while the log
+ * is enabled.  When the log is disabled, the macro costs a test of a
+ * global flag.
+ *
+ * \param [in] ... The format string literal, then its arguments.
+ */
+#define NS_BINLOG(...)                                                  \
+  do                                                                    \
+    {                                                                   \
+      if (ns3::BinaryLog::IsEnabled ())                                 \
+        {                                                               \
+          static const uint32_t ns3BinaryLogSite =                      \
+            ns3::BinaryLog::RegisterSite (g_log.Name (), __VA_ARGS__);  \
+          ns3::BinaryLog::Write (ns3BinaryLogSite, __VA_ARGS__);        \
+        }                                                               \
+    }                                                                   \
+  while (false)
+
+namespace ns3 {
+
+/**
+ * \ingroup logging
+ * \brief A binary log of raw, unformatted messages, for high-volume
+ * logging in long runs.
+ *
+ * Each thread appends its messages to its own ring of fixed-size
+ * records, without locking.  The rings are flushed to the log file when
+ * they are full, when Flush() is called and when the log is disabled;
+ * only these flushes take a lock.  The file begins with a FileHeader,
+ * followed by the Records, then by a record with the END_COMPONENT
+ * component, whose first argument is the size of the dictionary which
+ * ends the file: the text lines \c "C <id> <name>" of the components
+ * and \c "S <id> <component> <types> <format>" of the call sites.
+ *
+ * The records of each thread are in order, those of different threads
+ * are interleaved by flush.
+ */
+class BinaryLog
+{
+public:
+  /** The maximum number of arguments of a message. */
+  static const uint32_t MAX_ARGS = 6;
+
+  /** The header of a binary log file. */
+  struct FileHeader
+  {
+    char magic[8];              //!< "NS3BLOG"
+    uint32_t version;           //!< The file format version
+    uint32_t recordSize;        //!< The size of a Record
+    int64_t timeStepsPerSecond; //!< The simulation time resolution
+  };
+
+  /** A message of the binary log. */
+  struct Record
+  {
+    int64_t timestamp;          //!< The simulation time, in time steps
+    uint16_t component;         //!< The log component identifier
+    uint16_t thread;            //!< The identifier of the writing thread
+    uint32_t site;              //!< The call site index
+    uint64_t args[MAX_ARGS];    //!< The raw argument values
+  };
+
+  /** The component of the record which precedes the dictionary. */
+  static const uint16_t END_COMPONENT = 0xffff;
+
+  /**
+   * Start logging to a file.
+   *
+   * \param [in] filename The log file, which is truncated.
+   * \param [in] ringSize The number of records of the ring of each thread.
+   * \returns \c true if the file could be opened.
+   */
+  static bool Enable (std::string filename, uint32_t ringSize = 4096);
+  /**
+   * Flush all the rings and close the log file.
+   *
+   * No thread may be logging concurrently.
+   */
+  static void Disable (void);
+  /**
+   * Flush the rings of all the threads to the log file.
+   */
+  static void Flush (void);
+  /**
+   * \returns \c true if the log is enabled.
+   */
+  static bool IsEnabled (void)
+  {
+    return m_enabled.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * Register a call site of NS_BINLOG.
+   *
+   * \tparam Args \deduced The argument types.
+   * \param [in] component The name of the log component of the call site.
+   * \param [in] format The message format.
+   * \param [in] args The arguments, whose values are not used.
+   * \returns The call site identifier: the log component identifier
+   *          in the upper 16 bits and the call site index in the lower ones.
+   */
+  template <typename... Args>
+  static uint32_t RegisterSite (const char *component, const char *format, const Args &... args)
+  {
+    static_assert (sizeof... (Args) <= MAX_ARGS, "Too many NS_BINLOG arguments");
+    const char types[] = {TypeCode<Args> ()..., '\0'};
+    return DoRegisterSite (component, format, types);
+  }
+
+  /**
+   * Append a message to the ring of the calling thread.
+   *
+   * \tparam Args \deduced The argument types.
+   * \param [in] site The call site identifier.
+   * \param [in] format The message format, which is not used.
+   * \param [in] args The arguments.
+   */
+  template <typename... Args>
+  static void Write (uint32_t site, const char *format, const Args &... args)
+  {
+    Record *record = BeginRecord (site);
+    if (record != 0)
+      {
+        uint64_t *arg = record->args;
+        // expand the arguments in order
+        int expand[] = {0, (*arg++ = Encode (args), 0)...};
+        (void) expand;
+        EndRecord ();
+      }
+  }
+
+  /**
+   * Write a binary log file as text, one message per line:
+   * the time in seconds, the thread, the component and the message.
+   *
+   * \param [in] filename The binary log file.
+   * \param [in] os The output stream.
+   * \returns \c true if the file could be decoded.
+   */
+  static bool Decode (std::string filename, std::ostream &os);
+
+private:
+  /**
+   * Get the argument type code of a type.
+   *
+   * \tparam T The argument type.
+   * \returns 'i' for the signed integers and enums, 'u' for the unsigned
+   *          integers and booleans, 'd' for the floating point numbers,
+   *          'p' for the pointers and 't' for ns3::Time.
+   */
+  template <typename T>
+  static constexpr char TypeCode (void)
+  {
+    typedef typename std::decay<T>::type U;
+    static_assert (std::is_arithmetic<U>::value || std::is_enum<U>::value
+                   || std::is_pointer<U>::value || std::is_same<U, Time>::value,
+                   "Unsupported NS_BINLOG argument type");
+    return std::is_same<U, Time>::value ? 't'
+           : std::is_pointer<U>::value ? 'p'
+           : std::is_floating_point<U>::value ? 'd'
+           : std::is_same<U, bool>::value ? 'u'
+           : std::is_enum<U>::value ? 'i'
+           : std::is_signed<U>::value ? 'i' : 'u';
+  }
+  /**
+   * \param [in] v An integer or enum argument.
+   * \returns The raw value.
+   */
+  template <typename T>
+  static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uint64_t>::type
+  Encode (T v)
+  {
+    return static_cast<uint64_t> (static_cast<int64_t> (v));
+  }
+  /**
+   * \param [in] v A floating point argument.
+   * \returns The raw value.
+   */
+  template <typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value, uint64_t>::type
+  Encode (T v)
+  {
+    double d = v;
+    uint64_t raw;
+    std::memcpy (&raw, &d, sizeof (raw));
+    return raw;
+  }
+  /**
+   * \param [in] v A pointer argument.
+   * \returns The raw value.
+   */
+  template <typename T>
+  static uint64_t Encode (T *v)
+  {
+    return reinterpret_cast<uintptr_t> (v);
+  }
+  /**
+   * \param [in] v A Time argument.
+   * \returns The raw value.
+   */
+  static uint64_t Encode (const Time &v)
+  {
+    return static_cast<uint64_t> (v.GetTimeStep ());
+  }
+
+  /**
+   * Register a call site.
+   *
+   * \param [in] component The name of the log component of the call site.
+   * \param [in] format The message format.
+   * \param [in] types The argument type codes.
+   * \returns The call site identifier.
+   */
+  static uint32_t DoRegisterSite (const char *component, const char *format, const char *types);
+  /**
+   * Get the next record of the ring of the calling thread, and
+   * fill its header.
+   *
+   * \param [in] site The call site identifier.
+   * \returns The record, or 0 if the log has been disabled.
+   */
+  static Record * BeginRecord (uint32_t site);
+  /** Commit the record returned by BeginRecord. */
+  static void EndRecord (void);
+
+  /** Whether the log is enabled. */
+  static std::atomic<bool> m_enabled;
+};
+
+} // namespace ns3
+
+#endif /* BINARY_LOG_H */
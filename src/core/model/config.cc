@@ -26,7 +26,10 @@
 #include "pointer.h"
 #include "log.h"
 
+#include <algorithm>
+#include <map>
 #include <sstream>
+#include <unordered_map>
 
 /**
  * \file
@@ -182,6 +185,9 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, into the list of index ranges
+ * which it matches.
  */
 class ArrayMatcher
 {
@@ -199,8 +205,25 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (std::size_t i) const;
+  /**
+   * Get the indices matching the Config path, if they are all below
+   * a bound, so that an array can be indexed directly instead of being
+   * scanned.
+   *
+   * \param [in] n The bound, that is the size of the array.
+   * \param [out] indices The matching indices, in increasing order.
+   * \returns \c true if the specification contains no wildcard
+   *          and matches no index greater than or equal to \pname{n}.
+   */
+  bool GetIndices (std::size_t n, std::vector<std::size_t> *indices) const;
 
 private:
+  /**
+   * Parse one of the alternatives of the Config path specification.
+   *
+   * \param [in] element The alternative.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -211,77 +234,111 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** \c true if the Config path element contains a wildcard. */
+  bool m_any;
+  /** The inclusive ranges of indices matched by the Config path element. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 
 };  // class ArrayMatcher
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_any (false)
+{
+  NS_LOG_FUNCTION (this << element);
+  std::string::size_type cur = 0;
+  std::string::size_type next;
+  do
+    {
+      next = element.find ("|", cur);
+      Parse (element.substr (cur, next - cur));
+      cur = next + 1;
+    }
+  while (next != std::string::npos);
+}
+void
+ArrayMatcher::Parse (std::string element)
 {
   NS_LOG_FUNCTION (this << element);
+  if (element == "*")
+    {
+      m_any = true;
+      return;
+    }
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1
+      && dash > leftBracket && dash < rightBracket)
+    {
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
+      uint32_t min;
+      uint32_t max;
+      if (StringToUint32 (lowerBound, &min)
+          && StringToUint32 (upperBound, &max)
+          && min <= max)
+        {
+          m_ranges.push_back (std::make_pair (min, max));
+        }
+      return;
+    }
+  uint32_t value;
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
 }
 bool
 ArrayMatcher::Matches (std::size_t i) const
 {
   NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  if (m_any)
     {
       NS_LOG_DEBUG ("Array " << i << " matches *");
       return true;
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator range = m_ranges.begin ();
+       range != m_ranges.end (); ++range)
     {
-      std::string left = m_element.substr (0, tmp - 0);
-      std::string right = m_element.substr (tmp + 1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
+      if (i >= range->first && i <= range->second)
         {
-          NS_LOG_DEBUG ("Array " << i << " matches " << right);
+          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
           return true;
         }
-      NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
+    }
+  NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
+  return false;
+}
+bool
+ArrayMatcher::GetIndices (std::size_t n, std::vector<std::size_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << n << indices);
+  indices->clear ();
+  if (m_any)
+    {
       return false;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1
-      && dash > leftBracket && dash < rightBracket)
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator range = m_ranges.begin ();
+       range != m_ranges.end (); ++range)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
-      uint32_t min;
-      uint32_t max;
-      if (StringToUint32 (lowerBound, &min)
-          && StringToUint32 (upperBound, &max)
-          && i >= min && i <= max)
+      if (range->second >= n)
         {
-          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-          return true;
+          // the array may be indexed by keys rather than by positions
+          return false;
         }
-      else
+      for (std::size_t i = range->first; i <= range->second; ++i)
         {
-          NS_LOG_DEBUG ("Array " << i << " does not " << m_element);
-          return false;
+          indices->push_back (i);
         }
     }
-  uint32_t value;
-  if (StringToUint32 (m_element, &value)
-      && i == value)
+  if (m_ranges.size () > 1)
     {
-      NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-      return true;
+      std::sort (indices->begin (), indices->end ());
+      indices->erase (std::unique (indices->begin (), indices->end ()), indices->end ());
     }
-  NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
-  return false;
+  return true;
 }
 
 bool
@@ -294,9 +351,191 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * A Config path split into its segments, which are parsed once.
+ *
+ * The compiled paths are cached by ConfigImpl, see ConfigImpl::Compile.
+ */
+class CompiledPath : public SimpleRefCount<CompiledPath>
+{
+public:
+  /**
+   * Construct from a Config path.
+   *
+   * \param [in] path The Config path.
+   */
+  CompiledPath (std::string path);
+
+  /** A segment of a Config path. */
+  struct Segment
+  {
+    /**
+     * Construct from the segment string.
+     *
+     * \param [in] item The segment string.
+     */
+    Segment (std::string item);
+    /** The segment string. */
+    std::string item;
+    /** The segment as an array index specification. */
+    ArrayMatcher matcher;
+    /** \c true if the segment is a GetObject call, \c "$TypeId". */
+    bool isObject;
+    /** \c true if the TypeId of the GetObject call was found. */
+    bool hasTid;
+    /** The TypeId of the GetObject call. */
+    TypeId tid;
+  };
+
+  /** The segments of the Config path. */
+  std::vector<Segment> m_segments;
+
+};  // class CompiledPath
+
+CompiledPath::Segment::Segment (std::string item)
+  : item (item),
+    matcher (item),
+    isObject (item.find ("$") == 0),
+    hasTid (false)
+{
+  if (isObject)
+    {
+      hasTid = TypeId::LookupByNameFailSafe (item.substr (1, item.size () - 1), &tid);
+    }
+}
+
+CompiledPath::CompiledPath (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+
+  // ensure that we start and end with a '/'
+  std::string::size_type tmp = path.find ("/");
+  if (tmp != 0)
+    {
+      // no slash at start
+      path = "/" + path;
+    }
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
+    {
+      // no slash at end
+      path = path + "/";
+    }
+
+  std::string::size_type cur = 1;
+  std::string::size_type next;
+  while ((next = path.find ("/", cur)) != std::string::npos)
+    {
+      m_segments.push_back (Segment (path.substr (cur, next - cur)));
+      cur = next + 1;
+    }
+}
+
+/**
+ * \ingroup config-impl
+ * An attribute through which a Config path can go, that is an attribute
+ * holding a Pointer or an ObjectPtrContainer.
+ */
+struct NavigableAttribute
+{
+  /** The attribute name. */
+  std::string name;
+  /** The attribute flags. */
+  uint32_t flags;
+  /** The attribute accessor. */
+  Ptr<const AttributeAccessor> accessor;
+  /** \c true for an ObjectPtrContainer, \c false for a Pointer. */
+  bool isContainer;
+};
+
+/**
+ * \ingroup config-impl
+ * The attributes of a TypeId through which a Config path can go,
+ * indexed by name.
+ */
+struct NavigableAttributes : public SimpleRefCount<NavigableAttributes>
+{
+  /** The TypeId::GetAttributeGeneration value when this was built. */
+  uint32_t generation;
+  /**
+   * The attributes of the TypeId and of its parents,
+   * in the order in which they are resolved.
+   */
+  std::vector<NavigableAttribute> attributes;
+  /** The indices in attributes of each attribute name. */
+  std::unordered_map<std::string, std::vector<std::size_t> > byName;
+  /** The indices of all the attributes, for the \c "*" wildcard. */
+  std::vector<std::size_t> all;
+};
+
+/**
+ * \ingroup config-impl
+ * Get the navigable attributes of a TypeId, building them on first use
+ * and whenever an attribute has been added since they were built.
+ *
+ * \param [in] tid The TypeId.
+ * \returns The navigable attributes.
+ */
+static Ptr<const NavigableAttributes>
+GetNavigableAttributes (TypeId tid)
+{
+  static std::vector<Ptr<NavigableAttributes> > cache;
+  uint32_t generation = TypeId::GetAttributeGeneration ();
+  uint16_t uid = tid.GetUid ();
+  if (uid >= cache.size ())
+    {
+      cache.resize (TypeId::GetRegisteredN () + 1);
+    }
+  if (cache[uid] != 0 && cache[uid]->generation == generation)
+    {
+      return cache[uid];
+    }
+
+  NS_LOG_DEBUG ("index the attributes of tid=" << tid.GetName ());
+  Ptr<NavigableAttributes> attributes = Create<NavigableAttributes> ();
+  attributes->generation = generation;
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          NavigableAttribute attribute;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = false;
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = true;
+            }
+          else
+            {
+              // this could be anything else and we don't know what to do with it.
+              continue;
+            }
+          attribute.name = info.name;
+          attribute.flags = info.flags;
+          attribute.accessor = info.accessor;
+          attributes->byName[info.name].push_back (attributes->attributes.size ());
+          attributes->all.push_back (attributes->attributes.size ());
+          attributes->attributes.push_back (attribute);
+        }
+      nextTid = tid.GetParent ();
+    }
+  while (nextTid != tid);
+  cache[uid] = attributes;
+  return attributes;
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * Several paths can be resolved together, in which case the segments
+ * which they share are resolved only once.
  */
 class Resolver
 {
@@ -306,12 +545,18 @@ public:
    *
    * \param [in] path The Config path.
    */
-  Resolver (std::string path);
+  Resolver (Ptr<const CompiledPath> path);
+  /**
+   * Construct from a list of base Config paths.
+   *
+   * \param [in] paths The Config paths.
+   */
+  Resolver (const std::vector<Ptr<const CompiledPath> > &paths);
   /** Destructor. */
   virtual ~Resolver ();
 
   /**
-   * Parse the stored Config path into an object reference,
+   * Parse the stored Config paths into object references,
    * beginning at the indicated root object.
    *
    * \param [in] root The object corresponding to the current position in
@@ -320,29 +565,66 @@ public:
   void Resolve (Ptr<Object> root);
 
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
+  /** A list of Config paths, by their indices in m_paths. */
+  typedef std::vector<std::size_t> PathGroup;
+
   /**
-   * Parse the next element in the Config path.
+   * Split a group of Config paths by their segment at some depth.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] group The Config paths.
+   * \param [in] depth The depth of the segment.
+   * \param [out] ended The Config paths with no segment at \pname{depth}.
+   * \param [out] items The other Config paths, grouped by segment,
+   *                    in the order of \pname{group}.
+   */
+  void SplitGroup (const PathGroup &group, std::size_t depth,
+                   PathGroup *ended, std::vector<PathGroup> *items) const;
+  /**
+   * Parse the next element in the Config paths.
+   *
+   * \param [in] group The Config paths.
+   * \param [in] depth The depth of the next element.
    * \param [in] root The object corresponding to the current position
-   *                  in the Config path.
+   *                  in the Config paths.
+   */
+  void DoResolve (const PathGroup &group, std::size_t depth, Ptr<Object> root);
+  /**
+   * Parse the next element, which is the same in all the Config paths.
+   *
+   * \param [in] group The Config paths.
+   * \param [in] depth The depth of the next element.
+   * \param [in] root The object corresponding to the current position
+   *                  in the Config paths.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolveItem (const PathGroup &group, std::size_t depth, Ptr<Object> root);
   /**
-   * Parse an index on the Config path.
+   * Parse an index on the Config paths.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] group The Config paths.
+   * \param [in] depth The depth of the index.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (const PathGroup &group, std::size_t depth, Ptr<Object> root,
+                       const NavigableAttribute &attribute);
   /**
-   * Handle one object found on the path.
+   * Get the objects matching an index specification in a container.
+   *
+   * \param [in] matcher The index specification.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
+   * \param [out] matches The matching objects, by index.
+   */
+  void GetArrayMatches (const ArrayMatcher &matcher, Ptr<Object> root,
+                        const NavigableAttribute &attribute,
+                        std::map<std::size_t, Ptr<Object> > *matches) const;
+  /**
+   * Handle one object found on a path.
    *
    * \param [in] object The current object on the Config path.
+   * \param [in] index The index of the Config path.
    */
-  void DoResolveOne (Ptr<Object> object);
+  void DoResolveOne (Ptr<Object> object, std::size_t index);
   /**
    * Get the current Config path.
    *
@@ -354,44 +636,38 @@ private:
    *
    * \param [in] object The found object.
    * \param [in] path The matching Config path context.
+   * \param [in] index The index of the Config path in the list
+   *                   given to the constructor.
    */
-  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
+  virtual void DoOne (Ptr<Object> object, std::string path, std::size_t index) = 0;
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The Config paths. */
+  std::vector<Ptr<const CompiledPath> > m_paths;
+  /** All the Config paths. */
+  PathGroup m_all;
 
 };  // class Resolver
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Resolver::Resolver (Ptr<const CompiledPath> path)
+  : m_paths (1, path),
+    m_all (1, 0)
 {
   NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
 }
-Resolver::~Resolver ()
+Resolver::Resolver (const std::vector<Ptr<const CompiledPath> > &paths)
+  : m_paths (paths)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << &paths);
+  for (std::size_t i = 0; i < m_paths.size (); ++i)
+    {
+      m_all.push_back (i);
+    }
 }
-void
-Resolver::Canonicalize (void)
+Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
 }
 
 void
@@ -399,7 +675,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (m_all, 0, root);
 }
 
 std::string
@@ -416,39 +692,86 @@ Resolver::GetResolvedPath (void) const
 }
 
 void
-Resolver::DoResolveOne (Ptr<Object> object)
+Resolver::DoResolveOne (Ptr<Object> object, std::size_t index)
 {
-  NS_LOG_FUNCTION (this << object);
+  NS_LOG_FUNCTION (this << object << index);
 
   NS_LOG_DEBUG ("resolved=" << GetResolvedPath ());
-  DoOne (object, GetResolvedPath ());
+  DoOne (object, GetResolvedPath (), index);
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
-{
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-
-  if (next == std::string::npos)
-    {
-      //
-      // If root is zero, we're beginning to see if we can use the object name
-      // service to resolve this path.  It is impossible to have a object name
-      // associated with the root of the object name service since that root
-      // is not an object.  This path must be referring to something in another
-      // namespace and it will have been found already since the name service
-      // is always consulted last.
-      //
-      if (root)
+Resolver::SplitGroup (const PathGroup &group, std::size_t depth,
+                      PathGroup *ended, std::vector<PathGroup> *items) const
+{
+  NS_LOG_FUNCTION (this << &group << depth << ended << items);
+  if (group.size () == 1)
+    {
+      // the common case of a single path
+      if (depth == m_paths[group[0]]->m_segments.size ())
+        {
+          ended->push_back (group[0]);
+        }
+      else
         {
-          DoResolveOne (root);
+          items->push_back (group);
         }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  std::unordered_map<std::string, std::size_t> itemIndices;
+  for (PathGroup::const_iterator i = group.begin (); i != group.end (); ++i)
+    {
+      const std::vector<CompiledPath::Segment> &segments = m_paths[*i]->m_segments;
+      if (depth == segments.size ())
+        {
+          ended->push_back (*i);
+          continue;
+        }
+      std::pair<std::unordered_map<std::string, std::size_t>::iterator, bool> inserted =
+        itemIndices.insert (std::make_pair (segments[depth].item, items->size ()));
+      if (inserted.second)
+        {
+          items->push_back (PathGroup ());
+        }
+      (*items)[inserted.first->second].push_back (*i);
+    }
+}
+
+void
+Resolver::DoResolve (const PathGroup &group, std::size_t depth, Ptr<Object> root)
+{
+  NS_LOG_FUNCTION (this << &group << depth << root);
+  PathGroup ended;
+  std::vector<PathGroup> items;
+  SplitGroup (group, depth, &ended, &items);
+
+  //
+  // If root is zero, we're beginning to see if we can use the object name
+  // service to resolve this path.  It is impossible to have a object name
+  // associated with the root of the object name service since that root
+  // is not an object.  This path must be referring to something in another
+  // namespace and it will have been found already since the name service
+  // is always consulted last.
+  //
+  if (root)
+    {
+      for (PathGroup::const_iterator i = ended.begin (); i != ended.end (); ++i)
+        {
+          DoResolveOne (root, *i);
+        }
+    }
+  for (std::vector<PathGroup>::const_iterator i = items.begin (); i != items.end (); ++i)
+    {
+      DoResolveItem (*i, depth, root);
+    }
+}
+
+void
+Resolver::DoResolveItem (const PathGroup &group, std::size_t depth, Ptr<Object> root)
+{
+  NS_LOG_FUNCTION (this << &group << depth << root);
+  const CompiledPath::Segment &segment = m_paths[group.front ()]->m_segments[depth];
+  const std::string &item = segment.item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name
@@ -459,11 +782,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.compare (0, 5, "Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (group, depth + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -480,7 +802,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (group, depth + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -496,13 +818,12 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (segment.isObject)
     {
       // This is a call to GetObject
       std::string tidString = item.substr (1, item.size () - 1);
       NS_LOG_DEBUG ("GetObject=" << tidString << " on path=" << GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      TypeId tid = segment.hasTid ? segment.tid : TypeId::LookupByName (tidString);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
@@ -510,101 +831,142 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (group, depth + 1, object);
       m_workStack.pop_back ();
     }
   else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
-      bool foundMatch = false;
-
-      do
+      Ptr<const NavigableAttributes> attributes = GetNavigableAttributes (root->GetInstanceTypeId ());
+      const std::vector<std::size_t> *indices = &attributes->all;
+      if (item != "*")
         {
-          tid = nextTid;
-
-          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+          std::unordered_map<std::string, std::vector<std::size_t> >::const_iterator it =
+            attributes->byName.find (item);
+          if (it == attributes->byName.end ())
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute (i);
-              if (info.name != item && item != "*")
-                {
-                  continue;
-                }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (pChecker != 0)
+              NS_LOG_DEBUG ("Requested item=" << item << " does not exist on path=" << GetResolvedPath ());
+              return;
+            }
+          indices = &it->second;
+        }
+      for (std::vector<std::size_t>::const_iterator i = indices->begin (); i != indices->end (); ++i)
+        {
+          const NavigableAttribute &attribute = attributes->attributes[*i];
+          if (!attribute.isContainer)
+            {
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << attribute.name << " on path=" << GetResolvedPath ());
+              PointerValue pValue;
+              if (!(attribute.flags & TypeId::ATTR_GET) || !attribute.accessor->HasGetter ()
+                  || !attribute.accessor->Get (PeekPointer (root), pValue))
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\"" << item <<
-                                    "\" exists on path=\"" << GetResolvedPath () << "\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
+                  // let ObjectBase report the error
+                  root->GetAttribute (attribute.name, pValue);
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker =
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  NS_LOG_ERROR ("Requested object name=\"" << item <<
+                                "\" exists on path=\"" << GetResolvedPath () << "\""
+                                " but is null.");
+                  continue;
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              m_workStack.push_back (attribute.name);
+              DoResolve (group, depth + 1, object);
+              m_workStack.pop_back ();
             }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << attribute.name << " on path=" << GetResolvedPath ());
+              m_workStack.push_back (attribute.name);
+              DoArrayResolve (group, depth + 1, root, attribute);
+              m_workStack.pop_back ();
+            }
+        }
+    }
+}
 
-          nextTid = tid.GetParent ();
+void
+Resolver::GetArrayMatches (const ArrayMatcher &matcher, Ptr<Object> root,
+                           const NavigableAttribute &attribute,
+                           std::map<std::size_t, Ptr<Object> > *matches) const
+{
+  NS_LOG_FUNCTION (this << &matcher << root << attribute.name << matches);
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.accessor));
+  std::size_t n;
+  if (accessor == 0 || !(attribute.flags & TypeId::ATTR_GET)
+      || !accessor->GetN (PeekPointer (root), &n))
+    {
+      // let ObjectBase get the whole container, or report the error
+      ObjectPtrContainerValue container;
+      root->GetAttribute (attribute.name, container);
+      for (ObjectPtrContainerValue::Iterator it = container.Begin (); it != container.End (); ++it)
+        {
+          if (matcher.Matches (it->first))
+            {
+              (*matches)[it->first] = it->second;
+            }
         }
-      while (nextTid != tid);
+      return;
+    }
 
-      if (!foundMatch)
+  // Go straight to the explicit indices, if they are the positions of
+  // the objects in the container, as they are in an ObjectVector.
+  std::vector<std::size_t> indices;
+  if (matcher.GetIndices (n, &indices))
+    {
+      bool direct = true;
+      for (std::vector<std::size_t>::const_iterator i = indices.begin (); i != indices.end (); ++i)
+        {
+          std::size_t index;
+          Ptr<Object> object = accessor->Get (PeekPointer (root), *i, &index);
+          if (index != *i)
+            {
+              direct = false;
+              break;
+            }
+          (*matches)[index] = object;
+        }
+      if (direct)
         {
-          NS_LOG_DEBUG ("Requested item=" << item << " does not exist on path=" << GetResolvedPath ());
           return;
         }
+      matches->clear ();
+    }
+
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      std::size_t index;
+      Ptr<Object> object = accessor->Get (PeekPointer (root), i, &index);
+      if (matcher.Matches (index))
+        {
+          (*matches)[index] = object;
+        }
     }
 }
 
 void
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (const PathGroup &group, std::size_t depth, Ptr<Object> root,
+                          const NavigableAttribute &attribute)
 {
-  NS_LOG_FUNCTION (this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
-    {
-      return;
-    }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  NS_LOG_FUNCTION (this << &group << depth << root << attribute.name);
+  PathGroup ended;
+  std::vector<PathGroup> items;
+  SplitGroup (group, depth, &ended, &items);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
-  ObjectPtrContainerValue::Iterator it;
-  for (it = container.Begin (); it != container.End (); ++it)
+  for (std::vector<PathGroup>::const_iterator i = items.begin (); i != items.end (); ++i)
     {
-      if (matcher.Matches ((*it).first))
+      const ArrayMatcher &matcher = m_paths[i->front ()]->m_segments[depth].matcher;
+      std::map<std::size_t, Ptr<Object> > matches;
+      GetArrayMatches (matcher, root, attribute, &matches);
+      for (std::map<std::size_t, Ptr<Object> >::const_iterator it = matches.begin ();
+           it != matches.end (); ++it)
         {
           std::ostringstream oss;
-          oss << (*it).first;
+          oss << it->first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (*i, depth + 1, it->second);
           m_workStack.pop_back ();
         }
     }
@@ -633,6 +995,16 @@ public:
   void Disconnect (std::string path, const CallbackBase &cb);
   /** \copydoc Config::LookupMatches() */
   MatchContainer LookupMatches (std::string path);
+  /**
+   * Connect a callback to the trace sources matched by a list of paths.
+   *
+   * \param [in] paths The paths to match trace sources.
+   * \param [in] cb The callback to connect.
+   * \param [in] withContext \c true to connect with the matched path as context.
+   * \returns The number of trace sources connected.
+   */
+  std::size_t ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb,
+                          bool withContext);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -653,6 +1025,17 @@ private:
    * \param [in,out] leaf The trailing part of the \pname{path}.
    */
   void ParsePath (std::string path, std::string *root, std::string *leaf) const;
+  /**
+   * Get the compiled form of a Config path, from the cache if possible.
+   * \param [in] path The Config path.
+   * \returns The compiled Config path.
+   */
+  Ptr<const CompiledPath> Compile (std::string path);
+  /**
+   * Resolve a list of compiled Config paths from all the roots.
+   * \param [in] resolver The resolver of the Config paths.
+   */
+  void Resolve (Resolver &resolver) const;
 
   /** Container type to hold the root Config path tokens. */
   typedef std::vector<Ptr<Object> > Roots;
@@ -660,6 +1043,13 @@ private:
   /** The list of Config path roots. */
   Roots m_roots;
 
+  /** Container type of the compiled Config paths, by Config path. */
+  typedef std::unordered_map<std::string, Ptr<const CompiledPath> > CompiledPaths;
+  /** The cache of the compiled Config paths. */
+  CompiledPaths m_compiled;
+  /** The maximum number of compiled Config paths in the cache. */
+  static const std::size_t MAX_COMPILED = 4096;
+
 };  // class ConfigImpl
 
 void
@@ -674,6 +1064,42 @@ ConfigImpl::ParsePath (std::string path, std::string *root, std::string *leaf) c
   NS_LOG_FUNCTION (path << *root << *leaf);
 }
 
+Ptr<const CompiledPath>
+ConfigImpl::Compile (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  CompiledPaths::const_iterator it = m_compiled.find (path);
+  if (it != m_compiled.end ())
+    {
+      return it->second;
+    }
+  if (m_compiled.size () >= MAX_COMPILED)
+    {
+      // the paths built for each node are seldom used twice
+      m_compiled.clear ();
+    }
+  Ptr<const CompiledPath> compiled = Create<CompiledPath> (path);
+  m_compiled.insert (std::make_pair (path, compiled));
+  return compiled;
+}
+
+void
+ConfigImpl::Resolve (Resolver &resolver) const
+{
+  NS_LOG_FUNCTION (this << &resolver);
+  for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
+    {
+      resolver.Resolve (*i);
+    }
+
+  //
+  // See if we can do something with the object name service.  Starting with
+  // the root pointer zeroed indicates to the resolver that it should start
+  // looking at the root of the "/Names" namespace during this go.
+  //
+  resolver.Resolve (0);
+}
+
 void
 ConfigImpl::Set (std::string path, const AttributeValue &value)
 {
@@ -754,33 +1180,81 @@ ConfigImpl::LookupMatches (std::string path)
   class LookupMatchesResolver : public Resolver
   {
 public:
-    LookupMatchesResolver (std::string path)
+    LookupMatchesResolver (Ptr<const CompiledPath> path)
       : Resolver (path)
     {
     }
-    virtual void DoOne (Ptr<Object> object, std::string path)
+    virtual void DoOne (Ptr<Object> object, std::string path, std::size_t index)
     {
       m_objects.push_back (object);
       m_contexts.push_back (path);
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
-  for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
-    {
-      resolver.Resolve (*i);
-    }
-
-  //
-  // See if we can do something with the object name service.  Starting with
-  // the root pointer zeroed indicates to the resolver that it should start
-  // looking at the root of the "/Names" namespace during this go.
-  //
-  resolver.Resolve (0);
+  } resolver = LookupMatchesResolver (Compile (path));
+  Resolve (resolver);
 
   return MatchContainer (resolver.m_objects, resolver.m_contexts, path);
 }
 
+std::size_t
+ConfigImpl::ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb,
+                        bool withContext)
+{
+  NS_LOG_FUNCTION (this << &paths << &cb << withContext);
+  class ConnectAllResolver : public Resolver
+  {
+public:
+    ConnectAllResolver (const std::vector<Ptr<const CompiledPath> > &paths,
+                        const std::vector<std::string> &leaves,
+                        const CallbackBase &cb, bool withContext)
+      : Resolver (paths),
+        m_leaves (leaves),
+        m_cb (cb),
+        m_withContext (withContext),
+        m_connected (0)
+    {
+    }
+    virtual void DoOne (Ptr<Object> object, std::string path, std::size_t index)
+    {
+      const std::string &leaf = m_leaves[index];
+      bool ok;
+      if (m_withContext)
+        {
+          ok = object->TraceConnect (leaf, path + leaf, m_cb);
+        }
+      else
+        {
+          ok = object->TraceConnectWithoutContext (leaf, m_cb);
+        }
+      if (ok)
+        {
+          ++m_connected;
+        }
+    }
+    const std::vector<std::string> &m_leaves;
+    const CallbackBase &m_cb;
+    bool m_withContext;
+    std::size_t m_connected;
+  };
+
+  std::vector<Ptr<const CompiledPath> > roots;
+  std::vector<std::string> leaves;
+  roots.reserve (paths.size ());
+  leaves.reserve (paths.size ());
+  for (std::vector<std::string>::const_iterator i = paths.begin (); i != paths.end (); ++i)
+    {
+      std::string root, leaf;
+      ParsePath (*i, &root, &leaf);
+      // the roots are not cached: each of them is resolved only once here
+      roots.push_back (Create<CompiledPath> (root));
+      leaves.push_back (leaf);
+    }
+  ConnectAllResolver resolver (roots, leaves, cb, withContext);
+  Resolve (resolver);
+  return resolver.m_connected;
+}
+
 void
 ConfigImpl::RegisterRootNamespaceObject (Ptr<Object> obj)
 {
@@ -940,6 +1414,18 @@ MatchContainer LookupMatches (std::string path)
   NS_LOG_FUNCTION (path);
   return ConfigImpl::Get ()->LookupMatches (path);
 }
+std::size_t
+ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (&paths << &cb);
+  return ConfigImpl::Get ()->ConnectAll (paths, cb, true);
+}
+std::size_t
+ConnectWithoutContextAll (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (&paths << &cb);
+  return ConfigImpl::Get ()->ConnectAll (paths, cb, false);
+}
 
 void RegisterRootNamespaceObject (Ptr<Object> obj)
 {
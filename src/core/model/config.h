@@ -168,6 +168,32 @@ bool ConnectFailSafe (std::string path, const CallbackBase &cb);
  * This function undoes the work of Config::ConnectWithContext.
  */
 void Disconnect (std::string path, const CallbackBase &cb);
+/**
+ * \ingroup config
+ * \param [in] paths The paths to match trace sources.
+ * \param [in] cb The callback to connect to the matching trace sources.
+ * \returns The number of trace sources connected.
+ *
+ * This function connects the input callback to all the trace sources
+ * which match any of the input paths, as ConnectFailSafe does for each
+ * path, with the matched path as context.  The paths are resolved in a
+ * single traversal of the object tree, so that the segments which they
+ * share, e.g., "/NodeList/3/DeviceList/0" in
+ * "/NodeList/3/DeviceList/0/Mac/MacTx" and
+ * "/NodeList/3/DeviceList/0/Mac/MacRx", are resolved only once.
+ */
+std::size_t ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb);
+/**
+ * \ingroup config
+ * \param [in] paths The paths to match trace sources.
+ * \param [in] cb The callback to connect to the matching trace sources.
+ * \returns The number of trace sources connected.
+ *
+ * This function connects the input callback to all the trace sources
+ * which match any of the input paths, as ConnectAll does, but without
+ * context.
+ */
+std::size_t ConnectWithoutContextAll (const std::vector<std::string> &paths, const CallbackBase &cb);
 
 /**
  * \ingroup config
@@ -150,6 +150,7 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentUid = next.key.m_uid;
   next.impl->Invoke ();
   next.impl->Unref ();
+  m_profiler.NotifyEvent (m_currentTs, m_eventCount);
 
   ProcessEventsWithContext ();
 }
@@ -198,12 +199,15 @@ DefaultSimulatorImpl::Run (void)
   m_main = SystemThread::Self ();
   ProcessEventsWithContext ();
   m_stop = false;
+  m_profiler.Start (0, 1, TimeStep (m_currentTs));
 
   while (!m_events->IsEmpty () && !m_stop)
     {
       ProcessOneEvent ();
     }
 
+  m_profiler.Stop (TimeStep (m_currentTs), m_eventCount);
+
   // If the simulator stopped naturally by lack of events, make a
   // consistency test to check that we didn't lose any events along the way.
   NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
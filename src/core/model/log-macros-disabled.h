@@ -28,6 +28,26 @@
 #ifndef NS3_LOG_MACROS_DISABLED_H
 #define NS3_LOG_MACROS_DISABLED_H
 
+/**
+ * \ingroup logging
+ * Empty logging macro implementation, used when logging is disabled or elided.
+ */
+#define NS_LOG_NOOP_INTERNAL(msg)                \
+  do if (false)                                  \
+    {                                            \
+      std::clog << msg;                          \
+    }  while (false)
+
+/**
+ * \ingroup logging
+ * Empty logging macro implementation, used when logging is disabled or elided.
+ */
+#define NS_LOG_NOOP_FUNC_INTERNAL(msg)           \
+  do if (false)                                  \
+    {                                            \
+      ns3::ParameterLogger (std::clog) << msg;   \
+    } while (false)
+
 #ifndef NS3_LOG_ENABLE
 /*
   Implementation Note:
@@ -59,30 +79,12 @@
 */
 
 
-/**
- * \ingroup logging
- * Empty logging macro implementation, used when logging is disabled.
- */
-#define NS_LOG_NOOP_INTERNAL(msg)                \
-  do if (false)                                  \
-    {                                            \
-      std::clog << msg;                          \
-    }  while (false)
 
 #define NS_LOG(level, msg) \
   NS_LOG_NOOP_INTERNAL (msg)
 
 #define NS_LOG_FUNCTION_NOARGS()
 
-/**
- * \ingroup logging
- * Empty logging macro implementation, used when logging is disabled.
- */
-#define NS_LOG_NOOP_FUNC_INTERNAL(msg)           \
-  do if (false)                                  \
-    {                                            \
-      ns3::ParameterLogger (std::clog) << msg;   \
-    } while (false)
 
 #define NS_LOG_FUNCTION(parameters) \
   NS_LOG_NOOP_FUNC_INTERNAL (parameters)
@@ -198,6 +198,15 @@
         }                                                       \
     } while (false)
 
+#ifdef NS3_LOG_ELIDE_FUNCTION_LOGIC
+
+// NS_LOG_FUNCTION is compiled out of this module, see log.h
+#define NS_LOG_FUNCTION_NOARGS()
+#define NS_LOG_FUNCTION(parameters) \
+  NS_LOG_NOOP_FUNC_INTERNAL (parameters)
+
+#else /* !NS3_LOG_ELIDE_FUNCTION_LOGIC */
+
 /**
  * \ingroup logging
  *
@@ -258,6 +267,8 @@
     }                                                           \
   while (false)
 
+#endif /* !NS3_LOG_ELIDE_FUNCTION_LOGIC */
+
 
 /**
  * \ingroup logging
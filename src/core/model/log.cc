@@ -50,6 +50,11 @@ static TimePrinter g_logTimePrinter = 0;
  * The Log NodePrinter.
  */
 static NodePrinter g_logNodePrinter = 0;
+/**
+ * \ingroup logging
+ * Whether the log messages of this thread are suppressed.
+ */
+static thread_local bool t_logSuppressed = false;
 
 /**
  * \ingroup logging
@@ -282,7 +287,7 @@ bool
 LogComponent::IsEnabled (const enum LogLevel level) const
 {
   //  LogComponentEnableEnvVar ();
-  return (level & m_levels) ? 1 : 0;
+  return (level & m_levels) && !t_logSuppressed;
 }
 
 bool
@@ -640,6 +645,11 @@ NodePrinter LogGetNodePrinter (void)
   return g_logNodePrinter;
 }
 
+void LogSetThreadSuppressed (bool suppress)
+{
+  t_logSuppressed = suppress;
+}
+
 
 ParameterLogger::ParameterLogger (std::ostream &os)
   : m_first (true),
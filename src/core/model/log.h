@@ -81,6 +81,16 @@
  *   NS_LOG_FUNCTION (this << arg1 << args);
  * \endcode
  * Use NS_LOG_FUNCTION_NOARGS() only in static functions with no arguments.
+ *
+ * The function and logic levels are the most frequent ones in the
+ * hot paths, where even the disabled NS_LOG_FUNCTION() costs a test
+ * of the log component.  When the modules are compiled with
+ * \c NS3_LOG_ELIDE_FUNCTION_LOGIC defined, e.g., with
+ * \code
+ *   $ ./waf configure --enable-logs --elide-logs=network,internet,wifi
+ * \endcode
+ * NS_LOG_FUNCTION(), NS_LOG_FUNCTION_NOARGS() and NS_LOG_LOGIC() are
+ * compiled out of them, while the other levels are still available.
  */
 /** @{ */
 
@@ -281,6 +291,11 @@ void LogComponentDisableAll (enum LogLevel level);
 #define NS_LOG_INFO(msg) \
   NS_LOG (ns3::LOG_INFO, msg)
 
+#ifdef NS3_LOG_ELIDE_FUNCTION_LOGIC
+// NS_LOG_LOGIC is compiled out of this module
+#define NS_LOG_LOGIC(msg) \
+  NS_LOG_NOOP_INTERNAL (msg)
+#else
 /**
  * Use \ref NS_LOG to output a message of level LOG_LOGIC
  *
@@ -288,6 +303,7 @@ void LogComponentDisableAll (enum LogLevel level);
  */
 #define NS_LOG_LOGIC(msg) \
   NS_LOG (ns3::LOG_LOGIC, msg)
+#endif
 
 
 namespace ns3 {
@@ -329,6 +345,18 @@ void LogSetNodePrinter (NodePrinter np);
  */
 NodePrinter LogGetNodePrinter (void);
 
+/**
+ * Suppress, or restore, the log messages of the calling thread, whatever
+ * the levels enabled in the log components.
+ *
+ * WorkerPool suppresses the log messages of the threads running a batch
+ * of tasks concurrently, so the code it shares with the sequential path
+ * can keep its logging.
+ *
+ * \param [in] suppress Whether to suppress the log messages.
+ */
+void LogSetThreadSuppressed (bool suppress);
+
 
 /**
  * A single log component configuration.
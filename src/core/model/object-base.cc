@@ -26,6 +26,8 @@
 
 #include <cstdlib>  // getenv
 #include <cstring>  // strlen
+#include <map>
+#include <vector>
 
 /**
  * \file
@@ -76,99 +78,218 @@ ObjectBase::NotifyConstructionCompleted (void)
   NS_LOG_FUNCTION (this);
 }
 
-void
-ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
+/**
+ * \ingroup object
+ * Information needed by ObjectBase::ConstructSelf to initialize
+ * an attribute.
+ */
+struct ConstructionPlanItem
+{
+  /** The TypeId declaring the attribute. */
+  TypeId tid;
+  /** The index of the attribute in \c tid. */
+  std::size_t index;
+  /** The attribute flags. */
+  uint32_t flags;
+  /** The attribute accessor. */
+  Ptr<const AttributeAccessor> accessor;
+  /** The attribute checker. */
+  Ptr<const AttributeChecker> checker;
+  /** The default value of the attribute. */
+  Ptr<const AttributeValue> value;
+  /** \c true if \c value has already been validated by \c checker. */
+  bool validated;
+};
+
+/**
+ * \ingroup object
+ * The attributes of a TypeId and of all its parents, in the order
+ * they are initialized by ObjectBase::ConstructSelf, with their
+ * default values.
+ */
+struct ConstructionPlan : public SimpleRefCount<ConstructionPlan>
+{
+  /** The value of TypeId::GetAttributeGeneration when the plan was built. */
+  uint32_t generation;
+  /** The attributes. */
+  std::vector<ConstructionPlanItem> items;
+};
+
+/**
+ * \ingroup object
+ * Get the attribute defaults set through the NS_ATTRIBUTE_DEFAULT
+ * environment variable, which is parsed on first use.
+ *
+ * \returns The attribute values, indexed by attribute full name.
+ */
+static const std::map<std::string, std::string> &
+GetEnvironmentDefaults (void)
+{
+  static std::map<std::string, std::string> defaults;
+  static bool parsed = false;
+  if (parsed)
+    {
+      return defaults;
+    }
+  parsed = true;
+  const char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  if (envVar != 0 && std::strlen (envVar) > 0)
+    {
+      std::string env = envVar;
+      std::string::size_type cur = 0;
+      std::string::size_type next = 0;
+      while (next != std::string::npos)
+        {
+          next = env.find (";", cur);
+          std::string tmp = std::string (env, cur, next - cur);
+          std::string::size_type equal = tmp.find ("=");
+          if (equal != std::string::npos)
+            {
+              std::string name = tmp.substr (0, equal);
+              std::string envval = tmp.substr (equal + 1, tmp.size () - equal - 1);
+              // the first occurrence takes precedence
+              defaults.insert (std::make_pair (name, envval));
+            }
+          cur = next + 1;
+        }
+    }
+  return defaults;
+}
+
+/**
+ * \ingroup object
+ * Get the construction plan of a TypeId, building it on first use
+ * and whenever an attribute has been added or its initial value
+ * has been changed since it was built.
+ *
+ * \param [in] tid The TypeId of the object being constructed.
+ * \returns The construction plan.
+ */
+static Ptr<const ConstructionPlan>
+GetConstructionPlan (TypeId tid)
 {
+  static std::vector<Ptr<ConstructionPlan> > plans;
+  uint32_t generation = TypeId::GetAttributeGeneration ();
+  uint16_t uid = tid.GetUid ();
+  if (uid >= plans.size ())
+    {
+      plans.resize (TypeId::GetRegisteredN () + 1);
+    }
+  if (plans[uid] != 0 && plans[uid]->generation == generation)
+    {
+      return plans[uid];
+    }
+
+  NS_LOG_DEBUG ("build the construction plan of tid=" << tid.GetName ());
+  const std::map<std::string, std::string> &envDefaults = GetEnvironmentDefaults ();
+  Ptr<ConstructionPlan> plan = Create<ConstructionPlan> ();
+  plan->generation = generation;
   // loop over the inheritance tree back to the Object base class.
-  NS_LOG_FUNCTION (this << &attributes);
-  TypeId tid = GetInstanceTypeId ();
   do
     {
-      // loop over all attributes in object type
-      NS_LOG_DEBUG ("construct tid=" << tid.GetName () << ", params=" << tid.GetAttributeN ());
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
         {
           struct TypeId::AttributeInformation info = tid.GetAttribute (i);
-          NS_LOG_DEBUG ("try to construct \"" << tid.GetName () << "::" <<
-                        info.name << "\"");
-          // is this attribute stored in this AttributeConstructionList instance ?
-          Ptr<AttributeValue> value = attributes.Find (info.checker);
-          // See if this attribute should not be set here in the
-          // constructor.
-          if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+          ConstructionPlanItem item;
+          item.tid = tid;
+          item.index = i;
+          item.flags = info.flags;
+          item.accessor = info.accessor;
+          item.checker = info.checker;
+          item.value = info.initialValue;
+          item.validated = false;
+          if (info.flags & TypeId::ATTR_CONSTRUCT)
             {
-              // Handle this attribute if it should not be
-              // set here.
-              if (value == 0)
+              // the environment variable overrides the initial value
+              std::map<std::string, std::string>::const_iterator env = envDefaults.find (tid.GetAttributeFullName (i));
+              if (env != envDefaults.end ())
                 {
-                  // Skip this attribute if it's not in the
-                  // AttributeConstructionList.
-                  continue;
+                  Ptr<const AttributeValue> envValue = Create<StringValue> (env->second);
+                  if (info.checker->CreateValidValue (*envValue) != 0)
+                    {
+                      NS_LOG_DEBUG ("default of \"" << env->first << "\" from env var");
+                      item.value = envValue;
+                    }
                 }
-              else
+              // validate the default value once for all, unless the
+              // validation creates an object, which must not be shared
+              if (info.checker->Check (*item.value))
                 {
-                  // This is an error because this attribute is not
-                  // settable in its constructor but is present in
-                  // the AttributeConstructionList.
-                  NS_FATAL_ERROR ("Attribute name=" << info.name << " tid=" << tid.GetName () << ": initial value cannot be set using attributes");
+                  item.validated = true;
+                }
+              else if (info.checker->GetValueTypeName () != "ns3::PointerValue")
+                {
+                  Ptr<const AttributeValue> v = info.checker->CreateValidValue (*item.value);
+                  if (v != 0)
+                    {
+                      item.value = v;
+                      item.validated = true;
+                    }
                 }
             }
+          plan->items.push_back (item);
+        }
+      tid = tid.GetParent ();
+    }
+  while (tid != ObjectBase::GetTypeId ());
+  plans[uid] = plan;
+  return plan;
+}
 
+void
+ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
+{
+  NS_LOG_FUNCTION (this << &attributes);
+  Ptr<const ConstructionPlan> plan = GetConstructionPlan (GetInstanceTypeId ());
+  bool hasAttributes = attributes.Begin () != attributes.End ();
+  for (const ConstructionPlanItem &item : plan->items)
+    {
+      // is this attribute stored in this AttributeConstructionList instance ?
+      Ptr<AttributeValue> value;
+      if (hasAttributes)
+        {
+          value = attributes.Find (item.checker);
+        }
+      // See if this attribute should not be set here in the
+      // constructor.
+      if (!(item.flags & TypeId::ATTR_CONSTRUCT))
+        {
           if (value != 0)
             {
-              // We have a matching attribute value.
-              if (DoSet (info.accessor, info.checker, *value))
-                {
-                  NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                                info.name << "\"");
-                  continue;
-                }
+              // This is an error because this attribute is not
+              // settable in its constructor but is present in
+              // the AttributeConstructionList.
+              NS_FATAL_ERROR ("Attribute name=" << item.tid.GetAttribute (item.index).name << " tid=" << item.tid.GetName () << ": initial value cannot be set using attributes");
             }
+          continue;
+        }
 
-          // No matching attribute value so we try to look at the env var.
-          const char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-          if (envVar != 0 && std::strlen (envVar) > 0)
+      if (value != 0)
+        {
+          // We have a matching attribute value.
+          if (DoSet (item.accessor, item.checker, *value))
             {
-              std::string env = envVar;
-              std::string::size_type cur = 0;
-              std::string::size_type next = 0;
-              while (next != std::string::npos)
-                {
-                  next = env.find (";", cur);
-                  std::string tmp = std::string (env, cur, next - cur);
-                  std::string::size_type equal = tmp.find ("=");
-                  if (equal != std::string::npos)
-                    {
-                      std::string name = tmp.substr (0, equal);
-                      std::string envval = tmp.substr (equal + 1, tmp.size () - equal - 1);
-                      if (name == tid.GetAttributeFullName (i))
-                        {
-                          if (DoSet (info.accessor, info.checker, StringValue (envval)))
-                            {
-                              NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                                            info.name << "\" from env var");
-                              break;
-                            }
-                        }
-                    }
-                  cur = next + 1;
-                }
+              NS_LOG_DEBUG ("construct \"" << item.tid.GetAttributeFullName (item.index) << "\"");
+              continue;
             }
+        }
 
-          // No matching attribute value so we try to set the default value.
-          DoSet (info.accessor, info.checker, *info.initialValue);
-          NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                        info.name << "\" from initial value.");
+      // No matching attribute value so we set the default value.
+      if (item.validated)
+        {
+          item.accessor->Set (this, *item.value);
+        }
+      else
+        {
+          DoSet (item.accessor, item.checker, *item.value);
         }
-      tid = tid.GetParent ();
     }
-  while (tid != ObjectBase::GetTypeId ());
   NotifyConstructionCompleted ();
 }
 
 bool
-ObjectBase::DoSet (Ptr<const AttributeAccessor> accessor,
-                   Ptr<const AttributeChecker> checker,
+ObjectBase::DoSet (const Ptr<const AttributeAccessor> &accessor,
+                   const Ptr<const AttributeChecker> &checker,
                    const AttributeValue &value)
 {
   NS_LOG_FUNCTION (this << accessor << checker << &value);
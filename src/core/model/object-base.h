@@ -261,6 +261,13 @@ protected:
    * you should make sure that you invoke this method from
    * your most-derived constructor.
    *
+   * The attributes of each TypeId and their default values, including
+   * the ones given by the NS_ATTRIBUTE_DEFAULT environment variable,
+   * are collected and validated once, and collected again only after
+   * an attribute is added or its initial value is changed (see
+   * TypeId::GetAttributeGeneration); only the values found in
+   * \pname{attributes} are then validated for each object.
+   *
    * \param [in] attributes The attribute values used to initialize
    *        the member variables of this object's instance.
    */
@@ -277,8 +284,8 @@ private:
    * \returns \c true if the \c value could be validated by the \pname{checker}
    *          and written to the storage location.
    */
-  bool DoSet (Ptr<const AttributeAccessor> spec,
-              Ptr<const AttributeChecker> checker,
+  bool DoSet (const Ptr<const AttributeAccessor> &spec,
+              const Ptr<const AttributeChecker> &checker,
               const AttributeValue &value);
 
 };
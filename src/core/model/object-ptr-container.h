@@ -228,6 +228,24 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Get the number of instances in the container.
+   *
+   * \param [in] object The container object.
+   * \param [out] n The number of instances in the container.
+   * \returns true if the value could be obtained successfully.
+   */
+  bool GetN (const ObjectBase *object, std::size_t *n) const;
+  /**
+   * Get a single instance from the container, without copying the others
+   * as Get (const ObjectBase *, AttributeValue &) does.
+   *
+   * \param [in] object The container object.
+   * \param [in] i The position of the instance, in [0, n[.
+   * \param [out] index The index of the instance.
+   * \returns The instance.
+   */
+  Ptr<Object> Get (const ObjectBase *object, std::size_t i, std::size_t *index) const;
 
 private:
   /**
@@ -97,17 +97,22 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates)))
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  m_aggregates->mask = 0;
+  m_aggregates->slots = 0;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object ()
 {
   // remove this object from the aggregate list
   NS_LOG_FUNCTION (this);
+  // the hash table would refer to this object: fall back to the
+  // lookup in the list for the remaining objects
+  std::free (m_aggregates->slots);
+  m_aggregates->slots = 0;
   uint32_t n = m_aggregates->n;
   for (uint32_t i = 0; i < n; i++)
     {
@@ -132,10 +137,11 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates)))
 {
   m_aggregates->n = 1;
+  m_aggregates->mask = 0;
+  m_aggregates->slots = 0;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -151,43 +157,96 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
-  uint32_t n = m_aggregates->n;
-  TypeId objectTid = Object::GetTypeId ();
-  for (uint32_t i = 0; i < n; i++)
+  const struct Aggregates *aggregates = m_aggregates;
+  if (aggregates->slots != 0)
     {
-      Object *current = m_aggregates->buffer[i];
-      TypeId cur = current->GetInstanceTypeId ();
-      while (cur != tid && cur != objectTid)
+      uint16_t uid = tid.GetUid ();
+      for (uint32_t i = uid & aggregates->mask; ; i = (i + 1) & aggregates->mask)
         {
-          cur = cur.GetParent ();
+          const struct Aggregates::AggregateSlot &slot = aggregates->slots[i];
+          if (slot.uid == uid)
+            {
+              return const_cast<Object *> (slot.object);
+            }
+          if (slot.uid == 0)
+            {
+              return 0;
+            }
         }
-      if (cur == tid)
+    }
+
+  // Single object, or aggregates being deleted: look for the first
+  // object whose type is tid or derives from tid, up to Object.
+  uint32_t n = aggregates->n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Object *current = aggregates->buffer[i];
+      TypeId cur = current->GetInstanceTypeId ();
+      if (cur == tid || (cur.IsChildOf (tid) && tid != ObjectBase::GetTypeId ()))
         {
-          // This is an attempt to 'cache' the result of this lookup.
-          // the idea is that if we perform a lookup for a TypeId on this object,
-          // we are likely to perform the same lookup later so, we make sure
-          // that the aggregate array is sorted by the number of accesses
-          // to each object.
-
-          // first, increment the access count
-          current->m_getObjectCount++;
-          // then, update the sort
-          UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
           return const_cast<Object *> (current);
         }
     }
   return 0;
 }
 void
+Object::IndexAggregates (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  TypeId objectTid = Object::GetTypeId ();
+  uint32_t n = aggregates->n;
+  uint32_t nTypes = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      TypeId cur = aggregates->buffer[i]->GetInstanceTypeId ();
+      for (nTypes++; cur != objectTid && cur != cur.GetParent (); cur = cur.GetParent ())
+        {
+          nTypes++;
+        }
+    }
+  // keep the load factor below 1/2
+  uint32_t size = 2;
+  while (size < 2 * nTypes)
+    {
+      size *= 2;
+    }
+  aggregates->mask = size - 1;
+  aggregates->slots = (struct Aggregates::AggregateSlot *) std::calloc (size, sizeof (struct Aggregates::AggregateSlot));
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Object *current = aggregates->buffer[i];
+      TypeId cur = current->GetInstanceTypeId ();
+      while (true)
+        {
+          uint16_t uid = cur.GetUid ();
+          uint32_t j = uid & aggregates->mask;
+          while (aggregates->slots[j].uid != 0 && aggregates->slots[j].uid != uid)
+            {
+              j = (j + 1) & aggregates->mask;
+            }
+          // the first aggregated instance of a TypeId is the one returned
+          if (aggregates->slots[j].uid == 0)
+            {
+              aggregates->slots[j].uid = uid;
+              aggregates->slots[j].object = current;
+            }
+          if (cur == objectTid || cur == cur.GetParent ())
+            {
+              break;
+            }
+          cur = cur.GetParent ();
+        }
+    }
+}
+void
 Object::Initialize (void)
 {
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoInitialize is called. The user's
-   * implementation of the DoInitialize method could call GetObject (which could
-   * reorder the array) and it could call AggregateObject which would add an
-   * object at the end of the array. To be safe, we restart iteration over the
+   * implementation of the DoInitialize method could call AggregateObject which
+   * would add an object at the end of the array. To be safe, we restart iteration over the
    * array whenever we call some user code, just in case.
    */
   NS_LOG_FUNCTION (this);
@@ -216,8 +275,8 @@ Object::Dispose (void)
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoDispose is called. The user's
-   * DoDispose implementation could call GetObject (which could reorder the array)
-   * and it could call AggregateObject which would add an object at the end of the array.
+   * DoDispose implementation could call AggregateObject which would add an object
+   * at the end of the array.
    * So, to be safe, we restart the iteration over the array whenever we call some
    * user code.
    */
@@ -236,19 +295,6 @@ restart:
     }
 }
 void
-Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
-{
-  NS_LOG_FUNCTION (this << aggregates << j);
-  while (j > 0
-         && aggregates->buffer[j]->m_getObjectCount > aggregates->buffer[j - 1]->m_getObjectCount)
-    {
-      Object *tmp = aggregates->buffer[j - 1];
-      aggregates->buffer[j - 1] = aggregates->buffer[j];
-      aggregates->buffer[j] = tmp;
-      j--;
-    }
-}
-void
 Object::AggregateObject (Ptr<Object> o)
 {
   NS_LOG_FUNCTION (this << o);
@@ -263,6 +309,8 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates =
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates) + (total - 1) * sizeof(Object*));
   aggregates->n = total;
+  aggregates->mask = 0;
+  aggregates->slots = 0;
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0],
@@ -281,8 +329,8 @@ Object::AggregateObject (Ptr<Object> o)
                           other->GetInstanceTypeId () <<
                           " on objects of type " << typeId);
         }
-      UpdateSortedArray (aggregates, m_aggregates->n + i);
     }
+  IndexAggregates (aggregates);
 
   // keep track of the old aggregate buffers for the iteration
   // of NotifyNewAggregates
@@ -314,7 +362,9 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
+  std::free (a->slots);
   std::free (a);
+  std::free (b->slots);
   std::free (b);
 }
 /**
@@ -341,11 +341,27 @@ private:
    * chunk of memory than the struct to allow space for a larger
    * variable sized buffer whose size is indicated by the element
    * \c n
+   *
+   * When several Objects are aggregated, the list also holds an
+   * open-addressing hash table which maps the uid of every TypeId
+   * implemented by the aggregated Objects to the first of them (in
+   * aggregation order) which is an instance of that TypeId, so that
+   * GetObject() takes constant time and does not modify the list.
    */
   struct Aggregates
   {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /** The number of entries in \c slots minus one. */
+    uint32_t mask;
+    /** The hash table indexed by TypeId uid, or 0 if not indexed. */
+    struct AggregateSlot
+    {
+      /** The TypeId uid, or 0 if the slot is empty. */
+      uint16_t uid;
+      /** The Object. */
+      Object *object;
+    } *slots;
     /** The array of Objects. */
     Object *buffer[1];
   };
@@ -398,12 +414,11 @@ private:
   void Construct (const AttributeConstructionList &attributes);
 
   /**
-   * Keep the list of aggregates in most-recently-used order
+   * Build the hash table of a list of aggregates.
    *
    * \param [in,out] aggregates The list of aggregated Objects.
-   * \param [in] i The most recently used entry in the list.
    */
-  void UpdateSortedArray (struct Aggregates *aggregates, uint32_t i) const;
+  static void IndexAggregates (struct Aggregates *aggregates);
   /**
    * Attempt to delete this Object.
    *
@@ -435,14 +450,6 @@ private:
    * so the size of the array is indirectly a reference count.
    */
   struct Aggregates * m_aggregates;
-  /**
-   * The number of times the Object was accessed with a
-   * call to GetObject().
-   *
-   * This integer is used to implement a heuristic to sort
-   * the array of aggregates in most-frequently accessed order.
-   */
-  uint32_t m_getObjectCount;
 };
 
 template <typename T>
@@ -37,6 +37,7 @@
 #include <cmath>
 #include <iostream>
 #include <algorithm>    // upper_bound
+#include <limits>
 
 /**
  * \file
@@ -74,7 +75,8 @@ RandomVariableStream::GetTypeId (void)
 }
 
 RandomVariableStream::RandomVariableStream ()
-  : m_rng (0)
+  : m_rng (0),
+    m_rngStream (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -112,6 +114,7 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
                              RngSeedManager::GetRun ());
+      m_rngStream = nextStream;
     }
   else
     {
@@ -122,9 +125,23 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
                              RngSeedManager::GetRun ());
+      m_rngStream = target;
     }
   m_stream = stream;
 }
+void
+RandomVariableStream::SetSubstream (Ptr<const RandomVariableStream> base, uint64_t substream)
+{
+  NS_LOG_FUNCTION (this << base << substream);
+  NS_ASSERT (base->m_rng != 0);
+  NS_ASSERT (substream < ((1ULL) << 51));
+  delete m_rng;
+  m_rng = new RngStream (RngSeedManager::GetSeed (),
+                         base->m_rngStream,
+                         substream);
+  m_rngStream = base->m_rngStream;
+  m_stream = base->m_stream;
+}
 int64_t
 RandomVariableStream::GetStream (void) const
 {
@@ -139,6 +156,73 @@ RandomVariableStream::Peek (void) const
   return m_rng;
 }
 
+void
+RandomVariableStream::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      values[i] = GetValue ();
+    }
+}
+
+namespace {
+
+/**
+ * \ingroup randomvariable
+ * Fill a buffer with the values of a distribution obtained by the
+ * transform of one uniform value, rejecting the values above a bound,
+ * as the successive calls to GetValue(void) do.
+ *
+ * \tparam Transform \deduced The type of the transform.
+ * \param [in] rng The stream of uniform values.
+ * \param [in] antithetic Whether the uniform values are antithetic.
+ * \param [in] bound The upper bound on the values, or 0 if none.
+ * \param [in] transform The transform of a uniform value.
+ * \param [out] values The buffer.
+ * \param [in] n The number of values.
+ */
+template <typename Transform>
+void
+GetBoundedValues (RngStream *rng, bool antithetic, double bound,
+                  Transform transform, double *values, std::size_t n)
+{
+  std::size_t filled = 0;
+  while (filled < n)
+    {
+      // Each value uses at least one uniform value, so that this never
+      // draws more uniform values than the calls to GetValue would.
+      double *block = values + filled;
+      std::size_t count = n - filled;
+      rng->RandU01 (block, count);
+      if (antithetic)
+        {
+          for (std::size_t i = 0; i < count; ++i)
+            {
+              block[i] = 1 - block[i];
+            }
+        }
+      for (std::size_t i = 0; i < count; ++i)
+        {
+          block[i] = transform (block[i]);
+        }
+      if (bound == 0)
+        {
+          return;
+        }
+      // Keep the accepted values, in order.
+      for (std::size_t i = 0; i < count; ++i)
+        {
+          if (block[i] <= bound)
+            {
+              values[filled++] = block[i];
+            }
+        }
+    }
+}
+
+} // unnamed namespace
+
 NS_OBJECT_ENSURE_REGISTERED (UniformRandomVariable);
 
 TypeId
@@ -209,6 +293,25 @@ UniformRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_min, m_max + 1);
 }
+void
+UniformRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  const double min = m_min;
+  const double max = m_max;
+  Peek ()->RandU01 (values, n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      values[i] = min + values[i] * (max - min);
+    }
+  if (IsAntithetic ())
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        {
+          values[i] = min + (max - values[i]);
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED (ConstantRandomVariable);
 
@@ -445,6 +548,15 @@ ExponentialRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_bound);
 }
+void
+ExponentialRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  const double mean = m_mean;
+  GetBoundedValues (Peek (), IsAntithetic (), m_bound,
+                    [mean] (double v) { return -mean*std::log (v); },
+                    values, n);
+}
 
 NS_OBJECT_ENSURE_REGISTERED (ParetoRandomVariable);
 
@@ -549,6 +661,16 @@ ParetoRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_scale, m_shape, m_bound);
 }
+void
+ParetoRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  const double scale = m_scale;
+  const double exponent = 1.0 / m_shape;
+  GetBoundedValues (Peek (), IsAntithetic (), m_bound,
+                    [scale, exponent] (double v) { return (scale * ( 1.0 / std::pow (v, exponent))); },
+                    values, n);
+}
 
 NS_OBJECT_ENSURE_REGISTERED (WeibullRandomVariable);
 
@@ -643,6 +765,16 @@ WeibullRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_scale, m_shape, m_bound);
 }
+void
+WeibullRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  const double scale = m_scale;
+  const double exponent = 1.0 / m_shape;
+  GetBoundedValues (Peek (), IsAntithetic (), m_bound,
+                    [scale, exponent] (double v) { return scale * std::pow ( -std::log (v), exponent); },
+                    values, n);
+}
 
 NS_OBJECT_ENSURE_REGISTERED (NormalRandomVariable);
 
@@ -763,6 +895,70 @@ NormalRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_variance, m_bound);
 }
+void
+NormalRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  std::size_t filled = 0;
+  if (n > 0 && m_nextValid)
+    { // use previously generated
+      m_nextValid = false;
+      values[filled++] = m_next;
+    }
+  const double mean = m_mean;
+  const double sigma = std::sqrt (m_variance);
+  const double bound = m_bound;
+  const std::size_t maxPairs = 128;
+  double u[2 * maxPairs];
+  while (filled < n)
+    {
+      // Each pair gives at most two values, so that this never draws
+      // more uniform values than the calls to GetValue would, and only
+      // the last pair can fill the buffer.
+      std::size_t pairs = std::min ((n - filled + 1) / 2, maxPairs);
+      Peek ()->RandU01 (u, 2 * pairs);
+      if (IsAntithetic ())
+        {
+          for (std::size_t i = 0; i < 2 * pairs; ++i)
+            {
+              u[i] = 1 - u[i];
+            }
+        }
+      for (std::size_t i = 0; i < pairs; ++i)
+        {
+          double v1 = 2 * u[2 * i] - 1;
+          double v2 = 2 * u[2 * i + 1] - 1;
+          double w = v1 * v1 + v2 * v2;
+          if (w <= 1.0)
+            {
+              double y = std::sqrt ((-2 * std::log (w)) / w);
+              double next = mean + v2 * y * sigma;
+              bool nextValid = std::fabs (next - mean) <= bound;
+              double x1 = mean + v1 * y * sigma;
+              if (std::fabs (x1 - mean) <= bound)
+                {
+                  values[filled++] = x1;
+                  if (nextValid)
+                    {
+                      if (filled < n)
+                        {
+                          values[filled++] = next;
+                        }
+                      else
+                        {
+                          m_next = next;
+                          m_nextValid = true;
+                        }
+                    }
+                }
+              else if (nextValid)
+                {
+                  values[filled++] = next;
+                }
+            }
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED (LogNormalRandomVariable);
 
@@ -1284,10 +1480,21 @@ ZipfRandomVariable::GetTypeId (void)
                    DoubleValue (0.0),
                    MakeDoubleAccessor (&ZipfRandomVariable::m_alpha),
                    MakeDoubleChecker<double>())
+    .AddAttribute ("RejectionInversion",
+                   "Draw the values in constant expected time with the rejection-inversion "
+                   "method, instead of a linear search over the probabilities.  The "
+                   "distribution is the same, but not the sequence of values.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ZipfRandomVariable::m_rejectionInversion),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 ZipfRandomVariable::ZipfRandomVariable ()
+  : m_cN (0),
+    m_cAlpha (std::numeric_limits<double>::quiet_NaN ()),
+    m_riN (0),
+    m_riAlpha (std::numeric_limits<double>::quiet_NaN ())
 {
   // m_n and m_alpha are initialized after constructor by attributes
   NS_LOG_FUNCTION (this);
@@ -1310,13 +1517,50 @@ double
 ZipfRandomVariable::GetValue (uint32_t n, double alpha)
 {
   NS_LOG_FUNCTION (this << n << alpha);
+  if (m_rejectionInversion)
+    {
+      NS_ASSERT_MSG (n >= 1, "The Zipf distribution needs at least one element");
+      UpdateRejectionInversion (n, alpha);
+      while (1)
+        {
+          double u = Peek ()->RandU01 ();
+          if (IsAntithetic ())
+            {
+              u = (1 - u);
+            }
+          // Invert the integral of the density h, which dominates the
+          // probabilities of the integers, and accept the nearest integer
+          // if it is under the probability.
+          u = m_hIntegralN + u * (m_hIntegralX1 - m_hIntegralN);
+          double x = HIntegralInverse (u);
+          double k = std::floor (x + 0.5);
+          if (k < 1)
+            {
+              k = 1;
+            }
+          else if (k > n)
+            {
+              k = n;
+            }
+          if (k - x <= m_s || u >= HIntegral (k + 0.5) - H (k))
+            {
+              return k;
+            }
+        }
+    }
+
   // Calculate the normalization constant c.
-  m_c = 0.0;
-  for (uint32_t i = 1; i <= n; i++)
+  if (n != m_cN || !(alpha == m_cAlpha))
     {
-      m_c += (1.0 / std::pow ((double)i,alpha));
+      m_c = 0.0;
+      for (uint32_t i = 1; i <= n; i++)
+        {
+          m_c += (1.0 / std::pow ((double)i,alpha));
+        }
+      m_c = 1.0 / m_c;
+      m_cN = n;
+      m_cAlpha = alpha;
     }
-  m_c = 1.0 / m_c;
 
   // Get a uniform random variable in [0,1].
   double u = Peek ()->RandU01 ();
@@ -1338,6 +1582,81 @@ ZipfRandomVariable::GetValue (uint32_t n, double alpha)
   return zipf_value;
 }
 
+void
+ZipfRandomVariable::UpdateRejectionInversion (uint32_t n, double alpha)
+{
+  if (n == m_riN && alpha == m_riAlpha)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << n << alpha);
+  NS_ASSERT_MSG (alpha >= 0, "The rejection-inversion method needs a non negative alpha");
+  m_riN = n;
+  m_riAlpha = alpha;
+  m_hIntegralX1 = HIntegral (1.5) - 1;
+  m_hIntegralN = HIntegral (n + 0.5);
+  m_s = 2 - HIntegralInverse (HIntegral (2.5) - H (2));
+}
+
+namespace {
+
+/**
+ * \ingroup randomvariable
+ * \param [in] x The argument.
+ * \return \f$\log(1 + x) / x\f$, accurate near 0.
+ */
+double
+Log1pOverX (double x)
+{
+  if (std::fabs (x) > 1e-8)
+    {
+      return std::log1p (x) / x;
+    }
+  return 1 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+/**
+ * \ingroup randomvariable
+ * \param [in] x The argument.
+ * \return \f$(e^x - 1) / x\f$, accurate near 0.
+ */
+double
+Expm1OverX (double x)
+{
+  if (std::fabs (x) > 1e-8)
+    {
+      return std::expm1 (x) / x;
+    }
+  return 1 + x * 0.5 * (1 + x * 1.0 / 3.0 * (1 + 0.25 * x));
+}
+
+} // unnamed namespace
+
+double
+ZipfRandomVariable::H (double x) const
+{
+  return std::exp (-m_riAlpha * std::log (x));
+}
+
+double
+ZipfRandomVariable::HIntegral (double x) const
+{
+  double logX = std::log (x);
+  return Expm1OverX ((1 - m_riAlpha) * logX) * logX;
+}
+
+double
+ZipfRandomVariable::HIntegralInverse (double x) const
+{
+  double t = x * (1 - m_riAlpha);
+  if (t < -1)
+    {
+      // limit the argument to the domain of log1p, against rounding errors
+      t = -1;
+    }
+  return std::exp (Log1pOverX (t) * x);
+}
+
 uint32_t
 ZipfRandomVariable::GetInteger (uint32_t n, uint32_t alpha)
 {
@@ -1553,6 +1872,13 @@ EmpiricalRandomVariable::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&EmpiricalRandomVariable::m_interpolate),
                    MakeBooleanChecker ())
+    .AddAttribute ("Alias",
+                   "Sample the CDF in constant time with an alias table, "
+                   "instead of a binary search.  The distribution is the same, "
+                   "but not the sequence of values.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&EmpiricalRandomVariable::m_alias),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -1616,6 +1942,11 @@ EmpiricalRandomVariable::GetValue (void)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_alias)
+    {
+      return DoSampleAlias (m_interpolate);
+    }
+
   double value;
   if (PreSample (value))
     {
@@ -1650,6 +1981,11 @@ EmpiricalRandomVariable::Interpolate (void)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_alias)
+    {
+      return DoSampleAlias (true);
+    }
+
   double value;
   if (PreSample (value))
     {
@@ -1695,6 +2031,103 @@ EmpiricalRandomVariable::CDF (double v, double c)
   // NOTE.   These MUST be inserted in non-decreasing order
   NS_LOG_FUNCTION (this << v << c);
   m_emp.push_back (ValueCDF (v, c));
+  m_validated = false;
+  m_aliasProbability.clear ();
+}
+
+void
+EmpiricalRandomVariable::BuildAliasTable (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Vose's algorithm: fill each bin holding less than the mean
+  // probability with the excess of a bin holding more.
+  uint32_t k = m_emp.size ();
+  std::vector<double> scaled (k);
+  double prior = 0;
+  for (uint32_t i = 0; i < k; ++i)
+    {
+      scaled[i] = (m_emp[i].cdf - prior) * k;
+      prior = m_emp[i].cdf;
+    }
+  m_aliasProbability.assign (k, 1.0);
+  m_aliasBin.resize (k);
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+  for (uint32_t i = 0; i < k; ++i)
+    {
+      m_aliasBin[i] = i;
+      if (scaled[i] < 1.0)
+        {
+          small.push_back (i);
+        }
+      else
+        {
+          large.push_back (i);
+        }
+    }
+  while (!small.empty () && !large.empty ())
+    {
+      uint32_t less = small.back ();
+      small.pop_back ();
+      uint32_t more = large.back ();
+      m_aliasProbability[less] = scaled[less];
+      m_aliasBin[less] = more;
+      scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+      if (scaled[more] < 1.0)
+        {
+          large.pop_back ();
+          small.push_back (more);
+        }
+    }
+  // The remaining bins, in either list, only differ from the mean
+  // probability by rounding errors, and keep their probability of 1.
+}
+
+double
+EmpiricalRandomVariable::DoSampleAlias (bool interpolate)
+{
+  NS_LOG_FUNCTION (this << interpolate);
+  if (!m_validated)
+    {
+      Validate ();
+    }
+  if (m_aliasProbability.empty ())
+    {
+      BuildAliasTable ();
+    }
+
+  double r = Peek ()->RandU01 ();
+  if (IsAntithetic ())
+    {
+      r = (1 - r);
+    }
+
+  // The integer part of r * k selects a bin, the fractional part
+  // whether to keep it or to take its alias, and then the position
+  // within the selected bin.
+  std::size_t k = m_aliasProbability.size ();
+  double x = r * k;
+  std::size_t bin = std::min (static_cast<std::size_t> (x), k - 1);
+  double f = x - bin;
+  double p = m_aliasProbability[bin];
+  double fraction;
+  if (f < p)
+    {
+      fraction = f / p;
+    }
+  else
+    {
+      fraction = (f - p) / (1 - p);
+      bin = m_aliasBin[bin];
+    }
+
+  if (!interpolate || bin == 0)
+    {
+      return m_emp[bin].value;
+    }
+  double v1 = m_emp[bin - 1].value;
+  double v2 = m_emp[bin].value;
+  return v1 + (v2 - v1) * fraction;
 }
 
 void
@@ -29,6 +29,7 @@
 #include "type-id.h"
 #include "object.h"
 #include "attribute-helper.h"
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -125,6 +126,22 @@ public:
    */
   int64_t GetStream (void) const;
 
+  /**
+   * \brief Restart the generator at the beginning of a substream of the
+   * stream of another random variable.
+   *
+   * SetStream() uses the substream given by the run number.  Models that
+   * need independent and reproducible sequences for many entities, e.g.,
+   * one for each link, can derive them from a single stream by giving
+   * each entity its own substream.  There are 2^51 substreams of 2^76
+   * values in each stream; the caller is responsible for choosing
+   * substreams that do not overlap with the ones used by other runs.
+   *
+   * \param [in] base The random variable whose stream is used.
+   * \param [in] substream The substream index, smaller than 2^51.
+   */
+  void SetSubstream (Ptr<const RandomVariableStream> base, uint64_t substream);
+
   /**
    * \brief Specify whether antithetic values should be generated.
    * \param [in] isAntithetic If \c true antithetic value will be generated.
@@ -149,6 +166,20 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Get the next values drawn from the distribution.
+   *
+   * The values, and the state of the stream afterwards, are the same as
+   * those of \pname{n} successive calls to GetValue(void).  The default
+   * implementation calls GetValue(void); the continuous distributions
+   * with a closed form draw their uniform values in one block and apply
+   * the transform to the whole buffer.
+   *
+   * \param [out] values The buffer of at least \pname{n} values.
+   * \param [in] n The number of values.
+   */
+  virtual void GetValues (double *values, std::size_t n);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -187,6 +218,9 @@ private:
   /** The stream number for the RngStream. */
   int64_t m_stream;
 
+  /** The index of the stream of the RngStream, including automatic ones. */
+  uint64_t m_rngStream;
+
 };  // class RandomVariableStream
 
 
@@ -294,6 +328,7 @@ public:
    * \note The upper limit is included in the output range.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The lower bound on values that can be returned by this RNG stream. */
@@ -586,6 +621,7 @@ public:
   // Inherited from RandomVariableStream
   virtual double GetValue (void);
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The mean value of the unbounded exponential distribution. */
@@ -784,6 +820,7 @@ public:
    * which now involves the distance \f$u\f$ is from 1 in the denominator.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The mean parameter for the Pareto distribution returned by this RNG stream. */
@@ -993,6 +1030,7 @@ public:
    * which now involves the log of the distance \f$u\f$ is from 1.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The scale parameter for the Weibull distribution returned by this RNG stream. */
@@ -1226,6 +1264,7 @@ public:
    * which now involves the distances \f$u1\f$ and \f$u2\f$ are from 1.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The mean value for the normal distribution returned by this RNG stream. */
@@ -2089,6 +2128,14 @@ private:
  *   //
  *   double value = x->GetValue ();
  * \endcode
+ *
+ * By default each value is drawn by inversion, with a linear search
+ * over the \f$N\f$ probabilities.  With the \c RejectionInversion
+ * attribute, values are drawn in constant expected time with the
+ * rejection-inversion method of W. Hormann and G. Derflinger, "Rejection-
+ * inversion to generate variates from monotone discrete distributions",
+ * ACM TOMACS 6(3), 1996.  The distribution is the same, but the values
+ * drawn from a given stream are not.
  */
 class ZipfRandomVariable : public RandomVariableStream
 {
@@ -2179,6 +2226,33 @@ public:
   virtual uint32_t GetInteger (void);
 
 private:
+  /**
+   * \brief Compute the constants of the rejection-inversion method for
+   * the given parameters, if they are not already computed.
+   * \param [in] n N value for the Zipf distribution.
+   * \param [in] alpha Alpha value for the Zipf distribution.
+   */
+  void UpdateRejectionInversion (uint32_t n, double alpha);
+  /**
+   * \brief The unnormalized probability density \f$h(x) = x^{-\alpha}\f$.
+   * \param [in] x The argument.
+   * \return \f$h(x)\f$.
+   */
+  double H (double x) const;
+  /**
+   * \brief The integral of \f$h\f$, \f$H(x) = (x^{1 - \alpha} - 1) / (1 - \alpha)\f$,
+   * or \f$\log x\f$ for \f$\alpha = 1\f$.
+   * \param [in] x The argument.
+   * \return \f$H(x)\f$.
+   */
+  double HIntegral (double x) const;
+  /**
+   * \brief The inverse of HIntegral().
+   * \param [in] x The argument.
+   * \return \f$H^{-1}(x)\f$.
+   */
+  double HIntegralInverse (double x) const;
+
   /** The n value for the Zipf distribution returned by this RNG stream. */
   uint32_t m_n;
 
@@ -2187,6 +2261,23 @@ private:
 
   /** The normalization constant. */
   double m_c;
+  /** The n value of the normalization constant. */
+  uint32_t m_cN;
+  /** The alpha value of the normalization constant, NaN if not computed. */
+  double m_cAlpha;
+
+  /** Whether to use the rejection-inversion method. */
+  bool m_rejectionInversion;
+  /** The n value of the rejection-inversion constants. */
+  uint32_t m_riN;
+  /** The alpha value of the rejection-inversion constants, NaN if not computed. */
+  double m_riAlpha;
+  /** \f$H(1.5) - 1\f$. */
+  double m_hIntegralX1;
+  /** \f$H(n + 0.5)\f$. */
+  double m_hIntegralN;
+  /** The squeeze threshold of the rejection test. */
+  double m_s;
 
 };  // class ZipfRandomVariable
 
@@ -2475,6 +2566,13 @@ private:
  *
  * This will return continuous values on the range [0,1).
  *
+ * The uniform value is looked up by a binary search over the CDF.
+ * Distributions with many points can instead be sampled in constant time
+ * with an alias table (Walker's method, built with Vose's algorithm),
+ * enabled by the \c Alias attribute.  The table is built on the first
+ * draw after the CDF is modified.  The distribution is the same, in both
+ * modes, but the values drawn from a given stream are not.
+ *
  * See empirical-random-variable-example.cc for an example.
  */
 class EmpiricalRandomVariable : public RandomVariableStream
@@ -2608,6 +2706,19 @@ private:
    * \returns The interpolated CDF at \pname{r}
    */
   double DoInterpolate (double r);
+  /**
+   * \brief Build the alias table of the bins of the CDF.
+   *
+   * The first bin holds the probability of the first point, bin \c i
+   * the probability between points \c i - 1 and \c i.
+   */
+  void BuildAliasTable (void);
+  /**
+   * \brief Draw a value with the alias table.
+   * \param [in] interpolate Whether to interpolate within the bin.
+   * \return The value.
+   */
+  double DoSampleAlias (bool interpolate);
 
   /**
    * \brief Comparison operator, for use by std::upper_bound
@@ -2627,6 +2738,12 @@ private:
    * otherwise treat CDF as normal histogram.
    */
   bool m_interpolate;
+  /** If \c true, sample with the alias table. */
+  bool m_alias;
+  /** The probability of each bin of the alias table to be kept. */
+  std::vector<double> m_aliasProbability;
+  /** The bin drawn instead of each bin when it is not kept. */
+  std::vector<uint32_t> m_aliasBin;
 
 };  // class EmpiricalRandomVariable
 
@@ -20,6 +20,7 @@
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
 #include <string>
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -70,6 +71,16 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Generate the next \pname{n} random numbers of this stream.
+   *
+   * The values are those of \pname{n} successive calls to RandU01(void);
+   * the state of the generator is kept in registers between them.
+   *
+   * \param [out] values The buffer of at least \pname{n} values.
+   * \param [in] n The number of values.
+   */
+  void RandU01 (double *values, std::size_t n);
 
 private:
   /**
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator-checkpoint.h"
+#include "simulator.h"
+#include "simulator-impl.h"
+#include "log.h"
+#include "fatal-error.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorCheckpoint implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SimulatorCheckpoint");
+
+namespace {
+
+/** The branch of the process. */
+uint32_t g_branch = 0;
+/** The number of branches of the process which failed. */
+uint32_t g_failedBranches = 0;
+
+/** Flush the output streams, so that the branches do not repeat them. */
+void
+FlushOutput (void)
+{
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+}
+
+/**
+ * \returns The number of threads of the process, or 0 if unknown.
+ */
+uint32_t
+GetThreadCount (void)
+{
+  DIR *dir = opendir ("/proc/self/task");
+  if (dir == 0)
+    {
+      return 0;
+    }
+  uint32_t n = 0;
+  struct dirent *entry;
+  while ((entry = readdir (dir)) != 0)
+    {
+      if (entry->d_name[0] != '.')
+        {
+          ++n;
+        }
+    }
+  closedir (dir);
+  return n;
+}
+
+/**
+ * Wait for a branch to end.
+ * \returns Whether the branch exited with a zero status.
+ */
+bool
+WaitBranch (void)
+{
+  int status;
+  pid_t pid;
+  do
+    {
+      pid = waitpid (-1, &status, 0);
+    }
+  while (pid == -1 && errno == EINTR);
+  NS_ABORT_MSG_IF (pid == -1, "SimulatorCheckpoint: waitpid failed: " << std::strerror (errno));
+  if (WIFEXITED (status) && WEXITSTATUS (status) == 0)
+    {
+      return true;
+    }
+  NS_LOG_WARN ("Branch process " << pid << " failed with status " << status);
+  return false;
+}
+
+} // unnamed namespace
+
+uint32_t
+SimulatorCheckpoint::Fork (uint32_t nBranches, uint32_t maxConcurrent)
+{
+  NS_LOG_FUNCTION (nBranches << maxConcurrent);
+  NS_ABORT_MSG_IF (nBranches == 0, "SimulatorCheckpoint: no branch");
+  NS_ABORT_MSG_IF (maxConcurrent == 0, "SimulatorCheckpoint: no concurrent branch");
+
+  std::string impl = Simulator::GetImplementation ()->GetInstanceTypeId ().GetName ();
+  NS_ABORT_MSG_IF (impl != "ns3::DefaultSimulatorImpl",
+                   "SimulatorCheckpoint: unsupported simulator implementation " << impl);
+  uint32_t nThreads = GetThreadCount ();
+  NS_ABORT_MSG_IF (nThreads > 1,
+                   "SimulatorCheckpoint: the process has " << nThreads << " threads");
+
+  FlushOutput ();
+  uint32_t running = 0;
+  for (uint32_t branch = 1; branch < nBranches; ++branch)
+    {
+      if (running == maxConcurrent)
+        {
+          if (!WaitBranch ())
+            {
+              ++g_failedBranches;
+            }
+          --running;
+        }
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid == -1, "SimulatorCheckpoint: fork failed: " << std::strerror (errno));
+      if (pid == 0)
+        {
+          g_branch = branch;
+          g_failedBranches = 0;
+          NS_LOG_LOGIC ("Branch " << branch << " at " << Simulator::Now ().As (Time::S));
+          return branch;
+        }
+      ++running;
+    }
+  while (running > 0)
+    {
+      if (!WaitBranch ())
+        {
+          ++g_failedBranches;
+        }
+      --running;
+    }
+  g_branch = 0;
+  NS_LOG_LOGIC ("Branch 0 at " << Simulator::Now ().As (Time::S)
+                << ", " << g_failedBranches << " failed branches");
+  return 0;
+}
+
+uint32_t
+SimulatorCheckpoint::GetBranch (void)
+{
+  return g_branch;
+}
+
+uint32_t
+SimulatorCheckpoint::GetFailedBranches (void)
+{
+  return g_failedBranches;
+}
+
+void
+SimulatorCheckpoint::EndBranch (int status)
+{
+  NS_LOG_FUNCTION (status);
+  FlushOutput ();
+  std::_Exit (status);
+}
+
+} // namespace ns3
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATOR_CHECKPOINT_H
+#define SIMULATOR_CHECKPOINT_H
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorCheckpoint declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Fork a running simulation into branches which continue from
+ * the same state, to share a warm-up period between the runs of an
+ * experiment.
+ *
+ * Fork() creates the branches as child processes of the calling
+ * process, which is the checkpoint: each branch starts with a copy of
+ * the complete state of the simulation at the time of the call, the
+ * event list, the states of the random number streams, the attributes
+ * and the state of all the objects, and the packets in flight included.
+ * Fork() returns the index of the branch in each process, which applies
+ * the parameters under test of its branch and continues the simulation:
+ *
+ * \code
+ *   void
+ *   EndOfWarmUp (void)
+ *   {
+ *     uint32_t branch = SimulatorCheckpoint::Fork (rates.size (), 4);
+ *     Config::Set ("/NodeList/0/ApplicationList/0/DataRate", DataRateValue (rates[branch]));
+ *     OpenOutputFiles (branch);
+ *   }
+ *   ...
+ *   Simulator::Schedule (Seconds (30), &EndOfWarmUp);
+ *   Simulator::Run ();
+ * \endcode
+ *
+ * The checkpoint process waits for its branches 1 to \c n-1, then
+ * continues as the branch 0.  A branch ends with its process, when
+ * the program returns from \c main or calls EndBranch(); it can fork
+ * branches of its own.
+ *
+ * The state of the simulation is copied by the operating system, so
+ * that all the models are supported with the DefaultSimulatorImpl: a
+ * branch which applies the parameters of the run which was not forked
+ * gives the same results.  The simulation must not use threads, nor
+ * resources outside of the process: the real time and distributed
+ * simulator implementations, the emulation and tap devices and the
+ * visualizer are not supported.  The output streams are flushed before
+ * the fork, but the files opened before it are shared by the branches,
+ * which should write to their own files.
+ *
+ * The checkpoints are not saved to files: the events are arbitrary
+ * functions bound to their arguments, which cannot be serialized.
+ */
+class SimulatorCheckpoint
+{
+public:
+  /**
+   * Fork the simulation into branches.
+   *
+   * \param [in] nBranches The number of branches, including the branch 0
+   *             of the calling process.
+   * \param [in] maxConcurrent The maximum number of branches which run
+   *             at the same time, the checkpoint process waiting while
+   *             they run.
+   * \returns The index of the branch of the calling process, from 0 to
+   *          \c nBranches - 1.
+   */
+  static uint32_t Fork (uint32_t nBranches, uint32_t maxConcurrent = 1);
+  /**
+   * \returns The index of the branch of the calling process, as returned
+   *          by its last call to Fork(), or 0.
+   */
+  static uint32_t GetBranch (void);
+  /**
+   * \returns The number of branches of the calling process which did not
+   *          exit with a zero status.
+   */
+  static uint32_t GetFailedBranches (void);
+  /**
+   * End a branch, without returning to the code which called the
+   * simulation.
+   *
+   * The output streams are flushed, and the process exits without
+   * destroying its static objects.
+   *
+   * \param [in] status The exit status of the branch.
+   */
+  static void EndBranch (int status);
+};
+
+} // namespace ns3
+
+#endif /* SIMULATOR_CHECKPOINT_H */
@@ -19,6 +19,7 @@
 
 #include "simulator-impl.h"
 #include "log.h"
+#include "string.h"
 
 /**
  * \file
@@ -38,8 +39,56 @@ SimulatorImpl::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::SimulatorImpl")
     .SetParent<Object> ()
     .SetGroupName ("Core")
+    .AddAttribute ("ProfileFile",
+                   "The file the execution profile of the simulator is written "
+                   "to as JSON, the rank being appended to the name in a "
+                   "distributed simulation, or an empty string not to write it.",
+                   StringValue (""),
+                   MakeStringAccessor (&SimulatorImpl::SetProfileFile,
+                                       &SimulatorImpl::GetProfileFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ProfileInterval",
+                   "The interval of simulation time between the samples of "
+                   "the profile written to the file, or zero to write the "
+                   "summary of the runs only.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&SimulatorImpl::SetProfileInterval,
+                                     &SimulatorImpl::GetProfileInterval),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
 
+SimulatorProfiler &
+SimulatorImpl::GetProfiler (void)
+{
+  return m_profiler;
+}
+
+void
+SimulatorImpl::SetProfileFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_profiler.SetFile (filename);
+}
+
+std::string
+SimulatorImpl::GetProfileFile (void) const
+{
+  return m_profiler.GetFile ();
+}
+
+void
+SimulatorImpl::SetProfileInterval (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  m_profiler.SetInterval (interval);
+}
+
+Time
+SimulatorImpl::GetProfileInterval (void) const
+{
+  return m_profiler.GetInterval ();
+}
+
 } // namespace ns3
@@ -27,6 +27,7 @@
 #include "object.h"
 #include "object-factory.h"
 #include "ptr.h"
+#include "simulator-profiler.h"
 
 /**
  * \file
@@ -102,6 +103,39 @@ public:
   /** \copydoc Simulator::GetEventCount */
   virtual uint64_t GetEventCount (void) const = 0;
 
+  /**
+   * Get the execution profile of the simulator.
+   *
+   * \returns The profiler, notified by the implementations of their
+   *          events, synchronizations and messages.
+   */
+  SimulatorProfiler &GetProfiler (void);
+
+protected:
+  /** The execution profile of the simulator. */
+  SimulatorProfiler m_profiler;
+
+private:
+  /**
+   * Set the file the profile is written to.
+   * \param [in] filename The name of the file, or an empty string.
+   */
+  void SetProfileFile (std::string filename);
+  /**
+   * Get the file the profile is written to.
+   * \returns The name of the file.
+   */
+  std::string GetProfileFile (void) const;
+  /**
+   * Set the interval between the samples of the profile.
+   * \param [in] interval The interval of simulation time.
+   */
+  void SetProfileInterval (Time interval);
+  /**
+   * Get the interval between the samples of the profile.
+   * \returns The interval of simulation time.
+   */
+  Time GetProfileInterval (void) const;
 };
 
 } // namespace ns3
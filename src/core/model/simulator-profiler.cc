@@ -0,0 +1,360 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator-profiler.h"
+#include "log.h"
+#include "fatal-error.h"
+
+#include <chrono>
+#include <limits>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SimulatorProfiler");
+
+namespace {
+
+/**
+ * \ingroup simulator
+ * \returns The wall-clock time, in ns.
+ */
+int64_t
+GetWallClock (void)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>
+           (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+} // unnamed namespace
+
+SimulatorProfiler::Neighbor::Neighbor ()
+  : messagesSent (0),
+    nullMessagesSent (0),
+    packetsSent (0),
+    bytesSent (0),
+    messagesReceived (0),
+    nullMessagesReceived (0),
+    packetsReceived (0),
+    bytesReceived (0)
+{
+}
+
+SimulatorProfiler::SimulatorProfiler ()
+  : m_interval (Seconds (0)),
+    m_nextSample (std::numeric_limits<uint64_t>::max ()),
+    m_rank (0),
+    m_running (false),
+    m_startWallTime (0),
+    m_runTime (0),
+    m_eventCount (0),
+    m_sampleWallTime (0),
+    m_sampleEventCount (0),
+    m_blockingStart (-1),
+    m_blockingTime (0),
+    m_windowCount (0),
+    m_windowSum (Seconds (0)),
+    m_minWindow (Seconds (0)),
+    m_maxWindow (Seconds (0))
+{
+}
+
+SimulatorProfiler::~SimulatorProfiler ()
+{
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+}
+
+void
+SimulatorProfiler::SetFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT_MSG (!m_file.is_open (), "The profile file is already open");
+  m_filename = filename;
+}
+
+std::string
+SimulatorProfiler::GetFile (void) const
+{
+  return m_filename;
+}
+
+void
+SimulatorProfiler::SetInterval (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  m_interval = interval;
+}
+
+Time
+SimulatorProfiler::GetInterval (void) const
+{
+  return m_interval;
+}
+
+void
+SimulatorProfiler::Start (uint32_t rank, uint32_t nRanks, const Time &now)
+{
+  NS_LOG_FUNCTION (this << rank << nRanks << now);
+  m_rank = rank;
+  m_running = true;
+  m_startWallTime = GetWallClock ();
+  m_sampleWallTime = GetRunTime ();
+  m_sampleEventCount = m_eventCount;
+
+  if (m_filename.empty ())
+    {
+      return;
+    }
+  if (!m_file.is_open ())
+    {
+      std::string filename = m_filename;
+      if (nRanks > 1)
+        {
+          std::ostringstream oss;
+          oss << "-" << rank;
+          std::string::size_type dot = filename.rfind ('.');
+          std::string::size_type slash = filename.rfind ('/');
+          if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            {
+              dot = filename.size ();
+            }
+          filename.insert (dot, oss.str ());
+        }
+      m_file.open (filename.c_str ());
+      if (!m_file.is_open ())
+        {
+          NS_FATAL_ERROR ("Could not open the profile file " << filename);
+        }
+    }
+  if (m_interval.IsStrictlyPositive ())
+    {
+      m_nextSample = (now + m_interval).GetTimeStep ();
+    }
+}
+
+void
+SimulatorProfiler::Stop (const Time &now, uint64_t eventCount)
+{
+  NS_LOG_FUNCTION (this << now << eventCount);
+  if (!m_running)
+    {
+      return;
+    }
+  m_eventCount = eventCount;
+  m_runTime += GetWallClock () - m_startWallTime;
+  m_running = false;
+  m_nextSample = std::numeric_limits<uint64_t>::max ();
+
+  NS_LOG_INFO ("Rank " << m_rank << ": " << m_eventCount << " events in "
+               << GetRunTime () << " s, " << GetEventRate () << " events/s, "
+               << GetBlockingTime () << " s blocked, " << m_windowCount << " windows");
+  if (m_file.is_open ())
+    {
+      PrintSummary (m_file, now);
+      m_file << std::endl;
+    }
+}
+
+void
+SimulatorProfiler::Sample (const Time &now, uint64_t eventCount)
+{
+  NS_LOG_FUNCTION (this << now << eventCount);
+  m_eventCount = eventCount;
+  double elapsed = GetRunTime ();
+  double wallInterval = elapsed - m_sampleWallTime;
+  double rate = wallInterval > 0 ? (m_eventCount - m_sampleEventCount) / wallInterval : 0;
+  m_sampleWallTime = elapsed;
+  m_sampleEventCount = m_eventCount;
+
+  PrintCounters (m_file, "sample", now);
+  m_file << ",\"intervalEventRate\":" << rate << "}" << std::endl;
+
+  // Skip the intervals without events
+  uint64_t step = m_interval.GetTimeStep ();
+  m_nextSample += step * ((now.GetTimeStep () - m_nextSample) / step + 1);
+}
+
+void
+SimulatorProfiler::BeginBlocking (void)
+{
+  if (m_blockingStart < 0)
+    {
+      m_blockingStart = GetWallClock ();
+    }
+}
+
+void
+SimulatorProfiler::EndBlocking (void)
+{
+  if (m_blockingStart >= 0)
+    {
+      m_blockingTime += GetWallClock () - m_blockingStart;
+      m_blockingStart = -1;
+    }
+}
+
+void
+SimulatorProfiler::NotifyWindow (const Time &start, const Time &end)
+{
+  Time window = end - start;
+  if (m_windowCount == 0 || window < m_minWindow)
+    {
+      m_minWindow = window;
+    }
+  if (m_windowCount == 0 || window > m_maxWindow)
+    {
+      m_maxWindow = window;
+    }
+  m_windowSum += window;
+  ++m_windowCount;
+}
+
+void
+SimulatorProfiler::NotifyMessageSent (uint32_t rank, uint64_t bytes, uint32_t packets)
+{
+  Neighbor &neighbor = m_neighbors[rank];
+  ++neighbor.messagesSent;
+  if (packets == 0)
+    {
+      ++neighbor.nullMessagesSent;
+    }
+  neighbor.packetsSent += packets;
+  neighbor.bytesSent += bytes;
+}
+
+void
+SimulatorProfiler::NotifyMessageReceived (uint32_t rank, uint64_t bytes, uint32_t packets)
+{
+  Neighbor &neighbor = m_neighbors[rank];
+  ++neighbor.messagesReceived;
+  if (packets == 0)
+    {
+      ++neighbor.nullMessagesReceived;
+    }
+  neighbor.packetsReceived += packets;
+  neighbor.bytesReceived += bytes;
+}
+
+uint64_t
+SimulatorProfiler::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
+double
+SimulatorProfiler::GetEventRate (void) const
+{
+  double runTime = GetRunTime ();
+  return runTime > 0 ? m_eventCount / runTime : 0;
+}
+
+double
+SimulatorProfiler::GetBlockingTime (void) const
+{
+  return m_blockingTime * 1e-9;
+}
+
+uint64_t
+SimulatorProfiler::GetWindowCount (void) const
+{
+  return m_windowCount;
+}
+
+Time
+SimulatorProfiler::GetMinWindow (void) const
+{
+  return m_minWindow;
+}
+
+Time
+SimulatorProfiler::GetMeanWindow (void) const
+{
+  return m_windowCount == 0 ? Seconds (0) : m_windowSum / m_windowCount;
+}
+
+Time
+SimulatorProfiler::GetMaxWindow (void) const
+{
+  return m_maxWindow;
+}
+
+const std::map<uint32_t, SimulatorProfiler::Neighbor> &
+SimulatorProfiler::GetNeighbors (void) const
+{
+  return m_neighbors;
+}
+
+void
+SimulatorProfiler::PrintSummary (std::ostream &os, const Time &now) const
+{
+  double runTime = GetRunTime ();
+  PrintCounters (os, "summary", now);
+  os << ",\"blockingRatio\":" << (runTime > 0 ? GetBlockingTime () / runTime : 0) << "}";
+}
+
+void
+SimulatorProfiler::PrintCounters (std::ostream &os, const char *type, const Time &now) const
+{
+  os << "{\"type\":\"" << type << "\""
+     << ",\"rank\":" << m_rank
+     << ",\"time\":" << now.GetSeconds ()
+     << ",\"wallTime\":" << GetRunTime ()
+     << ",\"events\":" << m_eventCount
+     << ",\"eventRate\":" << GetEventRate ()
+     << ",\"blockingTime\":" << GetBlockingTime ()
+     << ",\"windows\":{\"count\":" << m_windowCount
+     << ",\"min\":" << m_minWindow.GetSeconds ()
+     << ",\"mean\":" << GetMeanWindow ().GetSeconds ()
+     << ",\"max\":" << m_maxWindow.GetSeconds () << "}"
+     << ",\"neighbors\":[";
+  for (std::map<uint32_t, Neighbor>::const_iterator i = m_neighbors.begin (); i != m_neighbors.end (); ++i)
+    {
+      const Neighbor &neighbor = i->second;
+      os << (i == m_neighbors.begin () ? "" : ",")
+         << "{\"rank\":" << i->first
+         << ",\"messagesSent\":" << neighbor.messagesSent
+         << ",\"nullMessagesSent\":" << neighbor.nullMessagesSent
+         << ",\"packetsSent\":" << neighbor.packetsSent
+         << ",\"bytesSent\":" << neighbor.bytesSent
+         << ",\"messagesReceived\":" << neighbor.messagesReceived
+         << ",\"nullMessagesReceived\":" << neighbor.nullMessagesReceived
+         << ",\"packetsReceived\":" << neighbor.packetsReceived
+         << ",\"bytesReceived\":" << neighbor.bytesReceived << "}";
+    }
+  os << "]";
+}
+
+double
+SimulatorProfiler::GetRunTime (void) const
+{
+  int64_t runTime = m_runTime;
+  if (m_running)
+    {
+      runTime += GetWallClock () - m_startWallTime;
+    }
+  return runTime * 1e-9;
+}
+
+} // namespace ns3
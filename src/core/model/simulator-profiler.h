@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATOR_PROFILER_H
+#define SIMULATOR_PROFILER_H
+
+#include "nstime.h"
+
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorProfiler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief The execution profile of a simulator implementation, for a
+ * rank of a distributed simulation or for a sequential simulation.
+ *
+ * The simulator implementations notify the profiler of the events they
+ * process, of the time they spend blocked waiting for the other ranks,
+ * of the windows of simulation time granted by their synchronizations,
+ * and of the messages exchanged with each neighbor rank.  The counters
+ * are always recorded, at the cost of a comparison per event and of a
+ * reading of the wall clock per synchronization.
+ *
+ * When a file is set, with the \c ProfileFile attribute of the
+ * SimulatorImpl, the profile is written to it as JSON, one object per
+ * line: a \c "sample" object every \c ProfileInterval of simulation
+ * time, if the interval is not zero, with the counters since the start
+ * of the run and the event rate during the interval, then a
+ * \c "summary" object at the end of each run.  In a distributed
+ * simulation, each rank writes its own file, the rank being inserted
+ * before the extension of the name, e.g. \c profile-1.json for the
+ * rank 1.  The times are in seconds.
+ */
+class SimulatorProfiler
+{
+public:
+  /** The counters of the messages exchanged with a neighbor rank. */
+  struct Neighbor
+  {
+    Neighbor ();
+    uint64_t messagesSent;          //!< messages sent to the rank
+    uint64_t nullMessagesSent;      //!< messages without packets sent to the rank
+    uint64_t packetsSent;           //!< packets sent to the rank
+    uint64_t bytesSent;             //!< bytes sent to the rank
+    uint64_t messagesReceived;      //!< messages received from the rank
+    uint64_t nullMessagesReceived;  //!< messages without packets received from the rank
+    uint64_t packetsReceived;       //!< packets received from the rank
+    uint64_t bytesReceived;         //!< bytes received from the rank
+  };
+
+  SimulatorProfiler ();
+  ~SimulatorProfiler ();
+
+  /**
+   * \param [in] filename The file to write the profile to, or an empty
+   *             string not to write it.
+   */
+  void SetFile (std::string filename);
+  /** \returns The file the profile is written to. */
+  std::string GetFile (void) const;
+  /**
+   * \param [in] interval The interval of simulation time between the
+   *             samples written to the file, or zero not to write them.
+   */
+  void SetInterval (Time interval);
+  /** \returns The interval of simulation time between the samples. */
+  Time GetInterval (void) const;
+
+  /**
+   * Notify the start of a run.
+   *
+   * \param [in] rank The rank of the simulator.
+   * \param [in] nRanks The number of ranks, 1 for a sequential simulation.
+   * \param [in] now The current simulation time.
+   */
+  void Start (uint32_t rank, uint32_t nRanks, const Time &now);
+  /**
+   * Notify the end of a run, and write the summary.
+   *
+   * \param [in] now The current simulation time.
+   * \param [in] eventCount The number of events processed since the
+   *             creation of the simulator.
+   */
+  void Stop (const Time &now, uint64_t eventCount);
+  /**
+   * Notify an event processed, and write a sample if the sampling
+   * interval has elapsed.
+   *
+   * \param [in] ts The timestamp of the event, in time steps.
+   * \param [in] eventCount The number of events processed since the
+   *             creation of the simulator.
+   */
+  inline void NotifyEvent (uint64_t ts, uint64_t eventCount)
+  {
+    if (ts >= m_nextSample)
+      {
+        Sample (TimeStep (ts), eventCount);
+      }
+  }
+  /** Notify that the simulator blocks, waiting for the other ranks. */
+  void BeginBlocking (void);
+  /** Notify that the simulator does not wait for the other ranks anymore. */
+  void EndBlocking (void);
+  /**
+   * Notify a window of simulation time granted by a synchronization.
+   *
+   * \param [in] start The start of the window.
+   * \param [in] end The time up to which the events may be processed.
+   */
+  void NotifyWindow (const Time &start, const Time &end);
+  /**
+   * Notify a message sent to another rank.
+   *
+   * \param [in] rank The destination rank.
+   * \param [in] bytes The size of the message.
+   * \param [in] packets The number of packets held by the message.
+   */
+  void NotifyMessageSent (uint32_t rank, uint64_t bytes, uint32_t packets);
+  /**
+   * Notify a message received from another rank.
+   *
+   * \param [in] rank The source rank.
+   * \param [in] bytes The size of the message.
+   * \param [in] packets The number of packets held by the message.
+   */
+  void NotifyMessageReceived (uint32_t rank, uint64_t bytes, uint32_t packets);
+
+  /** \returns The number of events processed by the runs. */
+  uint64_t GetEventCount (void) const;
+  /** \returns The wall-clock duration of the runs, the current one included, in seconds. */
+  double GetRunTime (void) const;
+  /** \returns The number of events processed per wall-clock second. */
+  double GetEventRate (void) const;
+  /** \returns The wall-clock time spent blocked, in seconds. */
+  double GetBlockingTime (void) const;
+  /** \returns The number of windows granted. */
+  uint64_t GetWindowCount (void) const;
+  /** \returns The smallest window granted. */
+  Time GetMinWindow (void) const;
+  /** \returns The mean of the windows granted. */
+  Time GetMeanWindow (void) const;
+  /** \returns The largest window granted. */
+  Time GetMaxWindow (void) const;
+  /** \returns The counters of the messages, by neighbor rank. */
+  const std::map<uint32_t, Neighbor> &GetNeighbors (void) const;
+
+  /**
+   * Print the summary of the profile as a JSON object.
+   *
+   * \param [in] os The output stream.
+   * \param [in] now The current simulation time.
+   */
+  void PrintSummary (std::ostream &os, const Time &now) const;
+
+private:
+  /**
+   * Write a sample, and compute the time of the next one.
+   *
+   * \param [in] now The current simulation time.
+   * \param [in] eventCount The number of events processed since the
+   *             creation of the simulator.
+   */
+  void Sample (const Time &now, uint64_t eventCount);
+  /**
+   * Print the counters common to the samples and to the summary.
+   *
+   * \param [in] os The output stream.
+   * \param [in] type The type of the object.
+   * \param [in] now The current simulation time.
+   */
+  void PrintCounters (std::ostream &os, const char *type, const Time &now) const;
+
+  std::string m_filename;     //!< The file the profile is written to.
+  std::ofstream m_file;       //!< The file, once opened by Start.
+  Time m_interval;            //!< The interval between the samples.
+  uint64_t m_nextSample;      //!< The timestamp of the next sample, in time steps.
+  uint32_t m_rank;            //!< The rank of the simulator.
+  bool m_running;             //!< Whether a run is in progress.
+  int64_t m_startWallTime;    //!< The wall-clock time of the start of the run, in ns.
+  int64_t m_runTime;          //!< The wall-clock duration of the previous runs, in ns.
+  uint64_t m_eventCount;      //!< The events processed by the runs.
+  double m_sampleWallTime;    //!< The elapsed time of the last sample.
+  uint64_t m_sampleEventCount; //!< The event count of the last sample.
+  int64_t m_blockingStart;    //!< The wall-clock time the simulator blocked, in ns.
+  int64_t m_blockingTime;     //!< The wall-clock time spent blocked, in ns.
+  uint64_t m_windowCount;     //!< The number of windows granted.
+  Time m_windowSum;           //!< The sum of the windows granted.
+  Time m_minWindow;           //!< The smallest window granted.
+  Time m_maxWindow;           //!< The largest window granted.
+  std::map<uint32_t, Neighbor> m_neighbors;  //!< The counters of the messages, by rank.
+};
+
+} // namespace ns3
+
+#endif /* SIMULATOR_PROFILER_H */
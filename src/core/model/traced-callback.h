@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +46,24 @@ namespace ns3 {
  * calling the \c operator() form with the appropriate
  * number of arguments.
  *
+ * The first Callback of the chain is stored in the TracedCallback
+ * itself, the following ones in a vector allocated when the second one
+ * is connected, so that invoking a trace source costs a test when no
+ * Callback is connected, and no pointer chasing when a single one is.
+ * The trace sources whose arguments are expensive to build can test
+ * IsEmpty() first:
+ *
+ * \code
+ *   if (!m_rxTrace.IsEmpty ())
+ *     {
+ *       m_rxTrace (mpdu->GetProtocolDataUnit ());
+ *     }
+ * \endcode
+ *
+ * The sinks can also be bound at compile time, with the template
+ * forms of ConnectWithoutContext, which call the sink function directly
+ * instead of through the virtual call of the Callback implementation.
+ *
  * \tparam Ts \explicit Types of the functor arguments.
  */
 template<typename... Ts>
@@ -54,6 +72,21 @@ class TracedCallback
 public:
   /** Constructor. */
   TracedCallback ();
+  /**
+   * Copy constructor.
+   *
+   * \param [in] o The TracedCallback to copy.
+   */
+  TracedCallback (const TracedCallback &o);
+  /**
+   * Assignment operator.
+   *
+   * \param [in] o The TracedCallback to copy.
+   * \returns This TracedCallback.
+   */
+  TracedCallback & operator = (const TracedCallback &o);
+  /** Destructor. */
+  ~TracedCallback ();
   /**
    * Append a Callback to the chain (without a context).
    *
@@ -83,6 +116,55 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * Append a member function of an object to the chain, bound at
+   * compile time.
+   *
+   * The object is not referenced: it must be disconnected before it
+   * is deleted.
+   *
+   * \code
+   *   m_macTxTrace.ConnectWithoutContext<Stats, &Stats::MacTx> (stats);
+   * \endcode
+   *
+   * \tparam T \explicit The class of the object.
+   * \tparam MEM \explicit The member function.
+   * \param [in] object The object.
+   */
+  template <typename T, void (T::*MEM) (Ts...)>
+  void ConnectWithoutContext (T *object);
+  /**
+   * Append a function to the chain, bound at compile time.
+   *
+   * \tparam F \explicit The function.
+   */
+  template <void (*F) (Ts...)>
+  void ConnectWithoutContext (void);
+  /**
+   * Remove from the chain a member function connected with the
+   * template form of ConnectWithoutContext.
+   *
+   * \tparam T \explicit The class of the object.
+   * \tparam MEM \explicit The member function.
+   * \param [in] object The object.
+   */
+  template <typename T, void (T::*MEM) (Ts...)>
+  void DisconnectWithoutContext (T *object);
+  /**
+   * Remove from the chain a function connected with the template form
+   * of ConnectWithoutContext.
+   *
+   * \tparam F \explicit The function.
+   */
+  template <void (*F) (Ts...)>
+  void DisconnectWithoutContext (void);
+  /**
+   * \returns \c true if no Callback is connected.
+   */
+  bool IsEmpty (void) const
+  {
+    return m_first.invoke == 0 && m_first.callback.IsNull ();
+  }
   /**
    * \brief Functor which invokes the chain of Callbacks.
    * \tparam Ts \deduced Types of the functor arguments.
@@ -102,14 +184,74 @@ public:
   /**@}*/
 
 private:
+  /** A Callback of the chain. */
+  struct Sink
+  {
+    /** The function which invokes a sink bound at compile time, or 0. */
+    void (*invoke) (const Sink &sink, Ts... args);
+    /** The object of a member function bound at compile time. */
+    void *object;
+    /** The Callback, if not bound at compile time. */
+    Callback<void,Ts...> callback;
+  };
+  /** Container type for holding the Callbacks after the first. */
+  typedef std::vector<Sink> SinkList;
   /**
-   * Container type for holding the chain of Callbacks.
-   *
-   * \tparam Ts \deduced Types of the functor arguments.
+   * Invoke a member function bound at compile time.
+   * \tparam T \explicit The class of the object.
+   * \tparam MEM \explicit The member function.
+   * \param [in] sink The sink.
+   * \param [in] args The arguments.
+   */
+  template <typename T, void (T::*MEM) (Ts...)>
+  static void InvokeMember (const Sink &sink, Ts... args)
+  {
+    (static_cast<T *> (sink.object)->*MEM) (args...);
+  }
+  /**
+   * Invoke a function bound at compile time.
+   * \tparam F \explicit The function.
+   * \param [in] sink The sink.
+   * \param [in] args The arguments.
    */
-  typedef std::list<Callback<void,Ts...> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  template <void (*F) (Ts...)>
+  static void InvokeFunction (const Sink &sink, Ts... args)
+  {
+    F (args...);
+  }
+  /**
+   * Invoke a sink.
+   * \param [in] sink The sink.
+   * \param [in] args The arguments.
+   */
+  static void Invoke (const Sink &sink, const Ts &... args)
+  {
+    if (sink.invoke == 0)
+      {
+        sink.callback (args...);
+      }
+    else
+      {
+        sink.invoke (sink, args...);
+      }
+  }
+  /**
+   * Append a sink to the chain.
+   * \param [in] sink The sink.
+   */
+  void Append (const Sink &sink);
+  /**
+   * Remove the sinks of the chain which match a predicate.
+   * \tparam P \deduced The predicate type.
+   * \param [in] match The predicate.
+   */
+  template <typename P>
+  void RemoveIf (P match);
+
+  /** The first Callback of the chain, empty if none. */
+  Sink m_first;
+  /** The following Callbacks, or 0 if none was ever connected. */
+  SinkList *m_others;
 };
 
 } // namespace ns3
@@ -123,18 +265,103 @@ namespace ns3 {
 
 template<typename... Ts>
 TracedCallback<Ts...>::TracedCallback ()
-  : m_callbackList ()
+  : m_first (),
+    m_others (0)
 {}
 template<typename... Ts>
+TracedCallback<Ts...>::TracedCallback (const TracedCallback &o)
+  : m_first (o.m_first),
+    m_others (0)
+{
+  if (o.m_others != 0 && !o.m_others->empty ())
+    {
+      m_others = new SinkList (*o.m_others);
+    }
+}
+template<typename... Ts>
+TracedCallback<Ts...> &
+TracedCallback<Ts...>::operator = (const TracedCallback &o)
+{
+  if (this != &o)
+    {
+      m_first = o.m_first;
+      delete m_others;
+      m_others = 0;
+      if (o.m_others != 0 && !o.m_others->empty ())
+        {
+          m_others = new SinkList (*o.m_others);
+        }
+    }
+  return *this;
+}
+template<typename... Ts>
+TracedCallback<Ts...>::~TracedCallback ()
+{
+  delete m_others;
+}
+template<typename... Ts>
+void
+TracedCallback<Ts...>::Append (const Sink &sink)
+{
+  if (IsEmpty ())
+    {
+      m_first = sink;
+      return;
+    }
+  if (m_others == 0)
+    {
+      m_others = new SinkList ();
+    }
+  m_others->push_back (sink);
+}
+template<typename... Ts>
+template <typename P>
+void
+TracedCallback<Ts...>::RemoveIf (P match)
+{
+  std::size_t n = 0;
+  if (!IsEmpty () && !match (m_first))
+    {
+      n = 1;
+    }
+  if (m_others != 0)
+    {
+      for (typename SinkList::iterator i = m_others->begin (); i != m_others->end (); ++i)
+        {
+          if (match (*i))
+            {
+              continue;
+            }
+          // shift the kept sinks to the front of the chain
+          if (n == 0)
+            {
+              m_first = *i;
+            }
+          else
+            {
+              (*m_others)[n - 1] = *i;
+            }
+          ++n;
+        }
+      m_others->resize (n > 0 ? n - 1 : 0);
+    }
+  if (n == 0)
+    {
+      m_first = Sink ();
+    }
+}
+template<typename... Ts>
 void
 TracedCallback<Ts...>::ConnectWithoutContext (const CallbackBase & callback)
 {
-  Callback<void,Ts...> cb;
-  if (!cb.Assign (callback))
+  Sink sink;
+  sink.invoke = 0;
+  sink.object = 0;
+  if (!sink.callback.Assign (callback))
     {
       NS_FATAL_ERROR_NO_MSG ();
     }
-  m_callbackList.push_back (cb);
+  Append (sink);
 }
 template<typename... Ts>
 void
@@ -145,25 +372,40 @@ TracedCallback<Ts...>::Connect (const CallbackBase & callback, std::string path)
     {
       NS_FATAL_ERROR ("when connecting to " << path);
     }
-  Callback<void,Ts...> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  Sink sink;
+  sink.invoke = 0;
+  sink.object = 0;
+  sink.callback = cb.Bind (path);
+  Append (sink);
+}
+template<typename... Ts>
+template <typename T, void (T::*MEM) (Ts...)>
+void
+TracedCallback<Ts...>::ConnectWithoutContext (T *object)
+{
+  Sink sink;
+  sink.invoke = &InvokeMember<T, MEM>;
+  sink.object = object;
+  Append (sink);
+}
+template<typename... Ts>
+template <void (*F) (Ts...)>
+void
+TracedCallback<Ts...>::ConnectWithoutContext (void)
+{
+  Sink sink;
+  sink.invoke = &InvokeFunction<F>;
+  sink.object = 0;
+  Append (sink);
 }
 template<typename... Ts>
 void
 TracedCallback<Ts...>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  RemoveIf ([&callback] (const Sink &sink)
     {
-      if ((*i).IsEqual (callback))
-        {
-          i = m_callbackList.erase (i);
-        }
-      else
-        {
-          i++;
-        }
-    }
+      return sink.invoke == 0 && sink.callback.IsEqual (callback);
+    });
 }
 template<typename... Ts>
 void
@@ -178,13 +420,42 @@ TracedCallback<Ts...>::Disconnect (const CallbackBase & callback, std::string pa
   DisconnectWithoutContext (realCb);
 }
 template<typename... Ts>
+template <typename T, void (T::*MEM) (Ts...)>
+void
+TracedCallback<Ts...>::DisconnectWithoutContext (T *object)
+{
+  void *p = object;
+  RemoveIf ([p] (const Sink &sink)
+    {
+      return sink.invoke == &InvokeMember<T, MEM> && sink.object == p;
+    });
+}
+template<typename... Ts>
+template <void (*F) (Ts...)>
+void
+TracedCallback<Ts...>::DisconnectWithoutContext (void)
+{
+  RemoveIf ([] (const Sink &sink)
+    {
+      return sink.invoke == &InvokeFunction<F>;
+    });
+}
+template<typename... Ts>
 void
 TracedCallback<Ts...>::operator() (Ts... args) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
+    {
+      return;
+    }
+  Invoke (m_first, args...);
+  if (m_others != 0)
     {
-      (*i)(args...);
+      // the sinks may connect other sinks, which may reallocate the vector
+      for (std::size_t i = 0; i < m_others->size (); ++i)
+        {
+          Invoke ((*m_others)[i], args...);
+        }
     }
 }
 
@@ -24,6 +24,7 @@
 #include "trace-source-accessor.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -78,6 +79,15 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
 class IidManager : public Singleton<IidManager>
 {
 public:
+  /** Constructor */
+  IidManager ();
+  /**
+   * Check if a type id derives from another one, in constant time.
+   * \param [in] uid The id.
+   * \param [in] other The id of the candidate ancestor.
+   * \returns \c true if \pname{other} is an ancestor of \pname{uid}.
+   */
+  bool IsChildOf (uint16_t uid, uint16_t other) const;
   /**
    * Create a new unique type id.
    * \param [in] name The name of this type id.
@@ -222,6 +232,11 @@ public:
    * \returns The number of attributes associated to this TypeId
    */
   std::size_t GetAttributeN (uint16_t uid) const;
+  /**
+   * Get the number of changes of the attributes of all the type ids.
+   * \returns The attribute change counter.
+   */
+  uint32_t GetAttributeGeneration (void) const;
   /**
    * Get Attribute information by index.
    * \param [in] uid The id.
@@ -264,6 +279,26 @@ public:
    * \returns Detailed information about the requested trace source.
    */
   struct TypeId::TraceSourceInformation GetTraceSource (uint16_t uid, std::size_t i) const;
+  /**
+   * Find an Attribute by name in a type id and its parents.
+   * \param [in] uid The id.
+   * \param [in] name The Attribute name.
+   * \param [out] owner The id which registered the Attribute.
+   * \param [out] i The index of the Attribute in \pname{owner}.
+   * \returns \c true if the Attribute was found.
+   */
+  bool LookupAttribute (uint16_t uid, const std::string &name,
+                        uint16_t *owner, std::size_t *i) const;
+  /**
+   * Find a TraceSource by name in a type id and its parents.
+   * \param [in] uid The id.
+   * \param [in] name The TraceSource name.
+   * \param [out] owner The id which registered the TraceSource.
+   * \param [out] i The index of the TraceSource in \pname{owner}.
+   * \returns \c true if the TraceSource was found.
+   */
+  bool LookupTraceSource (uint16_t uid, const std::string &name,
+                          uint16_t *owner, std::size_t *i) const;
   /**
    * Check if this TypeId should not be listed in documentation.
    * \param [in] uid The id.
@@ -320,6 +355,14 @@ private:
     TypeId::SupportLevel supportLevel;
     /** Support message. */
     std::string supportMsg;
+    /** The uids of the type ids from the root to this one included. */
+    std::vector<uint16_t> ancestors;
+    /** The value of m_nameGeneration when the name indexes were built. */
+    uint32_t nameGeneration;
+    /** The Attributes of this type id and of its parents by name. */
+    std::unordered_map<std::string, std::pair<uint16_t, std::size_t> > attributeIndex;
+    /** The TraceSources of this type id and of its parents by name. */
+    std::unordered_map<std::string, std::pair<uint16_t, std::size_t> > traceSourceIndex;
   };
   /** Iterator type. */
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
@@ -330,6 +373,16 @@ private:
    * \returns The information record.
    */
   struct IidManager::IidInformation * LookupInformation (uint16_t uid) const;
+  /**
+   * Build the by-name indexes of the Attributes and TraceSources
+   * of a type id, if they are out of date.
+   *
+   * The type id shadows the Attributes and TraceSources of its parents
+   * with the same name, in the order in which they are searched by
+   * TypeId::LookupAttributeByName and TypeId::LookupTraceSourceByName.
+   * \param [in] information The information record of the type id.
+   */
+  void IndexNames (struct IidInformation *information) const;
 
   /** The container of all type id records. */
   std::vector<struct IidInformation> m_information;
@@ -344,6 +397,14 @@ private:
   /** The by-hash index. */
   hashmap_t m_hashmap;
 
+  /** The number of attributes added or whose initial value has been changed. */
+  uint32_t m_attributeGeneration;
+  /**
+   * The number of changes of the Attributes, TraceSources or parents
+   * of the type ids, which invalidate the by-name indexes.
+   */
+  uint32_t m_nameGeneration;
+
 
   /** IidManager constants. */
   enum
@@ -380,6 +441,13 @@ IidManager::Hasher (const std::string name)
  */
 #define IIDL IID << ": "
 
+IidManager::IidManager ()
+  : m_attributeGeneration (0),
+    m_nameGeneration (1)
+{
+  NS_LOG_FUNCTION (IID);
+}
+
 uint16_t
 IidManager::AllocateUid (std::string name)
 {
@@ -443,10 +511,12 @@ IidManager::AllocateUid (std::string name)
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
   information.supportLevel = TypeId::SUPPORTED;
+  information.nameGeneration = 0;
   m_information.push_back (information);
   std::size_t tuid = m_information.size ();
   NS_ASSERT (tuid <= 0xffff);
   uint16_t uid = static_cast<uint16_t> (tuid);
+  m_information.back ().ancestors.push_back (uid);
 
   // Add to both maps:
   m_namemap.insert (std::make_pair (name, uid));
@@ -471,6 +541,23 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  // The parent of a type id is complete before the type ids deriving
+  // from it are registered, so that the ancestors can be computed once.
+  information->ancestors.clear ();
+  if (parent != uid)
+    {
+      information->ancestors = LookupInformation (parent)->ancestors;
+    }
+  information->ancestors.push_back (uid);
+  ++m_nameGeneration;
+}
+bool
+IidManager::IsChildOf (uint16_t uid, uint16_t other) const
+{
+  NS_LOG_FUNCTION (IID << uid << other);
+  const std::vector<uint16_t> &ancestors = LookupInformation (uid)->ancestors;
+  std::size_t depth = LookupInformation (other)->ancestors.size ();
+  return ancestors.size () > depth && ancestors[depth - 1] == other;
 }
 void
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -681,6 +768,8 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  ++m_attributeGeneration;
+  ++m_nameGeneration;
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void
@@ -692,10 +781,17 @@ IidManager::SetAttributeInitialValue (uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  ++m_attributeGeneration;
 }
 
 
 
+uint32_t
+IidManager::GetAttributeGeneration (void) const
+{
+  return m_attributeGeneration;
+}
+
 std::size_t
 IidManager::GetAttributeN (uint16_t uid) const
 {
@@ -773,6 +869,7 @@ IidManager::AddTraceSource (uint16_t uid,
   source.supportLevel = supportLevel;
   source.supportMsg = supportMsg;
   information->traceSources.push_back (source);
+  ++m_nameGeneration;
   NS_LOG_LOGIC (IIDL << information->traceSources.size () - 1);
 }
 std::size_t
@@ -793,6 +890,79 @@ IidManager::GetTraceSource (uint16_t uid, std::size_t i) const
   NS_LOG_LOGIC (IIDL << information->name);
   return information->traceSources[i];
 }
+
+void
+IidManager::IndexNames (struct IidInformation *information) const
+{
+  NS_LOG_FUNCTION (IID << information);
+  if (information->nameGeneration == m_nameGeneration)
+    {
+      return;
+    }
+  information->attributeIndex.clear ();
+  information->traceSourceIndex.clear ();
+  struct IidInformation *current = information;
+  uint16_t uid = static_cast<uint16_t> (information - &m_information[0] + 1);
+  while (true)
+    {
+      // emplace keeps the entries of the derived type ids
+      for (std::size_t i = 0; i < current->attributes.size (); ++i)
+        {
+          information->attributeIndex.emplace (current->attributes[i].name,
+                                               std::make_pair (uid, i));
+        }
+      for (std::size_t i = 0; i < current->traceSources.size (); ++i)
+        {
+          information->traceSourceIndex.emplace (current->traceSources[i].name,
+                                                 std::make_pair (uid, i));
+        }
+      struct IidInformation *parent = LookupInformation (current->parent);
+      if (parent == current)
+        {
+          break;
+        }
+      uid = current->parent;
+      current = parent;
+    }
+  information->nameGeneration = m_nameGeneration;
+}
+
+bool
+IidManager::LookupAttribute (uint16_t uid, const std::string &name,
+                             uint16_t *owner, std::size_t *i) const
+{
+  NS_LOG_FUNCTION (IID << uid << name << owner << i);
+  struct IidInformation *information = LookupInformation (uid);
+  IndexNames (information);
+  std::unordered_map<std::string, std::pair<uint16_t, std::size_t> >::const_iterator it =
+    information->attributeIndex.find (name);
+  if (it == information->attributeIndex.end ())
+    {
+      return false;
+    }
+  *owner = it->second.first;
+  *i = it->second.second;
+  return true;
+}
+
+bool
+IidManager::LookupTraceSource (uint16_t uid, const std::string &name,
+                               uint16_t *owner, std::size_t *i) const
+{
+  NS_LOG_FUNCTION (IID << uid << name << owner << i);
+  struct IidInformation *information = LookupInformation (uid);
+  IndexNames (information);
+  std::unordered_map<std::string, std::pair<uint16_t, std::size_t> >::const_iterator it =
+    information->traceSourceIndex.find (name);
+  if (it == information->traceSourceIndex.end ())
+    {
+      return false;
+    }
+  *owner = it->second.first;
+  *i = it->second.second;
+  return true;
+}
+
 bool
 IidManager::MustHideFromDocumentation (uint16_t uid) const
 {
@@ -883,40 +1053,26 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do
+  uint16_t owner;
+  std::size_t i;
+  if (!IidManager::Get ()->LookupAttribute (m_tid, name, &owner, &i))
     {
-      tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "Attribute '" << name << "' is deprecated: "
-                            << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("Attribute '" << name <<
-                                  "' is obsolete, with no fallback: " <<
-                                  tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
+      return false;
     }
-  while (nextTid != tid);
-  return false;
+  struct TypeId::AttributeInformation tmp = IidManager::Get ()->GetAttribute (owner, i);
+  if (tmp.supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "Attribute '" << name << "' is deprecated: "
+                << tmp.supportMsg << std::endl;
+    }
+  else if (tmp.supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("Attribute '" << name <<
+                      "' is obsolete, with no fallback: " <<
+                      tmp.supportMsg);
+    }
+  *info = tmp;
+  return true;
 }
 
 TypeId
@@ -958,12 +1114,7 @@ bool
 TypeId::IsChildOf (TypeId other) const
 {
   NS_LOG_FUNCTION (this << other.GetUid ());
-  TypeId tmp = *this;
-  while (tmp != other && tmp != tmp.GetParent ())
-    {
-      tmp = tmp.GetParent ();
-    }
-  return tmp == other && *this != other;
+  return IidManager::Get ()->IsChildOf (m_tid, other.m_tid);
 }
 std::string
 TypeId::GetGroupName (void) const
@@ -1056,6 +1207,11 @@ TypeId::SetAttributeInitialValue (std::size_t i,
   return true;
 }
 
+uint32_t
+TypeId::GetAttributeGeneration (void)
+{
+  return IidManager::Get ()->GetAttributeGeneration ();
+}
 
 Callback<ObjectBase *>
 TypeId::GetConstructor (void) const
@@ -1137,41 +1293,26 @@ TypeId::LookupTraceSourceByName (std::string name,
                                  struct TraceSourceInformation *info) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  struct TypeId::TraceSourceInformation tmp;
-  do
+  uint16_t owner;
+  std::size_t i;
+  if (!IidManager::Get ()->LookupTraceSource (m_tid, name, &owner, &i))
     {
-      tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetTraceSourceN (); i++)
-        {
-          tmp = tid.GetTraceSource (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "TraceSource '" << name << "' is deprecated: "
-                            << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("TraceSource '" << name <<
-                                  "' is obsolete, with no fallback: " <<
-                                  tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
+      return 0;
+    }
+  struct TypeId::TraceSourceInformation tmp = IidManager::Get ()->GetTraceSource (owner, i);
+  if (tmp.supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "TraceSource '" << name << "' is deprecated: "
+                << tmp.supportMsg << std::endl;
+    }
+  else if (tmp.supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("TraceSource '" << name <<
+                      "' is obsolete, with no fallback: " <<
+                      tmp.supportMsg);
     }
-  while (nextTid != tid);
-  return 0;
+  *info = tmp;
+  return tmp.accessor;
 }
 
 Ptr<const TraceSourceAccessor>
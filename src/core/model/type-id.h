@@ -206,7 +206,8 @@ public:
    *
    * Calling this method is roughly similar to calling dynamic_cast
    * except that you do not need object instances: you can do the check
-   * with TypeId instances instead.
+   * with TypeId instances instead. The ancestors of each TypeId are
+   * recorded when its parent is set, so the check takes constant time.
    */
   bool IsChildOf (TypeId other) const;
 
@@ -395,6 +396,16 @@ public:
    */
   bool SetAttributeInitialValue (std::size_t i,
                                  Ptr<const AttributeValue> initialValue);
+  /**
+   * Get the number of changes of the attributes of all the TypeIds.
+   *
+   * The counter is incremented whenever an attribute is added to a TypeId
+   * or its initial value is changed, e.g., by Config::SetDefault, so that
+   * the information derived from the attributes can be cached.
+   *
+   * \returns The attribute change counter.
+   */
+  static uint32_t GetAttributeGeneration (void);
 
   /**
    * Record in this TypeId the fact that a new attribute exists.
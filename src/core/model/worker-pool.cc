@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "worker-pool.h"
+#include "log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "system-thread.h"
+#endif
+
+#include <thread>
+
+/**
+ * @file
+ * @ingroup thread
+ * ns3::WorkerPool implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WorkerPool");
+
+WorkerPool::WorkerPool (uint32_t nThreads)
+  : m_batch (0),
+    m_busy (0),
+    m_stop (false),
+    m_nTasks (0),
+    m_next (0)
+{
+  NS_LOG_FUNCTION (this << nThreads);
+#ifdef HAVE_PTHREAD_H
+  for (uint32_t i = 0; i < nThreads; ++i)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&WorkerPool::Work, this));
+      m_threads.push_back (thread);
+      thread->Start ();
+    }
+#else
+  if (nThreads > 0)
+    {
+      NS_LOG_WARN ("built without thread support, tasks will run in the calling thread");
+    }
+#endif
+}
+
+WorkerPool::~WorkerPool ()
+{
+  NS_LOG_FUNCTION (this);
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all ();
+#ifdef HAVE_PTHREAD_H
+  for (std::vector<Ptr<SystemThread> >::iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+#endif
+  m_threads.clear ();
+}
+
+uint32_t
+WorkerPool::GetNThreads (void) const
+{
+  return m_threads.size ();
+}
+
+uint32_t
+WorkerPool::GetHardwareConcurrency (void)
+{
+  uint32_t n = std::thread::hardware_concurrency ();
+  return (n > 0) ? n : 1;
+}
+
+void
+WorkerPool::Run (uint32_t nTasks, Task task)
+{
+  NS_LOG_FUNCTION (this << nTasks);
+  if (m_threads.empty () || nTasks <= 1)
+    {
+      for (uint32_t i = 0; i < nTasks; ++i)
+        {
+          task (i);
+        }
+      return;
+    }
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_task = task;
+    m_nTasks = nTasks;
+    m_next.store (0);
+    m_busy = m_threads.size ();
+    ++m_batch;
+  }
+  m_start.notify_all ();
+  LogSetThreadSuppressed (true);
+  RunTasks ();
+  LogSetThreadSuppressed (false);
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (m_busy > 0)
+    {
+      m_done.wait (lock);
+    }
+  m_task = Task ();
+}
+
+void
+WorkerPool::RunTasks (void)
+{
+  // m_task is only read here: copying it would touch the non-atomic
+  // reference count of the callback implementation
+  uint32_t i;
+  while ((i = m_next.fetch_add (1)) < m_nTasks)
+    {
+      m_task (i);
+    }
+}
+
+void
+WorkerPool::Work (void)
+{
+  uint64_t batch = 0;
+  LogSetThreadSuppressed (true);
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      while (!m_stop && m_batch == batch)
+        {
+          m_start.wait (lock);
+        }
+      if (m_stop)
+        {
+          return;
+        }
+      batch = m_batch;
+      lock.unlock ();
+      RunTasks ();
+      lock.lock ();
+      if (--m_busy == 0)
+        {
+          m_done.notify_one ();
+        }
+    }
+}
+
+} // namespace ns3
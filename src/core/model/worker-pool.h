@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "callback.h"
+#include "simple-ref-count.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup thread
+ * ns3::WorkerPool declaration.
+ */
+
+namespace ns3 {
+
+class SystemThread;
+
+/**
+ * @ingroup thread
+ * @brief A fixed set of worker threads running batches of independent
+ * tasks on behalf of the simulation thread.
+ *
+ * Run() hands out the task indices [0, nTasks) to the workers and to the
+ * calling thread, and returns only when all the tasks of the batch have
+ * completed, so the caller can consume the results in a deterministic
+ * order, whatever the number of threads.
+ *
+ * The tasks run concurrently: they must not touch state shared with the
+ * other tasks of the same batch, including the reference counts of
+ * shared ns-3 objects (Ptr is not thread-safe), and must not schedule
+ * events.
+ *
+ * The log messages of the tasks are suppressed while a batch runs
+ * concurrently, on the calling thread too, so the output does not depend
+ * on the thread which ran each task; they are printed as usual when the
+ * tasks run in the calling thread alone.
+ *
+ * When ns-3 is built without thread support, or when the pool is created
+ * with zero threads, the tasks simply run in the calling thread.
+ */
+class WorkerPool : public SimpleRefCount<WorkerPool>
+{
+public:
+  /** The task type: the argument is the index of the task in the batch. */
+  typedef Callback<void, uint32_t> Task;
+
+  /**
+   * Create the pool and start its threads.
+   *
+   * \param [in] nThreads The number of worker threads, in addition to
+   *             the calling thread.
+   */
+  WorkerPool (uint32_t nThreads);
+  /** Stop and join the worker threads. */
+  ~WorkerPool ();
+
+  /**
+   * \returns The number of worker threads.
+   */
+  uint32_t GetNThreads (void) const;
+
+  /**
+   * Run a batch of tasks and wait for its completion.
+   *
+   * \param [in] nTasks The number of tasks in the batch.
+   * \param [in] task The task, invoked once for every index in [0, nTasks).
+   */
+  void Run (uint32_t nTasks, Task task);
+
+  /**
+   * \returns The number of hardware threads, or 1 if unknown.
+   */
+  static uint32_t GetHardwareConcurrency (void);
+
+private:
+  /** Main loop of the worker threads. */
+  void Work (void);
+  /** Claim and run the tasks of the current batch until none is left. */
+  void RunTasks (void);
+
+  std::vector<Ptr<SystemThread> > m_threads; //!< The worker threads.
+  std::mutex m_mutex;                 //!< Protects the batch state.
+  std::condition_variable m_start;    //!< Signals a new batch or stop.
+  std::condition_variable m_done;     //!< Signals the end of a batch.
+  uint64_t m_batch;                   //!< Id of the current batch.
+  uint32_t m_busy;                    //!< Workers still running the batch.
+  bool m_stop;                        //!< True when the workers must exit.
+  Task m_task;                        //!< Task of the current batch.
+  uint32_t m_nTasks;                  //!< Size of the current batch.
+  std::atomic<uint32_t> m_next;       //!< Next task index to claim.
+};
+
+} // namespace ns3
+
+#endif /* WORKER_POOL_H */
@@ -1467,6 +1467,78 @@ CallbackValueTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_gotCbValue, 2, "Callback Attribute set to null callback unexpectedly fired");
 }
 
+// ===========================================================================
+// Test that the defaults cached by ObjectBase::ConstructSelf follow the
+// changes of the initial values, and are combined with the values given
+// at construction.
+// ===========================================================================
+class ConstructionDefaultsTestCase : public TestCase
+{
+public:
+  ConstructionDefaultsTestCase (std::string description);
+  virtual ~ConstructionDefaultsTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+};
+
+ConstructionDefaultsTestCase::ConstructionDefaultsTestCase (std::string description)
+  : TestCase (description)
+{}
+
+void
+ConstructionDefaultsTestCase::DoRun (void)
+{
+  IntegerValue i;
+  UintegerValue u;
+
+  Ptr<AttributeObjectTest> p = CreateObject<AttributeObjectTest> ();
+  p->GetAttribute ("TestInt16", i);
+  NS_TEST_ASSERT_MSG_EQ (i.Get (), -2, "Attribute not set to its initial value");
+
+  //
+  // A new default applies to the objects created afterwards only.
+  //
+  Config::SetDefault ("ns3::AttributeObjectTest::TestInt16", IntegerValue (5));
+  Ptr<AttributeObjectTest> q = CreateObject<AttributeObjectTest> ();
+  q->GetAttribute ("TestInt16", i);
+  NS_TEST_ASSERT_MSG_EQ (i.Get (), 5, "Attribute not set to its new default value");
+  p->GetAttribute ("TestInt16", i);
+  NS_TEST_ASSERT_MSG_EQ (i.Get (), -2, "Attribute of an existing object changed by a new default value");
+
+  //
+  // The values given at construction override the defaults of the
+  // corresponding attributes only.
+  //
+  q = CreateObjectWithAttributes<AttributeObjectTest> ("TestUint8", UintegerValue (7),
+                                                       "TestInt16", StringValue ("9"));
+  q->GetAttribute ("TestUint8", u);
+  NS_TEST_ASSERT_MSG_EQ (u.Get (), 7, "Attribute not set to its construction value");
+  q->GetAttribute ("TestInt16", i);
+  NS_TEST_ASSERT_MSG_EQ (i.Get (), 9, "Attribute not set to its construction value");
+  q->GetAttribute ("TestInt16SetGet", i);
+  NS_TEST_ASSERT_MSG_EQ (i.Get (), 6, "Attribute not set to its initial value");
+
+  //
+  // A default value deserialized into an object is not shared.
+  //
+  PointerValue ptrP;
+  PointerValue ptrQ;
+  p->GetAttribute ("TestRandom", ptrP);
+  q->GetAttribute ("TestRandom", ptrQ);
+  NS_TEST_ASSERT_MSG_NE (ptrP.Get<RandomVariableStream> (), ptrQ.Get<RandomVariableStream> (),
+                         "Objects share the random variable created from the default value");
+
+  //
+  // Resetting the defaults restores the initial values.
+  //
+  Config::Reset ();
+  q = CreateObject<AttributeObjectTest> ();
+  q->GetAttribute ("TestInt16", i);
+  NS_TEST_ASSERT_MSG_EQ (i.Get (), -2, "Attribute not set to its initial value after Config::Reset");
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -1490,6 +1562,7 @@ AttributesTestSuite::AttributesTestSuite ()
   AddTestCase (new ObjectMapAttributeTestCase ("Check Attributes of type ObjectMapValue"), TestCase::QUICK);
   AddTestCase (new PointerAttributeTestCase ("Check Attributes of type PointerValue"), TestCase::QUICK);
   AddTestCase (new CallbackValueTestCase ("Check Attributes of type CallbackValue"), TestCase::QUICK);
+  AddTestCase (new ConstructionDefaultsTestCase ("Check the default values used at construction"), TestCase::QUICK);
   AddTestCase (new IntegerTraceSourceAttributeTestCase ("Ensure TracedValue<uint8_t> can be set like IntegerValue"), TestCase::QUICK);
   AddTestCase (new IntegerTraceSourceTestCase ("Ensure TracedValue<uint8_t> also works as trace source"), TestCase::QUICK);
   AddTestCase (new TracedCallbackTestCase ("Ensure TracedCallback<double, int, float> works as trace source"), TestCase::QUICK);
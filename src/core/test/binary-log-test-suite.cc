@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/binary-log.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup logging
+ * BinaryLog test suite.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryLogTestSuite");
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ * Check that the messages written to the binary log, by the simulation
+ * thread and by other threads, are decoded as they were written.
+ */
+class BinaryLogTestCase : public TestCase
+{
+public:
+  BinaryLogTestCase ();
+  virtual void DoRun (void);
+  /** Log a message with all the argument types. */
+  void LogAll (void);
+  /**
+   * Log the messages of a thread.
+   * \param thread The thread index.
+   * \param n The number of messages.
+   */
+  static void LogThread (uint32_t thread, uint32_t n);
+};
+
+BinaryLogTestCase::BinaryLogTestCase ()
+  : TestCase ("Check the binary log and its decoding")
+{}
+
+void
+BinaryLogTestCase::LogAll (void)
+{
+  NS_BINLOG ("int {} uint {} double {} bool {} time {} level {}",
+             -3, 7u, 0.5, true, MilliSeconds (20), LOG_LOGIC);
+}
+
+void
+BinaryLogTestCase::LogThread (uint32_t thread, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      NS_BINLOG ("thread {} message {}", thread, i);
+    }
+}
+
+void
+BinaryLogTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-log.blog");
+  // a small ring, which is flushed several times by each thread
+  bool ok = BinaryLog::Enable (filename, 16);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not open " << filename);
+
+  NS_BINLOG ("no argument");
+  Simulator::Schedule (Seconds (1.5), &BinaryLogTestCase::LogAll, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  const uint32_t nThreads = 3;
+  const uint32_t nMessages = 100;
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < nThreads; ++t)
+    {
+      threads.push_back (std::thread (&BinaryLogTestCase::LogThread, t, nMessages));
+    }
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+  BinaryLog::Disable ();
+  NS_TEST_ASSERT_MSG_EQ (BinaryLog::IsEnabled (), false, "The log is still enabled");
+
+  std::ostringstream os;
+  ok = BinaryLog::Decode (filename, os);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not decode " << filename);
+
+  // the rings of the threads are flushed when full, so that the
+  // messages of different threads are interleaved
+  std::istringstream is (os.str ());
+  std::string line;
+  std::vector<std::string> simulationLines;
+  std::vector<uint32_t> next (nThreads, 0);
+  uint32_t n = 0;
+  while (std::getline (is, line))
+    {
+      std::istringstream fields (line);
+      std::string time, writer, component, threadLabel, messageLabel;
+      fields >> time >> writer >> component;
+      NS_TEST_ASSERT_MSG_EQ (component, "BinaryLogTestSuite", "Wrong component");
+      if (writer == "0")
+        {
+          simulationLines.push_back (line);
+          continue;
+        }
+      // the messages of each thread are in order
+      uint32_t thread, message;
+      fields >> threadLabel >> thread >> messageLabel >> message;
+      NS_TEST_ASSERT_MSG_LT (thread, nThreads, "Wrong thread");
+      NS_TEST_ASSERT_MSG_EQ (message, next[thread], "Message out of order");
+      ++next[thread];
+      ++n;
+    }
+  NS_TEST_ASSERT_MSG_EQ (simulationLines.size (), 2, "Wrong number of simulation thread messages");
+  // the simulation time is unknown before the simulator is created
+  line = simulationLines[0];
+  NS_TEST_ASSERT_MSG_EQ (line.substr (line.find (' ') + 1), "0 BinaryLogTestSuite no argument", "Wrong message");
+  NS_TEST_ASSERT_MSG_EQ (simulationLines[1], "1.500000000 0 BinaryLogTestSuite int -3 uint 7 double 0.5 bool 1 time 0.02s level 32",
+                         "Wrong message");
+  NS_TEST_ASSERT_MSG_EQ (n, nThreads * nMessages, "Messages lost");
+}
+
+
+/**
+ * \ingroup core-tests
+ * BinaryLog test suite.
+ */
+class BinaryLogTestSuite : public TestSuite
+{
+public:
+  BinaryLogTestSuite ();
+};
+
+BinaryLogTestSuite::BinaryLogTestSuite ()
+  : TestSuite ("binary-log")
+{
+  AddTestCase (new BinaryLogTestCase ());
+}
+
+/** Static variable for test initialization. */
+static BinaryLogTestSuite g_binaryLogTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
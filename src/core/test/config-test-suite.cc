@@ -840,6 +840,108 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test for the resolution of several paths at once, and for the direct
+ * access to the objects of a vector by index.
+ */
+class ConnectAllConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ConnectAllConfigTestCase ();
+  /** Destructor. */
+  virtual ~ConnectAllConfigTestCase ()
+  {}
+
+  /**
+   * Trace callback with context path.
+   * \param path The context path.
+   * \param old The old value.
+   * \param newValue The new value.
+   */
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue)
+  {
+    NS_UNUSED (old);
+    NS_UNUSED (newValue);
+    m_paths.push_back (path);
+  }
+
+private:
+  virtual void DoRun (void);
+
+  std::vector<std::string> m_paths; //!< The context paths of the trace calls.
+};
+
+ConnectAllConfigTestCase::ConnectAllConfigTestCase ()
+  : TestCase ("Check the connection of several paths at once")
+{}
+
+void
+ConnectAllConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+  root->SetNodeB (b);
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      objects.back ()->SetNodeB (CreateObject<ConfigTestObject> ());
+      b->AddNodeA (objects.back ());
+    }
+
+  //
+  // Explicit indices, within or beyond the vector.
+  //
+  Config::MatchContainer matches = Config::LookupMatches ("/NodeB/NodesA/3");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Object 3 not matched");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objects[3], "Wrong object matched");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeB/NodesA/3/", "Wrong matched path");
+  matches = Config::LookupMatches ("/NodeB/NodesA/4");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 0, "Object 4 matched unexpectedly");
+  matches = Config::LookupMatches ("/NodeB/NodesA/3|1|[1-2]");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 3, "Objects 1 to 3 not matched");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeB/NodesA/1/", "Objects not matched in order");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (2), "/NodeB/NodesA/3/", "Objects not matched in order");
+
+  //
+  // Connect a callback to several paths, sharing their first segments.
+  //
+  std::vector<std::string> paths;
+  paths.push_back ("/NodeB/NodesA/0/Source");
+  paths.push_back ("/NodeB/NodesA/2/Source");
+  paths.push_back ("/NodeB/NodesA/2/NodeB/Source");
+  paths.push_back ("/NodeB/NodesA/[1-2]|7/Source");
+  paths.push_back ("/NodeB/NodesA/5/Source");
+  std::size_t connected = Config::ConnectAll (paths, MakeCallback (&ConnectAllConfigTestCase::TraceWithPath, this));
+  NS_TEST_ASSERT_MSG_EQ (connected, 5, "Wrong number of trace sources connected");
+
+  m_paths.clear ();
+  objects[0]->SetAttribute ("Source", IntegerValue (1));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 1, "Trace 0 did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[0], "/NodeB/NodesA/0/Source", "Trace 0 did not provide expected context");
+
+  m_paths.clear ();
+  objects[2]->SetAttribute ("Source", IntegerValue (2));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 2, "Trace 2 did not fire once per path");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[0], "/NodeB/NodesA/2/Source", "Trace 2 did not provide expected context");
+
+  m_paths.clear ();
+  PointerValue node;
+  objects[2]->GetAttribute ("NodeB", node);
+  node.Get<ConfigTestObject> ()->SetAttribute ("Source", IntegerValue (3));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 1, "Trace 2/NodeB did not fire as expected");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[0], "/NodeB/NodesA/2/NodeB/Source", "Trace 2/NodeB did not provide expected context");
+
+  m_paths.clear ();
+  objects[3]->SetAttribute ("Source", IntegerValue (4));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 0, "Trace 3 fired unexpectedly");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -858,6 +960,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new ConnectAllConfigTestCase);
 }
 
 /**
@@ -400,6 +400,21 @@ AggregateObjectTestCase::DoRun (void)
 
   baseA = baseB->GetObject<BaseA> ();
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
+
+  //
+  // When several aggregated Objects are instances of a type, GetObject
+  // returns the first one aggregated, whatever the previous lookups.
+  //
+  baseA = CreateObject<BaseA> ();
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  baseB = CreateObject<DerivedB> ();
+  baseA->AggregateObject (derivedA);
+  baseA->AggregateObject (baseB);
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<DerivedA> (), derivedA, "GetObject (through baseB) for DerivedA returns another Object");
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<BaseA> (), baseA, "GetObject (through baseB) for BaseA does not return the first BaseA");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseA> (), baseA, "GetObject (through derivedA) for BaseA does not return the first BaseA");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseB> (), baseB, "GetObject (through derivedA) for BaseB returns another Object");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<Object> (DerivedB::GetTypeId ()), baseB, "GetObject (through derivedA) for DerivedB returns another Object");
 }
 
 /**
@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * Tests of the bulk generation of random values, and of the substreams.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that RngStream::RandU01 (double *, std::size_t) gives the values
+ * of the successive calls to RandU01 (void).
+ */
+class RngStreamBulkTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  RngStreamBulkTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RngStreamBulkTestCase::RngStreamBulkTestCase ()
+  : TestCase ("Bulk RngStream values are those of the successive calls")
+{}
+
+void
+RngStreamBulkTestCase::DoRun (void)
+{
+  RngStream single (12345, 3, 7);
+  RngStream bulk (single);
+  std::vector<double> values (1000);
+  std::size_t done = 0;
+  for (std::size_t n : {1, 2, 97, 900})
+    {
+      bulk.RandU01 (&values[done], n);
+      done += n;
+    }
+  for (std::size_t i = 0; i < done; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (values[i], single.RandU01 (), "Different value " << i);
+    }
+  // the states of the two streams are the same
+  NS_TEST_ASSERT_MSG_EQ (bulk.RandU01 (), single.RandU01 (), "Different state");
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that RandomVariableStream::GetValues gives the values of the
+ * successive calls to GetValue, for a random variable configuration.
+ */
+class RandomVariableStreamBulkTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] factory The factory of the random variables.
+   * \param [in] name The name of the configuration.
+   */
+  RandomVariableStreamBulkTestCase (ObjectFactory factory, std::string name);
+
+private:
+  virtual void DoRun (void);
+  /** The factory of the random variables. */
+  ObjectFactory m_factory;
+};
+
+RandomVariableStreamBulkTestCase::RandomVariableStreamBulkTestCase (ObjectFactory factory,
+                                                                    std::string name)
+  : TestCase ("Bulk values of " + name),
+    m_factory (factory)
+{}
+
+void
+RandomVariableStreamBulkTestCase::DoRun (void)
+{
+  for (bool antithetic : {false, true})
+    {
+      Ptr<RandomVariableStream> single = m_factory.Create<RandomVariableStream> ();
+      Ptr<RandomVariableStream> bulk = m_factory.Create<RandomVariableStream> ();
+      single->SetStream (17);
+      bulk->SetStream (17);
+      single->SetAntithetic (antithetic);
+      bulk->SetAntithetic (antithetic);
+
+      // odd and even sizes, which split the pairs of the normal variable
+      std::vector<double> values (1200);
+      std::size_t done = 0;
+      for (std::size_t n : {0, 1, 3, 2, 65, 128, 1001})
+        {
+          bulk->GetValues (&values[done], n);
+          done += n;
+        }
+      for (std::size_t i = 0; i < done; ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (values[i], single->GetValue (),
+                                 "Different value " << i << " antithetic " << antithetic);
+        }
+      for (uint32_t i = 0; i < 3; ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (bulk->GetValue (), single->GetValue (),
+                                 "Different state antithetic " << antithetic);
+        }
+    }
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that the substreams selected with
+ * RandomVariableStream::SetSubstream depend only on the stream of the
+ * base variable and on the substream index.
+ */
+class SubstreamTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  SubstreamTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check if two random variables return the same sequence
+   * \param a the first random variable
+   * \param b the second random variable
+   * \return true if the first values drawn from a and b are equal
+   */
+  static bool AreEqual (Ptr<RandomVariableStream> a, Ptr<RandomVariableStream> b);
+};
+
+SubstreamTestCase::SubstreamTestCase ()
+  : TestCase ("Substreams of a Random Variable Stream")
+{}
+
+bool
+SubstreamTestCase::AreEqual (Ptr<RandomVariableStream> a, Ptr<RandomVariableStream> b)
+{
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      if (a->GetValue () != b->GetValue ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+SubstreamTestCase::DoRun (void)
+{
+  for (int64_t stream : {int64_t (-1), int64_t (5)})
+    {
+      Ptr<UniformRandomVariable> base = CreateObject<UniformRandomVariable> ();
+      base->SetStream (stream);
+
+      Ptr<UniformRandomVariable> a = CreateObject<UniformRandomVariable> ();
+      Ptr<UniformRandomVariable> b = CreateObject<UniformRandomVariable> ();
+      a->SetSubstream (base, 7);
+      b->SetSubstream (base, 7);
+      NS_TEST_ASSERT_MSG_EQ (a->GetStream (), stream, "The stream is not the one of the base");
+      NS_TEST_ASSERT_MSG_EQ (AreEqual (a, b), true, "Different sequences from the same substream");
+
+      a->SetSubstream (base, 7);
+      b->SetSubstream (base, 8);
+      NS_TEST_ASSERT_MSG_EQ (AreEqual (a, b), false, "Same sequence from different substreams");
+
+      // the substream given by the run number is the one used by SetStream
+      a->SetSubstream (base, RngSeedManager::GetRun ());
+      NS_TEST_ASSERT_MSG_EQ (AreEqual (a, base), true, "Wrong substream for the run number");
+    }
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Tests of the bulk generation of random values, and of the substreams.
+ */
+class RandomVariableStreamBulkTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  RandomVariableStreamBulkTestSuite ();
+};
+
+RandomVariableStreamBulkTestSuite::RandomVariableStreamBulkTestSuite ()
+  : TestSuite ("random-variable-stream-bulk", UNIT)
+{
+  AddTestCase (new RngStreamBulkTestCase);
+
+  ObjectFactory factory ("ns3::UniformRandomVariable",
+                         "Min", DoubleValue (-2.0),
+                         "Max", DoubleValue (5.0));
+  AddTestCase (new RandomVariableStreamBulkTestCase (factory, "uniform"));
+  factory = ObjectFactory ("ns3::ExponentialRandomVariable",
+                           "Mean", DoubleValue (3.0));
+  AddTestCase (new RandomVariableStreamBulkTestCase (factory, "exponential"));
+  factory.Set ("Bound", DoubleValue (2.0));
+  AddTestCase (new RandomVariableStreamBulkTestCase (factory, "bounded exponential"));
+  factory = ObjectFactory ("ns3::ParetoRandomVariable",
+                           "Scale", DoubleValue (1.0),
+                           "Shape", DoubleValue (2.5),
+                           "Bound", DoubleValue (4.0));
+  AddTestCase (new RandomVariableStreamBulkTestCase (factory, "bounded pareto"));
+  factory = ObjectFactory ("ns3::WeibullRandomVariable",
+                           "Scale", DoubleValue (2.0),
+                           "Shape", DoubleValue (1.5));
+  AddTestCase (new RandomVariableStreamBulkTestCase (factory, "weibull"));
+  factory = ObjectFactory ("ns3::NormalRandomVariable",
+                           "Mean", DoubleValue (1.0),
+                           "Variance", DoubleValue (4.0));
+  AddTestCase (new RandomVariableStreamBulkTestCase (factory, "normal"));
+  factory.Set ("Bound", DoubleValue (1.5));
+  AddTestCase (new RandomVariableStreamBulkTestCase (factory, "bounded normal"));
+  // default implementation
+  factory = ObjectFactory ("ns3::GammaRandomVariable",
+                           "Alpha", DoubleValue (2.0),
+                           "Beta", DoubleValue (1.0));
+  AddTestCase (new RandomVariableStreamBulkTestCase (factory, "gamma"));
+
+  AddTestCase (new SubstreamTestCase);
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RandomVariableStreamBulkTestSuite instance variable.
+ */
+static RandomVariableStreamBulkTestSuite g_randomVariableStreamBulkTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/random-variable-stream.h"
+#include <cmath>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * Tests of the constant time samplers of the empirical and Zipf
+ * random variables.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Check the frequencies of the values drawn with the alias table of
+ * EmpiricalRandomVariable, and its interpolation.
+ */
+class EmpiricalAliasTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  EmpiricalAliasTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EmpiricalAliasTestCase::EmpiricalAliasTestCase ()
+  : TestCase ("Empirical random variable sampled with an alias table")
+{}
+
+void
+EmpiricalAliasTestCase::DoRun (void)
+{
+  // values 0 .. 9, with the probabilities 0.1, 0, 0.15, 0.05, ...
+  const double cdf[] = {0.1, 0.1, 0.25, 0.3, 0.45, 0.5, 0.7, 0.8, 0.95, 1.0};
+  const uint32_t k = sizeof (cdf) / sizeof (cdf[0]);
+  Ptr<EmpiricalRandomVariable> x = CreateObject<EmpiricalRandomVariable> ();
+  x->SetStream (5);
+  x->SetAttribute ("Alias", BooleanValue (true));
+  for (uint32_t i = 0; i < k; ++i)
+    {
+      x->CDF (i, cdf[i]);
+    }
+
+  const uint32_t n = 200000;
+  std::vector<uint32_t> counts (k, 0);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      double value = x->GetValue ();
+      NS_TEST_ASSERT_MSG_EQ (value, std::floor (value), "Sampled value not in the CDF");
+      NS_TEST_ASSERT_MSG_LT (value, k, "Sampled value out of range");
+      ++counts[static_cast<uint32_t> (value)];
+    }
+  double prior = 0;
+  for (uint32_t i = 0; i < k; ++i)
+    {
+      double p = cdf[i] - prior;
+      prior = cdf[i];
+      // five standard deviations
+      double tolerance = 5 * std::sqrt (p * (1 - p) / n) + 1e-9;
+      NS_TEST_ASSERT_MSG_EQ_TOL (counts[i] / static_cast<double> (n), p, tolerance,
+                                 "Wrong frequency of value " << i);
+    }
+
+  // Interpolation: the values above the first point are uniform
+  // within their bin.
+  x->SetInterpolate (true);
+  double below = 0;
+  double sum = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      double value = x->GetValue ();
+      NS_TEST_ASSERT_MSG_EQ ((value >= 0 && value <= k - 1), true, "Interpolated value out of range");
+      below += (value < 2.5);
+      sum += value;
+    }
+  // P(value < 2.5) = 0.1 + 0 + 0.15 + 0.05 / 2, value i being
+  // interpolated over [i - 1, i]
+  NS_TEST_ASSERT_MSG_EQ_TOL (below / n, 0.275, 0.005, "Wrong interpolated distribution");
+  double mean = 0;
+  for (uint32_t i = 1; i < k; ++i)
+    {
+      mean += (cdf[i] - cdf[i - 1]) * (i - 0.5);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (sum / n, mean, 0.02, "Wrong interpolated mean");
+
+  // Adding points rebuilds the table.
+  Ptr<EmpiricalRandomVariable> y = CreateObject<EmpiricalRandomVariable> ();
+  y->SetAttribute ("Alias", BooleanValue (true));
+  y->CDF (3, 1.0);
+  NS_TEST_ASSERT_MSG_EQ (y->GetValue (), 3, "Wrong single value");
+  y = CreateObject<EmpiricalRandomVariable> ();
+  y->SetAttribute ("Alias", BooleanValue (true));
+  y->CDF (3, 0.5);
+  y->CDF (4, 1.0);
+  y->GetValue ();
+  y->CDF (5, 1.0);
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      NS_TEST_ASSERT_MSG_NE (y->GetValue (), 5, "Value with no probability drawn");
+    }
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Check the frequencies of the values of ZipfRandomVariable drawn with
+ * the rejection-inversion method.
+ */
+class ZipfRejectionInversionTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ZipfRejectionInversionTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ZipfRejectionInversionTestCase::ZipfRejectionInversionTestCase ()
+  : TestCase ("Zipf random variable drawn with rejection-inversion")
+{}
+
+void
+ZipfRejectionInversionTestCase::DoRun (void)
+{
+  const uint32_t nValues = 20;
+  const uint32_t n = 200000;
+  for (double alpha : {0.0, 0.5, 1.0, 1.5, 3.0})
+    {
+      Ptr<ZipfRandomVariable> x = CreateObject<ZipfRandomVariable> ();
+      x->SetStream (9);
+      x->SetAttribute ("N", IntegerValue (nValues));
+      x->SetAttribute ("Alpha", DoubleValue (alpha));
+      x->SetAttribute ("RejectionInversion", BooleanValue (true));
+
+      std::vector<uint32_t> counts (nValues + 1, 0);
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          uint32_t value = x->GetInteger ();
+          NS_TEST_ASSERT_MSG_EQ ((value >= 1 && value <= nValues), true,
+                                 "Value out of range for alpha " << alpha);
+          ++counts[value];
+        }
+      double c = 0;
+      for (uint32_t i = 1; i <= nValues; ++i)
+        {
+          c += std::pow (i, -alpha);
+        }
+      for (uint32_t i = 1; i <= nValues; ++i)
+        {
+          double p = std::pow (i, -alpha) / c;
+          double tolerance = 5 * std::sqrt (p * (1 - p) / n);
+          NS_TEST_ASSERT_MSG_EQ_TOL (counts[i] / static_cast<double> (n), p, tolerance,
+                                     "Wrong frequency of " << i << " for alpha " << alpha);
+        }
+    }
+
+  // Large populations
+  Ptr<ZipfRandomVariable> x = CreateObject<ZipfRandomVariable> ();
+  x->SetStream (9);
+  x->SetAttribute ("RejectionInversion", BooleanValue (true));
+  uint32_t ones = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint32_t value = x->GetInteger (1000000, 1);
+      NS_TEST_ASSERT_MSG_EQ ((value >= 1 && value <= 1000000), true, "Value out of range");
+      ones += (value == 1);
+    }
+  // 1 / H(10^6), H the harmonic number
+  NS_TEST_ASSERT_MSG_EQ_TOL (ones / static_cast<double> (n), 0.069480, 0.003, "Wrong frequency of 1");
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Tests of the constant time samplers of the empirical and Zipf
+ * random variables.
+ */
+class RandomVariableStreamSamplingTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  RandomVariableStreamSamplingTestSuite ();
+};
+
+RandomVariableStreamSamplingTestSuite::RandomVariableStreamSamplingTestSuite ()
+  : TestSuite ("random-variable-stream-sampling", UNIT)
+{
+  AddTestCase (new EmpiricalAliasTestCase);
+  AddTestCase (new ZipfRejectionInversionTestCase);
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RandomVariableStreamSamplingTestSuite instance variable.
+ */
+static RandomVariableStreamSamplingTestSuite g_randomVariableStreamSamplingTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
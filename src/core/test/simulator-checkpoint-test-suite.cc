@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-checkpoint.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include <fstream>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * SimulatorCheckpoint test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+/**
+ * \ingroup core-tests
+ *
+ * Check that the branches forked from a checkpoint give the results of
+ * the runs which were not forked.
+ *
+ * The simulation is a chain of events at random intervals, which add
+ * random values scaled by a parameter to a checksum.  The parameter
+ * changes at half time, when the simulation is forked into three
+ * branches: two keep the parameter, the third changes it.  The
+ * bulk-send-checkpoint suite of the applications module checks a
+ * network scenario the same way.
+ */
+class SimulatorCheckpointTestCase : public TestCase
+{
+public:
+  SimulatorCheckpointTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the simulation.
+   * \param [in] newScale The parameter of the second half of the simulation.
+   * \param [in] fork Whether to fork at half time, the parameter changing
+   *             in the last branch only.
+   * \returns The checksum of the branch of the process.
+   */
+  double Simulate (double newScale, bool fork);
+  /** Add a random value to the checksum and schedule the next event. */
+  void Step (void);
+  /**
+   * Fork the simulation, or change its parameter.
+   * \param [in] fork Whether to fork.
+   */
+  void HalfTime (bool fork);
+
+  Ptr<UniformRandomVariable> m_random;  //!< The random values
+  double m_scale;                       //!< The parameter of the simulation
+  double m_newScale;                    //!< The parameter of the second half
+  double m_sum;                         //!< The checksum
+  uint32_t m_events;                    //!< The number of events
+};
+
+SimulatorCheckpointTestCase::SimulatorCheckpointTestCase ()
+  : TestCase ("Branches forked from a checkpoint")
+{}
+
+void
+SimulatorCheckpointTestCase::Step (void)
+{
+  m_sum += m_scale * m_random->GetValue ();
+  ++m_events;
+  Simulator::Schedule (Seconds (m_random->GetValue (0, 0.1)),
+                       &SimulatorCheckpointTestCase::Step, this);
+}
+
+void
+SimulatorCheckpointTestCase::HalfTime (bool fork)
+{
+  if (!fork || SimulatorCheckpoint::Fork (3, 2) == 2)
+    {
+      m_scale = m_newScale;
+    }
+}
+
+double
+SimulatorCheckpointTestCase::Simulate (double newScale, bool fork)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  m_scale = 1;
+  m_newScale = newScale;
+  m_sum = 0;
+  m_events = 0;
+  Simulator::Schedule (Seconds (0.05), &SimulatorCheckpointTestCase::Step, this);
+  Simulator::Schedule (Seconds (5), &SimulatorCheckpointTestCase::HalfTime, this, fork);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_random = 0;
+  return m_sum;
+}
+
+void
+SimulatorCheckpointTestCase::DoRun (void)
+{
+  double reference = Simulate (1, false);
+  uint32_t events = m_events;
+  double changed = Simulate (3, false);
+  NS_TEST_ASSERT_MSG_NE (reference, changed, "The parameter has no effect");
+
+  std::string prefix = CreateTempDirFilename ("branch-");
+  double sum = Simulate (3, true);
+  if (SimulatorCheckpoint::GetBranch () != 0)
+    {
+      std::ostringstream name;
+      name << prefix << SimulatorCheckpoint::GetBranch ();
+      std::ofstream file (name.str ().c_str ());
+      file.precision (17);
+      file << sum << " " << m_events << std::endl;
+      SimulatorCheckpoint::EndBranch (file ? 0 : 1);
+    }
+  NS_TEST_ASSERT_MSG_EQ (SimulatorCheckpoint::GetFailedBranches (), 0, "Branches failed");
+  NS_TEST_EXPECT_MSG_EQ (sum, reference, "The checkpoint process differs");
+  NS_TEST_EXPECT_MSG_EQ (m_events, events, "The checkpoint process differs");
+
+  double expected[3] = {reference, reference, changed};
+  for (uint32_t branch = 1; branch < 3; ++branch)
+    {
+      std::ostringstream name;
+      name << prefix << branch;
+      std::ifstream file (name.str ().c_str ());
+      double branchSum = 0;
+      uint32_t branchEvents = 0;
+      file >> branchSum >> branchEvents;
+      NS_TEST_ASSERT_MSG_EQ (bool (file), true, "Missing result of branch " << branch);
+      NS_TEST_EXPECT_MSG_EQ_TOL (branchSum, expected[branch], 1e-12 * expected[branch],
+                                 "Branch " << branch << " differs");
+      NS_TEST_EXPECT_MSG_EQ (branchEvents, events, "Branch " << branch << " differs");
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * SimulatorCheckpoint test suite.
+ */
+class SimulatorCheckpointTestSuite : public TestSuite
+{
+public:
+  SimulatorCheckpointTestSuite ();
+};
+
+SimulatorCheckpointTestSuite::SimulatorCheckpointTestSuite ()
+  : TestSuite ("simulator-checkpoint", UNIT)
+{
+  AddTestCase (new SimulatorCheckpointTestCase, TestCase::QUICK);
+}
+
+static SimulatorCheckpointTestSuite g_simulatorCheckpointTestSuite; //!< Static variable for test initialization
+
+} // namespace tests
+
+} // namespace ns3
@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/simulator-profiler.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include <fstream>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup simulator
+ * SimulatorProfiler test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+/**
+ * \ingroup core-tests
+ *
+ * Check the profile of a run of the DefaultSimulatorImpl, and the
+ * samples and the summary written to the profile file.
+ */
+class SimulatorProfilerRunTestCase : public TestCase
+{
+public:
+  SimulatorProfilerRunTestCase ();
+private:
+  virtual void DoRun (void);
+  /** An event. */
+  void Event (void);
+};
+
+SimulatorProfilerRunTestCase::SimulatorProfilerRunTestCase ()
+  : TestCase ("Profile of a run of the default simulator")
+{}
+
+void
+SimulatorProfilerRunTestCase::Event (void)
+{}
+
+void
+SimulatorProfilerRunTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("profile.json");
+  Ptr<SimulatorImpl> impl = Simulator::GetImplementation ();
+  impl->SetAttribute ("ProfileFile", StringValue (filename));
+  impl->SetAttribute ("ProfileInterval", TimeValue (MilliSeconds (100)));
+
+  // 100 events every 10 ms, then an event after a gap of 1 s
+  for (uint32_t i = 1; i <= 100; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (10 * i), &SimulatorProfilerRunTestCase::Event, this);
+    }
+  Simulator::Schedule (Seconds (2), &SimulatorProfilerRunTestCase::Event, this);
+  Simulator::Run ();
+
+  const SimulatorProfiler &profiler = impl->GetProfiler ();
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetEventCount (), Simulator::GetEventCount (), "Wrong event count");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetEventCount (), 101, "Wrong event count");
+  NS_TEST_EXPECT_MSG_GT (profiler.GetRunTime (), 0, "No run time");
+  NS_TEST_EXPECT_MSG_GT (profiler.GetEventRate (), 0, "No event rate");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetBlockingTime (), 0, "A sequential simulation does not block");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetWindowCount (), 0, "A sequential simulation has no windows");
+  Simulator::Destroy ();
+
+  // A sample at 100 ms, ..., 1 s and at 2 s, then the summary
+  std::ifstream file (filename.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (bool (file), true, "Missing profile file");
+  uint32_t samples = 0;
+  uint32_t summaries = 0;
+  std::string line;
+  std::string last;
+  while (std::getline (file, line))
+    {
+      NS_TEST_EXPECT_MSG_EQ (line[0], '{', "Not a JSON object: " << line);
+      NS_TEST_EXPECT_MSG_EQ (line[line.size () - 1], '}', "Not a JSON object: " << line);
+      if (line.find ("\"type\":\"sample\"") != std::string::npos)
+        {
+          ++samples;
+        }
+      else if (line.find ("\"type\":\"summary\"") != std::string::npos)
+        {
+          ++summaries;
+          last = line;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (samples, 11, "Wrong number of samples");
+  NS_TEST_EXPECT_MSG_EQ (summaries, 1, "Wrong number of summaries");
+  NS_TEST_EXPECT_MSG_NE (last.find ("\"events\":101,"), std::string::npos, "Wrong summary: " << last);
+  NS_TEST_EXPECT_MSG_NE (last.find ("\"time\":2,"), std::string::npos, "Wrong summary: " << last);
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * Check the counters of the windows and of the messages of the
+ * distributed simulators.
+ */
+class SimulatorProfilerCountersTestCase : public TestCase
+{
+public:
+  SimulatorProfilerCountersTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+SimulatorProfilerCountersTestCase::SimulatorProfilerCountersTestCase ()
+  : TestCase ("Counters of the windows and of the messages")
+{}
+
+void
+SimulatorProfilerCountersTestCase::DoRun (void)
+{
+  SimulatorProfiler profiler;
+  profiler.Start (1, 3, Seconds (0));
+  profiler.NotifyWindow (Seconds (0), MilliSeconds (20));
+  profiler.NotifyWindow (MilliSeconds (20), MilliSeconds (30));
+  profiler.NotifyWindow (MilliSeconds (30), MilliSeconds (60));
+  profiler.BeginBlocking ();
+  profiler.EndBlocking ();
+  profiler.NotifyMessageSent (0, 100, 2);
+  profiler.NotifyMessageSent (0, 32, 0);
+  profiler.NotifyMessageSent (2, 64, 1);
+  profiler.NotifyMessageReceived (2, 200, 3);
+  profiler.Stop (MilliSeconds (60), 10);
+
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetWindowCount (), 3, "Wrong number of windows");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetMinWindow (), MilliSeconds (10), "Wrong smallest window");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetMeanWindow (), MilliSeconds (20), "Wrong mean window");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetMaxWindow (), MilliSeconds (30), "Wrong largest window");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (profiler.GetBlockingTime (), 0, "Negative blocking time");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (profiler.GetBlockingTime (), profiler.GetRunTime (), "Blocked longer than the run");
+
+  const std::map<uint32_t, SimulatorProfiler::Neighbor> &neighbors = profiler.GetNeighbors ();
+  NS_TEST_ASSERT_MSG_EQ (neighbors.size (), 2, "Wrong number of neighbors");
+  const SimulatorProfiler::Neighbor &rank0 = neighbors.find (0)->second;
+  NS_TEST_EXPECT_MSG_EQ (rank0.messagesSent, 2, "Wrong number of messages sent");
+  NS_TEST_EXPECT_MSG_EQ (rank0.nullMessagesSent, 1, "Wrong number of null messages sent");
+  NS_TEST_EXPECT_MSG_EQ (rank0.packetsSent, 2, "Wrong number of packets sent");
+  NS_TEST_EXPECT_MSG_EQ (rank0.bytesSent, 132, "Wrong number of bytes sent");
+  NS_TEST_EXPECT_MSG_EQ (rank0.messagesReceived, 0, "Wrong number of messages received");
+  const SimulatorProfiler::Neighbor &rank2 = neighbors.find (2)->second;
+  NS_TEST_EXPECT_MSG_EQ (rank2.messagesSent, 1, "Wrong number of messages sent");
+  NS_TEST_EXPECT_MSG_EQ (rank2.messagesReceived, 1, "Wrong number of messages received");
+  NS_TEST_EXPECT_MSG_EQ (rank2.nullMessagesReceived, 0, "Wrong number of null messages received");
+  NS_TEST_EXPECT_MSG_EQ (rank2.packetsReceived, 3, "Wrong number of packets received");
+  NS_TEST_EXPECT_MSG_EQ (rank2.bytesReceived, 200, "Wrong number of bytes received");
+
+  std::ostringstream oss;
+  profiler.PrintSummary (oss, MilliSeconds (60));
+  std::string summary = oss.str ();
+  NS_TEST_EXPECT_MSG_NE (summary.find ("\"rank\":1,"), std::string::npos, "Wrong summary: " << summary);
+  NS_TEST_EXPECT_MSG_NE (summary.find ("\"windows\":{\"count\":3,\"min\":0.01,\"mean\":0.02,\"max\":0.03}"),
+                         std::string::npos, "Wrong summary: " << summary);
+  NS_TEST_EXPECT_MSG_NE (summary.find ("{\"rank\":2,\"messagesSent\":1,"), std::string::npos,
+                         "Wrong summary: " << summary);
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * SimulatorProfiler test suite.
+ */
+class SimulatorProfilerTestSuite : public TestSuite
+{
+public:
+  SimulatorProfilerTestSuite ();
+};
+
+SimulatorProfilerTestSuite::SimulatorProfilerTestSuite ()
+  : TestSuite ("simulator-profiler", UNIT)
+{
+  AddTestCase (new SimulatorProfilerRunTestCase, TestCase::QUICK);
+  AddTestCase (new SimulatorProfilerCountersTestCase, TestCase::QUICK);
+}
+
+static SimulatorProfilerTestSuite g_simulatorProfilerTestSuite; //!< Static variable for test initialization
+
+} // namespace tests
+
+} // namespace ns3
@@ -19,6 +19,7 @@
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
 #include "ns3/unused.h"
+#include <string>
 
 using namespace ns3;
 
@@ -113,6 +114,125 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class TracedCallbackChainTestCase : public TestCase
+{
+public:
+  TracedCallbackChainTestCase ();
+  virtual ~TracedCallbackChainTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (int a);
+  void CbTwo (int a);
+  void CbThree (int a);
+  static void CbFunction (int a);
+  static void CbContext (std::string context, int a);
+
+  std::string m_calls;
+  static std::string g_functionCalls;
+  static std::string g_contexts;
+};
+
+std::string TracedCallbackChainTestCase::g_functionCalls;
+std::string TracedCallbackChainTestCase::g_contexts;
+
+TracedCallbackChainTestCase::TracedCallbackChainTestCase ()
+  : TestCase ("Check the order, copies and compile time sinks of TracedCallback")
+{}
+
+void
+TracedCallbackChainTestCase::CbOne (int a)
+{
+  m_calls += "1(" + std::to_string (a) + ")";
+}
+
+void
+TracedCallbackChainTestCase::CbTwo (int a)
+{
+  m_calls += "2(" + std::to_string (a) + ")";
+}
+
+void
+TracedCallbackChainTestCase::CbThree (int a)
+{
+  m_calls += "3(" + std::to_string (a) + ")";
+}
+
+void
+TracedCallbackChainTestCase::CbFunction (int a)
+{
+  g_functionCalls += "f(" + std::to_string (a) + ")";
+}
+
+void
+TracedCallbackChainTestCase::CbContext (std::string context, int a)
+{
+  NS_UNUSED (a);
+  g_contexts += context + ";";
+}
+
+void
+TracedCallbackChainTestCase::DoRun (void)
+{
+  TracedCallback<int> trace;
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "New trace not empty");
+  trace (0);
+
+  //
+  // The callbacks are called in the order of their connection, the first
+  // one being stored inline and the next ones in a vector.
+  //
+  trace.ConnectWithoutContext (MakeCallback (&TracedCallbackChainTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), false, "Connected trace empty");
+  trace.ConnectWithoutContext (MakeCallback (&TracedCallbackChainTestCase::CbTwo, this));
+  trace.ConnectWithoutContext<TracedCallbackChainTestCase, &TracedCallbackChainTestCase::CbThree> (this);
+  trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "1(1)2(1)3(1)", "Wrong calls");
+
+  //
+  // A copy has its own chain.
+  //
+  TracedCallback<int> copy = trace;
+  copy.DisconnectWithoutContext (MakeCallback (&TracedCallbackChainTestCase::CbTwo, this));
+  m_calls = "";
+  trace (2);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "1(2)2(2)3(2)", "The copy changed the original chain");
+  m_calls = "";
+  copy (3);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "1(3)3(3)", "Wrong calls of the copy");
+
+  //
+  // Removing the first callback moves the next one inline.
+  //
+  trace.DisconnectWithoutContext (MakeCallback (&TracedCallbackChainTestCase::CbOne, this));
+  trace.ConnectWithoutContext<&TracedCallbackChainTestCase::CbFunction> ();
+  m_calls = "";
+  trace (4);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "2(4)3(4)", "Wrong calls after disconnection");
+  NS_TEST_ASSERT_MSG_EQ (g_functionCalls, "f(4)", "Function not called");
+  trace.DisconnectWithoutContext<TracedCallbackChainTestCase, &TracedCallbackChainTestCase::CbThree> (this);
+  trace.DisconnectWithoutContext<&TracedCallbackChainTestCase::CbFunction> ();
+  m_calls = "";
+  trace (5);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "2(5)", "Compile time sink not disconnected");
+  NS_TEST_ASSERT_MSG_EQ (g_functionCalls, "f(4)", "Function not disconnected");
+  trace.DisconnectWithoutContext (MakeCallback (&TracedCallbackChainTestCase::CbTwo, this));
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "Disconnected trace not empty");
+
+  //
+  // The contexts are bound to the callbacks.
+  //
+  copy = trace;
+  NS_TEST_ASSERT_MSG_EQ (copy.IsEmpty (), true, "Assigned trace not empty");
+  copy.Connect (MakeCallback (&TracedCallbackChainTestCase::CbContext), "a");
+  copy.Connect (MakeCallback (&TracedCallbackChainTestCase::CbContext), "b");
+  copy.Disconnect (MakeCallback (&TracedCallbackChainTestCase::CbContext), "a");
+  copy (6);
+  NS_TEST_ASSERT_MSG_EQ (g_contexts, "b;", "Wrong context");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +243,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new TracedCallbackChainTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/worker-pool.h"
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup thread
+ * WorkerPool test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+NS_LOG_COMPONENT_DEFINE ("WorkerPoolTestSuite");
+
+
+/**
+ * \ingroup core-tests
+ *  Check that every task of every batch runs exactly once.
+ */
+class WorkerPoolTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param nThreads The number of worker threads.
+   */
+  WorkerPoolTestCase (uint32_t nThreads);
+  virtual void DoRun (void);
+  /**
+   * The task: record the index and square it.
+   * \param i The task index.
+   */
+  void Task (uint32_t i);
+
+  uint32_t m_nThreads;           //!< Number of worker threads
+  std::vector<uint32_t> m_runs;  //!< Number of runs of each task
+  std::vector<uint64_t> m_out;   //!< Output of each task
+};
+
+WorkerPoolTestCase::WorkerPoolTestCase (uint32_t nThreads)
+  : TestCase ("Check a batch of tasks with a pool of " + std::to_string (nThreads) + " worker threads"),
+    m_nThreads (nThreads)
+{}
+
+void
+WorkerPoolTestCase::Task (uint32_t i)
+{
+  m_runs[i]++;
+  m_out[i] = static_cast<uint64_t> (i) * i;
+}
+
+void
+WorkerPoolTestCase::DoRun (void)
+{
+  Ptr<WorkerPool> pool = Create<WorkerPool> (m_nThreads);
+  const uint32_t nTasks = 1000;
+  for (uint32_t batch = 0; batch < 20; ++batch)
+    {
+      m_runs.assign (nTasks, 0);
+      m_out.assign (nTasks, 0);
+      pool->Run (nTasks, MakeCallback (&WorkerPoolTestCase::Task, this));
+      for (uint32_t i = 0; i < nTasks; ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_runs[i], 1, "task " << i << " of batch " << batch << " did not run exactly once");
+          NS_TEST_ASSERT_MSG_EQ (m_out[i], static_cast<uint64_t> (i) * i, "wrong output of task " << i);
+        }
+    }
+  // empty batches return immediately
+  pool->Run (0, MakeCallback (&WorkerPoolTestCase::Task, this));
+}
+
+
+/**
+ * \ingroup core-tests
+ *  Check that the log messages are suppressed while a batch runs
+ *  concurrently, and only then.
+ */
+class WorkerPoolLogTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  WorkerPoolLogTestCase ();
+  virtual void DoRun (void);
+  /**
+   * The task: record whether the log messages are enabled.
+   * \param i The task index.
+   */
+  void Task (uint32_t i);
+  /**
+   * Run a batch and check the log state seen by its tasks.
+   * \param pool The pool.
+   * \param nTasks The number of tasks.
+   * \param enabled Whether the tasks must see the log messages enabled.
+   */
+  void Check (Ptr<WorkerPool> pool, uint32_t nTasks, bool enabled);
+
+  std::vector<uint8_t> m_enabled;  //!< Log state seen by each task
+};
+
+WorkerPoolLogTestCase::WorkerPoolLogTestCase ()
+  : TestCase ("Check the suppression of the log messages of the tasks")
+{}
+
+void
+WorkerPoolLogTestCase::Task (uint32_t i)
+{
+  m_enabled[i] = g_log.IsEnabled (LOG_INFO);
+}
+
+void
+WorkerPoolLogTestCase::Check (Ptr<WorkerPool> pool, uint32_t nTasks, bool enabled)
+{
+  m_enabled.assign (nTasks, !enabled);
+  pool->Run (nTasks, MakeCallback (&WorkerPoolLogTestCase::Task, this));
+  for (uint32_t i = 0; i < nTasks; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (static_cast<bool> (m_enabled[i]), enabled,
+                             "wrong log state in task " << i << " of " << nTasks
+                             << " with " << pool->GetNThreads () << " threads");
+    }
+  NS_TEST_ASSERT_MSG_EQ (g_log.IsEnabled (LOG_INFO), true, "log messages not restored after the batch");
+}
+
+void
+WorkerPoolLogTestCase::DoRun (void)
+{
+  LogComponentEnable ("WorkerPoolTestSuite", LOG_LEVEL_INFO);
+  Ptr<WorkerPool> sequential = Create<WorkerPool> (0);
+  Check (sequential, 100, true);
+  Ptr<WorkerPool> pool = Create<WorkerPool> (2);
+  // a single task runs in the calling thread alone
+  Check (pool, 1, true);
+  Check (pool, 100, pool->GetNThreads () == 0);
+  LogComponentDisable ("WorkerPoolTestSuite", LOG_LEVEL_INFO);
+}
+
+
+/**
+ * \ingroup core-tests
+ *  WorkerPool test suite
+ */
+class WorkerPoolTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  WorkerPoolTestSuite ()
+    : TestSuite ("worker-pool")
+  {
+    AddTestCase (new WorkerPoolTestCase (0));
+    AddTestCase (new WorkerPoolTestCase (1));
+    AddTestCase (new WorkerPoolTestCase (4));
+    AddTestCase (new WorkerPoolLogTestCase);
+  }
+};
+
+/**
+ * \ingroup core-tests
+ * WorkerPoolTestSuite instance variable.
+ */
+static WorkerPoolTestSuite g_workerPoolTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
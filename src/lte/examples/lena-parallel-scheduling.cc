@@ -0,0 +1,189 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/config-store.h"
+
+#include <cmath>
+#include <iostream>
+
+using namespace ns3;
+
+/*
+ * Multi-cell MAC scheduler benchmark.
+ *
+ * A grid of eNBs, each serving a number of UEs with saturated (RLC SM)
+ * downlink and uplink bearers, so that the FF MAC schedulers have work to
+ * do in every TTI. The wall-clock time of the run is reported, together
+ * with a digest of the scheduling decisions, which must be the same for
+ * any value of --threads when --parallel is used. For instance:
+ *
+ * ./waf --run "lena-parallel-scheduling --nEnb=200 --parallel=0"
+ * ./waf --run "lena-parallel-scheduling --nEnb=200 --parallel=1 --threads=7"
+ */
+
+/// number of TBs scheduled
+static uint64_t g_nTb = 0;
+/// digest of the scheduling decisions
+static uint64_t g_digest = 0;
+
+/**
+ * Add a value to the scheduling digest.
+ *
+ * \param v the value
+ */
+static void
+Digest (uint64_t v)
+{
+  g_digest = g_digest * 1099511628211ULL + v;
+}
+
+/**
+ * DL scheduling trace sink.
+ *
+ * \param path the trace context
+ * \param info the DL scheduling info
+ */
+static void
+DlScheduling (std::string path, DlSchedulingCallbackInfo info)
+{
+  ++g_nTb;
+  Digest (info.frameNo * 10 + info.subframeNo);
+  Digest (info.rnti);
+  Digest (info.mcsTb1);
+  Digest (info.sizeTb1);
+}
+
+/**
+ * UL scheduling trace sink.
+ *
+ * \param path the trace context
+ * \param frameNo the frame number
+ * \param subframeNo the subframe number
+ * \param rnti the RNTI
+ * \param mcs the MCS
+ * \param size the TB size
+ * \param componentCarrierId the component carrier ID
+ */
+static void
+UlScheduling (std::string path, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+              uint8_t mcs, uint16_t size, uint8_t componentCarrierId)
+{
+  ++g_nTb;
+  Digest (frameNo * 10 + subframeNo);
+  Digest (rnti);
+  Digest (mcs);
+  Digest (size);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nEnb = 16;
+  uint32_t nUePerEnb = 10;
+  double simTime = 0.5;
+  bool parallel = true;
+  uint32_t threads = WorkerPool::GetHardwareConcurrency () - 1;
+  std::string scheduler = "ns3::PfFfMacScheduler";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nEnb", "Number of eNBs", nEnb);
+  cmd.AddValue ("nUePerEnb", "Number of UEs per eNB", nUePerEnb);
+  cmd.AddValue ("simTime", "Simulated time (in seconds)", simTime);
+  cmd.AddValue ("parallel", "Enable the parallel scheduling mode of the eNB MACs", parallel);
+  cmd.AddValue ("threads", "Number of scheduler worker threads in parallel mode", threads);
+  cmd.AddValue ("scheduler", "Type of the FF MAC scheduler", scheduler);
+  cmd.Parse (argc, argv);
+
+  ConfigStore inputConfig;
+  inputConfig.ConfigureDefaults ();
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::LteEnbMac::ParallelScheduling", BooleanValue (parallel));
+  Config::SetDefault ("ns3::LteEnbRrc::EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_SM_ALWAYS));
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  Config::SetGlobal ("LteMacSchedulerThreads", UintegerValue (threads));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetSchedulerType (scheduler);
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (nEnb);
+  ueNodes.Create (nEnb * nUePerEnb);
+
+  // eNBs on a square grid, the UEs of each eNB around it
+  uint32_t gridWidth = std::ceil (std::sqrt (nEnb));
+  double interSiteDistance = 500.0;
+  Ptr<ListPositionAllocator> enbPositions = CreateObject<ListPositionAllocator> ();
+  Ptr<ListPositionAllocator> uePositions = CreateObject<ListPositionAllocator> ();
+  Ptr<UniformRandomVariable> offset = CreateObject<UniformRandomVariable> ();
+  offset->SetAttribute ("Min", DoubleValue (-interSiteDistance / 3));
+  offset->SetAttribute ("Max", DoubleValue (interSiteDistance / 3));
+  for (uint32_t i = 0; i < nEnb; ++i)
+    {
+      Vector enb ((i % gridWidth) * interSiteDistance, (i / gridWidth) * interSiteDistance, 30.0);
+      enbPositions->Add (enb);
+      for (uint32_t j = 0; j < nUePerEnb; ++j)
+        {
+          uePositions->Add (Vector (enb.x + offset->GetValue (), enb.y + offset->GetValue (), 1.5));
+        }
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositions);
+  mobility.Install (enbNodes);
+  mobility.SetPositionAllocator (uePositions);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  for (uint32_t i = 0; i < ueDevs.GetN (); ++i)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i / nUePerEnb));
+    }
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  lteHelper->AssignStreams (ueDevs, stream);
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/DlScheduling",
+                   MakeCallback (&DlScheduling));
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/UlScheduling",
+                   MakeCallback (&UlScheduling));
+
+  int64_t setupMs = clock.End ();
+  clock.Start ();
+  Simulator::Stop (Seconds (simTime));
+  Simulator::Run ();
+  int64_t runMs = clock.End ();
+  Simulator::Destroy ();
+
+  std::cout << "cells " << nEnb << " ues " << nEnb * nUePerEnb
+            << " parallel " << parallel << " threads " << (parallel ? threads : 0)
+            << " setup-ms " << setupMs << " run-ms " << runMs
+            << " tbs " << g_nTb << " digest " << std::hex << g_digest << std::dec
+            << std::endl;
+  return 0;
+}
@@ -291,7 +291,10 @@ EpcEnbApplication::RecvFromLteSocket (Ptr<Socket> socket)
       std::map<uint8_t, uint32_t>::iterator bidIt = rntiIt->second.find (bid);
       NS_ASSERT (bidIt != rntiIt->second.end ());
       uint32_t teid = bidIt->second;
-      m_rxLteSocketPktTrace (packet->Copy ());
+      if (!m_rxLteSocketPktTrace.IsEmpty ())
+        {
+          m_rxLteSocketPktTrace (packet->Copy ());
+        }
       SendToS1uSocket (packet, teid);
     }
 }
@@ -312,7 +315,10 @@ EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
     }
   else
     {
-      m_rxS1uSocketPktTrace (packet->Copy ());
+      if (!m_rxS1uSocketPktTrace.IsEmpty ())
+        {
+          m_rxS1uSocketPktTrace (packet->Copy ());
+        }
       SendToLteSocket (packet, it->second.m_rnti, it->second.m_bid);
     }
 }
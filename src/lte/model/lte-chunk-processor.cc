@@ -63,7 +63,13 @@ LteChunkProcessor::EvaluateChunk (const SpectrumValue& sinr, Time duration)
     {
       m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
     }
-  (*m_sumValues) += sinr * duration.GetSeconds ();
+  // accumulate in place, without allocating a temporary SpectrumValue
+  double seconds = duration.GetSeconds ();
+  Values::iterator sumIt = m_sumValues->ValuesBegin ();
+  for (Values::const_iterator it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); ++it, ++sumIt)
+    {
+      *sumIt += (*it) * seconds;
+    }
   m_totDuration += duration;
 }
 
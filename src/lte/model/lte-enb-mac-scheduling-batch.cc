@@ -0,0 +1,117 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-enb-mac-scheduling-batch.h"
+#include "lte-enb-mac.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/simulation-singleton.h>
+#include <ns3/global-value.h>
+#include <ns3/uinteger.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteEnbMacSchedulingBatch");
+
+/**
+ * \ingroup lte
+ * Number of worker threads used by LteEnbMacSchedulingBatch.
+ */
+static GlobalValue g_lteMacSchedulerThreads = GlobalValue ("LteMacSchedulerThreads",
+                                                           "Number of worker threads running the schedulers of the "
+                                                           "LteEnbMac instances with ParallelScheduling enabled, in "
+                                                           "addition to the simulation thread",
+                                                           UintegerValue (0),
+                                                           MakeUintegerChecker<uint32_t> ());
+
+LteEnbMacSchedulingBatch::LteEnbMacSchedulingBatch ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteEnbMacSchedulingBatch::~LteEnbMacSchedulingBatch ()
+{
+  NS_LOG_FUNCTION (this);
+  m_pending.clear ();
+  m_running.clear ();
+  m_pool = 0;
+}
+
+void
+LteEnbMacSchedulingBatch::Add (Ptr<LteEnbMac> mac)
+{
+  SimulationSingleton<LteEnbMacSchedulingBatch>::Get ()->DoAdd (mac);
+}
+
+void
+LteEnbMacSchedulingBatch::DoAdd (Ptr<LteEnbMac> mac)
+{
+  NS_LOG_FUNCTION (this << mac);
+  if (m_pending.empty ())
+    {
+      Simulator::ScheduleNow (&LteEnbMacSchedulingBatch::Execute, this);
+    }
+  m_pending.push_back (mac);
+}
+
+void
+LteEnbMacSchedulingBatch::Execute ()
+{
+  NS_LOG_FUNCTION (this << m_pending.size ());
+  if (m_pool == 0)
+    {
+      UintegerValue nThreads;
+      g_lteMacSchedulerThreads.GetValue (nThreads);
+      m_pool = Create<WorkerPool> (nThreads.Get ());
+    }
+  NS_ASSERT (m_running.empty ());
+  m_running.swap (m_pending);
+  uint32_t n = m_running.size ();
+
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m_running[i]->PrepareDlScheduling ();
+      m_running[i]->HoldSchedIndications ();
+    }
+  m_pool->Run (n, MakeCallback (&LteEnbMacSchedulingBatch::TriggerDl, this));
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m_running[i]->ReleaseSchedIndications ();
+      m_running[i]->PrepareUlScheduling ();
+      m_running[i]->HoldSchedIndications ();
+    }
+  m_pool->Run (n, MakeCallback (&LteEnbMacSchedulingBatch::TriggerUl, this));
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m_running[i]->ReleaseSchedIndications ();
+    }
+  m_running.clear ();
+}
+
+void
+LteEnbMacSchedulingBatch::TriggerDl (uint32_t i)
+{
+  m_running[i]->TriggerDlScheduling ();
+}
+
+void
+LteEnbMacSchedulingBatch::TriggerUl (uint32_t i)
+{
+  m_running[i]->TriggerUlScheduling ();
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_ENB_MAC_SCHEDULING_BATCH_H
+#define LTE_ENB_MAC_SCHEDULING_BATCH_H
+
+#include <ns3/ptr.h>
+#include <ns3/worker-pool.h>
+
+#include <vector>
+
+namespace ns3 {
+
+class LteEnbMac;
+
+/**
+ * \ingroup lte
+ *
+ * Runs the FF MAC schedulers of all the LteEnbMac instances with the
+ * ParallelScheduling attribute set, for a given subframe, on a pool of
+ * worker threads.
+ *
+ * The schedulers of different cells do not share any state within a
+ * TTI, hence the batch executes, at the time of the subframe:
+ *  -# for every cell, in the order the cells started the subframe, the
+ *     forwarding of the DL feedback (CQI, RACH) to the scheduler;
+ *  -# the SchedDlTriggerReq of all the cells, in parallel, with the
+ *     scheduler indications kept aside by the MAC;
+ *  -# for every cell, in order, the processing of the DL indications and
+ *     the forwarding of the UL feedback (CQI, BSR) to the scheduler;
+ *  -# the SchedUlTriggerReq of all the cells, in parallel;
+ *  -# for every cell, in order, the processing of the UL indications.
+ *
+ * The sequence of calls seen by each scheduler and by each MAC is thus
+ * the same as in the sequential mode and does not depend on the number
+ * of threads. The batch runs in an event scheduled for the same time as
+ * the subframe indications, after the other events already scheduled for
+ * that time.
+ *
+ * The number of worker threads is given by the LteMacSchedulerThreads
+ * global value. When it is more than zero, the log messages of the
+ * trigger requests run in parallel, in the MAC and in the schedulers, are
+ * suppressed (see WorkerPool).
+ */
+class LteEnbMacSchedulingBatch
+{
+public:
+  LteEnbMacSchedulingBatch ();
+  ~LteEnbMacSchedulingBatch ();
+
+  /**
+   * Add a MAC to the batch of the current subframe; the first MAC added
+   * for a given time schedules the execution of the batch.
+   *
+   * \param mac the MAC
+   */
+  static void Add (Ptr<LteEnbMac> mac);
+
+private:
+  /**
+   * Add a MAC to the batch of the current subframe
+   *
+   * \param mac the MAC
+   */
+  void DoAdd (Ptr<LteEnbMac> mac);
+  /// Run the schedulers of all the MACs of the batch
+  void Execute ();
+  /**
+   * Worker pool task: run the DL scheduler of a MAC
+   *
+   * \param i index of the MAC in m_running
+   */
+  void TriggerDl (uint32_t i);
+  /**
+   * Worker pool task: run the UL scheduler of a MAC
+   *
+   * \param i index of the MAC in m_running
+   */
+  void TriggerUl (uint32_t i);
+
+  std::vector<Ptr<LteEnbMac> > m_pending; ///< MACs waiting for the batch
+  std::vector<Ptr<LteEnbMac> > m_running; ///< MACs of the batch being executed
+  Ptr<WorkerPool> m_pool; ///< the worker threads, created on first use
+};
+
+} // namespace ns3
+
+#endif /* LTE_ENB_MAC_SCHEDULING_BATCH_H */
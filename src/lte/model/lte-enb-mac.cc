@@ -40,6 +40,8 @@
 #include "ns3/lte-mac-sap.h"
 #include "ns3/lte-enb-cmac-sap.h"
 #include <ns3/lte-common.h>
+#include <ns3/boolean.h>
+#include "lte-enb-mac-scheduling-batch.h"
 
 
 namespace ns3 {
@@ -373,6 +375,15 @@ LteEnbMac::GetTypeId (void)
                    UintegerValue (0),
                    MakeUintegerAccessor (&LteEnbMac::m_componentCarrierId),
                    MakeUintegerChecker<uint8_t> (0,4))
+    .AddAttribute ("ParallelScheduling",
+                   "If true, the scheduler of this MAC is triggered together with the schedulers "
+                   "of the other MACs using this mode in the same subframe, and the DL and UL "
+                   "trigger requests of all these cells run on a pool of worker threads "
+                   "(see the LteMacSchedulerThreads global value). The scheduler results are "
+                   "delivered in a deterministic order, independent of the number of threads.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteEnbMac::m_parallelScheduling),
+                   MakeBooleanChecker ())
   ;
 
   return tid;
@@ -380,7 +391,9 @@ LteEnbMac::GetTypeId (void)
 
 
 LteEnbMac::LteEnbMac ():
-m_ccmMacSapUser (0)
+m_ccmMacSapUser (0),
+m_parallelScheduling (false),
+m_holdSchedIndications (false)
 {
   NS_LOG_FUNCTION (this);
   m_macSapProvider = new EnbMacMemberLteMacSapProvider<LteEnbMac> (this);
@@ -407,6 +420,8 @@ LteEnbMac::DoDispose ()
   m_dlInfoListReceived.clear ();
   m_ulInfoListReceived.clear ();
   m_miDlHarqProcessesPackets.clear ();
+  m_heldDlConfigInd.clear ();
+  m_heldUlConfigInd.clear ();
   delete m_macSapProvider;
   delete m_cmacSapProvider;
   delete m_schedSapUser;
@@ -506,6 +521,26 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   m_frameNo = frameNo;
   m_subframeNo = subframeNo;
 
+  if (m_parallelScheduling)
+    {
+      // the scheduler will be triggered by the batch, together with
+      // the other cells of this subframe
+      LteEnbMacSchedulingBatch::Add (this);
+      return;
+    }
+
+  PrepareDlScheduling ();
+  TriggerDlScheduling ();
+  PrepareUlScheduling ();
+  TriggerUlScheduling ();
+}
+
+void
+LteEnbMac::PrepareDlScheduling ()
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t frameNo = m_frameNo;
+  uint32_t subframeNo = m_subframeNo;
 
   // --- DOWNLINK ---
   // Send Dl-CQI info to the scheduler
@@ -574,8 +609,9 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     {
       dlSchedSubframeNo = dlSchedSubframeNo + m_macChTtiDelay;
     }
-  FfMacSchedSapProvider::SchedDlTriggerReqParameters dlparams;
+  FfMacSchedSapProvider::SchedDlTriggerReqParameters& dlparams = m_dlTriggerReq;
   dlparams.m_sfnSf = ((0x3FF & dlSchedFrameNo) << 4) | (0xF & dlSchedSubframeNo);
+  dlparams.m_dlInfoList.clear ();
 
   // Forward DL HARQ feebacks collected during last TTI
   if (m_dlInfoListReceived.size () > 0)
@@ -584,9 +620,21 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
       // empty local buffer
       m_dlInfoListReceived.clear ();
     }
+}
 
-  m_schedSapProvider->SchedDlTriggerReq (dlparams);
+void
+LteEnbMac::TriggerDlScheduling ()
+{
+  NS_LOG_FUNCTION (this);
+  m_schedSapProvider->SchedDlTriggerReq (m_dlTriggerReq);
+}
 
+void
+LteEnbMac::PrepareUlScheduling ()
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t frameNo = m_frameNo;
+  uint32_t subframeNo = m_subframeNo;
 
   // --- UPLINK ---
   // Send UL-CQI info to the scheduler
@@ -628,8 +676,9 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     {
       ulSchedSubframeNo = ulSchedSubframeNo + (m_macChTtiDelay + UL_PUSCH_TTIS_DELAY);
     }
-  FfMacSchedSapProvider::SchedUlTriggerReqParameters ulparams;
+  FfMacSchedSapProvider::SchedUlTriggerReqParameters& ulparams = m_ulTriggerReq;
   ulparams.m_sfnSf = ((0x3FF & ulSchedFrameNo) << 4) | (0xF & ulSchedSubframeNo);
+  ulparams.m_ulInfoList.clear ();
 
   // Forward DL HARQ feebacks collected during last TTI
   if (m_ulInfoListReceived.size () > 0)
@@ -638,9 +687,39 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
       // empty local buffer
       m_ulInfoListReceived.clear ();
     }
+}
 
-  m_schedSapProvider->SchedUlTriggerReq (ulparams);
+void
+LteEnbMac::TriggerUlScheduling ()
+{
+  NS_LOG_FUNCTION (this);
+  m_schedSapProvider->SchedUlTriggerReq (m_ulTriggerReq);
+}
 
+void
+LteEnbMac::HoldSchedIndications ()
+{
+  NS_LOG_FUNCTION (this);
+  m_holdSchedIndications = true;
+}
+
+void
+LteEnbMac::ReleaseSchedIndications ()
+{
+  NS_LOG_FUNCTION (this);
+  m_holdSchedIndications = false;
+  std::vector<FfMacSchedSapUser::SchedDlConfigIndParameters> dlInd;
+  dlInd.swap (m_heldDlConfigInd);
+  for (std::vector<FfMacSchedSapUser::SchedDlConfigIndParameters>::const_iterator it = dlInd.begin (); it != dlInd.end (); ++it)
+    {
+      DoSchedDlConfigInd (*it);
+    }
+  std::vector<FfMacSchedSapUser::SchedUlConfigIndParameters> ulInd;
+  ulInd.swap (m_heldUlConfigInd);
+  for (std::vector<FfMacSchedSapUser::SchedUlConfigIndParameters>::const_iterator it = ulInd.begin (); it != ulInd.end (); ++it)
+    {
+      DoSchedUlConfigInd (*it);
+    }
 }
 
 
@@ -1084,6 +1163,12 @@ void
 LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (m_holdSchedIndications)
+    {
+      // called by a worker thread: keep the result for the simulation thread
+      m_heldDlConfigInd.push_back (ind);
+      return;
+    }
   // Create DL PHY PDU
   Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
@@ -1226,6 +1311,12 @@ void
 LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (m_holdSchedIndications)
+    {
+      // called by a worker thread: keep the result for the simulation thread
+      m_heldUlConfigInd.push_back (ind);
+      return;
+    }
 
   for (unsigned int i = 0; i < ind.m_dciList.size (); i++)
     {
@@ -66,6 +66,8 @@ class LteEnbMac :   public Object
   friend class EnbMacMemberLteEnbPhySapUser;
   /// allow MemberLteCcmMacSapProvider<LteEnbMac> class friend access
   friend class MemberLteCcmMacSapProvider<LteEnbMac>;
+  /// allow LteEnbMacSchedulingBatch class friend access
+  friend class LteEnbMacSchedulingBatch;
 
 public:
   /**
@@ -331,6 +333,41 @@ private:
   * \param subframeNo subframe number
   */
   void DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo);
+
+  /**
+  * \brief Forward the DL feedback received since the last subframe to the
+  * scheduler and build the DL trigger request of the current subframe
+  */
+  void PrepareDlScheduling ();
+  /**
+  * \brief Send the DL trigger request built by PrepareDlScheduling to the
+  * scheduler
+  *
+  * In parallel scheduling mode this runs on a worker thread.
+  */
+  void TriggerDlScheduling ();
+  /**
+  * \brief Forward the UL feedback received since the last subframe to the
+  * scheduler and build the UL trigger request of the current subframe
+  */
+  void PrepareUlScheduling ();
+  /**
+  * \brief Send the UL trigger request built by PrepareUlScheduling to the
+  * scheduler
+  *
+  * In parallel scheduling mode this runs on a worker thread.
+  */
+  void TriggerUlScheduling ();
+  /**
+  * \brief Store the scheduler indications instead of processing them,
+  * until ReleaseSchedIndications is called
+  */
+  void HoldSchedIndications ();
+  /**
+  * \brief Process the scheduler indications stored since
+  * HoldSchedIndications was called, in the order they were received
+  */
+  void ReleaseSchedIndications ();
   /**
   * \brief Receive RACH Preamble function
   * \param prachId PRACH ID number
@@ -466,6 +503,15 @@ private:
 
   /// component carrier Id used to address sap
   uint8_t m_componentCarrierId;
+
+  /// true if the scheduler is triggered by LteEnbMacSchedulingBatch
+  bool m_parallelScheduling;
+  /// true if the scheduler indications have to be stored instead of processed
+  bool m_holdSchedIndications;
+  std::vector<FfMacSchedSapUser::SchedDlConfigIndParameters> m_heldDlConfigInd; ///< stored DL scheduler indications
+  std::vector<FfMacSchedSapUser::SchedUlConfigIndParameters> m_heldUlConfigInd; ///< stored UL scheduler indications
+  FfMacSchedSapProvider::SchedDlTriggerReqParameters m_dlTriggerReq; ///< DL trigger request of the current subframe
+  FfMacSchedSapProvider::SchedUlTriggerReqParameters m_ulTriggerReq; ///< UL trigger request of the current subframe
  
 };
 
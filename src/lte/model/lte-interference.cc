@@ -53,6 +53,8 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_interf = 0;
+  m_sinr = 0;
   Object::DoDispose ();
 } 
 
@@ -78,6 +80,7 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
       m_rxSignal = rxPsd->Copy ();
       m_lastChangeTime = Now ();
       m_receiving = true;
+      MarkAllRbsChanged ();
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
           (*it)->Start ();
@@ -99,6 +102,7 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
       // make sure they use orthogonal resource blocks
       NS_ASSERT (Sum ((*rxPsd) * (*m_rxSignal)) == 0.0);
       (*m_rxSignal) += (*rxPsd);
+      MarkChangedRbs (*rxPsd);
     }
 }
 
@@ -156,6 +160,7 @@ LteInterference::DoAddSignal (Ptr<const SpectrumValue> spd)
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
   (*m_allSignals) += (*spd);
+  MarkChangedRbs (*spd);
 }
 
 void
@@ -167,6 +172,7 @@ LteInterference::DoSubtractSignal (Ptr<const SpectrumValue> spd, uint32_t signal
   if (deltaSignalId > 0)
     {   
       (*m_allSignals) -= (*spd);
+      MarkChangedRbs (*spd);
     }
   else
     {
@@ -175,6 +181,68 @@ LteInterference::DoSubtractSignal (Ptr<const SpectrumValue> spd, uint32_t signal
 }
 
 
+void
+LteInterference::MarkChangedRbs (const SpectrumValue& spd)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_allRbsChanged)
+    {
+      return;
+    }
+  // only the RBs actually covered by the signal need to be recomputed
+  uint32_t rb = 0;
+  for (Values::const_iterator it = spd.ConstValuesBegin (); it != spd.ConstValuesEnd (); ++it, ++rb)
+    {
+      if ((*it != 0.0) && !m_rbChanged[rb])
+        {
+          m_rbChanged[rb] = true;
+          m_changedRbs.push_back (rb);
+        }
+    }
+}
+
+void
+LteInterference::MarkAllRbsChanged ()
+{
+  NS_LOG_FUNCTION (this);
+  m_allRbsChanged = true;
+}
+
+void
+LteInterference::UpdateChangedRbs ()
+{
+  NS_LOG_FUNCTION (this);
+  const SpectrumValue& allSignals = *m_allSignals;
+  const SpectrumValue& rxSignal = *m_rxSignal;
+  const SpectrumValue& noise = *m_noise;
+  SpectrumValue& interf = *m_interf;
+  SpectrumValue& sinr = *m_sinr;
+  if (m_allRbsChanged)
+    {
+      uint32_t n = interf.GetValuesN ();
+      for (uint32_t rb = 0; rb < n; ++rb)
+        {
+          interf[rb] = allSignals[rb] - rxSignal[rb] + noise[rb];
+          sinr[rb] = rxSignal[rb] / interf[rb];
+        }
+      m_allRbsChanged = false;
+    }
+  else
+    {
+      for (std::vector<uint32_t>::const_iterator it = m_changedRbs.begin (); it != m_changedRbs.end (); ++it)
+        {
+          uint32_t rb = *it;
+          interf[rb] = allSignals[rb] - rxSignal[rb] + noise[rb];
+          sinr[rb] = rxSignal[rb] / interf[rb];
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator it = m_changedRbs.begin (); it != m_changedRbs.end (); ++it)
+    {
+      m_rbChanged[*it] = false;
+    }
+  m_changedRbs.clear ();
+}
+
 void
 LteInterference::ConditionallyEvaluateChunk ()
 {
@@ -188,9 +256,9 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      UpdateChangedRbs ();
+      const SpectrumValue& interf = *m_interf;
+      const SpectrumValue& sinr = *m_sinr;
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
@@ -217,6 +285,12 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_interf = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_changedRbs.clear ();
+  m_changedRbs.reserve (noisePsd->GetValuesN ());
+  m_rbChanged.assign (noisePsd->GetValuesN (), false);
+  MarkAllRbsChanged ();
   if (m_receiving == true)
     {
       // abort rx
@@ -28,6 +28,7 @@
 #include <ns3/spectrum-value.h>
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -128,6 +129,22 @@ protected:
    * @param signalId the signal ID
    */
   virtual void DoSubtractSignal (Ptr<const SpectrumValue> spd, uint32_t signalId);
+  /**
+   * Mark the RBs occupied by the given signal as changed, so that their
+   * interference and SINR are recomputed at the next chunk evaluation
+   *
+   * @param spd the power spectral density of the signal
+   */
+  void MarkChangedRbs (const SpectrumValue& spd);
+  /**
+   * Mark all the RBs as changed
+   */
+  void MarkAllRbsChanged ();
+  /**
+   * Update m_interf and m_sinr for the RBs changed since the last chunk
+   * evaluation
+   */
+  void UpdateChangedRbs ();
 
   bool m_receiving {false}; ///< are we receiving?
 
@@ -143,6 +160,21 @@ protected:
 
   Ptr<const SpectrumValue> m_noise {nullptr}; ///< the noise value
 
+  Ptr<SpectrumValue> m_interf {nullptr}; /**< interference plus noise of the
+                                          * current chunk; reused across
+                                          * chunks and updated only for the
+                                          * changed RBs
+                                          */
+
+  Ptr<SpectrumValue> m_sinr {nullptr}; /**< SINR of the current chunk; reused
+                                        * across chunks and updated only for
+                                        * the changed RBs
+                                        */
+
+  std::vector<uint32_t> m_changedRbs; ///< RBs changed since the last chunk evaluation
+  std::vector<bool> m_rbChanged; ///< per-RB flag, true if the RB is in m_changedRbs
+  bool m_allRbsChanged {true}; ///< true if all the RBs have to be recomputed
+
   Time m_lastChangeTime {Seconds(0)}; /**< the time of the last change in
                                        * m_TotalPower
                                        */
@@ -331,86 +331,145 @@ static const double cEcrTable [9][38] = {
 };
 
 
+/**
+ * Description of one of the uniformly spaced SINR -> MI maps. Since the
+ * axis values are uniformly spaced, the index of a SINR value is
+ * ((sinrLin - axis[0]) / (axis[SIZE-1] - axis[0])) * (SIZE-1), so the
+ * lookup reduces to a multiply-add and a floor.
+ */
+struct MiMap
+{
+  const double *mi;     ///< MI values
+  uint16_t size;        ///< number of entries
+  double axisMin;       ///< first SINR value of the axis
+  double axisMax;       ///< last SINR value of the axis
+  double scalingCoeff;  ///< (SIZE-1) / (axisMax - axisMin)
+};
+
+/**
+ * \brief build the descriptor of a SINR -> MI map
+ * \param mi the MI values
+ * \param axis the (uniformly spaced) SINR axis
+ * \param size the number of entries of both arrays
+ * \return the descriptor
+ */
+static MiMap
+MakeMiMap (const double *mi, const double *axis, uint16_t size)
+{
+  MiMap m;
+  m.mi = mi;
+  m.size = size;
+  m.axisMin = axis[0];
+  m.axisMax = axis[size - 1];
+  m.scalingCoeff = (size - 1) / (axis[size - 1] - axis[0]);
+  return m;
+}
+
+/**
+ * \brief get the SINR -> MI map of the modulation used by the given MCS
+ * \param mcs the MCS
+ * \return the descriptor of the map
+ */
+static const MiMap&
+GetMiMap (uint8_t mcs)
+{
+  static const MiMap qpsk = MakeMiMap (MI_map_qpsk, MI_map_qpsk_axis, MI_MAP_QPSK_SIZE);
+  static const MiMap qam16 = MakeMiMap (MI_map_16qam, MI_map_16qam_axis, MI_MAP_16QAM_SIZE);
+  static const MiMap qam64 = MakeMiMap (MI_map_64qam, MI_map_64qam_axis, MI_MAP_64QAM_SIZE);
+  if (mcs <= MI_QPSK_MAX_ID)
+    {
+      return qpsk;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID)
+    {
+      return qam16;
+    }
+  return qam64;
+}
+
+/**
+ * \brief map a linear SINR value to its MI
+ * \param m the SINR -> MI map
+ * \param sinrLin the SINR (linear)
+ * \return the MI
+ */
+static inline double
+LookupMi (const MiMap& m, double sinrLin)
+{
+  if (sinrLin > m.axisMax)
+    {
+      return 1;
+    }
+  double sinrIndexDouble = (sinrLin - m.axisMin) * m.scalingCoeff + 1;
+  uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
+  NS_ASSERT_MSG (sinrIndex < m.size, "MI map out of data");
+  return m.mi[sinrIndex];
+}
+
+/**
+ * Coefficients of the BLER curves (see MappingMiBler) resolved once for
+ * every (CB size curve, ECR) pair, including the fallback to the next
+ * larger CB size curve when no curve is available for a given ECR.
+ */
+struct BlerCurveCoeffs
+{
+  BlerCurveCoeffs ()
+  {
+    for (int cbIndex = 0; cbIndex < 9; cbIndex++)
+      {
+        for (int ecrId = 0; ecrId <= MI_64QAM_BLER_MAX_ID; ecrId++)
+          {
+            // take the lowest CB size including this CB for removing CB size
+            // quatization errors
+            double b = bEcrTable[cbIndex][ecrId];
+            for (int i = cbIndex; (i < 9) && (b < 0); i++)
+              {
+                b = bEcrTable[i][ecrId];
+              }
+            double c = cEcrTable[cbIndex][ecrId];
+            for (int i = cbIndex; (i < 9) && (c < 0); i++)
+              {
+                c = cEcrTable[i][ecrId];
+              }
+            m_b[cbIndex][ecrId] = b;
+            m_c[cbIndex][ecrId] = c;
+            m_invSqrt2c[cbIndex][ecrId] = 1.0 / (std::sqrt (2.0) * c);
+          }
+      }
+  }
+  double m_b[9][MI_64QAM_BLER_MAX_ID + 1];          ///< resolved b coefficients
+  double m_c[9][MI_64QAM_BLER_MAX_ID + 1];          ///< resolved c coefficients
+  double m_invSqrt2c[9][MI_64QAM_BLER_MAX_ID + 1];  ///< 1 / (sqrt(2) * c)
+};
+
+/**
+ * \return the BLER curve coefficients, built on first use
+ */
+static const BlerCurveCoeffs&
+GetBlerCurveCoeffs ()
+{
+  static const BlerCurveCoeffs coeffs;
+  return coeffs;
+}
+
+
 double 
 LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
-  
-  double MI;
+
+  // the modulation is the same for all the RBs of the TB, hence the map
+  // is selected once and the loop only does the indexed lookups
+  const MiMap& miMap = GetMiMap (mcs);
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  
-  for (uint32_t i = 0; i < map.size (); i++)
+  for (std::vector<int>::const_iterator it = map.begin (); it != map.end (); ++it)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
-        {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-            {
-              MI = 1;
-            }
-          else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
-        }
-      else
-        {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
-        }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
+      double sinrLin = sinr[*it];
+      double MI = LookupMi (miMap, sinrLin);
+      NS_LOG_LOGIC (" RB " << *it << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
       MIsum += MI;
     }
-  MI = MIsum / map.size ();
+  double MI = MIsum / map.size ();
   NS_LOG_LOGIC (" MI = " << MI);
   return MI;
 }
@@ -420,8 +479,6 @@ double
 LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
 {
   NS_LOG_FUNCTION (mib << (uint32_t) ecrId << (uint32_t) cbSize);
-  double b = 0;
-  double c = 0;
 
   NS_ASSERT_MSG (ecrId <= MI_64QAM_BLER_MAX_ID, "ECR out of range [0..37]: " << (uint16_t) ecrId);
   int cbIndex = 1;
@@ -432,30 +489,11 @@ LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
   cbIndex--;
   NS_LOG_LOGIC (" ECRid " << (uint16_t)ecrId << " ECR " << BlerCurvesEcrMap[ecrId] << " CB size " << cbSize << " CB size curve " << cbMiSizeTable[cbIndex]);
 
-  b = bEcrTable[cbIndex][ecrId];
-  if (b<0.0)
-    {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(b<0))
-        {
-          b = bEcrTable[i++][ecrId];
-        }
-    }
-  c = cEcrTable[cbIndex][ecrId];
-  if (c<0.0)
-    {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(c<0))
-        {
-          c = cEcrTable[i++][ecrId];
-        }
-    }
+  const BlerCurveCoeffs& coeffs = GetBlerCurveCoeffs ();
+  double b = coeffs.m_b[cbIndex][ecrId];
+  double c = coeffs.m_c[cbIndex][ecrId];
   // see IEEE802.16m EMD formula 55 of section 4.3.2.1
-  double bler = 0.5*( 1 - erf((mib-b)/(sqrt(2)*c)) );
+  double bler = 0.5*( 1 - erf((mib-b) * coeffs.m_invSqrt2c[cbIndex][ecrId]) );
   NS_LOG_LOGIC ("MIB: " << mib << " BLER:" << bler << " b:" << b << " c:" << c);
   return bler;
 }
@@ -468,31 +506,13 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
   NS_LOG_FUNCTION (sinr);
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  Values::iterator sinrIt = sinrCopy.ValuesBegin ();
+  const MiMap& miMap = GetMiMap (0); // QPSK
+  Values::const_iterator sinrIt = sinr.ConstValuesBegin ();
   uint16_t rb = 0;
-  NS_ASSERT (sinrIt!=sinrCopy.ValuesEnd ());
-  while (sinrIt!=sinrCopy.ValuesEnd ())
+  NS_ASSERT (sinrIt!=sinr.ConstValuesEnd ());
+  while (sinrIt!=sinr.ConstValuesEnd ())
     {
-      double sinrLin = *sinrIt;
-      if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-        {
-          MI = 1;
-        }
-      else 
-        { 
-          // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-          // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-          static const double scalingCoeffQpsk = 
-            (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-          double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-          uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-          NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-          MI = MI_map_qpsk[sinrIndex];
-        }
-      MIsum += MI;
+      MIsum += LookupMi (miMap, *sinrIt);
       sinrIt++;
       rb++;
     }
@@ -554,7 +574,7 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
 
 
 TbStats_t
-LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory)
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
 
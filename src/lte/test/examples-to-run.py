@@ -23,6 +23,7 @@ cpp_examples = [
     ("lena-gtpu-tunnel", "True", "True"),
     ("lena-intercell-interference --simTime=0.1", "True", "True"),
     ("lena-pathloss-traces", "True", "True"),
+    ("lena-parallel-scheduling --nEnb=4 --nUePerEnb=3 --simTime=0.1 --threads=2", "True", "True"),
     ("lena-profiling", "True", "True"),
     ("lena-profiling --simTime=0.1 --nUe=2 --nEnb=5 --nFloors=0", "True", "True"),
     ("lena-profiling --simTime=0.1 --nUe=3 --nEnb=6 --nFloors=1", "True", "True"),
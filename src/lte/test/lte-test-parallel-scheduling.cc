@@ -0,0 +1,219 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-enb-rrc.h"
+#include "ns3/lte-common.h"
+#include "ns3/eps-bearer.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestParallelScheduling");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that the scheduling decisions taken by the eNB MACs in
+ * parallel scheduling mode do not depend on the number of worker threads.
+ */
+class LteParallelSchedulingTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param schedulerType the type of the FF MAC scheduler
+   */
+  LteParallelSchedulingTestCase (std::string schedulerType);
+  virtual ~LteParallelSchedulingTestCase ();
+
+  /**
+   * DL scheduling trace sink
+   *
+   * \param log the log of the current run
+   * \param path the trace context
+   * \param info the DL scheduling info
+   */
+  static void DlScheduling (std::ostringstream *log, std::string path, DlSchedulingCallbackInfo info);
+  /**
+   * UL scheduling trace sink
+   *
+   * \param log the log of the current run
+   * \param path the trace context
+   * \param frameNo the frame number
+   * \param subframeNo the subframe number
+   * \param rnti the RNTI
+   * \param mcs the MCS
+   * \param size the TB size
+   * \param componentCarrierId the component carrier ID
+   */
+  static void UlScheduling (std::ostringstream *log, std::string path,
+                            uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                            uint8_t mcs, uint16_t size, uint8_t componentCarrierId);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the scenario
+   *
+   * \param nThreads number of scheduler worker threads
+   * \return the log of the scheduling decisions
+   */
+  std::string RunScenario (uint32_t nThreads);
+
+  std::string m_schedulerType; ///< the scheduler type
+};
+
+LteParallelSchedulingTestCase::LteParallelSchedulingTestCase (std::string schedulerType)
+  : TestCase ("Parallel scheduling with " + schedulerType),
+    m_schedulerType (schedulerType)
+{
+}
+
+LteParallelSchedulingTestCase::~LteParallelSchedulingTestCase ()
+{
+}
+
+void
+LteParallelSchedulingTestCase::DlScheduling (std::ostringstream *log, std::string path, DlSchedulingCallbackInfo info)
+{
+  *log << path << " DL " << info.frameNo << " " << info.subframeNo << " " << info.rnti
+       << " " << (uint32_t) info.mcsTb1 << " " << info.sizeTb1
+       << " " << (uint32_t) info.mcsTb2 << " " << info.sizeTb2 << std::endl;
+}
+
+void
+LteParallelSchedulingTestCase::UlScheduling (std::ostringstream *log, std::string path,
+                                             uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                                             uint8_t mcs, uint16_t size, uint8_t componentCarrierId)
+{
+  *log << path << " UL " << frameNo << " " << subframeNo << " " << rnti
+       << " " << (uint32_t) mcs << " " << size << std::endl;
+}
+
+std::string
+LteParallelSchedulingTestCase::RunScenario (uint32_t nThreads)
+{
+  Config::Reset ();
+  Config::SetDefault ("ns3::LteEnbMac::ParallelScheduling", BooleanValue (true));
+  Config::SetDefault ("ns3::LteEnbRrc::EpsBearerToRlcMapping", EnumValue (LteEnbRrc::RLC_SM_ALWAYS));
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  Config::SetGlobal ("LteMacSchedulerThreads", UintegerValue (nThreads));
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetSchedulerType (m_schedulerType);
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+
+  const uint32_t nEnb = 4;
+  const uint32_t nUePerEnb = 3;
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (nEnb);
+  ueNodes.Create (nEnb * nUePerEnb);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (500.0),
+                                 "GridWidth", UintegerValue (nEnb));
+  mobility.Install (enbNodes);
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (-50.0),
+                                 "MinY", DoubleValue (20.0),
+                                 "DeltaX", DoubleValue (500.0 / nUePerEnb),
+                                 "DeltaY", DoubleValue (10.0),
+                                 "GridWidth", UintegerValue (nEnb * nUePerEnb));
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  for (uint32_t i = 0; i < ueDevs.GetN (); ++i)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i / nUePerEnb));
+    }
+  // use the same random streams in all the runs
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  lteHelper->AssignStreams (ueDevs, stream);
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  std::ostringstream log;
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/DlScheduling",
+                   MakeBoundCallback (&LteParallelSchedulingTestCase::DlScheduling, &log));
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/UlScheduling",
+                   MakeBoundCallback (&LteParallelSchedulingTestCase::UlScheduling, &log));
+
+  Simulator::Stop (MilliSeconds (200));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return log.str ();
+}
+
+void
+LteParallelSchedulingTestCase::DoRun (void)
+{
+  std::string reference = RunScenario (0);
+  NS_TEST_ASSERT_MSG_NE (reference.size (), 0, "no scheduling decision");
+  std::string parallel = RunScenario (3);
+  NS_TEST_ASSERT_MSG_EQ ((parallel == reference), true, "the scheduling decisions depend on the number of threads");
+  Config::SetGlobal ("LteMacSchedulerThreads", UintegerValue (0));
+  Config::Reset ();
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Parallel scheduling test suite
+ */
+class LteParallelSchedulingTestSuite : public TestSuite
+{
+public:
+  LteParallelSchedulingTestSuite ();
+};
+
+LteParallelSchedulingTestSuite::LteParallelSchedulingTestSuite ()
+  : TestSuite ("lte-parallel-scheduling", SYSTEM)
+{
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::PfFfMacScheduler"), TestCase::QUICK);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::RrFfMacScheduler"), TestCase::QUICK);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::PssFfMacScheduler"), TestCase::EXTENSIVE);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::CqaFfMacScheduler"), TestCase::EXTENSIVE);
+}
+
+/**
+ * \ingroup lte-test
+ * Static variable for test initialization
+ */
+static LteParallelSchedulingTestSuite g_lteParallelSchedulingTestSuite;
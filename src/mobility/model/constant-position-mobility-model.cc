@@ -57,5 +57,10 @@ ConstantPositionMobilityModel::DoGetVelocity (void) const
 {
   return Vector (0.0, 0.0, 0.0);
 }
+bool
+ConstantPositionMobilityModel::DoIsPiecewiseLinear (void) const
+{
+  return true;
+}
 
 } // namespace ns3
@@ -90,7 +90,7 @@ GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
   m_meanVelocity = 0.0;
   m_meanDirection = 0.0;
   m_meanPitch = 0.0;
-  m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
+  m_event.Schedule (Seconds (0), &GaussMarkovMobilityModel::Start, this);
   m_helper.Unpause ();
 }
 
@@ -161,7 +161,7 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
   // If out of bounds, then alter the velocity vector and average direction to keep the position in bounds
   if (m_bounds.IsInside (nextPosition))
     {
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+      m_event.Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
     }
   else
     {
@@ -187,7 +187,7 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
       m_Pitch = m_meanPitch;
       m_helper.SetVelocity (speed);
       m_helper.Unpause ();
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+      m_event.Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
     }
   NotifyCourseChange ();
 }
@@ -210,13 +210,18 @@ GaussMarkovMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
   m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
+  m_event.Schedule (Seconds (0), &GaussMarkovMobilityModel::Start, this);
 }
 Vector
 GaussMarkovMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+bool
+GaussMarkovMobilityModel::DoIsPiecewiseLinear (void) const
+{
+  return true;
+}
 
 int64_t
 GaussMarkovMobilityModel::DoAssignStreams (int64_t stream)
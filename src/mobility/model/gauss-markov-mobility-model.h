@@ -28,7 +28,7 @@
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/nstime.h"
-#include "ns3/event-id.h"
+#include "mobility-tick-scheduler.h"
 #include "ns3/box.h"
 #include "ns3/random-variable-stream.h"
 
@@ -101,6 +101,7 @@ private:
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  virtual bool DoIsPiecewiseLinear (void) const;
   ConstantVelocityHelper m_helper; //!< constant velocity helper
   Time m_timeStep; //!< duraiton after which direction and speed should change
   double m_alpha; //!< tunable constant in the model
@@ -116,7 +117,7 @@ private:
   Ptr<NormalRandomVariable> m_normalDirection; //!< Gaussian rv for next direction value
   Ptr<RandomVariableStream> m_rndMeanPitch; //!< rv used to assign avg. pitch 
   Ptr<NormalRandomVariable> m_normalPitch; //!< Gaussian rv for next pitch
-  EventId m_event; //!< event id of scheduled start
+  MobilityUpdateEvent m_event; //!< event id of scheduled start
   Box m_bounds; //!< bounding box
 };
 
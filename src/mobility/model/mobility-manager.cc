@@ -0,0 +1,251 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "mobility-manager.h"
+#include "mobility-model.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityManager");
+
+NS_OBJECT_ENSURE_REGISTERED (MobilityManager);
+
+TypeId
+MobilityManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilityManager")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilityManager> ()
+  ;
+  return tid;
+}
+
+MobilityManager::MobilityManager ()
+  : m_evaluated (0),
+    m_valid (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityManager::~MobilityManager ()
+{
+}
+
+Ptr<MobilityManager>
+MobilityManager::Get (void)
+{
+  return *DoGet ();
+}
+
+Ptr<MobilityManager> *
+MobilityManager::DoGet (void)
+{
+  static Ptr<MobilityManager> ptr = 0;
+  if (ptr == 0)
+    {
+      ptr = CreateObject<MobilityManager> ();
+      Simulator::ScheduleDestroy (&MobilityManager::Delete);
+    }
+  return &ptr;
+}
+
+void
+MobilityManager::Delete (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  (*DoGet ())->Dispose ();
+  (*DoGet ()) = 0;
+}
+
+void
+MobilityManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_models.begin (); i != m_models.end (); ++i)
+    {
+      (*i)->m_manager = 0;
+    }
+  m_models.clear ();
+  m_nonLinear.clear ();
+  m_start.clear ();
+  m_x0.clear ();
+  m_y0.clear ();
+  m_z0.clear ();
+  m_vx.clear ();
+  m_vy.clear ();
+  m_vz.clear ();
+  m_x.clear ();
+  m_y.clear ();
+  m_z.clear ();
+  m_valid = false;
+  Object::DoDispose ();
+}
+
+uint32_t
+MobilityManager::Add (Ptr<MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  NS_ASSERT_MSG (model->m_manager == 0, "the mobility model is already registered");
+  uint32_t i = m_models.size ();
+  model->m_manager = this;
+  model->m_managerIndex = i;
+  m_models.push_back (model);
+  if (!model->IsPiecewiseLinear ())
+    {
+      m_nonLinear.push_back (i);
+    }
+  m_start.push_back (0);
+  m_x0.push_back (0);
+  m_y0.push_back (0);
+  m_z0.push_back (0);
+  m_vx.push_back (0);
+  m_vy.push_back (0);
+  m_vz.push_back (0);
+  m_x.push_back (0);
+  m_y.push_back (0);
+  m_z.push_back (0);
+  m_valid = false;
+  NotifyCourseChange (i);
+  return i;
+}
+
+uint32_t
+MobilityManager::GetN (void) const
+{
+  return m_models.size ();
+}
+
+Ptr<MobilityModel>
+MobilityManager::GetMobilityModel (uint32_t i) const
+{
+  return m_models.at (i);
+}
+
+uint32_t
+MobilityManager::GetIndex (Ptr<const MobilityModel> model) const
+{
+  NS_ASSERT_MSG (model->m_manager == this, "the mobility model is not registered");
+  return model->m_managerIndex;
+}
+
+void
+MobilityManager::NotifyCourseChange (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  Ptr<MobilityModel> model = m_models[i];
+  Vector position = model->GetPosition ();
+  if (model->IsPiecewiseLinear ())
+    {
+      Vector velocity = model->GetVelocity ();
+      m_start[i] = Simulator::Now ().GetTimeStep ();
+      m_x0[i] = position.x;
+      m_y0[i] = position.y;
+      m_z0[i] = position.z;
+      m_vx[i] = velocity.x;
+      m_vy[i] = velocity.y;
+      m_vz[i] = velocity.z;
+    }
+  if (m_valid && m_evaluated == Simulator::Now ().GetTimeStep ())
+    {
+      m_x[i] = position.x;
+      m_y[i] = position.y;
+      m_z[i] = position.z;
+    }
+}
+
+void
+MobilityManager::Evaluate (void)
+{
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  if (m_valid && m_evaluated == now)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << now);
+  double step = TimeStep (1).GetSeconds ();
+  uint32_t n = m_models.size ();
+  const int64_t *start = n == 0 ? 0 : &m_start[0];
+  const double *x0 = n == 0 ? 0 : &m_x0[0];
+  const double *y0 = n == 0 ? 0 : &m_y0[0];
+  const double *z0 = n == 0 ? 0 : &m_z0[0];
+  const double *vx = n == 0 ? 0 : &m_vx[0];
+  const double *vy = n == 0 ? 0 : &m_vy[0];
+  const double *vz = n == 0 ? 0 : &m_vz[0];
+  double *x = n == 0 ? 0 : &m_x[0];
+  double *y = n == 0 ? 0 : &m_y[0];
+  double *z = n == 0 ? 0 : &m_z[0];
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      double dt = (now - start[i]) * step;
+      x[i] = x0[i] + vx[i] * dt;
+      y[i] = y0[i] + vy[i] * dt;
+      z[i] = z0[i] + vz[i] * dt;
+    }
+  for (std::vector<uint32_t>::const_iterator i = m_nonLinear.begin (); i != m_nonLinear.end (); ++i)
+    {
+      Vector position = m_models[*i]->GetPosition ();
+      x[*i] = position.x;
+      y[*i] = position.y;
+      z[*i] = position.z;
+    }
+  m_evaluated = now;
+  m_valid = true;
+}
+
+Vector
+MobilityManager::GetPosition (uint32_t i)
+{
+  NS_ASSERT (i < m_models.size ());
+  Evaluate ();
+  return Vector (m_x[i], m_y[i], m_z[i]);
+}
+
+double
+MobilityManager::GetDistance (uint32_t i, uint32_t j)
+{
+  NS_ASSERT (i < m_models.size () && j < m_models.size ());
+  Evaluate ();
+  double dx = m_x[i] - m_x[j];
+  double dy = m_y[i] - m_y[j];
+  double dz = m_z[i] - m_z[j];
+  return std::sqrt (dx * dx + dy * dy + dz * dz);
+}
+
+const std::vector<double> &
+MobilityManager::GetX (void)
+{
+  Evaluate ();
+  return m_x;
+}
+
+const std::vector<double> &
+MobilityManager::GetY (void)
+{
+  Evaluate ();
+  return m_y;
+}
+
+const std::vector<double> &
+MobilityManager::GetZ (void)
+{
+  Evaluate ();
+  return m_z;
+}
+
+} // namespace ns3
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_MANAGER_H
+#define MOBILITY_MANAGER_H
+
+#include "ns3/object.h"
+#include "ns3/vector.h"
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Evaluate the positions of many mobility models at once.
+ *
+ * The manager keeps the trajectory of each registered mobility model
+ * as the segment on which the model moves since its last course change:
+ * the position and the time at the start of the segment, and the
+ * velocity.  The segments are stored in arrays of coordinates, and the
+ * positions of all the models at the current time are evaluated in one
+ * pass over these arrays, the first time they are requested at a given
+ * time; the positions are then read from the cache until the time
+ * advances or a model changes its course.
+ *
+ * The registered models update their segment at each course change.
+ * The models which do not move in straight lines between their course
+ * changes (see MobilityModel::IsPiecewiseLinear) are evaluated through
+ * MobilityModel::GetPosition during the same pass.
+ *
+ * The positions are equal to the positions returned by the models to
+ * the rounding of the floating point computations, the models updating
+ * their own positions step by step.
+ *
+ * \code
+ *   Ptr<MobilityManager> manager = MobilityManager::Get ();
+ *   for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+ *     {
+ *       manager->Add ((*i)->GetObject<MobilityModel> ());
+ *     }
+ *   ...
+ *   const std::vector<double> &x = manager->GetX ();
+ * \endcode
+ */
+class MobilityManager : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MobilityManager ();
+  virtual ~MobilityManager ();
+
+  /**
+   * \return the manager of the simulation, created on the first call
+   * and destroyed by Simulator::Destroy.
+   */
+  static Ptr<MobilityManager> Get (void);
+
+  /**
+   * Register a mobility model.
+   *
+   * A model can be registered with one manager only.
+   *
+   * \param model the mobility model
+   * \return the index of the model in the manager
+   */
+  uint32_t Add (Ptr<MobilityModel> model);
+  /**
+   * \return the number of registered models
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a model
+   * \return the model registered with the index \p i
+   */
+  Ptr<MobilityModel> GetMobilityModel (uint32_t i) const;
+  /**
+   * \param model a registered mobility model
+   * \return the index of the model in the manager
+   */
+  uint32_t GetIndex (Ptr<const MobilityModel> model) const;
+
+  /**
+   * \param i the index of a model
+   * \return the current position of the model
+   */
+  Vector GetPosition (uint32_t i);
+  /**
+   * \param i the index of a model
+   * \param j the index of another model
+   * \return the current distance between the two models
+   */
+  double GetDistance (uint32_t i, uint32_t j);
+  /**
+   * \return the current x coordinates of the models, by index
+   */
+  const std::vector<double> &GetX (void);
+  /**
+   * \return the current y coordinates of the models, by index
+   */
+  const std::vector<double> &GetY (void);
+  /**
+   * \return the current z coordinates of the models, by index
+   */
+  const std::vector<double> &GetZ (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class MobilityModel;
+
+  /**
+   * Store the new segment of a model which changed its course.
+   * \param i the index of the model
+   */
+  void NotifyCourseChange (uint32_t i);
+  /**
+   * Evaluate the positions of all the models at the current time,
+   * unless they are already evaluated.
+   */
+  void Evaluate (void);
+  /**
+   * \return the address of the pointer to the manager of the simulation
+   */
+  static Ptr<MobilityManager> *DoGet (void);
+  /**
+   * Destroy the manager of the simulation.
+   */
+  static void Delete (void);
+
+  std::vector<Ptr<MobilityModel> > m_models; //!< the registered models
+  std::vector<uint32_t> m_nonLinear;          //!< the models evaluated through GetPosition
+  std::vector<int64_t> m_start;               //!< the start time of the segments, in time steps
+  std::vector<double> m_x0;                   //!< the x coordinate at the start of the segments
+  std::vector<double> m_y0;                   //!< the y coordinate at the start of the segments
+  std::vector<double> m_z0;                   //!< the z coordinate at the start of the segments
+  std::vector<double> m_vx;                   //!< the x velocity on the segments
+  std::vector<double> m_vy;                   //!< the y velocity on the segments
+  std::vector<double> m_vz;                   //!< the z velocity on the segments
+  std::vector<double> m_x;                    //!< the evaluated x coordinates
+  std::vector<double> m_y;                    //!< the evaluated y coordinates
+  std::vector<double> m_z;                    //!< the evaluated z coordinates
+  int64_t m_evaluated;                        //!< the time of the evaluated positions, in time steps
+  bool m_valid;                               //!< whether the evaluated positions are valid
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_MANAGER_H */
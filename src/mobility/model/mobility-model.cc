@@ -21,6 +21,7 @@
 #include <cmath>
 
 #include "mobility-model.h"
+#include "mobility-manager.h"
 #include "ns3/trace-source-accessor.h"
 
 namespace ns3 {
@@ -53,6 +54,9 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_courseChangeEpoch (0),
+    m_manager (0),
+    m_managerIndex (0)
 {
 }
 
@@ -75,6 +79,11 @@ void
 MobilityModel::SetPosition (const Vector &position)
 {
   DoSetPosition (position);
+  ++m_courseChangeEpoch;
+  if (m_manager != 0)
+    {
+      m_manager->NotifyCourseChange (m_managerIndex);
+    }
 }
 
 double 
@@ -94,9 +103,26 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  ++m_courseChangeEpoch;
+  if (m_manager != 0)
+    {
+      m_manager->NotifyCourseChange (m_managerIndex);
+    }
   m_courseChangeTrace (this);
 }
 
+uint64_t
+MobilityModel::GetCourseChangeEpoch (void) const
+{
+  return m_courseChangeEpoch;
+}
+
+bool
+MobilityModel::IsPiecewiseLinear (void) const
+{
+  return DoIsPiecewiseLinear ();
+}
+
 int64_t
 MobilityModel::AssignStreams (int64_t start)
 {
@@ -110,5 +136,11 @@ MobilityModel::DoAssignStreams (int64_t start)
   return 0;
 }
 
+bool
+MobilityModel::DoIsPiecewiseLinear (void) const
+{
+  return false;
+}
+
 
 } // namespace ns3
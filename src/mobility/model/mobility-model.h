@@ -26,6 +26,8 @@
 
 namespace ns3 {
 
+class MobilityManager;
+
 /**
  * \ingroup mobility
  * \brief Keep track of the current position and velocity of an object.
@@ -78,6 +80,23 @@ public:
    * \return the number of stream indices assigned by this model
    */
   int64_t AssignStreams (int64_t stream);
+  /**
+   * \return the number of course changes of this model.
+   *
+   * The counter is incremented by each course change notification and
+   * each SetPosition, so that a model whose counter did not change and
+   * whose velocity is zero did not move.  The users which cache results
+   * derived from the position, as PropagationCache, compare the counters.
+   */
+  uint64_t GetCourseChangeEpoch (void) const;
+  /**
+   * \return true if the model moves in a straight line at the velocity
+   * returned by GetVelocity between its course changes, false otherwise.
+   *
+   * The MobilityManager evaluates the positions of such models from
+   * their last course change.
+   */
+  bool IsPiecewiseLinear (void) const;
 
   /**
    *  TracedCallback signature.
@@ -122,6 +141,14 @@ private:
    * \return the number of streams used
    */
   virtual int64_t DoAssignStreams (int64_t start);
+  /**
+   * The default implementation returns false.  Subclasses which only
+   * change their velocity when they notify a course change are expected
+   * to override this.
+   * \return true if the model moves in a straight line between its
+   * course changes
+   */
+  virtual bool DoIsPiecewiseLinear (void) const;
 
   /**
    * Used to alert subscribers that a change in direction, velocity,
@@ -129,6 +156,12 @@ private:
    */
   ns3::TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  mutable uint64_t m_courseChangeEpoch; //!< The number of course changes
+
+  friend class MobilityManager;
+  MobilityManager *m_manager;           //!< The manager of the model, if any
+  uint32_t m_managerIndex;              //!< The index of the model in its manager
+
 };
 
 } // namespace ns3
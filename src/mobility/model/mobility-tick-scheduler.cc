@@ -0,0 +1,253 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "mobility-tick-scheduler.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityTickScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (MobilityTickScheduler);
+
+/**
+ * \relates MobilityTickScheduler
+ * \anchor GlobalValueMobilityTickScheduler
+ * \brief A global switch to run the updates of the random mobility
+ * models from the MobilityTickScheduler.
+ */
+static GlobalValue g_mobilityTickScheduler = GlobalValue ("MobilityTickScheduler",
+                                                          "A global switch to run the updates of the random mobility models from a shared event",
+                                                          BooleanValue (false),
+                                                          MakeBooleanChecker ());
+
+namespace {
+
+/** The value of the global value, or -1 if it was not read. */
+int g_mobilityTickSchedulerEnabled = -1;
+
+/** Read the global value again in the next simulation. */
+void
+ResetMobilityTickSchedulerEnabled (void)
+{
+  g_mobilityTickSchedulerEnabled = -1;
+}
+
+} // unnamed namespace
+
+TypeId
+MobilityTickScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilityTickScheduler")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilityTickScheduler> ()
+  ;
+  return tid;
+}
+
+MobilityTickScheduler::MobilityTickScheduler ()
+  : m_uid (0),
+    m_tickTs (0),
+    m_updates (0),
+    m_ticks (0),
+    m_inTick (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityTickScheduler::~MobilityTickScheduler ()
+{
+}
+
+Ptr<MobilityTickScheduler>
+MobilityTickScheduler::Get (void)
+{
+  return *DoGet ();
+}
+
+Ptr<MobilityTickScheduler> *
+MobilityTickScheduler::DoGet (void)
+{
+  static Ptr<MobilityTickScheduler> ptr = 0;
+  if (ptr == 0)
+    {
+      ptr = CreateObject<MobilityTickScheduler> ();
+      Simulator::ScheduleDestroy (&MobilityTickScheduler::Delete);
+    }
+  return &ptr;
+}
+
+void
+MobilityTickScheduler::Delete (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  (*DoGet ())->Dispose ();
+  (*DoGet ()) = 0;
+}
+
+bool
+MobilityTickScheduler::IsEnabled (void)
+{
+  if (g_mobilityTickSchedulerEnabled < 0)
+    {
+      BooleanValue value;
+      g_mobilityTickScheduler.GetValue (value);
+      g_mobilityTickSchedulerEnabled = value.Get () ? 1 : 0;
+      Simulator::ScheduleDestroy (&ResetMobilityTickSchedulerEnabled);
+    }
+  return g_mobilityTickSchedulerEnabled == 1;
+}
+
+void
+MobilityTickScheduler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_tick.Cancel ();
+  for (std::vector<Update>::iterator i = m_heap.begin (); i != m_heap.end (); ++i)
+    {
+      i->event->Unref ();
+    }
+  m_heap.clear ();
+  Object::DoDispose ();
+}
+
+bool
+MobilityTickScheduler::Later (const Update &a, const Update &b)
+{
+  return a.ts > b.ts || (a.ts == b.ts && a.uid > b.uid);
+}
+
+void
+MobilityTickScheduler::Schedule (const Time &delay, const Ptr<EventImpl> &event)
+{
+  NS_LOG_FUNCTION (this << delay << event);
+  NS_ASSERT (delay.IsPositive ());
+  Update update;
+  update.ts = (Simulator::Now () + delay).GetTimeStep ();
+  update.uid = m_uid++;
+  update.event = PeekPointer (event);
+  update.event->Ref ();
+  m_heap.push_back (update);
+  std::push_heap (m_heap.begin (), m_heap.end (), &MobilityTickScheduler::Later);
+  if (!m_inTick && (!m_tick.IsRunning () || update.ts < m_tickTs))
+    {
+      ScheduleTick ();
+    }
+}
+
+void
+MobilityTickScheduler::ScheduleTick (void)
+{
+  while (!m_heap.empty () && m_heap.front ().event->IsCancelled ())
+    {
+      std::pop_heap (m_heap.begin (), m_heap.end (), &MobilityTickScheduler::Later);
+      m_heap.back ().event->Unref ();
+      m_heap.pop_back ();
+    }
+  if (m_heap.empty ())
+    {
+      m_tick.Cancel ();
+      return;
+    }
+  int64_t ts = m_heap.front ().ts;
+  if (m_tick.IsRunning () && m_tickTs == ts)
+    {
+      return;
+    }
+  m_tick.Cancel ();
+  m_tickTs = ts;
+  m_tick = Simulator::Schedule (TimeStep (ts) - Simulator::Now (), &MobilityTickScheduler::Tick, this);
+}
+
+void
+MobilityTickScheduler::Tick (void)
+{
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  NS_LOG_FUNCTION (this << now);
+  m_inTick = true;
+  uint64_t updates = m_updates;
+  while (!m_heap.empty () && m_heap.front ().ts <= now)
+    {
+      std::pop_heap (m_heap.begin (), m_heap.end (), &MobilityTickScheduler::Later);
+      EventImpl *event = m_heap.back ().event;
+      m_heap.pop_back ();
+      if (!event->IsCancelled ())
+        {
+          event->Invoke ();
+          event->Cancel ();
+          ++m_updates;
+        }
+      event->Unref ();
+    }
+  if (m_updates != updates)
+    {
+      ++m_ticks;
+    }
+  m_inTick = false;
+  ScheduleTick ();
+}
+
+uint64_t
+MobilityTickScheduler::GetUpdates (void) const
+{
+  return m_updates;
+}
+
+uint64_t
+MobilityTickScheduler::GetTicks (void) const
+{
+  return m_ticks;
+}
+
+MobilityUpdateEvent::MobilityUpdateEvent ()
+{
+}
+
+void
+MobilityUpdateEvent::DoSchedule (const Time &delay, EventImpl *event)
+{
+  if (MobilityTickScheduler::IsEnabled ())
+    {
+      m_tick = Ptr<EventImpl> (event, false);
+      MobilityTickScheduler::Get ()->Schedule (delay, m_tick);
+    }
+  else
+    {
+      m_event = Simulator::Schedule (delay, Ptr<EventImpl> (event, false));
+    }
+}
+
+void
+MobilityUpdateEvent::Cancel (void)
+{
+  m_event.Cancel ();
+  if (m_tick != 0)
+    {
+      m_tick->Cancel ();
+    }
+}
+
+bool
+MobilityUpdateEvent::IsRunning (void) const
+{
+  return m_event.IsRunning () || (m_tick != 0 && !m_tick->IsCancelled ());
+}
+
+} // namespace ns3
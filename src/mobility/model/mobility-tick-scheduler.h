@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_TICK_SCHEDULER_H
+#define MOBILITY_TICK_SCHEDULER_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/event-impl.h"
+#include "ns3/make-event.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Run the updates of the mobility models from a single simulator
+ * event.
+ *
+ * The random mobility models schedule an event at each change of
+ * direction, wall bounce or pause, so that with many mobile nodes most
+ * of the events of the simulator are mobility updates.  When the
+ * global value \c MobilityTickScheduler is true, the models schedule
+ * their updates with this scheduler instead: the updates are kept in a
+ * heap ordered by time, and a single simulator event, the tick, runs all
+ * the updates due at its time in one batch, then is rescheduled at the
+ * time of the next update.
+ *
+ * Each update runs at the time at which it would have run as a
+ * simulator event, and the updates due at the same time run in the
+ * order in which they were scheduled, so that the models draw the same
+ * random numbers from their streams and follow the same trajectories.
+ * The updates run in the context of the tick rather than the context
+ * of their node, and run together relatively to the other events of
+ * the simulator which expire at the same time.
+ */
+class MobilityTickScheduler : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MobilityTickScheduler ();
+  virtual ~MobilityTickScheduler ();
+
+  /**
+   * \return the scheduler of the simulation, created on the first call
+   * and destroyed by Simulator::Destroy.
+   */
+  static Ptr<MobilityTickScheduler> Get (void);
+  /**
+   * \return the value of the global value \c MobilityTickScheduler,
+   * read once per simulation.
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * Schedule an update.
+   *
+   * The update is cancelled with EventImpl::Cancel; it is cancelled
+   * by the scheduler once it ran.
+   *
+   * \param delay the delay before the update
+   * \param event the update
+   */
+  void Schedule (const Time &delay, const Ptr<EventImpl> &event);
+
+  /**
+   * \return the number of updates run
+   */
+  uint64_t GetUpdates (void) const;
+  /**
+   * \return the number of ticks which ran updates
+   */
+  uint64_t GetTicks (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Run the updates which expire now, and schedule the next tick.
+   */
+  void Tick (void);
+  /**
+   * Remove the cancelled updates from the top of the heap, and
+   * schedule the tick at the time of the next update.
+   */
+  void ScheduleTick (void);
+  /**
+   * \return the address of the pointer to the scheduler of the simulation
+   */
+  static Ptr<MobilityTickScheduler> *DoGet (void);
+  /**
+   * Destroy the scheduler of the simulation.
+   */
+  static void Delete (void);
+
+  /** An update in the heap. */
+  struct Update
+  {
+    int64_t ts;          //!< the expiration time, in time steps
+    uint64_t uid;        //!< the order of the update
+    EventImpl *event;    //!< the update, referenced by the heap
+  };
+  /**
+   * The order of the heap, the first update on top.
+   * \param a an update
+   * \param b another update
+   * \return true if \p a expires after \p b
+   */
+  static bool Later (const Update &a, const Update &b);
+
+  std::vector<Update> m_heap;     //!< the pending updates
+  uint64_t m_uid;                 //!< the order of the next update
+  EventId m_tick;                 //!< the next tick
+  int64_t m_tickTs;               //!< the time of the next tick, in time steps
+  uint64_t m_updates;             //!< the number of updates run
+  uint64_t m_ticks;               //!< the number of ticks
+  bool m_inTick;                  //!< whether the tick is running
+};
+
+/**
+ * \ingroup mobility
+ * \brief The pending update of a mobility model.
+ *
+ * The update is scheduled with the MobilityTickScheduler when it is
+ * enabled, and with the simulator otherwise.  It replaces the EventId
+ * of the models.
+ */
+class MobilityUpdateEvent
+{
+public:
+  MobilityUpdateEvent ();
+  /**
+   * Schedule the update, a method of the model.  A pending update is
+   * not cancelled.
+   *
+   * \param delay the delay before the update
+   * \param mem_ptr the method
+   * \param obj the model
+   * \param args the arguments of the method
+   */
+  template <typename MEM, typename OBJ, typename... Ts>
+  void Schedule (const Time &delay, MEM mem_ptr, OBJ obj, Ts&&... args);
+  /**
+   * Cancel the update, if it is pending.
+   */
+  void Cancel (void);
+  /**
+   * \return true if the update is pending
+   */
+  bool IsRunning (void) const;
+
+private:
+  /**
+   * Schedule the update.
+   * \param delay the delay before the update
+   * \param event the update
+   */
+  void DoSchedule (const Time &delay, EventImpl *event);
+
+  EventId m_event;        //!< the update scheduled with the simulator
+  Ptr<EventImpl> m_tick;  //!< the update scheduled with the MobilityTickScheduler
+};
+
+template <typename MEM, typename OBJ, typename... Ts>
+void
+MobilityUpdateEvent::Schedule (const Time &delay, MEM mem_ptr, OBJ obj, Ts&&... args)
+{
+  DoSchedule (delay, MakeEvent (mem_ptr, obj, std::forward<Ts> (args)...));
+}
+
+} // namespace ns3
+
+#endif /* MOBILITY_TICK_SCHEDULER_H */
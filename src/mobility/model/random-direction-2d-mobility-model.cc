@@ -87,7 +87,7 @@ RandomDirection2dMobilityModel::BeginPause (void)
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
   m_event.Cancel ();
-  m_event = Simulator::Schedule (pause, &RandomDirection2dMobilityModel::ResetDirectionAndSpeed, this);
+  m_event.Schedule (pause, &RandomDirection2dMobilityModel::ResetDirectionAndSpeed, this);
   NotifyCourseChange ();
 }
 
@@ -106,8 +106,8 @@ RandomDirection2dMobilityModel::SetDirectionAndSpeed (double direction)
   Vector next = m_bounds.CalculateIntersection (position, vector);
   Time delay = Seconds (CalculateDistance (position, next) / speed);
   m_event.Cancel ();
-  m_event = Simulator::Schedule (delay,
-                                 &RandomDirection2dMobilityModel::BeginPause, this);
+  m_event.Schedule (delay,
+                    &RandomDirection2dMobilityModel::BeginPause, this);
   NotifyCourseChange ();
 }
 void
@@ -145,13 +145,18 @@ RandomDirection2dMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
   m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomDirection2dMobilityModel::DoInitializePrivate, this);
+  m_event.Schedule (Seconds (0), &RandomDirection2dMobilityModel::DoInitializePrivate, this);
 }
 Vector
 RandomDirection2dMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+bool
+RandomDirection2dMobilityModel::DoIsPiecewiseLinear (void) const
+{
+  return true;
+}
 int64_t
 RandomDirection2dMobilityModel::DoAssignStreams (int64_t stream)
 {
@@ -23,7 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
-#include "ns3/event-id.h"
+#include "mobility-tick-scheduler.h"
 #include "ns3/rectangle.h"
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
@@ -75,12 +75,13 @@ private:
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  virtual bool DoIsPiecewiseLinear (void) const;
 
   Ptr<UniformRandomVariable> m_direction; //!< rv to control direction
   Rectangle m_bounds; //!< the 2D bounding area
   Ptr<RandomVariableStream> m_speed; //!< a random variable to control speed
   Ptr<RandomVariableStream> m_pause; //!< a random variable to control pause 
-  EventId m_event; //!< event ID of next scheduled event
+  MobilityUpdateEvent m_event; //!< event ID of next scheduled event
   ConstantVelocityHelper m_helper; //!< helper for velocity computations
 };
 
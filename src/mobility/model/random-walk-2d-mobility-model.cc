@@ -116,14 +116,14 @@ RandomWalk2dMobilityModel::DoWalk (Time delayLeft)
   m_event.Cancel ();
   if (m_bounds.IsInside (nextPosition))
     {
-      m_event = Simulator::Schedule (delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate, this);
+      m_event.Schedule (delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate, this);
     }
   else
     {
       nextPosition = m_bounds.CalculateIntersection (position, speed);
       Time delay = Seconds ((nextPosition.x - position.x) / speed.x);
-      m_event = Simulator::Schedule (delay, &RandomWalk2dMobilityModel::Rebound, this,
-                                     delayLeft - delay);
+      m_event.Schedule (delay, &RandomWalk2dMobilityModel::Rebound, this,
+                        delayLeft - delay);
     }
   NotifyCourseChange ();
 }
@@ -168,13 +168,18 @@ RandomWalk2dMobilityModel::DoSetPosition (const Vector &position)
   NS_ASSERT (m_bounds.IsInside (position));
   m_helper.SetPosition (position);
   m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomWalk2dMobilityModel::DoInitializePrivate, this);
+  m_event.Schedule (Seconds (0), &RandomWalk2dMobilityModel::DoInitializePrivate, this);
 }
 Vector
 RandomWalk2dMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+bool
+RandomWalk2dMobilityModel::DoIsPiecewiseLinear (void) const
+{
+  return true;
+}
 int64_t
 RandomWalk2dMobilityModel::DoAssignStreams (int64_t stream)
 {
@@ -22,7 +22,7 @@
 
 #include "ns3/object.h"
 #include "ns3/nstime.h"
-#include "ns3/event-id.h"
+#include "mobility-tick-scheduler.h"
 #include "ns3/rectangle.h"
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
@@ -78,9 +78,10 @@ private:
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  virtual bool DoIsPiecewiseLinear (void) const;
 
   ConstantVelocityHelper m_helper; //!< helper for this object
-  EventId m_event; //!< stored event ID 
+  MobilityUpdateEvent m_event; //!< stored event ID 
   enum Mode m_mode; //!< whether in time or distance mode
   double m_modeDistance; //!< Change direction and speed after this distance
   Time m_modeTime; //!< Change current direction and speed after this delay
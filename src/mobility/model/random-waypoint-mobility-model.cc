@@ -72,8 +72,8 @@ RandomWaypointMobilityModel::BeginWalk (void)
   m_helper.Unpause ();
   Time travelDelay = Seconds (CalculateDistance (destination, m_current) / speed);
   m_event.Cancel ();
-  m_event = Simulator::Schedule (travelDelay,
-                                 &RandomWaypointMobilityModel::DoInitializePrivate, this);
+  m_event.Schedule (travelDelay,
+                    &RandomWaypointMobilityModel::DoInitializePrivate, this);
   NotifyCourseChange ();
 }
 
@@ -90,7 +90,7 @@ RandomWaypointMobilityModel::DoInitializePrivate (void)
   m_helper.Update ();
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
-  m_event = Simulator::Schedule (pause, &RandomWaypointMobilityModel::BeginWalk, this);
+  m_event.Schedule (pause, &RandomWaypointMobilityModel::BeginWalk, this);
   NotifyCourseChange ();
 }
 
@@ -105,13 +105,18 @@ RandomWaypointMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
   m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomWaypointMobilityModel::DoInitializePrivate, this);
+  m_event.Schedule (Seconds (0), &RandomWaypointMobilityModel::DoInitializePrivate, this);
 }
 Vector
 RandomWaypointMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+bool
+RandomWaypointMobilityModel::DoIsPiecewiseLinear (void) const
+{
+  return true;
+}
 int64_t
 RandomWaypointMobilityModel::DoAssignStreams (int64_t stream)
 {
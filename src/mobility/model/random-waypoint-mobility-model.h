@@ -23,6 +23,7 @@
 #include "constant-velocity-helper.h"
 #include "mobility-model.h"
 #include "position-allocator.h"
+#include "mobility-tick-scheduler.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 
@@ -72,12 +73,13 @@ private:
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  virtual bool DoIsPiecewiseLinear (void) const;
 
   ConstantVelocityHelper m_helper; //!< helper for velocity computations
   Ptr<PositionAllocator> m_position; //!< pointer to position allocator
   Ptr<RandomVariableStream> m_speed; //!< random variable to generate speeds
   Ptr<RandomVariableStream> m_pause; //!< random variable to generate pauses
-  EventId m_event; //!< event ID of next scheduled event
+  MobilityUpdateEvent m_event; //!< event ID of next scheduled event
 };
 
 } // namespace ns3
@@ -88,6 +88,7 @@ private:
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  virtual bool DoIsPiecewiseLinear (void) const;
 
   ConstantVelocityHelper m_helper; //!< helper for velocity computations
   double m_maxSpeed; //!< maximum speed value (m/s)
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/rectangle.h"
+#include "ns3/mobility-manager.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/constant-acceleration-mobility-model.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/random-direction-2d-mobility-model.h"
+#include "ns3/random-waypoint-mobility-model.h"
+#include "ns3/gauss-markov-mobility-model.h"
+#include "ns3/position-allocator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MobilityManagerTest");
+
+/**
+ * Check that the positions evaluated by the MobilityManager are the
+ * positions of the registered models, for models which move in straight
+ * lines between their course changes and for a model which does not,
+ * including when the models change their course or are moved at the
+ * time of a previous evaluation.
+ */
+class MobilityManagerTestCase : public TestCase
+{
+public:
+  MobilityManagerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the positions of the manager with the positions of the models.
+   */
+  void Check (void);
+  /**
+   * Move a model, and check the positions evaluated at the same time.
+   */
+  void Move (void);
+
+  Ptr<MobilityManager> m_manager;  //!< the manager
+  uint32_t m_checks;               //!< the number of checks
+};
+
+MobilityManagerTestCase::MobilityManagerTestCase ()
+  : TestCase ("Check the positions evaluated by the MobilityManager"),
+    m_checks (0)
+{
+}
+
+void
+MobilityManagerTestCase::Check (void)
+{
+  const std::vector<double> &x = m_manager->GetX ();
+  const std::vector<double> &y = m_manager->GetY ();
+  const std::vector<double> &z = m_manager->GetZ ();
+  NS_TEST_ASSERT_MSG_EQ (x.size (), m_manager->GetN (), "wrong number of positions");
+  for (uint32_t i = 0; i < m_manager->GetN (); ++i)
+    {
+      Vector position = m_manager->GetMobilityModel (i)->GetPosition ();
+      NS_TEST_ASSERT_MSG_EQ_TOL (x[i], position.x, 1e-6, "wrong x coordinate of model " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (y[i], position.y, 1e-6, "wrong y coordinate of model " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (z[i], position.z, 1e-6, "wrong z coordinate of model " << i);
+    }
+  ++m_checks;
+  Simulator::Schedule (Seconds (0.37), &MobilityManagerTestCase::Check, this);
+}
+
+void
+MobilityManagerTestCase::Move (void)
+{
+  Vector before = m_manager->GetPosition (0);
+  Ptr<ConstantVelocityMobilityModel> model = DynamicCast<ConstantVelocityMobilityModel> (m_manager->GetMobilityModel (0));
+  model->SetPosition (before + Vector (10, 0, 0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_manager->GetPosition (0).x, before.x + 10, 1e-9, "the cached position is not updated");
+  model->SetVelocity (Vector (0, 2, 0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_manager->GetDistance (0, 0), 0, 1e-12, "wrong distance");
+  Simulator::Schedule (Seconds (3.1), &MobilityManagerTestCase::Move, this);
+}
+
+void
+MobilityManagerTestCase::DoRun (void)
+{
+  m_manager = MobilityManager::Get ();
+
+  Ptr<ConstantVelocityMobilityModel> velocity = CreateObject<ConstantVelocityMobilityModel> ();
+  velocity->SetPosition (Vector (1, 2, 3));
+  velocity->SetVelocity (Vector (1, -1, 0.5));
+  NS_TEST_ASSERT_MSG_EQ (m_manager->Add (velocity), 0, "wrong index");
+
+  Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (5, 5, 0));
+  m_manager->Add (position);
+
+  Ptr<ConstantAccelerationMobilityModel> acceleration = CreateObject<ConstantAccelerationMobilityModel> ();
+  acceleration->SetVelocityAndAcceleration (Vector (1, 0, 0), Vector (0.5, 0.1, 0));
+  NS_TEST_ASSERT_MSG_EQ (acceleration->IsPiecewiseLinear (), false, "the model is not piecewise linear");
+  m_manager->Add (acceleration);
+
+  Ptr<RandomRectanglePositionAllocator> allocator = CreateObject<RandomRectanglePositionAllocator> ();
+  allocator->SetAttribute ("X", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+  allocator->SetAttribute ("Y", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+  allocator->AssignStreams (1);
+
+  std::vector<Ptr<MobilityModel> > models;
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      Ptr<MobilityModel> walk = CreateObject<RandomWalk2dMobilityModel> ();
+      walk->SetAttribute ("Bounds", RectangleValue (Rectangle (0, 100, 0, 100)));
+      walk->SetAttribute ("Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"));
+      walk->SetAttribute ("Time", StringValue ("1.3s"));
+      models.push_back (walk);
+      Ptr<MobilityModel> direction = CreateObject<RandomDirection2dMobilityModel> ();
+      direction->SetAttribute ("Bounds", RectangleValue (Rectangle (0, 100, 0, 100)));
+      direction->SetAttribute ("Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.5]"));
+      models.push_back (direction);
+      Ptr<MobilityModel> waypoint = CreateObject<RandomWaypointMobilityModel> ();
+      waypoint->SetAttribute ("PositionAllocator", PointerValue (allocator));
+      waypoint->SetAttribute ("Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.2]"));
+      models.push_back (waypoint);
+      Ptr<MobilityModel> gaussMarkov = CreateObject<GaussMarkovMobilityModel> ();
+      gaussMarkov->SetAttribute ("TimeStep", StringValue ("0.5s"));
+      models.push_back (gaussMarkov);
+    }
+  int64_t stream = 10;
+  for (uint32_t i = 0; i < models.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (models[i]->IsPiecewiseLinear (), true, "the model is piecewise linear");
+      models[i]->SetPosition (allocator->GetNext ());
+      stream += models[i]->AssignStreams (stream);
+      NS_TEST_ASSERT_MSG_EQ (m_manager->Add (models[i]), i + 3, "wrong index");
+      NS_TEST_ASSERT_MSG_EQ (m_manager->GetIndex (models[i]), i + 3, "wrong index");
+      models[i]->Initialize ();
+    }
+
+  Simulator::Schedule (Seconds (0.1), &MobilityManagerTestCase::Check, this);
+  Simulator::Schedule (Seconds (2.0), &MobilityManagerTestCase::Move, this);
+  Simulator::Stop (Seconds (60));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_GT (m_checks, 150, "the positions were not checked");
+  m_manager = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * MobilityManager test suite
+ */
+class MobilityManagerTestSuite : public TestSuite
+{
+public:
+  MobilityManagerTestSuite ();
+};
+
+MobilityManagerTestSuite::MobilityManagerTestSuite ()
+  : TestSuite ("mobility-manager", UNIT)
+{
+  AddTestCase (new MobilityManagerTestCase, TestCase::QUICK);
+}
+
+static MobilityManagerTestSuite g_mobilityManagerTestSuite; //!< the test suite
@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
+#include "ns3/rectangle.h"
+#include "ns3/mobility-tick-scheduler.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/random-direction-2d-mobility-model.h"
+#include "ns3/random-waypoint-mobility-model.h"
+#include "ns3/gauss-markov-mobility-model.h"
+#include "ns3/position-allocator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MobilityTickSchedulerTest");
+
+/**
+ * Check that the random mobility models follow the same trajectories
+ * when their updates are run by the MobilityTickScheduler: the course
+ * changes of the models, with their times, positions and velocities,
+ * are recorded with and without the scheduler, and compared.
+ */
+class MobilityTickSchedulerTestCase : public TestCase
+{
+public:
+  MobilityTickSchedulerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** A course change of a model. */
+  struct Change
+  {
+    uint32_t model;   //!< the index of the model
+    Time time;        //!< the time of the change
+    Vector position;  //!< the position of the model
+    Vector velocity;  //!< the velocity of the model
+  };
+  /**
+   * Move the models.
+   * \param tick whether to use the MobilityTickScheduler
+   * \param [out] changes the course changes of the models
+   */
+  void Simulate (bool tick, std::vector<Change> &changes);
+  /**
+   * Record a course change.
+   * \param changes the course changes
+   * \param index the index of the model
+   * \param model the model
+   */
+  static void CourseChange (std::vector<Change> *changes, uint32_t index, Ptr<const MobilityModel> model);
+  /**
+   * Move a model, which cancels its pending update.
+   * \param model the model
+   */
+  static void Move (Ptr<MobilityModel> model);
+
+  uint64_t m_ticks;  //!< the number of ticks of the MobilityTickScheduler
+};
+
+MobilityTickSchedulerTestCase::MobilityTickSchedulerTestCase ()
+  : TestCase ("Check the trajectories of the models updated by the MobilityTickScheduler"),
+    m_ticks (0)
+{
+}
+
+void
+MobilityTickSchedulerTestCase::CourseChange (std::vector<Change> *changes, uint32_t index,
+                                             Ptr<const MobilityModel> model)
+{
+  Change change;
+  change.model = index;
+  change.time = Simulator::Now ();
+  change.position = model->GetPosition ();
+  change.velocity = model->GetVelocity ();
+  changes->push_back (change);
+}
+
+void
+MobilityTickSchedulerTestCase::Move (Ptr<MobilityModel> model)
+{
+  model->SetPosition (Vector (50, 50, 0));
+}
+
+void
+MobilityTickSchedulerTestCase::Simulate (bool tick, std::vector<Change> &changes)
+{
+  GlobalValue::Bind ("MobilityTickScheduler", BooleanValue (tick));
+
+  Ptr<RandomRectanglePositionAllocator> allocator = CreateObject<RandomRectanglePositionAllocator> ();
+  allocator->SetAttribute ("X", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+  allocator->SetAttribute ("Y", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+  allocator->AssignStreams (1);
+
+  std::vector<Ptr<MobilityModel> > models;
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      Ptr<MobilityModel> walk = CreateObject<RandomWalk2dMobilityModel> ();
+      walk->SetAttribute ("Bounds", RectangleValue (Rectangle (0, 100, 0, 100)));
+      walk->SetAttribute ("Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"));
+      walk->SetAttribute ("Time", StringValue ("1s"));
+      models.push_back (walk);
+      Ptr<MobilityModel> direction = CreateObject<RandomDirection2dMobilityModel> ();
+      direction->SetAttribute ("Bounds", RectangleValue (Rectangle (0, 100, 0, 100)));
+      direction->SetAttribute ("Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.5]"));
+      models.push_back (direction);
+      Ptr<MobilityModel> waypoint = CreateObject<RandomWaypointMobilityModel> ();
+      waypoint->SetAttribute ("PositionAllocator", PointerValue (allocator));
+      waypoint->SetAttribute ("Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.2]"));
+      models.push_back (waypoint);
+      Ptr<MobilityModel> gaussMarkov = CreateObject<GaussMarkovMobilityModel> ();
+      gaussMarkov->SetAttribute ("TimeStep", StringValue ("0.5s"));
+      models.push_back (gaussMarkov);
+    }
+  int64_t stream = 10;
+  for (uint32_t i = 0; i < models.size (); ++i)
+    {
+      models[i]->SetPosition (allocator->GetNext ());
+      stream += models[i]->AssignStreams (stream);
+      models[i]->TraceConnectWithoutContext ("CourseChange",
+                                             MakeBoundCallback (&MobilityTickSchedulerTestCase::CourseChange,
+                                                                &changes, i));
+      models[i]->Initialize ();
+    }
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Simulator::Schedule (Seconds (7.3 + i), &MobilityTickSchedulerTestCase::Move, models[i]);
+    }
+
+  Simulator::Stop (Seconds (30));
+  Simulator::Run ();
+  m_ticks = tick ? MobilityTickScheduler::Get ()->GetTicks () : 0;
+  Simulator::Destroy ();
+}
+
+void
+MobilityTickSchedulerTestCase::DoRun (void)
+{
+  std::vector<Change> reference;
+  Simulate (false, reference);
+  std::vector<Change> changes;
+  Simulate (true, changes);
+  GlobalValue::Bind ("MobilityTickScheduler", BooleanValue (false));
+
+  NS_TEST_ASSERT_MSG_GT (m_ticks, 0, "the MobilityTickScheduler was not used");
+  NS_TEST_ASSERT_MSG_LT (m_ticks, changes.size (), "the updates were not run in batches");
+  NS_TEST_ASSERT_MSG_EQ (changes.size (), reference.size (), "wrong number of course changes");
+  // the course changes at the same time may be notified in another order
+  std::vector<std::vector<Change> > expected (80);
+  std::vector<std::vector<Change> > actual (80);
+  for (uint32_t i = 0; i < reference.size (); ++i)
+    {
+      expected[reference[i].model].push_back (reference[i]);
+      actual[changes[i].model].push_back (changes[i]);
+    }
+  for (uint32_t m = 0; m < expected.size (); ++m)
+    {
+      NS_TEST_ASSERT_MSG_EQ (actual[m].size (), expected[m].size (), "wrong number of course changes of model " << m);
+      for (uint32_t i = 0; i < expected[m].size (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (actual[m][i].time, expected[m][i].time, "wrong time of model " << m);
+          NS_TEST_ASSERT_MSG_EQ (actual[m][i].position, expected[m][i].position, "wrong position of model " << m);
+          NS_TEST_ASSERT_MSG_EQ (actual[m][i].velocity, expected[m][i].velocity, "wrong velocity of model " << m);
+        }
+    }
+}
+
+/**
+ * MobilityTickScheduler test suite
+ */
+class MobilityTickSchedulerTestSuite : public TestSuite
+{
+public:
+  MobilityTickSchedulerTestSuite ();
+};
+
+MobilityTickSchedulerTestSuite::MobilityTickSchedulerTestSuite ()
+  : TestSuite ("mobility-tick-scheduler", UNIT)
+{
+  AddTestCase (new MobilityTickSchedulerTestCase, TestCase::QUICK);
+}
+
+static MobilityTickSchedulerTestSuite g_mobilityTickSchedulerTestSuite; //!< the test suite
@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ * Benchmark of the exchange of packets between the MPI ranks.
+ *
+ * The ranks form a ring: each rank holds "pairs" nodes, each linked by
+ * a point-to-point channel to a node of the next rank.  Every node sends
+ * raw packets at a constant rate to the node on the other side of its
+ * link, so that all the packets cross the ranks.  The number of packets
+ * received by the nodes is checked against the number of packets sent,
+ * and the number of packets exchanged per second of wall clock time is
+ * reported by rank 0.
+ *
+ * It runs on a single host, for instance:
+ *
+ *   mpirun -np 2 ./waf --run "packet-exchange-distributed --aggregate=false"
+ *   mpirun -np 4 ./waf --run "packet-exchange-distributed --nullmsg --metadata=false"
+ *
+ * The global values MpiPacketAggregation and MpiPacketMetadata select
+ * how the packets are sent to the other ranks.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/point-to-point-helper.h"
+#include <mpi.h>
+
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("PacketExchangeDistributed");
+
+namespace {
+
+/** The protocol number of the packets, carried by the point-to-point devices. */
+const uint16_t PROTOCOL = 0x0800;
+
+/** The number of packets sent by the nodes of this rank. */
+uint64_t g_sent = 0;
+/** The number of packets received by the nodes of this rank. */
+uint64_t g_received = 0;
+
+/**
+ * Send a packet, and schedule the next one.
+ * \param device The device sending the packet.
+ * \param size The size of the packets.
+ * \param interval The interval between the packets.
+ * \param stop The time after which no packet is sent.
+ */
+void
+SendPacket (Ptr<NetDevice> device, uint32_t size, Time interval, Time stop)
+{
+  if (Simulator::Now () > stop)
+    {
+      return;
+    }
+  if (device->Send (Create<Packet> (size), device->GetBroadcast (), PROTOCOL))
+    {
+      ++g_sent;
+    }
+  Simulator::Schedule (interval, &SendPacket, device, size, interval, stop);
+}
+
+/**
+ * Count a received packet.
+ * \param device The device receiving the packet.
+ * \param packet The packet.
+ * \param protocol The protocol number of the packet.
+ * \param from The address of the sender.
+ * \param to The address of the receiver.
+ * \param type The type of the packet.
+ */
+void
+ReceivePacket (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+               const Address &from, const Address &to, NetDevice::PacketType type)
+{
+  ++g_received;
+}
+
+} // unnamed namespace
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t pairs = 10;
+  double rate = 10000;
+  uint32_t size = 100;
+  Time duration = Seconds (1);
+  bool nullmsg = false;
+  bool aggregate = true;
+  bool metadata = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the exchange of packets between the MPI ranks.");
+  cmd.AddValue ("pairs", "number of links from each rank to the next one", pairs);
+  cmd.AddValue ("rate", "packets per second sent by each node", rate);
+  cmd.AddValue ("size", "size of the packets in bytes", size);
+  cmd.AddValue ("duration", "time during which the packets are sent", duration);
+  cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+  cmd.AddValue ("aggregate", "Aggregate the packets sent to a rank in one MPI message", aggregate);
+  cmd.AddValue ("metadata", "Send the metadata and tags of the packets", metadata);
+  cmd.Parse (argc, argv);
+
+  // Distributed simulation setup; by default use granted time window algorithm.
+  if (nullmsg)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::NullMessageSimulatorImpl"));
+    }
+  else
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::DistributedSimulatorImpl"));
+    }
+  GlobalValue::Bind ("MpiPacketAggregation", BooleanValue (aggregate));
+  GlobalValue::Bind ("MpiPacketMetadata", BooleanValue (metadata));
+  if (metadata)
+    {
+      PacketMetadata::Enable ();
+    }
+
+  // Enable parallel simulator with the command line arguments
+  MpiInterface::Enable (&argc, &argv);
+
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+
+  if (systemCount < 2)
+    {
+      std::cout << "This simulation requires at least 2 logical processors." << std::endl;
+      return 1;
+    }
+
+  PointToPointHelper link;
+  link.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  link.SetChannelAttribute ("Delay", StringValue ("1ms"));
+
+  // The nodes of each rank, linked to the nodes of the next rank
+  std::vector<NodeContainer> nodes (systemCount);
+  for (uint32_t rank = 0; rank < systemCount; ++rank)
+    {
+      nodes[rank].Create (pairs, rank);
+    }
+  Time interval = Seconds (1.0 / rate);
+  for (uint32_t rank = 0; rank < systemCount; ++rank)
+    {
+      uint32_t next = (rank + 1) % systemCount;
+      for (uint32_t i = 0; i < pairs; ++i)
+        {
+          NetDeviceContainer devices = link.Install (nodes[rank].Get (i), nodes[next].Get (i));
+          for (uint32_t d = 0; d < devices.GetN (); ++d)
+            {
+              Ptr<NetDevice> device = devices.Get (d);
+              Ptr<Node> node = device->GetNode ();
+              if (node->GetSystemId () != systemId)
+                {
+                  continue;
+                }
+              node->RegisterProtocolHandler (MakeCallback (&ReceivePacket), PROTOCOL, device);
+              // Spread the start of the senders over the interval
+              Time start = Seconds ((d * pairs + i) / (2.0 * pairs * rate));
+              Simulator::ScheduleWithContext (node->GetId (), start,
+                                              &SendPacket, device, size, interval, duration);
+            }
+        }
+    }
+
+  // Leave the time to the last packets to be received
+  Simulator::Stop (duration + MilliSeconds (10));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+  Simulator::Destroy ();
+
+  uint64_t local[2] = { g_sent, g_received };
+  uint64_t total[2] = { 0, 0 };
+  MPI_Reduce (local, total, 2, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+  int64_t maxMs = 0;
+  MPI_Reduce (&ms, &maxMs, 1, MPI_INT64_T, MPI_MAX, 0, MPI_COMM_WORLD);
+
+  if (systemId == 0)
+    {
+      std::cout << (nullmsg ? "null-message" : "granted-time-window")
+                << ", " << systemCount << " ranks, " << pairs << " pairs, "
+                << (aggregate ? "aggregated" : "not aggregated") << ", "
+                << (metadata ? "with" : "without") << " metadata" << std::endl
+                << std::setw (12) << total[0] << " sent "
+                << std::setw (12) << total[1] << " received "
+                << std::setw (8) << maxMs << " ms "
+                << std::setw (12) << std::fixed << std::setprecision (0)
+                << total[1] * 1000.0 / std::max<int64_t> (maxMs, 1) << " packets/s" << std::endl;
+    }
+
+  // Exit the MPI execution environment
+  MpiInterface::Disable ();
+  return total[0] == total[1] || systemId != 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ * Automatic partition of a topology across the MPI ranks.
+ *
+ * The topology is made of clusters of nodes, each cluster being a ring
+ * of point-to-point links with a short delay, the clusters being joined
+ * in a ring by links with a long delay.  The nodes are created without
+ * system id, and the MpiPartitionHelper assigns them to the ranks, then
+ * converts the links cut between the ranks to remote links.  The nodes
+ * send raw packets to their neighbors, and the number of packets
+ * received is checked against the number of packets sent.
+ *
+ * A pilot run, in a single process, records the number of packets
+ * received by each node, which can then be used as the load of the
+ * nodes:
+ *
+ *   ./waf --run "partition-distributed --pilot=weights.txt"
+ *   mpirun -np 4 ./waf --run "partition-distributed --weights=weights.txt"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-partition-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include <mpi.h>
+
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("PartitionDistributed");
+
+namespace {
+
+/** The protocol number of the packets, carried by the point-to-point devices. */
+const uint16_t PROTOCOL = 0x0800;
+
+/** The number of packets sent by the nodes of this rank. */
+uint64_t g_sent = 0;
+/** The number of packets received by the nodes of this rank. */
+uint64_t g_received = 0;
+
+/**
+ * Send a packet, and schedule the next one.
+ * \param device The device sending the packet.
+ * \param interval The interval between the packets.
+ * \param stop The time after which no packet is sent.
+ */
+void
+SendPacket (Ptr<NetDevice> device, Time interval, Time stop)
+{
+  if (Simulator::Now () > stop)
+    {
+      return;
+    }
+  if (device->Send (Create<Packet> (100), device->GetBroadcast (), PROTOCOL))
+    {
+      ++g_sent;
+    }
+  Simulator::Schedule (interval, &SendPacket, device, interval, stop);
+}
+
+/**
+ * Count a received packet.
+ * \param device The device receiving the packet.
+ * \param packet The packet.
+ * \param protocol The protocol number of the packet.
+ * \param from The address of the sender.
+ * \param to The address of the receiver.
+ * \param type The type of the packet.
+ */
+void
+ReceivePacket (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+               const Address &from, const Address &to, NetDevice::PacketType type)
+{
+  ++g_received;
+}
+
+} // unnamed namespace
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t clusters = 8;
+  uint32_t size = 16;
+  Time duration = Seconds (1);
+  bool nullmsg = false;
+  std::string pilot;
+  std::string weights;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("clusters", "number of clusters", clusters);
+  cmd.AddValue ("size", "number of nodes per cluster", size);
+  cmd.AddValue ("duration", "time during which the packets are sent", duration);
+  cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+  cmd.AddValue ("pilot", "Run serially, and write the load of the nodes to this file", pilot);
+  cmd.AddValue ("weights", "Read the load of the nodes from this file", weights);
+  cmd.Parse (argc, argv);
+
+  uint32_t systemId = 0;
+  if (pilot.empty ())
+    {
+      // Distributed simulation setup; by default use granted time window algorithm.
+      if (nullmsg)
+        {
+          GlobalValue::Bind ("SimulatorImplementationType",
+                             StringValue ("ns3::NullMessageSimulatorImpl"));
+        }
+      else
+        {
+          GlobalValue::Bind ("SimulatorImplementationType",
+                             StringValue ("ns3::DistributedSimulatorImpl"));
+        }
+
+      // Enable parallel simulator with the command line arguments
+      MpiInterface::Enable (&argc, &argv);
+      systemId = MpiInterface::GetSystemId ();
+    }
+
+  // The clusters, then the links between the clusters; the nodes have
+  // no system id.
+  PointToPointHelper clusterLink;
+  clusterLink.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  clusterLink.SetChannelAttribute ("Delay", StringValue ("100us"));
+  PointToPointHelper backbone;
+  backbone.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  backbone.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  std::vector<NodeContainer> nodes (clusters);
+  for (uint32_t c = 0; c < clusters; ++c)
+    {
+      nodes[c].Create (size);
+      for (uint32_t i = 0; i < size; ++i)
+        {
+          clusterLink.Install (nodes[c].Get (i), nodes[c].Get ((i + 1) % size));
+        }
+    }
+  for (uint32_t c = 0; c < clusters; ++c)
+    {
+      backbone.Install (nodes[c].Get (0), nodes[(c + 1) % clusters].Get (size / 2));
+    }
+
+  if (pilot.empty ())
+    {
+      MpiPartitionHelper partition;
+      if (!weights.empty ())
+        {
+          partition.ReadWeights (weights);
+        }
+      partition.Install ();
+      if (systemId == 0)
+        {
+          std::cout << "Partition into " << MpiInterface::GetSize () << " ranks: lookahead "
+                    << partition.GetLookahead ().As (Time::MS) << ", "
+                    << partition.GetCutSize () << " links cut, imbalance "
+                    << partition.GetImbalance () << std::endl;
+        }
+    }
+  else
+    {
+      MpiPartitionHelper::EnablePilot (pilot);
+    }
+
+  // The traffic, sent and received by the nodes of this rank; the first
+  // node of each cluster sends more packets than the others.
+  uint32_t nodesOfRank = 0;
+  for (NodeList::Iterator n = NodeList::Begin (); n != NodeList::End (); ++n)
+    {
+      Ptr<Node> node = *n;
+      if (node->GetSystemId () != systemId)
+        {
+          continue;
+        }
+      ++nodesOfRank;
+      node->RegisterProtocolHandler (MakeCallback (&ReceivePacket), PROTOCOL, 0);
+      Time interval = node->GetId () % size == 0 ? MicroSeconds (100) : MilliSeconds (1);
+      for (uint32_t d = 0; d < node->GetNDevices (); ++d)
+        {
+          Simulator::ScheduleWithContext (node->GetId (), Seconds (0),
+                                          &SendPacket, node->GetDevice (d), interval, duration);
+        }
+    }
+
+  // Leave the time to the last packets to be received
+  Simulator::Stop (duration + MilliSeconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  if (!pilot.empty ())
+    {
+      std::cout << g_sent << " sent " << g_received << " received" << std::endl;
+      return g_sent == g_received ? 0 : 1;
+    }
+
+  uint64_t local[2] = { g_sent, g_received };
+  uint64_t total[2] = { 0, 0 };
+  MPI_Reduce (local, total, 2, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+  std::cout << "Rank " << systemId << ": " << nodesOfRank << " nodes, "
+            << g_sent << " sent, " << g_received << " received" << std::endl;
+  if (systemId == 0)
+    {
+      std::cout << total[0] << " sent " << total[1] << " received" << std::endl;
+    }
+
+  // Exit the MPI execution environment
+  MpiInterface::Disable ();
+  return total[0] == total[1] || systemId != 0 ? 0 : 1;
+}
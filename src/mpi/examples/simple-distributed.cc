@@ -39,6 +39,11 @@
  *
  * One packet is sent from each left leaf node.  The packet sinks on the
  * right leaf nodes output logging information when they receive the packet.
+ *
+ * With --stop=false the simulation is not stopped at 5 s, but runs until
+ * no event is left on any logical processor.  With --testing the
+ * receptions are printed on the standard output, for the regression
+ * tests of the mpi module.
  */
 
 #include "ns3/core-module.h"
@@ -57,18 +62,34 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("SimpleDistributed");
 
+/**
+ * Print a packet received by a sink, for the regression tests
+ * \param packet the packet received
+ * \param from the address of the sender
+ */
+void
+SinkRx (Ptr<const Packet> packet, const Address &from)
+{
+  std::cout << "TEST " << Simulator::Now ().As (Time::S) << " received " << packet->GetSize ()
+            << " bytes from " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << std::endl;
+}
+
 int
 main (int argc, char *argv[])
 {
   bool nix = true;
   bool nullmsg = false;
   bool tracing = false;
+  bool stop = true;
+  bool testing = false;
 
   // Parse command line
   CommandLine cmd (__FILE__);
   cmd.AddValue ("nix", "Enable the use of nix-vector or global routing", nix);
   cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
   cmd.AddValue ("tracing", "Enable pcap tracing", tracing);
+  cmd.AddValue ("stop", "Stop the simulation at 5 s, instead of running it until no event is left", stop);
+  cmd.AddValue ("testing", "Print the receptions of the sinks, for the regression tests", testing);
   cmd.Parse (argc, argv);
 
   // Distributed simulation setup; by default use granted time window algorithm.
@@ -86,7 +107,10 @@ main (int argc, char *argv[])
   // Enable parallel simulator with the command line arguments
   MpiInterface::Enable (&argc, &argv);
 
-  LogComponentEnable ("PacketSink", LOG_LEVEL_INFO);
+  if (!testing)
+    {
+      LogComponentEnable ("PacketSink", LOG_LEVEL_INFO);
+    }
 
   uint32_t systemId = MpiInterface::GetSystemId ();
   uint32_t systemCount = MpiInterface::GetSize ();
@@ -237,6 +261,13 @@ main (int argc, char *argv[])
         }
       sinkApp.Start (Seconds (1.0));
       sinkApp.Stop (Seconds (5));
+      if (testing)
+        {
+          for (uint32_t i = 0; i < 4; ++i)
+            {
+              sinkApp.Get (i)->TraceConnectWithoutContext ("Rx", MakeCallback (&SinkRx));
+            }
+        }
     }
 
   // Create the OnOff applications to send
@@ -260,8 +291,15 @@ main (int argc, char *argv[])
       clientApps.Stop (Seconds (5));
     }
 
-  Simulator::Stop (Seconds (5));
+  if (stop)
+    {
+      Simulator::Stop (Seconds (5));
+    }
   Simulator::Run ();
+  if (testing)
+    {
+      std::cout << "TEST rank " << systemId << " stopped" << std::endl;
+    }
   Simulator::Destroy ();
   // Exit the MPI execution environment
   MpiInterface::Disable ();
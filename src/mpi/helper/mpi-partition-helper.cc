@@ -0,0 +1,738 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mpi-partition-helper.h"
+#include "ns3/mpi-interface.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+#include "ns3/packet.h"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpiPartitionHelper");
+
+namespace {
+
+/**
+ * A weighted graph, with its adjacency in compressed rows.
+ */
+struct Graph
+{
+  std::vector<double> weight;     //!< the weight of the vertices
+  std::vector<uint32_t> start;    //!< the first edge of each vertex, and the end of the edges
+  std::vector<uint32_t> adj;      //!< the other vertex of the edges
+  std::vector<double> edge;       //!< the weight of the edges
+
+  /** \return the number of vertices */
+  uint32_t GetN (void) const
+  {
+    return weight.size ();
+  }
+};
+
+/** An edge of a graph being built. */
+struct Edge
+{
+  uint32_t u;     //!< a vertex
+  uint32_t v;     //!< the other vertex
+  double weight;  //!< the weight of the edge
+
+  /**
+   * \param other another edge
+   * \return whether this edge is ordered before the other
+   */
+  bool operator < (const Edge &other) const
+  {
+    return u < other.u || (u == other.u && v < other.v);
+  }
+};
+
+/**
+ * Build a graph, merging the parallel edges and dropping the loops.
+ * \param weight the weight of the vertices
+ * \param edges the edges, in one direction
+ * \return the graph
+ */
+Graph
+MakeGraph (const std::vector<double> &weight, std::vector<Edge> edges)
+{
+  uint32_t n = edges.size ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Edge reverse = { edges[i].v, edges[i].u, edges[i].weight };
+      edges.push_back (reverse);
+    }
+  std::sort (edges.begin (), edges.end ());
+
+  Graph g;
+  g.weight = weight;
+  g.start.assign (weight.size () + 1, 0);
+  for (std::vector<Edge>::const_iterator i = edges.begin (); i != edges.end (); ++i)
+    {
+      if (i->u == i->v)
+        {
+          continue;
+        }
+      if (!g.adj.empty () && g.adj.back () == i->v && g.start[i->u + 1] > 0)
+        {
+          // a parallel edge of the last edge of the same vertex
+          g.edge.back () += i->weight;
+          continue;
+        }
+      g.adj.push_back (i->v);
+      g.edge.push_back (i->weight);
+      g.start[i->u + 1] = g.adj.size ();
+    }
+  // the vertices without edges start where the previous vertex ends
+  for (uint32_t v = 1; v < g.start.size (); ++v)
+    {
+      g.start[v] = std::max (g.start[v], g.start[v - 1]);
+    }
+  return g;
+}
+
+/**
+ * Find the representative of a set, with path compression.
+ * \param parent the parent of each element
+ * \param x an element
+ * \return the representative of the set of the element
+ */
+uint32_t
+FindSet (std::vector<uint32_t> &parent, uint32_t x)
+{
+  while (parent[x] != x)
+    {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+  return x;
+}
+
+/**
+ * Assign weights to bins, the heaviest first, each to the lightest bin.
+ * \param weight the weights
+ * \param k the number of bins
+ * \return the weight of the heaviest bin
+ */
+double
+PackBins (std::vector<double> weight, uint32_t k)
+{
+  std::sort (weight.begin (), weight.end (), std::greater<double> ());
+  std::vector<double> bins (k, 0);
+  for (uint32_t i = 0; i < weight.size (); ++i)
+    {
+      *std::min_element (bins.begin (), bins.end ()) += weight[i];
+    }
+  return *std::max_element (bins.begin (), bins.end ());
+}
+
+/**
+ * Coarsen a graph by merging the vertices joined by the heaviest edges.
+ * \param g the graph
+ * \param maxWeight the maximum weight of a merged vertex
+ * \param [out] map the coarse vertex of each vertex
+ * \return the coarse graph
+ */
+Graph
+Coarsen (const Graph &g, double maxWeight, std::vector<uint32_t> &map)
+{
+  uint32_t n = g.GetN ();
+  const uint32_t NONE = 0xffffffff;
+  std::vector<uint32_t> match (n, NONE);
+  // the light vertices first, so that the heavy ones do not absorb all
+  // their neighbors
+  std::vector<std::pair<double, uint32_t> > order (n);
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      order[v] = std::make_pair (g.weight[v], v);
+    }
+  std::sort (order.begin (), order.end ());
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint32_t v = order[i].second;
+      if (match[v] != NONE)
+        {
+          continue;
+        }
+      uint32_t best = v;
+      double bestEdge = 0;
+      for (uint32_t e = g.start[v]; e < g.start[v + 1]; ++e)
+        {
+          uint32_t u = g.adj[e];
+          if (match[u] == NONE && g.edge[e] > bestEdge
+              && g.weight[u] + g.weight[v] <= maxWeight)
+            {
+              best = u;
+              bestEdge = g.edge[e];
+            }
+        }
+      match[v] = best;
+      match[best] = v;
+    }
+
+  map.assign (n, NONE);
+  std::vector<double> weight;
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      if (map[v] == NONE)
+        {
+          map[v] = weight.size ();
+          map[match[v]] = weight.size ();
+          weight.push_back (g.weight[v] + (match[v] != v ? g.weight[match[v]] : 0));
+        }
+    }
+  std::vector<Edge> edges;
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      for (uint32_t e = g.start[v]; e < g.start[v + 1]; ++e)
+        {
+          if (v < g.adj[e])
+            {
+              Edge edge = { map[v], map[g.adj[e]], g.edge[e] };
+              edges.push_back (edge);
+            }
+        }
+    }
+  return MakeGraph (weight, edges);
+}
+
+/**
+ * Partition the coarsest graph by growing the parts one after the
+ * other, each from the vertex most connected to the previous parts,
+ * adding the vertex most connected to the part until it reaches its
+ * share of the weight.
+ * \param g the graph
+ * \param k the number of parts
+ * \return the part of each vertex
+ */
+std::vector<uint32_t>
+GrowParts (const Graph &g, uint32_t k)
+{
+  uint32_t n = g.GetN ();
+  const uint32_t NONE = 0xffffffff;
+  double total = 0;
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      total += g.weight[v];
+    }
+  std::vector<uint32_t> part (n, NONE);
+  // the connection of the unassigned vertices to the assigned ones
+  std::vector<double> assigned (n, 0);
+  uint32_t remaining = n;
+  double remainingWeight = total;
+  for (uint32_t p = 0; p + 1 < k && remaining > 0; ++p)
+    {
+      double target = remainingWeight / (k - p);
+      // the candidates, ordered by decreasing connection to the part
+      std::set<std::pair<double, uint32_t> > candidates;
+      std::vector<double> gain (n, 0);
+      uint32_t seed = NONE;
+      for (uint32_t v = 0; v < n; ++v)
+        {
+          if (part[v] == NONE && (seed == NONE || assigned[v] > assigned[seed]))
+            {
+              seed = v;
+            }
+        }
+      candidates.insert (std::make_pair (0, seed));
+      double load = 0;
+      while (!candidates.empty () && remaining > k - p - 1)
+        {
+          uint32_t v = candidates.begin ()->second;
+          candidates.erase (candidates.begin ());
+          if (load > 0 && load + g.weight[v] > target
+              && load + g.weight[v] - target > target - load)
+            {
+              break;
+            }
+          part[v] = p;
+          load += g.weight[v];
+          --remaining;
+          for (uint32_t e = g.start[v]; e < g.start[v + 1]; ++e)
+            {
+              uint32_t u = g.adj[e];
+              assigned[u] += g.edge[e];
+              if (part[u] == NONE)
+                {
+                  candidates.erase (std::make_pair (-gain[u], u));
+                  gain[u] += g.edge[e];
+                  candidates.insert (std::make_pair (-gain[u], u));
+                }
+            }
+          if (candidates.empty () && load < target)
+            {
+              // the part is not connected to the other vertices
+              for (uint32_t u = 0; u < n; ++u)
+                {
+                  if (part[u] == NONE)
+                    {
+                      candidates.insert (std::make_pair (0, u));
+                      break;
+                    }
+                }
+            }
+        }
+      remainingWeight -= load;
+    }
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      if (part[v] == NONE)
+        {
+          part[v] = k - 1;
+        }
+    }
+  return part;
+}
+
+/**
+ * Refine a partition by moving the vertices to the part they are the
+ * most connected to, as long as the cut decreases, or the balance
+ * improves without increasing the cut.
+ * \param g the graph
+ * \param k the number of parts
+ * \param maxLoad the maximum weight of a part
+ * \param [in,out] part the part of each vertex
+ */
+void
+Refine (const Graph &g, uint32_t k, double maxLoad, std::vector<uint32_t> &part)
+{
+  uint32_t n = g.GetN ();
+  std::vector<double> load (k, 0);
+  for (uint32_t v = 0; v < n; ++v)
+    {
+      load[part[v]] += g.weight[v];
+    }
+  std::vector<double> connection (k, 0);
+  for (uint32_t pass = 0; pass < 10; ++pass)
+    {
+      bool moved = false;
+      for (uint32_t v = 0; v < n; ++v)
+        {
+          uint32_t from = part[v];
+          for (uint32_t e = g.start[v]; e < g.start[v + 1]; ++e)
+            {
+              connection[part[g.adj[e]]] += g.edge[e];
+            }
+          bool overloaded = load[from] > maxLoad;
+          uint32_t best = from;
+          double bestGain = 0;
+          for (uint32_t p = 0; p < k; ++p)
+            {
+              if (p == from || load[p] + g.weight[v] > maxLoad
+                  || (connection[p] == 0 && !overloaded))
+                {
+                  continue;
+                }
+              double gain = connection[p] - connection[from];
+              bool balances = load[p] + g.weight[v] < load[from];
+              if ((best == from && (gain > 0 || (gain == 0 && balances) || overloaded))
+                  || (best != from && (gain > bestGain || (gain == bestGain && load[p] < load[best]))))
+                {
+                  best = p;
+                  bestGain = gain;
+                }
+            }
+          for (uint32_t e = g.start[v]; e < g.start[v + 1]; ++e)
+            {
+              connection[part[g.adj[e]]] = 0;
+            }
+          if (best != from)
+            {
+              part[v] = best;
+              load[from] -= g.weight[v];
+              load[best] += g.weight[v];
+              moved = true;
+            }
+        }
+      if (!moved)
+        {
+          break;
+        }
+    }
+}
+
+/**
+ * Partition a graph with the multilevel scheme.
+ * \param g the graph
+ * \param k the number of parts
+ * \param maxLoad the maximum weight of a part
+ * \return the part of each vertex
+ */
+std::vector<uint32_t>
+PartitionGraph (const Graph &g, uint32_t k, double maxLoad)
+{
+  // Stop coarsening once the graph is small enough to be partitioned
+  // directly, or when the vertices can no more be merged.
+  const uint32_t COARSEST = 16;
+  std::vector<Graph> levels (1, g);
+  std::vector<std::vector<uint32_t> > maps;
+  while (levels.back ().GetN () > COARSEST * k)
+    {
+      std::vector<uint32_t> map;
+      Graph coarse = Coarsen (levels.back (), maxLoad / 2, map);
+      if (coarse.GetN () > 0.95 * levels.back ().GetN ())
+        {
+          break;
+        }
+      levels.push_back (coarse);
+      maps.push_back (map);
+    }
+  NS_LOG_LOGIC ("coarsest graph of " << levels.back ().GetN () << " vertices after "
+                << maps.size () << " levels");
+
+  std::vector<uint32_t> part = GrowParts (levels.back (), k);
+  Refine (levels.back (), k, maxLoad, part);
+  for (uint32_t level = maps.size (); level > 0; --level)
+    {
+      const std::vector<uint32_t> &map = maps[level - 1];
+      std::vector<uint32_t> fine (map.size ());
+      for (uint32_t v = 0; v < map.size (); ++v)
+        {
+          fine[v] = part[map[v]];
+        }
+      part.swap (fine);
+      Refine (levels[level - 1], k, maxLoad, part);
+    }
+  return part;
+}
+
+/** The file written by the pilot run. */
+std::string g_pilotFilename;
+/** The number of packets received by each node during the pilot run. */
+std::vector<uint64_t> g_pilotPackets;
+
+/**
+ * Count a packet received during the pilot run.
+ * \param device the device receiving the packet
+ * \param packet the packet
+ * \param protocol the protocol number of the packet
+ * \param from the address of the sender
+ * \param to the address of the receiver
+ * \param type the type of the packet
+ */
+void
+PilotReceive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+              const Address &from, const Address &to, NetDevice::PacketType type)
+{
+  uint32_t node = device->GetNode ()->GetId ();
+  if (node < g_pilotPackets.size ())
+    {
+      ++g_pilotPackets[node];
+    }
+}
+
+/**
+ * Write the load of the nodes measured by the pilot run.
+ */
+void
+WritePilot (void)
+{
+  std::ofstream os (g_pilotFilename.c_str ());
+  NS_ABORT_MSG_UNLESS (os.is_open (), "Can't open file " << g_pilotFilename);
+  for (uint32_t i = 0; i < g_pilotPackets.size (); ++i)
+    {
+      os << i << " " << 1 + g_pilotPackets[i] << std::endl;
+    }
+  g_pilotPackets.clear ();
+}
+
+} // unnamed namespace
+
+MpiPartitionHelper::MpiPartitionHelper ()
+  : m_imbalance (0.1),
+    m_lookahead (Time::Max ()),
+    m_maxImbalance (0),
+    m_cutSize (0)
+{
+}
+
+void
+MpiPartitionHelper::SetImbalance (double imbalance)
+{
+  NS_LOG_FUNCTION (this << imbalance);
+  NS_ABORT_MSG_IF (imbalance < 0, "The imbalance must be positive");
+  m_imbalance = imbalance;
+}
+
+void
+MpiPartitionHelper::SetNodeWeight (Ptr<Node> node, double weight)
+{
+  NS_LOG_FUNCTION (this << node << weight);
+  m_weights[node->GetId ()] = weight;
+}
+
+void
+MpiPartitionHelper::ReadWeights (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream is (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (is.is_open (), "Can't open file " << filename);
+  uint32_t node;
+  double weight;
+  while (is >> node >> weight)
+    {
+      m_weights[node] = weight;
+    }
+}
+
+std::vector<std::pair<TypeId, MpiPartitionHelper::ChannelConverter> > &
+MpiPartitionHelper::GetConverters (void)
+{
+  static std::vector<std::pair<TypeId, ChannelConverter> > converters;
+  return converters;
+}
+
+void
+MpiPartitionHelper::AddChannelConverter (TypeId tid, ChannelConverter converter)
+{
+  GetConverters ().push_back (std::make_pair (tid, converter));
+}
+
+bool
+MpiPartitionHelper::FindConverter (Ptr<Channel> channel, ChannelConverter &converter)
+{
+  TypeId tid = channel->GetInstanceTypeId ();
+  std::vector<std::pair<TypeId, ChannelConverter> > &converters = GetConverters ();
+  for (uint32_t i = 0; i < converters.size (); ++i)
+    {
+      if (tid == converters[i].first || tid.IsChildOf (converters[i].first))
+        {
+          converter = converters[i].second;
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+MpiPartitionHelper::BuildGraph (std::vector<Link> &links, std::vector<Ptr<Channel> > &channels) const
+{
+  NS_LOG_FUNCTION (this);
+  std::set<uint32_t> visited;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      for (uint32_t d = 0; d < (*i)->GetNDevices (); ++d)
+        {
+          Ptr<Channel> channel = (*i)->GetDevice (d)->GetChannel ();
+          if (channel == 0 || !visited.insert (channel->GetId ()).second)
+            {
+              continue;
+            }
+          TimeValue delay (Seconds (0));
+          channel->GetAttributeFailSafe ("Delay", delay);
+          ChannelConverter converter;
+          bool cuttable = FindConverter (channel, converter) && delay.Get ().IsStrictlyPositive ();
+          // the nodes of a channel are linked to the node of its first
+          // device, which is enough to keep them together or to count
+          // the links cut
+          Ptr<Node> first = channel->GetDevice (0)->GetNode ();
+          for (std::size_t j = 1; j < channel->GetNDevices (); ++j)
+            {
+              Ptr<Node> node = channel->GetDevice (j)->GetNode ();
+              if (node == first)
+                {
+                  continue;
+                }
+              Link link = { first->GetId (), node->GetId (), delay.Get (), cuttable };
+              links.push_back (link);
+              channels.push_back (channel);
+            }
+        }
+    }
+}
+
+std::vector<uint32_t>
+MpiPartitionHelper::Partition (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ABORT_MSG_IF (n == 0, "No rank to partition the nodes into");
+
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::vector<double> weight (nNodes);
+  double total = 0;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      std::map<uint32_t, double>::const_iterator w = m_weights.find (i);
+      weight[i] = w != m_weights.end () ? w->second : 1 + NodeList::GetNode (i)->GetNDevices ();
+      total += weight[i];
+    }
+  double maxLoad = (1 + m_imbalance) * total / n;
+
+  std::vector<Link> links;
+  std::vector<Ptr<Channel> > channels;
+  BuildGraph (links, channels);
+
+  // The candidate lookaheads: the links shorter than the lookahead are
+  // kept within the ranks, and the largest lookahead which leaves
+  // enough freedom to balance the load is chosen.
+  std::vector<Time> delays;
+  for (uint32_t l = 0; l < links.size (); ++l)
+    {
+      if (links[l].cuttable)
+        {
+          delays.push_back (links[l].delay);
+        }
+    }
+  std::sort (delays.begin (), delays.end (), std::greater<Time> ());
+  delays.erase (std::unique (delays.begin (), delays.end ()), delays.end ());
+  if (delays.empty ())
+    {
+      delays.push_back (Time::Max ());
+    }
+
+  std::vector<uint32_t> component;
+  std::vector<double> componentWeight;
+  for (uint32_t t = 0; t < delays.size (); ++t)
+    {
+      std::vector<uint32_t> parent (nNodes);
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          parent[i] = i;
+        }
+      for (uint32_t l = 0; l < links.size (); ++l)
+        {
+          if (!links[l].cuttable || links[l].delay < delays[t])
+            {
+              parent[FindSet (parent, links[l].a)] = FindSet (parent, links[l].b);
+            }
+        }
+      const uint32_t NONE = 0xffffffff;
+      std::vector<uint32_t> index (nNodes, NONE);
+      component.assign (nNodes, 0);
+      componentWeight.clear ();
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          uint32_t root = FindSet (parent, i);
+          if (index[root] == NONE)
+            {
+              index[root] = componentWeight.size ();
+              componentWeight.push_back (0);
+            }
+          component[i] = index[root];
+          componentWeight[component[i]] += weight[i];
+        }
+      bool feasible = componentWeight.size () >= n && PackBins (componentWeight, n) <= maxLoad;
+      NS_LOG_LOGIC ("lookahead " << delays[t].As (Time::S) << ": " << componentWeight.size ()
+                    << " components, " << (feasible ? "feasible" : "not feasible"));
+      if (feasible)
+        {
+          break;
+        }
+    }
+
+  // The graph of the components, joined by the links which may be cut
+  std::vector<Edge> edges;
+  for (uint32_t l = 0; l < links.size (); ++l)
+    {
+      Edge edge = { component[links[l].a], component[links[l].b], 1 };
+      edges.push_back (edge);
+    }
+  Graph g = MakeGraph (componentWeight, edges);
+  std::vector<uint32_t> componentPart = PartitionGraph (g, n, maxLoad);
+
+  std::vector<uint32_t> part (nNodes);
+  std::vector<double> load (n, 0);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      part[i] = componentPart[component[i]];
+      load[part[i]] += weight[i];
+    }
+  m_lookahead = Time::Max ();
+  m_cutSize = 0;
+  for (uint32_t l = 0; l < links.size (); ++l)
+    {
+      if (part[links[l].a] != part[links[l].b])
+        {
+          m_lookahead = Min (m_lookahead, links[l].delay);
+          ++m_cutSize;
+        }
+    }
+  m_maxImbalance = total > 0 ? *std::max_element (load.begin (), load.end ()) * n / total : 0;
+  NS_LOG_INFO ("partition into " << n << " ranks: lookahead " << m_lookahead.As (Time::S)
+               << ", " << m_cutSize << " links cut, imbalance " << m_maxImbalance);
+  return part;
+}
+
+void
+MpiPartitionHelper::Install (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_UNLESS (MpiInterface::IsEnabled (), "MpiInterface::Enable must be called before the partition");
+
+  std::vector<uint32_t> part = Partition (MpiInterface::GetSize ());
+  for (uint32_t i = 0; i < part.size (); ++i)
+    {
+      NodeList::GetNode (i)->SetAttribute ("SystemId", UintegerValue (part[i]));
+    }
+
+  std::vector<Link> links;
+  std::vector<Ptr<Channel> > channels;
+  BuildGraph (links, channels);
+  std::set<uint32_t> converted;
+  for (uint32_t l = 0; l < links.size (); ++l)
+    {
+      ChannelConverter converter;
+      if (converted.insert (channels[l]->GetId ()).second
+          && FindConverter (channels[l], converter) && !converter.IsNull ())
+        {
+          converter (channels[l], part[links[l].a] != part[links[l].b]);
+        }
+    }
+}
+
+Time
+MpiPartitionHelper::GetLookahead (void) const
+{
+  return m_lookahead;
+}
+
+double
+MpiPartitionHelper::GetImbalance (void) const
+{
+  return m_maxImbalance;
+}
+
+uint32_t
+MpiPartitionHelper::GetCutSize (void) const
+{
+  return m_cutSize;
+}
+
+void
+MpiPartitionHelper::EnablePilot (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  g_pilotFilename = filename;
+  g_pilotPackets.assign (NodeList::GetNNodes (), 0);
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      (*i)->RegisterProtocolHandler (MakeCallback (&PilotReceive), 0, 0);
+    }
+  Simulator::ScheduleDestroy (&WritePilot);
+}
+
+} // namespace ns3
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MPI_PARTITION_HELPER_H
+#define NS3_MPI_PARTITION_HELPER_H
+
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/type-id.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class Channel;
+class Node;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Assign the nodes of the NodeList to the MPI ranks.
+ *
+ * The helper builds the graph of the nodes linked by the channels of
+ * their devices, and partitions it so that the ranks get a similar load
+ * and the delays of the links cut between the ranks, which bound the
+ * lookahead of the distributed simulators, are as large as possible:
+ *
+ * - Only the channels whose TypeId has a registered converter (see
+ *   AddChannelConverter) can be cut, e.g. the point-to-point channels;
+ *   the nodes linked by the other channels stay on the same rank.
+ * - The largest delay such that the links shorter than the delay can be
+ *   kept within the ranks, while the load of the ranks stays within the
+ *   tolerated imbalance, is the lookahead.
+ * - Among the partitions with this lookahead, the number of links cut
+ *   is minimized by a multilevel partitioning: the graph is coarsened
+ *   by merging the nodes joined by the most links, the coarsest graph
+ *   is partitioned by growing the parts, then the partition is refined
+ *   by moving the boundary nodes while the graph is uncoarsened.
+ *
+ * The load of a node is estimated by one plus the number of its devices,
+ * by the weights set explicitly, or by the number of packets received by
+ * the node during a pilot run (see EnablePilot and ReadWeights).
+ *
+ * Install must be called by all the ranks once the topology is created,
+ * after MpiInterface::Enable and before the applications are installed
+ * on the nodes of the rank.  It sets the SystemId of the nodes, then
+ * converts the channels cut between the ranks to the remote channels,
+ * so that the topology may be created, e.g. with the point-to-point
+ * topology helpers, without any system id.  The partition is
+ * deterministic, so that all the ranks compute the same one.
+ */
+class MpiPartitionHelper
+{
+public:
+  /**
+   * A converter of the channels, called once the SystemId of the nodes
+   * is set, with the channel and whether it is cut between the ranks:
+   * it replaces the channel by a remote channel if it is cut, or by a
+   * local channel otherwise, e.g. if a topology helper created a remote
+   * channel because the system id of the nodes was not set yet.
+   */
+  typedef Callback<void, Ptr<Channel>, bool> ChannelConverter;
+
+  MpiPartitionHelper ();
+
+  /**
+   * \param imbalance the tolerated imbalance of the load of the ranks,
+   *        e.g. 0.1 for a rank to have up to 10% more load than the
+   *        average
+   */
+  void SetImbalance (double imbalance);
+  /**
+   * \param node a node
+   * \param weight the load of the node
+   */
+  void SetNodeWeight (Ptr<Node> node, double weight);
+  /**
+   * Read the load of the nodes recorded by a pilot run.
+   * \param filename the file written by the pilot run
+   */
+  void ReadWeights (std::string filename);
+
+  /**
+   * Compute the partition of the nodes.
+   * \param n the number of ranks
+   * \return the rank of each node of the NodeList
+   */
+  std::vector<uint32_t> Partition (uint32_t n);
+  /**
+   * Compute the partition of the nodes for the MPI ranks, set the
+   * SystemId of the nodes and convert the channels, depending on whether
+   * they are cut between the ranks.
+   */
+  void Install (void);
+
+  /**
+   * \return the smallest delay of the links cut by the last partition,
+   *         or the maximum simulation time if no link is cut
+   */
+  Time GetLookahead (void) const;
+  /**
+   * \return the largest load of a rank relative to the average load,
+   *         for the last partition
+   */
+  double GetImbalance (void) const;
+  /**
+   * \return the number of links cut by the last partition
+   */
+  uint32_t GetCutSize (void) const;
+
+  /**
+   * Record the number of packets received by each node during the
+   * simulation, and write them when the simulator is destroyed, to be
+   * read by ReadWeights.  Must be called in a serial run once the
+   * topology is created.
+   * \param filename the file to write
+   */
+  static void EnablePilot (std::string filename);
+  /**
+   * Allow the channels of a type, or of a subclass of the type, to be
+   * cut between the ranks.
+   * \param tid the TypeId of the channels
+   * \param converter the converter of the channels
+   */
+  static void AddChannelConverter (TypeId tid, ChannelConverter converter);
+
+private:
+  /** A link between two nodes. */
+  struct Link
+  {
+    uint32_t a;        //!< the first node
+    uint32_t b;        //!< the second node
+    Time delay;        //!< the delay of the channel
+    bool cuttable;     //!< whether the link may be cut between the ranks
+  };
+
+  /**
+   * Build the links of the nodes of the NodeList.
+   * \param [out] links the links
+   * \param [out] channels the channels, one per link
+   */
+  void BuildGraph (std::vector<Link> &links, std::vector<Ptr<Channel> > &channels) const;
+  /**
+   * \param channel a channel
+   * \param [out] converter the converter of the channel, if any
+   * \return whether the channel may be cut between the ranks
+   */
+  static bool FindConverter (Ptr<Channel> channel, ChannelConverter &converter);
+  /**
+   * \return the converters of the channels, by TypeId
+   */
+  static std::vector<std::pair<TypeId, ChannelConverter> > &GetConverters (void);
+
+  double m_imbalance;                     //!< the tolerated imbalance
+  std::map<uint32_t, double> m_weights;   //!< the load of the nodes set explicitly
+  Time m_lookahead;                       //!< the lookahead of the last partition
+  double m_maxImbalance;                  //!< the imbalance of the last partition
+  uint32_t m_cutSize;                     //!< the number of links cut by the last partition
+};
+
+} // namespace ns3
+
+#endif /* NS3_MPI_PARTITION_HELPER_H */
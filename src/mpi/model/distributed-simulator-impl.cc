@@ -318,6 +318,7 @@ DistributedSimulatorImpl::ProcessOneEvent (void)
   m_currentUid = next.key.m_uid;
   next.impl->Invoke ();
   next.impl->Unref ();
+  m_profiler.NotifyEvent (m_currentTs, m_eventCount);
 }
 
 bool
@@ -362,6 +363,7 @@ DistributedSimulatorImpl::Run (void)
   CalculateLookAhead ();
   m_stop = false;
   m_globalFinished = false;
+  m_profiler.Start (m_myId, m_systemCount, Now ());
   while (!m_globalFinished)
     {
       Time nextTime = Next ();
@@ -374,7 +376,10 @@ DistributedSimulatorImpl::Run (void)
       if (nextTime > m_grantedTime || IsLocalFinished () )
         {
           // Can't process next event, calculate a new LBTS
-          // First receive any pending messages
+          m_profiler.BeginBlocking ();
+          // First send the packets aggregated during the window
+          GrantedTimeWindowMpiInterface::SendPendingPackets ();
+          // Then receive any pending messages
           GrantedTimeWindowMpiInterface::ReceiveMessages ();
           // reset next time
           nextTime = Next ();
@@ -386,6 +391,7 @@ DistributedSimulatorImpl::Run (void)
           m_pLBTS[m_myId] = lMsg;
           MPI_Allgather (&lMsg, sizeof (LbtsMessage), MPI_BYTE, m_pLBTS,
                          sizeof (LbtsMessage), MPI_BYTE, MPI_COMM_WORLD);
+          m_profiler.EndBlocking ();
           Time smallestTime = m_pLBTS[0].GetSmallestTime ();
           // The totRx and totTx counts insure there are no transient
           // messages;  If totRx != totTx, there are transients,
@@ -416,7 +422,12 @@ DistributedSimulatorImpl::Run (void)
               else
                 {
                   // Overflow is possible here if near end of representable time.
-                  m_grantedTime = smallestTime + m_lookAhead;
+                  Time grantedTime = smallestTime + m_lookAhead;
+                  if (!m_globalFinished)
+                    {
+                      m_profiler.NotifyWindow (m_grantedTime, grantedTime);
+                    }
+                  m_grantedTime = grantedTime;
                 }
             }
         }
@@ -429,6 +440,8 @@ DistributedSimulatorImpl::Run (void)
         }
     }
 
+  m_profiler.Stop (Now (), m_eventCount);
+
   // If the simulator stopped naturally by lack of events, make a
   // consistency test to check that we didn't lose any events along the way.
   NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
@@ -42,45 +42,14 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GrantedTimeWindowMpiInterface");
 
-SentBuffer::SentBuffer ()
-{
-  m_buffer = 0;
-  m_request = 0;
-}
-
-SentBuffer::~SentBuffer ()
-{
-  delete [] m_buffer;
-}
-
-uint8_t*
-SentBuffer::GetBuffer ()
-{
-  return m_buffer;
-}
-
-void
-SentBuffer::SetBuffer (uint8_t* buffer)
-{
-  m_buffer = buffer;
-}
-
-MPI_Request*
-SentBuffer::GetRequest ()
-{
-  return &m_request;
-}
-
 uint32_t              GrantedTimeWindowMpiInterface::m_sid = 0;
 uint32_t              GrantedTimeWindowMpiInterface::m_size = 1;
 bool                  GrantedTimeWindowMpiInterface::m_initialized = false;
 bool                  GrantedTimeWindowMpiInterface::m_enabled = false;
 uint32_t              GrantedTimeWindowMpiInterface::m_rxCount = 0;
 uint32_t              GrantedTimeWindowMpiInterface::m_txCount = 0;
-std::list<SentBuffer> GrantedTimeWindowMpiInterface::m_pendingTx;
-
-MPI_Request* GrantedTimeWindowMpiInterface::m_requests;
-char**       GrantedTimeWindowMpiInterface::m_pRxBuffers;
+MpiReceiveBuffers     GrantedTimeWindowMpiInterface::m_rxBuffers;
+MpiPacketBatch        GrantedTimeWindowMpiInterface::m_batch;
 
 TypeId 
 GrantedTimeWindowMpiInterface::GetTypeId (void)
@@ -97,14 +66,8 @@ GrantedTimeWindowMpiInterface::Destroy ()
 {
   NS_LOG_FUNCTION (this);
 
-  for (uint32_t i = 0; i < GetSize (); ++i)
-    {
-      delete [] m_pRxBuffers[i];
-    }
-  delete [] m_pRxBuffers;
-  delete [] m_requests;
-
-  m_pendingTx.clear ();
+  m_rxBuffers.Clear ();
+  m_batch.Clear ();
 }
 
 uint32_t
@@ -165,14 +128,12 @@ GrantedTimeWindowMpiInterface::Enable (int* pargc, char*** pargv)
   m_enabled = true;
   m_initialized = true;
   // Post a non-blocking receive for all peers
-  m_pRxBuffers = new char*[m_size];
-  m_requests = new MPI_Request[m_size];
+  m_rxBuffers.Initialize (m_size);
   for (uint32_t i = 0; i < GetSize (); ++i)
     {
-      m_pRxBuffers[i] = new char[MAX_MPI_MSG_SIZE];
-      MPI_Irecv (m_pRxBuffers[i], MAX_MPI_MSG_SIZE, MPI_CHAR, MPI_ANY_SOURCE, 0,
-                 MPI_COMM_WORLD, &m_requests[i]);
+      m_rxBuffers.Post (i, MPI_ANY_SOURCE);
     }
+  m_batch.Initialize (m_size, 0);
 }
 
 void
@@ -180,30 +141,34 @@ GrantedTimeWindowMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, ui
 {
   NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
 
-  SentBuffer sendBuf;
-  m_pendingTx.push_back (sendBuf);
-  std::list<SentBuffer>::reverse_iterator i = m_pendingTx.rbegin (); // Points to the last element
-
-  uint32_t serializedSize = p->GetSerializedSize ();
-  uint8_t* buffer =  new uint8_t[serializedSize + 16];
-  i->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t t = rxTime.GetInteger ();
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = t;
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = node;
-  *pData++ = dev;
-  // Serialize the packet
-  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
-
   // Find the system id for the destination node
   Ptr<Node> destNode = NodeList::GetNode (node);
   uint32_t nodeSysId = destNode->GetSystemId ();
 
-  MPI_Isend (reinterpret_cast<void *> (i->GetBuffer ()), serializedSize + 16, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (i->GetRequest ()));
+  if (m_batch.IsFull (nodeSysId, p))
+    {
+      m_batch.Send (nodeSysId);
+    }
+  m_batch.AddPacket (nodeSysId, p, rxTime, node, dev);
   m_txCount++;
+  if (!m_batch.IsAggregated ())
+    {
+      m_batch.Send (nodeSysId);
+    }
+}
+
+void
+GrantedTimeWindowMpiInterface::SendPendingPackets ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  for (uint32_t rank = 0; rank < m_size; ++rank)
+    {
+      if (m_batch.HasPackets (rank))
+        {
+          m_batch.Send (rank);
+        }
+    }
 }
 
 void
@@ -218,51 +183,19 @@ GrantedTimeWindowMpiInterface::ReceiveMessages ()
       int index = 0;
       MPI_Status status;
 
-      MPI_Testany (MpiInterface::GetSize (), m_requests, &index, &flag, &status);
+      MPI_Testany (m_rxBuffers.GetN (), m_rxBuffers.GetRequests (), &index, &flag, &status);
       if (!flag)
         {
           break;        // No more messages
         }
       int count;
       MPI_Get_count (&status, MPI_CHAR, &count);
-      m_rxCount++; // Count this receive
-
-      // Get the meta data first
-      uint64_t* pTime = reinterpret_cast<uint64_t *> (m_pRxBuffers[index]);
-      uint64_t time = *pTime++;
-      uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-      uint32_t node = *pData++;
-      uint32_t dev  = *pData++;
-
-      Time rxTime (time);
-
-      count -= sizeof (time) + sizeof (node) + sizeof (dev);
-
-      Ptr<Packet> p = Create<Packet> (reinterpret_cast<uint8_t *> (pData), count, true);
-
-      // Find the correct node/device to schedule receive event
-      Ptr<Node> pNode = NodeList::GetNode (node);
-      Ptr<MpiReceiver> pMpiRec = 0;
-      uint32_t nDevices = pNode->GetNDevices ();
-      for (uint32_t i = 0; i < nDevices; ++i)
-        {
-          Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
-          if (pThisDev->GetIfIndex () == dev)
-            {
-              pMpiRec = pThisDev->GetObject<MpiReceiver> ();
-              break;
-            }
-        }
-
-      NS_ASSERT (pNode && pMpiRec);
-
-      // Schedule the rx event
-      Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
-                                      &MpiReceiver::Receive, pMpiRec, p);
+      uint32_t packets = MpiPacketBatch::Deliver (m_rxBuffers.GetBuffer (index), count);
+      m_rxCount += packets;
+      Simulator::GetImplementation ()->GetProfiler ().NotifyMessageReceived (status.MPI_SOURCE, count, packets);
 
       // Re-queue the next read
-      MPI_Irecv (m_pRxBuffers[index], MAX_MPI_MSG_SIZE, MPI_CHAR, MPI_ANY_SOURCE, 0,
-                 MPI_COMM_WORLD, &m_requests[index]);
+      m_rxBuffers.Post (index, MPI_ANY_SOURCE);
     }
 }
 
@@ -271,19 +204,7 @@ GrantedTimeWindowMpiInterface::TestSendComplete ()
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  std::list<SentBuffer>::iterator i = m_pendingTx.begin ();
-  while (i != m_pendingTx.end ())
-    {
-      MPI_Status status;
-      int flag = 0;
-      MPI_Test (i->GetRequest (), &flag, &status);
-      std::list<SentBuffer>::iterator current = i; // Save current for erasing
-      i++;                                    // Advance to next
-      if (flag)
-        { // This message is complete
-          m_pendingTx.erase (current);
-        }
-    }
+  m_batch.TestSendComplete ();
 }
 
 void
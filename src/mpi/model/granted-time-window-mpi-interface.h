@@ -30,49 +30,12 @@
 #include "ns3/buffer.h"
 
 #include "parallel-communication-interface.h"
+#include "mpi-packet-batch.h"
 
 #include "mpi.h"
 
 namespace ns3 {
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-const uint32_t MAX_MPI_MSG_SIZE = 2000;
-
-/**
- * \ingroup mpi
- *
- * \brief Tracks non-blocking sends
- *
- * This class is used to keep track of the asynchronous non-blocking
- * sends that have been posted.
- */
-class SentBuffer
-{
-public:
-  SentBuffer ();
-  ~SentBuffer ();
-
-  /**
-   * \return pointer to sent buffer
-   */
-  uint8_t* GetBuffer ();
-  /**
-   * \param buffer pointer to sent buffer
-   */
-  void SetBuffer (uint8_t* buffer);
-  /**
-   * \return MPI request
-   */
-  MPI_Request* GetRequest ();
-
-private:
-  uint8_t* m_buffer;
-  MPI_Request m_request;
-};
-
 class Packet;
 
 /**
@@ -124,9 +87,15 @@ public:
    * \param node destination node
    * \param dev destination device
    *
-   * Serialize and send a packet to the specified node and net device
+   * Serialize and send a packet to the specified node and net device.
+   * When the packets are aggregated, the packet is sent with the other
+   * packets for the same rank at the next synchronization.
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * Send the packets aggregated for the other ranks
+   */
+  static void SendPendingPackets ();
   /**
    * Check for received messages complete
    */
@@ -156,14 +125,11 @@ private:
   static bool     m_initialized;
   static bool     m_enabled;
 
-  // Pending non-blocking receives
-  static MPI_Request* m_requests;
-
-  // Data buffers for non-blocking reads
-  static char**   m_pRxBuffers;
+  // Data buffers and requests of the non-blocking reads
+  static MpiReceiveBuffers m_rxBuffers;
 
-  // List of pending non-blocking sends
-  static std::list<SentBuffer> m_pendingTx;
+  // Packets to send, and pending non-blocking sends
+  static MpiPacketBatch m_batch;
 };
 
 } // namespace ns3
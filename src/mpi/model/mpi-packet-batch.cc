@@ -0,0 +1,342 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mpi-packet-batch.h"
+#include "mpi-receiver.h"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpiPacketBatch");
+
+/**
+ * \ingroup mpi
+ * \anchor GlobalValueMpiPacketAggregation
+ * \brief Whether the packets sent to a rank are aggregated in one MPI
+ * message until the synchronization with the rank.
+ */
+static GlobalValue g_mpiPacketAggregation = GlobalValue ("MpiPacketAggregation",
+                                                         "Whether the packets sent to a rank are aggregated in one MPI message "
+                                                         "until the synchronization with the rank",
+                                                         BooleanValue (true),
+                                                         MakeBooleanChecker ());
+
+/**
+ * \ingroup mpi
+ * \anchor GlobalValueMpiPacketMetadata
+ * \brief Whether the packets sent to other ranks carry their metadata
+ * and tags.
+ */
+static GlobalValue g_mpiPacketMetadata = GlobalValue ("MpiPacketMetadata",
+                                                      "Whether the packets sent to other ranks carry their metadata and tags; "
+                                                      "without them, only the bytes of the packets are sent",
+                                                      BooleanValue (true),
+                                                      MakeBooleanChecker ());
+
+namespace {
+
+/** The size of the record of a packet, without the packet. */
+const uint32_t RECORD_SIZE = sizeof (uint64_t) + 4 * sizeof (uint32_t);
+/** The flag of the records of the packets serialized with their metadata and tags. */
+const uint32_t RECORD_METADATA = 1;
+
+} // unnamed namespace
+
+MpiPacketBatch::MpiPacketBatch ()
+  : m_headerSize (0),
+    m_aggregate (true),
+    m_metadata (true)
+{
+}
+
+MpiPacketBatch::~MpiPacketBatch ()
+{
+}
+
+void
+MpiPacketBatch::Initialize (uint32_t size, uint32_t headerSize)
+{
+  NS_LOG_FUNCTION (this << size << headerSize);
+  BooleanValue aggregate;
+  g_mpiPacketAggregation.GetValue (aggregate);
+  m_aggregate = aggregate.Get ();
+  BooleanValue metadata;
+  g_mpiPacketMetadata.GetValue (metadata);
+  m_metadata = metadata.Get ();
+  m_headerSize = headerSize;
+  m_batches.assign (size, std::vector<uint8_t> (headerSize, 0));
+  m_packets.assign (size, 0);
+}
+
+bool
+MpiPacketBatch::IsAggregated (void) const
+{
+  return m_aggregate;
+}
+
+bool
+MpiPacketBatch::IsFull (uint32_t rank, Ptr<const Packet> p) const
+{
+  uint32_t size = m_metadata ? p->GetSerializedSize () : p->GetSize ();
+  NS_ABORT_MSG_IF (m_headerSize + RECORD_SIZE + size > MAX_MPI_MSG_SIZE,
+                   "Packet of " << size << " bytes too large for an MPI message");
+  return m_batches[rank].size () + RECORD_SIZE + size > MAX_MPI_MSG_SIZE;
+}
+
+void
+MpiPacketBatch::AddPacket (uint32_t rank, Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << rank << p << rxTime.GetTimeStep () << node << dev);
+  std::vector<uint8_t> &batch = m_batches[rank];
+  ++m_packets[rank];
+  uint32_t size = m_metadata ? p->GetSerializedSize () : p->GetSize ();
+  uint32_t offset = batch.size ();
+  batch.resize (offset + RECORD_SIZE + size);
+  uint8_t *record = &batch[offset];
+
+  uint64_t t = rxTime.GetInteger ();
+  uint32_t flags = m_metadata ? RECORD_METADATA : 0;
+  std::memcpy (record, &t, sizeof (t));
+  record += sizeof (t);
+  std::memcpy (record, &node, sizeof (node));
+  record += sizeof (node);
+  std::memcpy (record, &dev, sizeof (dev));
+  record += sizeof (dev);
+  std::memcpy (record, &size, sizeof (size));
+  record += sizeof (size);
+  std::memcpy (record, &flags, sizeof (flags));
+  record += sizeof (flags);
+  if (m_metadata)
+    {
+      p->Serialize (record, size);
+    }
+  else
+    {
+      p->CopyData (record, size);
+    }
+}
+
+bool
+MpiPacketBatch::HasPackets (uint32_t rank) const
+{
+  return m_batches[rank].size () > m_headerSize;
+}
+
+uint8_t *
+MpiPacketBatch::GetHeader (uint32_t rank)
+{
+  return m_headerSize == 0 ? 0 : &m_batches[rank][0];
+}
+
+void
+MpiPacketBatch::Send (uint32_t rank)
+{
+  NS_LOG_FUNCTION (this << rank << m_batches[rank].size ());
+  Simulator::GetImplementation ()->GetProfiler ().NotifyMessageSent (rank, m_batches[rank].size (), m_packets[rank]);
+  m_packets[rank] = 0;
+  if (m_free.empty ())
+    {
+      m_free.push_back (PendingSend ());
+    }
+  std::list<PendingSend>::iterator send = m_free.begin ();
+  send->data.swap (m_batches[rank]);
+  m_pending.splice (m_pending.end (), m_free, send);
+  m_batches[rank].clear ();
+  m_batches[rank].resize (m_headerSize, 0);
+
+  MPI_Isend (&send->data[0], send->data.size (), MPI_CHAR, rank, 0,
+             MPI_COMM_WORLD, &send->request);
+}
+
+void
+MpiPacketBatch::TestSendComplete (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::list<PendingSend>::iterator i = m_pending.begin ();
+  while (i != m_pending.end ())
+    {
+      MPI_Status status;
+      int flag = 0;
+      MPI_Test (&i->request, &flag, &status);
+      std::list<PendingSend>::iterator current = i; // Save current for moving
+      ++i;
+      if (flag)
+        { // This message is complete, its buffer can be reused
+          m_free.splice (m_free.end (), m_pending, current);
+        }
+    }
+}
+
+void
+MpiPacketBatch::Cancel (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::list<PendingSend>::iterator i = m_pending.begin (); i != m_pending.end (); ++i)
+    {
+      MPI_Cancel (&i->request);
+      MPI_Request_free (&i->request);
+    }
+  m_free.splice (m_free.end (), m_pending);
+}
+
+void
+MpiPacketBatch::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_batches.clear ();
+  m_packets.clear ();
+  m_pending.clear ();
+  m_free.clear ();
+}
+
+uint32_t
+MpiPacketBatch::Deliver (const uint8_t *records, uint32_t size)
+{
+  NS_LOG_FUNCTION (size);
+  uint32_t n = 0;
+  const uint8_t *end = records + size;
+  while (records < end)
+    {
+      NS_ASSERT (records + RECORD_SIZE <= end);
+      uint64_t t;
+      uint32_t node;
+      uint32_t dev;
+      uint32_t packetSize;
+      uint32_t flags;
+      std::memcpy (&t, records, sizeof (t));
+      records += sizeof (t);
+      std::memcpy (&node, records, sizeof (node));
+      records += sizeof (node);
+      std::memcpy (&dev, records, sizeof (dev));
+      records += sizeof (dev);
+      std::memcpy (&packetSize, records, sizeof (packetSize));
+      records += sizeof (packetSize);
+      std::memcpy (&flags, records, sizeof (flags));
+      records += sizeof (flags);
+      NS_ASSERT (records + packetSize <= end);
+
+      Ptr<Packet> p;
+      if (flags & RECORD_METADATA)
+        {
+          p = Create<Packet> (records, packetSize, true);
+        }
+      else
+        {
+          p = Create<Packet> (records, packetSize);
+        }
+      records += packetSize;
+
+      // Find the correct node/device to schedule receive event
+      Ptr<Node> pNode = NodeList::GetNode (node);
+      Ptr<MpiReceiver> pMpiRec = 0;
+      uint32_t nDevices = pNode->GetNDevices ();
+      for (uint32_t i = 0; i < nDevices; ++i)
+        {
+          Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
+          if (pThisDev->GetIfIndex () == dev)
+            {
+              pMpiRec = pThisDev->GetObject<MpiReceiver> ();
+              break;
+            }
+        }
+
+      NS_ASSERT (pNode && pMpiRec);
+
+      // Schedule the rx event
+      Time rxTime (t);
+      Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
+                                      &MpiReceiver::Receive, pMpiRec, p);
+      ++n;
+    }
+  return n;
+}
+
+MpiReceiveBuffers::MpiReceiveBuffers ()
+{
+}
+
+MpiReceiveBuffers::~MpiReceiveBuffers ()
+{
+}
+
+void
+MpiReceiveBuffers::Initialize (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  m_buffers.assign (static_cast<std::size_t> (n) * MAX_MPI_MSG_SIZE, 0);
+  m_requests.assign (n, MPI_REQUEST_NULL);
+}
+
+void
+MpiReceiveBuffers::Post (uint32_t i, int source)
+{
+  MPI_Irecv (GetBuffer (i), MAX_MPI_MSG_SIZE, MPI_CHAR, source, 0,
+             MPI_COMM_WORLD, &m_requests[i]);
+}
+
+uint8_t *
+MpiReceiveBuffers::GetBuffer (uint32_t i)
+{
+  return &m_buffers[static_cast<std::size_t> (i) * MAX_MPI_MSG_SIZE];
+}
+
+MPI_Request *
+MpiReceiveBuffers::GetRequests (void)
+{
+  return m_requests.empty () ? 0 : &m_requests[0];
+}
+
+uint32_t
+MpiReceiveBuffers::GetN (void) const
+{
+  return m_requests.size ();
+}
+
+void
+MpiReceiveBuffers::Cancel (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<MPI_Request>::iterator i = m_requests.begin (); i != m_requests.end (); ++i)
+    {
+      if (*i != MPI_REQUEST_NULL)
+        {
+          MPI_Cancel (&*i);
+          MPI_Request_free (&*i);
+        }
+    }
+}
+
+void
+MpiReceiveBuffers::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_buffers.clear ();
+  m_requests.clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MPI_PACKET_BATCH_H
+#define NS3_MPI_PACKET_BATCH_H
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include "mpi.h"
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup mpi
+ *
+ * Maximum size of an MPI message, which holds a batch of packets.  The
+ * receive buffers are allocated with this size.
+ */
+const uint32_t MAX_MPI_MSG_SIZE = 65536;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief The packets sent to the other ranks, in one MPI message per
+ * rank and batch.
+ *
+ * Each message starts with a header of a fixed size, written by the
+ * communication interface, followed by a record per packet: the receive
+ * time, the destination node and device, the size and the flags of the
+ * packet, then the packet.  When the packets are aggregated (global
+ * value \c MpiPacketAggregation), the packets sent to a rank accumulate
+ * in its batch until the communication interface sends the batch, or
+ * the batch is full; otherwise the interface sends each packet in its
+ * own batch.  When the metadata are not sent (global value
+ * \c MpiPacketMetadata), the records hold the bytes of the packets only,
+ * without their metadata and tags.
+ *
+ * The batches and the buffers of the pending sends are reused, so that
+ * the packets are serialized without allocation once the buffers have
+ * grown to the size of the traffic.
+ */
+class MpiPacketBatch
+{
+public:
+  MpiPacketBatch ();
+  ~MpiPacketBatch ();
+
+  /**
+   * Allocate the batches, and read the global values.
+   * \param size the number of ranks
+   * \param headerSize the size of the header of the messages
+   */
+  void Initialize (uint32_t size, uint32_t headerSize);
+  /**
+   * \return whether the packets are aggregated
+   */
+  bool IsAggregated (void) const;
+  /**
+   * \param rank the destination rank
+   * \param p a packet
+   * \return whether the packet does not fit in the batch of the rank,
+   *         which must be sent before the packet is added
+   */
+  bool IsFull (uint32_t rank, Ptr<const Packet> p) const;
+  /**
+   * Add a packet to the batch of a rank.
+   *
+   * \param rank the destination rank
+   * \param p the packet
+   * \param rxTime the receive time at the destination node
+   * \param node the destination node
+   * \param dev the destination device
+   */
+  void AddPacket (uint32_t rank, Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * \param rank a rank
+   * \return whether the batch of the rank holds packets
+   */
+  bool HasPackets (uint32_t rank) const;
+  /**
+   * \param rank a rank
+   * \return the header of the batch of the rank, to be written before
+   *         the batch is sent
+   */
+  uint8_t *GetHeader (uint32_t rank);
+  /**
+   * Send the batch of a rank with MPI_Isend, notify the profiler of
+   * the simulator, and start a new batch.
+   * \param rank the destination rank
+   */
+  void Send (uint32_t rank);
+  /**
+   * Release the buffers of the completed sends.
+   */
+  void TestSendComplete (void);
+  /**
+   * Cancel the pending sends.
+   */
+  void Cancel (void);
+  /**
+   * Release all the buffers.
+   */
+  void Clear (void);
+
+  /**
+   * Schedule the receive events of the packets of a message.
+   * \param records the records of the packets
+   * \param size the size of the records
+   * \return the number of packets
+   */
+  static uint32_t Deliver (const uint8_t *records, uint32_t size);
+
+private:
+  /** A message being sent. */
+  struct PendingSend
+  {
+    std::vector<uint8_t> data;  //!< the message
+    MPI_Request request;        //!< the request of MPI_Isend
+  };
+
+  uint32_t m_headerSize;                        //!< the size of the header of the messages
+  bool m_aggregate;                             //!< whether the packets are aggregated
+  bool m_metadata;                              //!< whether the metadata and tags are sent
+  std::vector<std::vector<uint8_t> > m_batches; //!< the batch of each rank
+  std::vector<uint32_t> m_packets;              //!< the number of packets of each batch
+  std::list<PendingSend> m_pending;             //!< the messages being sent
+  std::list<PendingSend> m_free;                //!< the buffers of the completed sends
+};
+
+/**
+ * \ingroup mpi
+ *
+ * \brief The buffers of the non-blocking receives, allocated once in a
+ * single block, each buffer being posted again once its message is
+ * handled.
+ */
+class MpiReceiveBuffers
+{
+public:
+  MpiReceiveBuffers ();
+  ~MpiReceiveBuffers ();
+
+  /**
+   * Allocate the buffers.
+   * \param n the number of buffers
+   */
+  void Initialize (uint32_t n);
+  /**
+   * Post a non-blocking receive.
+   * \param i the index of the buffer
+   * \param source the source rank, or MPI_ANY_SOURCE
+   */
+  void Post (uint32_t i, int source);
+  /**
+   * \param i the index of a buffer
+   * \return the buffer
+   */
+  uint8_t *GetBuffer (uint32_t i);
+  /**
+   * \return the requests of the receives
+   */
+  MPI_Request *GetRequests (void);
+  /**
+   * \return the number of buffers
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Cancel the pending receives.
+   */
+  void Cancel (void);
+  /**
+   * Release the buffers.
+   */
+  void Clear (void);
+
+private:
+  std::vector<uint8_t> m_buffers;       //!< the buffers
+  std::vector<MPI_Request> m_requests;  //!< the requests of the receives
+};
+
+} // namespace ns3
+
+#endif /* NS3_MPI_PACKET_BATCH_H */
@@ -31,10 +31,12 @@
 #include "ns3/net-device.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
 #include "ns3/log.h"
 
 #include <mpi.h>
 
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <list>
@@ -43,50 +45,13 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NullMessageMpiInterface");
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 2000;
-
-NullMessageSentBuffer::NullMessageSentBuffer ()
-{
-  m_buffer = 0;
-  m_request = 0;
-}
-
-NullMessageSentBuffer::~NullMessageSentBuffer ()
-{
-  delete [] m_buffer;
-}
-
-uint8_t*
-NullMessageSentBuffer::GetBuffer ()
-{
-  return m_buffer;
-}
-
-void
-NullMessageSentBuffer::SetBuffer (uint8_t* buffer)
-{
-  m_buffer = buffer;
-}
-
-MPI_Request*
-NullMessageSentBuffer::GetRequest ()
-{
-  return &m_request;
-}
-
 uint32_t              NullMessageMpiInterface::g_sid = 0;
 uint32_t              NullMessageMpiInterface::g_size = 1;
 uint32_t              NullMessageMpiInterface::g_numNeighbors = 0;
 bool                  NullMessageMpiInterface::g_initialized = false;
 bool                  NullMessageMpiInterface::g_enabled = false;
-std::list<NullMessageSentBuffer> NullMessageMpiInterface::g_pendingTx;
-
-MPI_Request* NullMessageMpiInterface::g_requests;
-char**       NullMessageMpiInterface::g_pRxBuffers;
+MpiReceiveBuffers     NullMessageMpiInterface::g_rxBuffers;
+MpiPacketBatch        NullMessageMpiInterface::g_batch;
 
 NullMessageMpiInterface::NullMessageMpiInterface ()
 {
@@ -160,20 +125,19 @@ NullMessageMpiInterface::InitializeSendReceiveBuffers(void)
   g_numNeighbors = RemoteChannelBundleManager::Size();
 
   // Post a non-blocking receive for all peers
-  g_requests = new MPI_Request[g_numNeighbors];
-  g_pRxBuffers = new char*[g_numNeighbors];
+  g_rxBuffers.Initialize (g_numNeighbors);
   int index = 0;
   for (uint32_t rank = 0; rank < g_size; ++rank)
     {
       Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
       if (bundle) 
         {
-          g_pRxBuffers[index] = new char[NULL_MESSAGE_MAX_MPI_MSG_SIZE];
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, rank, 0,
-                     MPI_COMM_WORLD, &g_requests[index]);
+          g_rxBuffers.Post (index, rank);
           ++index;
         }
     }
+
+  g_batch.Initialize (g_size, 4 * sizeof (uint64_t));
 }
 
 void
@@ -187,61 +151,72 @@ NullMessageMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t
   Ptr<Node> destNode = NodeList::GetNode (node);
   uint32_t nodeSysId = destNode->GetSystemId ();
 
-  NullMessageSentBuffer sendBuf;
-  g_pendingTx.push_back (sendBuf);
-  std::list<NullMessageSentBuffer>::reverse_iterator iter = g_pendingTx.rbegin (); // Points to the last element
+  if (g_batch.IsFull (nodeSysId, p))
+    {
+      SendBatch (nodeSysId, NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId));
+      NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+    }
+  g_batch.AddPacket (nodeSysId, p, rxTime, node, dev);
 
-  uint32_t serializedSize = p->GetSerializedSize ();
-  uint32_t bufferSize = serializedSize + ( 2 * sizeof (uint64_t) ) + ( 2 * sizeof (uint32_t) );
-  uint8_t* buffer =  new uint8_t[bufferSize];
-  iter->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t t = rxTime.GetInteger ();
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = t;
+  // Without aggregation, the packet is sent at once with its guarantee
+  // time, otherwise with the next Null Message.
+  if (!g_batch.IsAggregated ())
+    {
+      SendBatch (nodeSysId, NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId));
+      NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+    }
+}
 
-  Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
-  *pTime++ = guarantee_update.GetTimeStep ();
+void
+NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<RemoteChannelBundle> bundle,
+                                          const Time& request, const Time& output)
+{
+  NS_LOG_FUNCTION (guarantee_update.GetTimeStep () << bundle << request.GetTimeStep () << output.GetTimeStep ());
 
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = node;
-  *pData++ = dev;
-  // Serialize the packet
-  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
+  NS_ASSERT (g_enabled);
 
-  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (iter->GetRequest ()));
+  // Find the system id for the destination MPI rank
+  uint32_t nodeSysId = bundle->GetSystemId ();
 
-  NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+  SendBatch (nodeSysId, guarantee_update, request, output);
 }
 
 void
-NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<RemoteChannelBundle> bundle)
+NullMessageMpiInterface::SendPendingPackets ()
 {
-  NS_LOG_FUNCTION (guarantee_update.GetTimeStep () << bundle);
+  NS_LOG_FUNCTION_NOARGS ();
 
   NS_ASSERT (g_enabled);
 
-  NullMessageSentBuffer sendBuf;
-  g_pendingTx.push_back (sendBuf);
-  std::list<NullMessageSentBuffer>::reverse_iterator iter = g_pendingTx.rbegin (); // Points to the last element
-
-  uint32_t bufferSize = 2 * sizeof (uint64_t) + 2 * sizeof (uint32_t);
-  uint8_t* buffer =  new uint8_t[bufferSize];
-  iter->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = 0;
-  *pTime++ = guarantee_update.GetInteger ();
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = 0;
-  *pData++ = 0;
+  for (uint32_t rank = 0; rank < g_size; ++rank)
+    {
+      if (g_batch.HasPackets (rank))
+        {
+          SendBatch (rank, NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (rank));
+          NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (rank);
+        }
+    }
+}
+
+void
+NullMessageMpiInterface::SendBatch (uint32_t rank, const Time& guarantee_update,
+                                    const Time& request, const Time& output)
+{
+  NS_LOG_FUNCTION (rank << guarantee_update.GetTimeStep () << request.GetTimeStep () << output.GetTimeStep ());
 
-  // Find the system id for the destination MPI rank
-  uint32_t nodeSysId = bundle->GetSystemId ();
+  Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (rank);
+  NS_ASSERT (bundle);
 
-  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (iter->GetRequest ()));
+  // The guarantee time must not decrease, even if estimated otherwise
+  Time update = Max (guarantee_update, bundle->GetSentGuaranteeTime ());
+  uint64_t header[4] = { static_cast<uint64_t> (update.GetInteger ()),
+                         static_cast<uint64_t> (request.GetInteger ()),
+                         static_cast<uint64_t> (output.GetInteger ()),
+                         bundle->GetPacketMessagesReceived () };
+  bundle->NotifySent (g_batch.HasPackets (rank), update, request);
+
+  std::memcpy (g_batch.GetHeader (rank), header, sizeof (header));
+  g_batch.Send (rank);
 }
 
 void
@@ -287,13 +262,13 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
 
       if (blocking)
         {
-          MPI_Waitany (g_numNeighbors, g_requests, &index, &status);
+          MPI_Waitany (g_rxBuffers.GetN (), g_rxBuffers.GetRequests (), &index, &status);
           messageReceived = 1; /* Wait always implies message was received */
           stop = true;
         }
       else
         {
-          MPI_Testany (g_numNeighbors, g_requests, &index, &messageReceived, &status);
+          MPI_Testany (g_rxBuffers.GetN (), g_rxBuffers.GetRequests (), &index, &messageReceived, &status);
         }
 
       if (messageReceived)
@@ -301,54 +276,21 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
           int count;
           MPI_Get_count (&status, MPI_CHAR, &count);
 
-          // Get the meta data first
-          uint64_t* pTime = reinterpret_cast<uint64_t *> (g_pRxBuffers[index]);
-          uint64_t time = *pTime++;
-          uint64_t guaranteeUpdate = *pTime++;
-
-          uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-          uint32_t node = *pData++;
-          uint32_t dev  = *pData++;
-
-          Time rxTime (time);
-
-          // rxtime == 0 means this is a Null Message
-          if (rxTime > Time (0))
-            {
-              count -= sizeof (time) + sizeof (guaranteeUpdate) + sizeof (node) + sizeof (dev);
-
-              Ptr<Packet> p = Create<Packet> (reinterpret_cast<uint8_t *> (pData), count, true);
-
-              // Find the correct node/device to schedule receive event
-              Ptr<Node> pNode = NodeList::GetNode (node);
-              Ptr<MpiReceiver> pMpiRec = 0;
-              uint32_t nDevices = pNode->GetNDevices ();
-              for (uint32_t i = 0; i < nDevices; ++i)
-                {
-                  Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
-                  if (pThisDev->GetIfIndex () == dev)
-                    {
-                      pMpiRec = pThisDev->GetObject<MpiReceiver> ();
-                      break;
-                    }
-                }
-              NS_ASSERT (pNode && pMpiRec);
-
-              // Schedule the rx event
-              Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
-                                              &MpiReceiver::Receive, pMpiRec, p);
-
-            }
+          // Get the guarantee and request times first, then the packets if any
+          const uint8_t* buffer = g_rxBuffers.GetBuffer (index);
+          uint64_t header[4];
+          std::memcpy (header, buffer, sizeof (header));
+          uint32_t packets = MpiPacketBatch::Deliver (buffer + sizeof (header), count - sizeof (header));
 
           // Update guarantee time for both packet receives and Null Messages.
           Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (status.MPI_SOURCE);
           NS_ASSERT (bundle);
 
-          bundle->SetGuaranteeTime (Time (guaranteeUpdate));
+          bundle->NotifyReceived (packets > 0, Time (header[0]), Time (header[1]), Time (header[2]), header[3]);
+          Simulator::GetImplementation ()->GetProfiler ().NotifyMessageReceived (status.MPI_SOURCE, count, packets);
 
           // Re-queue the next read
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, status.MPI_SOURCE, 0,
-                     MPI_COMM_WORLD, &g_requests[index]);
+          g_rxBuffers.Post (index, status.MPI_SOURCE);
 
         }
       else
@@ -367,19 +309,7 @@ NullMessageMpiInterface::TestSendComplete ()
 
   NS_ASSERT (g_enabled);
 
-  std::list<NullMessageSentBuffer>::iterator iter = g_pendingTx.begin ();
-  while (iter != g_pendingTx.end ())
-    {
-      MPI_Status status;
-      int flag = 0;
-      MPI_Test (iter->GetRequest (), &flag, &status);
-      std::list<NullMessageSentBuffer>::iterator current = iter; // Save current for erasing
-      ++iter; // Advance to next
-      if (flag)
-        { // This message is complete
-          g_pendingTx.erase (current);
-        }
-    }
+  g_batch.TestSendComplete ();
 }
 
 void
@@ -392,30 +322,13 @@ NullMessageMpiInterface::Disable ()
   if (flag)
     {
 
-      for (std::list<NullMessageSentBuffer>::iterator iter = g_pendingTx.begin ();
-           iter != g_pendingTx.end ();
-           ++iter)
-        {
-          MPI_Cancel (iter->GetRequest ());
-          MPI_Request_free (iter->GetRequest ());
-        }
-
-      for (uint32_t i = 0; i < g_numNeighbors; ++i)
-        {
-          MPI_Cancel (&g_requests[i]);
-          MPI_Request_free (&g_requests[i]);
-        }
+      g_batch.Cancel ();
+      g_rxBuffers.Cancel ();
 
       MPI_Finalize ();
 
-      for (uint32_t i = 0; i < g_numNeighbors; ++i)
-        {
-          delete [] g_pRxBuffers[i];
-        }
-      delete [] g_pRxBuffers;
-      delete [] g_requests;
-
-      g_pendingTx.clear ();
+      g_rxBuffers.Clear ();
+      g_batch.Clear ();
 
       g_enabled = false;
       g_initialized = false;
@@ -23,6 +23,7 @@
 #define NS3_NULLMESSAGE_MPI_INTERFACE_H
 
 #include "parallel-communication-interface.h"
+#include "mpi-packet-batch.h"
 
 #include <ns3/nstime.h>
 #include <ns3/buffer.h>
@@ -35,45 +36,6 @@ namespace ns3 {
 class RemoteChannelBundle;
 class Packet;
 
-/**
- * \ingroup mpi
- *
- * \brief Non-blocking send buffers for Null Message implementation.
- * 
- * One buffer is allocated for each non-blocking send.
- */
-class NullMessageSentBuffer
-{
-public:
-  NullMessageSentBuffer ();
-  ~NullMessageSentBuffer ();
-
-  /**
-   * \return pointer to sent buffer
-   */
-  uint8_t* GetBuffer ();
-  /**
-   * \param buffer pointer to sent buffer
-   */
-  void SetBuffer (uint8_t* buffer);
-  /**
-   * \return MPI request
-   */
-  MPI_Request* GetRequest ();
-
-private:
-
-  /**
-   * Buffer for send.
-   */
-  uint8_t* m_buffer;
-
-  /**
-   * MPI request posted for the send.
-   */
-  MPI_Request m_request;
-};
-
 /**
  * \ingroup mpi
  *
@@ -124,20 +86,28 @@ public:
    * \param dev destination device
    *
    * Serialize and send a packet to the specified node and net device.
+   * When the packets are aggregated, the packet is sent with the next
+   * Null Message to the rank of the node.
    *
    * \internal
-   * The MPI buffer format packs a delivery information and the serialized packet.
+   * The MPI buffer format packs the guarantee time for the Null Message
+   * algorithm and the request time, followed by the records of the
+   * packets of the batch, see MpiPacketBatch.
    *
-   * uint64_t time the packed should be delivered
    * uint64_t guarantee time for the Null Message algorithm.
-   * uint32_t node id of destination
-   * unit32_t dev id on destination
-   * uint8_t[] serialized packet
+   * uint64_t time up to which a guarantee is requested, or zero.
+   * uint64_t earliest output time, for the request.
+   * uint64_t number of messages holding packets received from the remote task, for the request.
+   * uint8_t[] records of the packets
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
   /**
    * \param guaranteeUpdate guarantee update time for the Null Message
-   * \bundle the destination bundle for the Null Message.
+   * \param bundle the destination bundle for the Null Message.
+   * \param request the time up to which a guarantee is requested from
+   *        the remote task, or zero
+   * \param output the earliest output time of this task to the remote
+   *        task, excluding the packets of the remote task, for the request
    *
    * \brief Send a Null Message to across the specified bundle.  
    *
@@ -147,19 +117,30 @@ public:
    *
    * Null Messages are sent when a packet has not been sent across
    * this bundle in order to allow time advancement on the remote
-   * MPI task.
+   * MPI task.  The packets aggregated for the remote task are sent
+   * with the Null Message.  A task blocked on the remote task
+   * requests a guarantee up to the time of its next event, giving its
+   * earliest output time so that the remote task may compute its
+   * guarantee beyond the last guarantee received from this task.
    *
    * \internal
-   * The Null Message MPI buffer format is based on the format for sending a packet with
-   * several fields set to 0 to signal that it is a Null Message.  Overloading the normal packet
-   * format simplifies receive logic.
+   * The Null Message MPI buffer format is the format for sending
+   * packets, a Null Message being a batch without packets.
    *
-   * uint64_t 0 must be zero for Null Message
    * uint64_t guarantee time
-   * uint32_t 0 must be zero for Null Message
-   * uint32_t 0 must be zero for Null Message
+   * uint64_t request time
+   * uint64_t earliest output time
+   * uint64_t number of messages holding packets received
+   * uint8_t[] records of the packets aggregated for the remote task, if any
+   */
+  static void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle,
+                               const Time& request = Time (0), const Time& output = Time (0));
+  /**
+   * Send the packets aggregated for the remote tasks, with their
+   * guarantee time.  Must be called before blocking on the receive
+   * of a message, since the remote tasks may wait for the packets.
    */
-  static void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle);
+  static void SendPendingPackets ();
   /**
    * Non-blocking check for received messages complete.  Will
    * receive all messages that are queued up locally.
@@ -193,6 +174,18 @@ private:
    * receive all messages that are queued up locally.
    */
   static void ReceiveMessages (bool blocking = false);
+  /**
+   * Send the batch of a rank, with a guarantee time.  The guarantee
+   * time sent is at least the last one sent to the rank.
+   * \param rank the destination rank
+   * \param guaranteeUpdate guarantee update time for the Null Message
+   * \param request the time up to which a guarantee is requested from
+   *        the rank, or zero
+   * \param output the earliest output time of this task to the rank,
+   *        for the request
+   */
+  static void SendBatch (uint32_t rank, const Time& guaranteeUpdate,
+                         const Time& request = Time (0), const Time& output = Time (0));
 
   // System ID (rank) for this task
   static uint32_t g_sid;
@@ -206,14 +199,11 @@ private:
   static bool     g_initialized;
   static bool     g_enabled;
 
-  // Pending non-blocking receives
-  static MPI_Request* g_requests;
-
-  // Data buffers for non-blocking receives
-  static char**   g_pRxBuffers;
+  // Data buffers and requests of the non-blocking receives
+  static MpiReceiveBuffers g_rxBuffers;
 
-  // List of pending non-blocking sends
-  static std::list<NullMessageSentBuffer> g_pendingTx;
+  // Packets to send, and pending non-blocking sends
+  static MpiPacketBatch g_batch;
 };
 
 } // namespace ns3
@@ -31,16 +31,22 @@
 #include <ns3/event-impl.h>
 #include <ns3/channel.h>
 #include <ns3/node-container.h>
+#include <ns3/node-list.h>
+#include <ns3/boolean.h>
 #include <ns3/double.h>
 #include <ns3/ptr.h>
 #include <ns3/pointer.h>
 #include <ns3/assert.h>
 #include <ns3/log.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <queue>
+#include <set>
 
 namespace ns3 {
 
@@ -50,6 +56,26 @@ NS_OBJECT_ENSURE_REGISTERED (NullMessageSimulatorImpl);
 
 NullMessageSimulatorImpl* NullMessageSimulatorImpl::g_instance = 0;
 
+namespace {
+
+/**
+ * \param time a time, or the maximum simulation time
+ * \param delay a delay
+ * \return the time plus the delay, bounded by the maximum simulation time
+ */
+Time
+AddDelay (Time time, Time delay)
+{
+  Time maximum = Simulator::GetMaximumSimulationTime ();
+  if (time >= maximum - delay)
+    {
+      return maximum;
+    }
+  return time + delay;
+}
+
+} // unnamed namespace
+
 TypeId
 NullMessageSimulatorImpl::GetTypeId (void)
 {
@@ -61,6 +87,21 @@ NullMessageSimulatorImpl::GetTypeId (void)
                    DoubleValue (1.0),
                    MakeDoubleAccessor (&NullMessageSimulatorImpl::m_schedulerTune),
                    MakeDoubleChecker<double> (0.01,1.0))
+    .AddAttribute ("DemandDriven",
+                   "Send the Null Messages only to the remote tasks blocked "
+                   "on this task, instead of periodically",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&NullMessageSimulatorImpl::m_demandDriven),
+                   MakeBooleanChecker ())
+    .AddAttribute ("EarliestOutputTime",
+                   "Estimate the guarantee times from the distance of the "
+                   "pending events to the remote tasks, through the channels "
+                   "of the nodes, instead of the smallest delay of the channels "
+                   "to the remote tasks only.  This is correct only if the events "
+                   "of a node reach the other nodes through their channels only",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NullMessageSimulatorImpl::m_earliestOutputTime),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -85,6 +126,7 @@ NullMessageSimulatorImpl::NullMessageSimulatorImpl ()
   m_unscheduledEvents = 0;
   m_eventCount = 0;
   m_events = 0;
+  m_inEvent = false;
 
   m_safeTime = Seconds (0);
 
@@ -127,6 +169,19 @@ NullMessageSimulatorImpl::Destroy ()
         }
     }
 
+  for (std::vector<RemoteChannelBundle *>::const_iterator i = m_bundles.begin ();
+       i != m_bundles.end (); ++i)
+    {
+      NS_LOG_INFO ("Task " << m_myId << " to task " << (*i)->GetSystemId ()
+                   << ": " << (*i)->GetNullMessagesSent () << " Null Messages and "
+                   << (*i)->GetPacketMessagesSent () << " packet messages sent, "
+                   << (*i)->GetNullMessagesReceived () << " Null Messages and "
+                   << (*i)->GetPacketMessagesReceived () << " packet messages received");
+      (*i)->ClearEarliestOutputTime ();
+    }
+  m_bundles.clear ();
+  m_boundaryBundles.clear ();
+
   RemoteChannelBundleManager::Destroy();
   MpiInterface::Destroy ();
 }
@@ -137,6 +192,7 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
   NS_LOG_FUNCTION (this);
 
   int num_local_nodes = 0;
+  std::map<uint32_t, std::map<uint32_t, Time> > attached;
 
   if (MpiInterface::GetSize () > 1)
     {
@@ -193,6 +249,13 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
               TimeValue delay;
               channel->GetAttribute ("Delay", delay);
               remoteChannelBundle->AddChannel (channel, delay.Get () );
+
+              std::map<uint32_t, Time> &nodes = attached[remoteNode->GetSystemId ()];
+              std::map<uint32_t, Time>::iterator node = nodes.find ((*iter)->GetId ());
+              if (node == nodes.end () || delay.Get () < node->second)
+                {
+                  nodes[(*iter)->GetId ()] = delay.Get ();
+                }
             }
         }
     }
@@ -200,10 +263,151 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
   // Completed setup of remote channel bundles.  Setup send and receive buffers.
   NullMessageMpiInterface::InitializeSendReceiveBuffers ();
 
+  m_bundles.clear ();
+  for (uint32_t rank = 0; rank < m_systemCount; ++rank)
+    {
+      Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (rank);
+      if (bundle)
+        {
+          m_bundles.push_back (PeekPointer (bundle));
+        }
+    }
+  if (m_earliestOutputTime && !m_bundles.empty ())
+    {
+      CalculateEarliestOutputTime (attached);
+    }
+
   // Initialized to 0 as we don't have a simulation start time.
   m_safeTime = Time (0);
 }
 
+void
+NullMessageSimulatorImpl::CalculateEarliestOutputTime (const std::map<uint32_t, std::map<uint32_t, Time> > &attached)
+{
+  NS_LOG_FUNCTION (this);
+
+  const int64_t infinity = std::numeric_limits<int64_t>::max ();
+  uint32_t nNodes = NodeList::GetNNodes ();
+  m_boundaryBundles.assign (nNodes, std::vector<RemoteChannelBundle *> ());
+
+  for (std::vector<RemoteChannelBundle *>::const_iterator b = m_bundles.begin (); b != m_bundles.end (); ++b)
+    {
+      RemoteChannelBundle *bundle = *b;
+
+      // Distance of the local nodes to the remote task, through the
+      // channels: a channel is crossed once, from its closest node.
+      std::vector<int64_t> distance (nNodes, infinity);
+      std::set<uint32_t> channels;
+      typedef std::pair<int64_t, uint32_t> Item;
+      std::priority_queue<Item, std::vector<Item>, std::greater<Item> > queue;
+      const std::map<uint32_t, Time> &sources = attached.find (bundle->GetSystemId ())->second;
+      for (std::map<uint32_t, Time>::const_iterator i = sources.begin (); i != sources.end (); ++i)
+        {
+          distance[i->first] = i->second.GetTimeStep ();
+          queue.push (Item (distance[i->first], i->first));
+        }
+      while (!queue.empty ())
+        {
+          Item item = queue.top ();
+          queue.pop ();
+          if (item.first > distance[item.second])
+            {
+              continue;
+            }
+          Ptr<Node> node = NodeList::GetNode (item.second);
+          for (uint32_t i = 0; i < node->GetNDevices (); ++i)
+            {
+              Ptr<Channel> channel = node->GetDevice (i)->GetChannel ();
+              if (channel == 0 || !channels.insert (channel->GetId ()).second)
+                {
+                  continue;
+                }
+              // The channels without delay, e.g. wireless channels, are
+              // crossed without delay.
+              TimeValue delay;
+              int64_t d = item.first;
+              if (channel->GetAttributeFailSafe ("Delay", delay))
+                {
+                  d += delay.Get ().GetTimeStep ();
+                }
+              for (std::size_t j = 0; j < channel->GetNDevices (); ++j)
+                {
+                  Ptr<Node> other = channel->GetDevice (j)->GetNode ();
+                  if (other->GetSystemId () == m_myId && d < distance[other->GetId ()])
+                    {
+                      distance[other->GetId ()] = d;
+                      queue.push (Item (d, other->GetId ()));
+                    }
+                }
+            }
+        }
+
+      // The events of the nodes of the other tasks, scheduled e.g. when
+      // the nodes are created, are assumed to be at the delay of the bundle.
+      int64_t interior = infinity;
+      for (uint32_t n = 0; n < nNodes; ++n)
+        {
+          if (NodeList::GetNode (n)->GetSystemId () != m_myId
+              || distance[n] <= bundle->GetDelay ().GetTimeStep ())
+            {
+              m_boundaryBundles[n].push_back (bundle);
+            }
+          else
+            {
+              interior = std::min (interior, distance[n]);
+            }
+        }
+      bundle->SetInteriorDelay (TimeStep (interior));
+
+      // The packets received from the other tasks
+      for (std::vector<RemoteChannelBundle *>::const_iterator r = m_bundles.begin (); r != m_bundles.end (); ++r)
+        {
+          const std::map<uint32_t, Time> &receivers = attached.find ((*r)->GetSystemId ())->second;
+          int64_t d = infinity;
+          for (std::map<uint32_t, Time>::const_iterator i = receivers.begin (); i != receivers.end (); ++i)
+            {
+              d = std::min (d, distance[i->first]);
+            }
+          if (d != infinity)
+            {
+              bundle->AddInputDelay (*r, TimeStep (d));
+            }
+        }
+    }
+
+  // Record the events scheduled before the simulation starts
+  std::vector<Scheduler::Event> events;
+  while (!m_events->IsEmpty ())
+    {
+      events.push_back (m_events->RemoveNext ());
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      m_events->Insert (*i);
+      AddEvent (i->key.m_context, i->key.m_ts);
+    }
+}
+
+const std::vector<RemoteChannelBundle *> &
+NullMessageSimulatorImpl::GetBoundaryBundles (uint32_t context) const
+{
+  if (context < m_boundaryBundles.size ())
+    {
+      return m_boundaryBundles[context];
+    }
+  return m_bundles;
+}
+
+void
+NullMessageSimulatorImpl::AddEvent (uint32_t context, uint64_t ts)
+{
+  const std::vector<RemoteChannelBundle *> &bundles = GetBoundaryBundles (context);
+  for (std::vector<RemoteChannelBundle *>::const_iterator i = bundles.begin (); i != bundles.end (); ++i)
+    {
+      (*i)->AddBoundaryEvent (ts);
+    }
+}
+
 void
 NullMessageSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
 {
@@ -233,12 +437,24 @@ NullMessageSimulatorImpl::ProcessOneEvent (void)
   m_unscheduledEvents--;
   m_eventCount++;
 
+  if (!m_boundaryBundles.empty ())
+    {
+      const std::vector<RemoteChannelBundle *> &bundles = GetBoundaryBundles (next.key.m_context);
+      for (std::vector<RemoteChannelBundle *>::const_iterator i = bundles.begin (); i != bundles.end (); ++i)
+        {
+          (*i)->PopBoundaryEvent (next.key.m_ts);
+        }
+    }
+
   NS_LOG_LOGIC ("handle " << next.key.m_ts);
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
+  m_inEvent = true;
   next.impl->Invoke ();
+  m_inEvent = false;
   next.impl->Unref ();
+  m_profiler.NotifyEvent (m_currentTs, m_eventCount);
 }
 
 bool
@@ -263,6 +479,11 @@ NullMessageSimulatorImpl::ScheduleNullMessageEvent (Ptr<RemoteChannelBundle> bun
 {
   NS_LOG_FUNCTION (this << bundle);
 
+  if (m_demandDriven)
+    {
+      return;
+    }
+
   Time delay (m_schedulerTune * bundle->GetDelay ().GetTimeStep ());
 
   bundle->SetEventId (Simulator::Schedule (delay, &NullMessageSimulatorImpl::NullMessageEventHandler, 
@@ -274,6 +495,11 @@ NullMessageSimulatorImpl::RescheduleNullMessageEvent (Ptr<RemoteChannelBundle> b
 {
   NS_LOG_FUNCTION (this << bundle);
 
+  if (m_demandDriven)
+    {
+      return;
+    }
+
   Simulator::Cancel (bundle->GetEventId ());
 
   Time delay (m_schedulerTune * bundle->GetDelay ().GetTimeStep ());
@@ -302,11 +528,25 @@ NullMessageSimulatorImpl::Run (void)
 
   RemoteChannelBundleManager::InitializeNullMessageEvents ();
 
-  // Stop will be set if stop is called by simulation.
+  m_profiler.Start (m_myId, m_systemCount, Now ());
+
+  // Stop will be set if stop is called by simulation.  Without the
+  // periodic Null Message events, the event list of a task may be empty
+  // while the remote tasks still send packets.
   m_stop = false;
-  while (!IsFinished ())
+  while (!m_stop)
     {
-      Time nextTime = Next ();
+      if (m_events->IsEmpty () && (!m_demandDriven || m_bundles.empty ()))
+        {
+          break;
+        }
+      // Once all the tasks are out of events, the guarantees reach the
+      // maximum simulation time and no packet can arrive anymore
+      if (m_events->IsEmpty () && GetSafeTime () == GetMaximumSimulationTime ())
+        {
+          break;
+        }
+      Time nextTime = m_events->IsEmpty () ? GetMaximumSimulationTime () : Next ();
 
       if ( nextTime <= GetSafeTime () )
         {
@@ -319,6 +559,23 @@ NullMessageSimulatorImpl::Run (void)
           HandleArrivingMessagesBlocking ();
         }
     }
+
+  // The remote tasks may be blocked on this task, which will not
+  // answer their requests anymore.
+  if (m_demandDriven && !m_bundles.empty ())
+    {
+      NullMessageMpiInterface::SendPendingPackets ();
+      for (std::vector<RemoteChannelBundle *>::const_iterator i = m_bundles.begin (); i != m_bundles.end (); ++i)
+        {
+          Time guarantee = CalculateGuaranteeTime (*i);
+          if (guarantee > (*i)->GetSentGuaranteeTime ())
+            {
+              NullMessageMpiInterface::SendNullMessage (guarantee, *i);
+            }
+        }
+    }
+
+  m_profiler.Stop (Now (), m_eventCount);
 }
 
 void
@@ -330,6 +587,11 @@ NullMessageSimulatorImpl::HandleArrivingMessagesNonBlocking (void)
 
   CalculateSafeTime ();
 
+  if (m_demandDriven)
+    {
+      SendNullMessages (false);
+    }
+
   // Check for send completes
   NullMessageMpiInterface::TestSendComplete ();
 }
@@ -339,9 +601,24 @@ NullMessageSimulatorImpl::HandleArrivingMessagesBlocking (void)
 {
   NS_LOG_FUNCTION (this);
 
+  // The requests carry the aggregated packets, if any
+  if (m_demandDriven)
+    {
+      SendNullMessages (true);
+    }
+
+  // The remote tasks may be waiting for the aggregated packets
+  NullMessageMpiInterface::SendPendingPackets ();
+
+  m_profiler.BeginBlocking ();
   NullMessageMpiInterface::ReceiveMessagesBlocking ();
+  m_profiler.EndBlocking ();
 
   CalculateSafeTime ();
+  if (!m_events->IsEmpty () && Next () <= GetSafeTime () && GetSafeTime () != GetMaximumSimulationTime ())
+    {
+      m_profiler.NotifyWindow (Now (), GetSafeTime ());
+    }
 
   // Check for send completes
   NullMessageMpiInterface::TestSendComplete ();
@@ -413,6 +690,10 @@ NullMessageSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (!m_boundaryBundles.empty ())
+    {
+      AddEvent (ev.key.m_context, ev.key.m_ts);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -434,6 +715,10 @@ NullMessageSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &del
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (!m_boundaryBundles.empty ())
+    {
+      AddEvent (ev.key.m_context, ev.key.m_ts);
+    }
 }
 
 EventId
@@ -449,6 +734,10 @@ NullMessageSimulatorImpl::ScheduleNow (EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (!m_boundaryBundles.empty ())
+    {
+      AddEvent (ev.key.m_context, ev.key.m_ts);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -508,6 +797,14 @@ NullMessageSimulatorImpl::Remove (const EventId &id)
   event.key.m_context = id.GetContext ();
   event.key.m_uid = id.GetUid ();
   m_events->Remove (event);
+  if (!m_boundaryBundles.empty ())
+    {
+      const std::vector<RemoteChannelBundle *> &bundles = GetBoundaryBundles (event.key.m_context);
+      for (std::vector<RemoteChannelBundle *>::const_iterator i = bundles.begin (); i != bundles.end (); ++i)
+        {
+          (*i)->RemoveBoundaryEvent (event.key.m_ts);
+        }
+    }
   event.impl->Cancel ();
   // whenever we remove an event from the event list, we have to unref it.
   event.impl->Unref ();
@@ -583,14 +880,97 @@ Time NullMessageSimulatorImpl::CalculateGuaranteeTime (uint32_t nodeSysId)
   Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (nodeSysId);
   NS_ASSERT (bundle);
 
-  return Min (NullMessageSimulatorImpl::GetInstance ()->Next (), GetSafeTime ()) + bundle->GetDelay ();
+  return CalculateGuaranteeTime (bundle);
+}
+
+Time NullMessageSimulatorImpl::CalculateGuaranteeTime (Ptr<RemoteChannelBundle> bundle)
+{
+  return Min (CalculateOutputTime (bundle),
+              AddDelay (bundle->GetGuaranteeTime (), GetSelfInputDelay (bundle)));
+}
+
+Time NullMessageSimulatorImpl::CalculateOutputTime (Ptr<RemoteChannelBundle> bundle)
+{
+  Time next = m_events->IsEmpty () ? GetMaximumSimulationTime () : Next ();
+  if (m_boundaryBundles.empty ())
+    {
+      Time safeTime = GetMaximumSimulationTime ();
+      for (std::vector<RemoteChannelBundle *>::const_iterator i = m_bundles.begin (); i != m_bundles.end (); ++i)
+        {
+          if (*i != PeekPointer (bundle))
+            {
+              safeTime = Min (safeTime, (*i)->GetGuaranteeTime ());
+            }
+        }
+      return AddDelay (Min (next, safeTime), bundle->GetDelay ());
+    }
+
+  // Earliest output time: the events on the nodes at the delay of the
+  // bundle, the other events, and the packets from the other remote
+  // tasks, which arrive after their guarantee time.
+  Time eot = AddDelay (bundle->GetNextBoundaryEvent (), bundle->GetDelay ());
+  eot = Min (eot, AddDelay (next, bundle->GetInteriorDelay ()));
+  eot = Min (eot, bundle->GetInputTime ());
+  if (m_inEvent)
+    {
+      // The event being executed may schedule events on its node now
+      const std::vector<RemoteChannelBundle *> &bundles = GetBoundaryBundles (m_currentContext);
+      bool boundary = std::find (bundles.begin (), bundles.end (), PeekPointer (bundle)) != bundles.end ();
+      eot = Min (eot, AddDelay (Now (), boundary ? bundle->GetDelay () : bundle->GetInteriorDelay ()));
+    }
+  return eot;
+}
+
+Time
+NullMessageSimulatorImpl::GetSelfInputDelay (Ptr<RemoteChannelBundle> bundle) const
+{
+  if (m_boundaryBundles.empty ())
+    {
+      return bundle->GetDelay ();
+    }
+  return bundle->GetSelfInputDelay ();
+}
+
+void
+NullMessageSimulatorImpl::SendNullMessages (bool blocked)
+{
+  NS_LOG_FUNCTION (this << blocked);
+
+  Time next = m_events->IsEmpty () ? GetMaximumSimulationTime () : Next ();
+  for (std::vector<RemoteChannelBundle *>::const_iterator i = m_bundles.begin (); i != m_bundles.end (); ++i)
+    {
+      RemoteChannelBundle *bundle = *i;
+      // A blocked task requests a guarantee from the tasks it is
+      // waiting for, unless an earlier request covers it.
+      bool request = blocked && bundle->GetGuaranteeTime () < next && bundle->GetRequestTime () < next;
+      Time demand = bundle->GetDemand ();
+      if (!request && demand.IsZero ())
+        {
+          continue;
+        }
+      Time output = CalculateOutputTime (bundle);
+      Time guarantee = Min (output, AddDelay (bundle->GetGuaranteeTime (), GetSelfInputDelay (bundle)));
+      Time demandOutput = bundle->GetDemandOutputTime ();
+      if (!demandOutput.IsZero ())
+        {
+          guarantee = Max (guarantee, Min (output, AddDelay (demandOutput, GetSelfInputDelay (bundle))));
+        }
+      if (request
+          || (!demand.IsZero ()
+              && (guarantee >= demand || (blocked && guarantee > bundle->GetSentGuaranteeTime ()))))
+        {
+          NS_LOG_LOGIC ("Null Message to task " << bundle->GetSystemId () << ", guarantee "
+                        << guarantee << (request ? ", request" : ""));
+          NullMessageMpiInterface::SendNullMessage (guarantee, bundle, request ? next : Time (0), output);
+        }
+    }
 }
 
 void NullMessageSimulatorImpl::NullMessageEventHandler(RemoteChannelBundle* bundle)
 {
   NS_LOG_FUNCTION (this << bundle);
 
-  Time time = Min (Next (), GetSafeTime ()) + bundle->GetDelay ();
+  Time time = CalculateGuaranteeTime (bundle);
   NullMessageMpiInterface::SendNullMessage (time, bundle);
 
   ScheduleNullMessageEvent (bundle);
@@ -28,6 +28,8 @@
 #include <ns3/ptr.h>
 
 #include <list>
+#include <map>
+#include <vector>
 #include <iostream>
 #include <fstream>
 
@@ -159,6 +161,83 @@ private:
    */
   Time CalculateGuaranteeTime (uint32_t systemId);
 
+  /**
+   * \param bundle the bundle to compute guarantee time for
+   *
+   * \return Guarantee time
+   *
+   * Calculate the guarantee time for the remote task of the bundle.
+   * It is the next event time, or the safe time, plus the delay of
+   * the bundle, or, if EarliestOutputTime is true, the earliest output
+   * time of the bundle: the earliest time at which the pending events,
+   * and the packets to be received from the other tasks, may reach the
+   * remote task given their distance to it.
+   */
+  Time CalculateGuaranteeTime (Ptr<RemoteChannelBundle> bundle);
+
+  /**
+   * \param bundle the bundle to compute the output time for
+   *
+   * \return the guarantee time for the remote task of the bundle,
+   * excluding the packets which will be received from the remote task
+   */
+  Time CalculateOutputTime (Ptr<RemoteChannelBundle> bundle);
+
+  /**
+   * \param bundle a bundle
+   *
+   * \return the smallest distance from the nodes receiving the packets
+   * of the bundle to the remote task of the bundle
+   */
+  Time GetSelfInputDelay (Ptr<RemoteChannelBundle> bundle) const;
+
+  /**
+   * \param blocked whether this task is blocked until messages are
+   *        received
+   *
+   * Send the Null Messages when DemandDriven is true: to the remote
+   * tasks which requested a guarantee, once the guarantee reaches the
+   * time requested, or if this task is blocked, as soon as the
+   * guarantee increases.  A blocked task also requests a guarantee from
+   * the remote tasks it is waiting for.
+   *
+   * A request gives the earliest output time of the requesting task,
+   * excluding the packets of the remote task.  If the requesting task
+   * had received all the messages of the remote task, the packets
+   * which the remote task will receive from the requesting task are
+   * either sent after this output time, or caused by the packets the
+   * remote task will send: the guarantee of the remote task may then
+   * exceed the last guarantee of the requesting task, instead of
+   * creeping by the delay of the bundle with each exchange.
+   */
+  void SendNullMessages (bool blocked);
+
+  /**
+   * \param attached for each remote task, the local nodes attached to
+   *        the channels to the task, with the delay of their channel
+   *
+   * Compute the distance of the nodes to the remote tasks, through the
+   * channels of the nodes of this task, used to estimate the earliest
+   * output time of the bundles, and record the events already
+   * scheduled.
+   */
+  void CalculateEarliestOutputTime (const std::map<uint32_t, std::map<uint32_t, Time> > &attached);
+
+  /**
+   * \param context the context of an event
+   * \return the bundles for which the events in this context are at the
+   *         delay of the bundle
+   */
+  const std::vector<RemoteChannelBundle *> & GetBoundaryBundles (uint32_t context) const;
+
+  /**
+   * \param context the context of an event
+   * \param ts the time stamp of the event
+   *
+   * Record an event scheduled, for the earliest output time.
+   */
+  void AddEvent (uint32_t context, uint64_t ts);
+
   /**
    * \param bundle remote channel bundle to schedule an event for.
    *
@@ -204,6 +283,34 @@ private:
    */
   double m_schedulerTune;
 
+  /*
+   * Whether the Null Messages are sent only to the tasks blocked on this
+   * task, instead of periodically.
+   */
+  bool m_demandDriven;
+
+  /*
+   * Whether the guarantee times are the earliest output times of the
+   * bundles, instead of the next event time plus the delay.
+   */
+  bool m_earliestOutputTime;
+
+  /*
+   * Whether an event is being executed.
+   */
+  bool m_inEvent;
+
+  /*
+   * The bundles to the remote tasks.
+   */
+  std::vector<RemoteChannelBundle *> m_bundles;
+
+  /*
+   * For each node, the bundles for which the node is at the delay of
+   * the bundle; empty if the earliest output times are not tracked.
+   */
+  std::vector<std::vector<RemoteChannelBundle *> > m_boundaryBundles;
+
   /*
    * Singleton instance.
    */
@@ -42,14 +42,36 @@ TypeId RemoteChannelBundle::GetTypeId (void)
 RemoteChannelBundle::RemoteChannelBundle ()
   : m_remoteSystemId (UINT32_MAX),
     m_guaranteeTime (0),
-    m_delay (NS_TIME_INFINITY)
+    m_delay (NS_TIME_INFINITY),
+    m_sentGuaranteeTime (0),
+    m_demand (0),
+    m_demandOutput (0),
+    m_demandReceived (0),
+    m_requestTime (0),
+    m_nullMessagesSent (0),
+    m_packetMessagesSent (0),
+    m_nullMessagesReceived (0),
+    m_packetMessagesReceived (0),
+    m_interiorDelay (NS_TIME_INFINITY),
+    m_selfInputDelay (NS_TIME_INFINITY)
 {
 }
 
 RemoteChannelBundle::RemoteChannelBundle (const uint32_t remoteSystemId)
   : m_remoteSystemId (remoteSystemId),
     m_guaranteeTime (0),
-    m_delay (NS_TIME_INFINITY)
+    m_delay (NS_TIME_INFINITY),
+    m_sentGuaranteeTime (0),
+    m_demand (0),
+    m_demandOutput (0),
+    m_demandReceived (0),
+    m_requestTime (0),
+    m_nullMessagesSent (0),
+    m_packetMessagesSent (0),
+    m_nullMessagesReceived (0),
+    m_packetMessagesReceived (0),
+    m_interiorDelay (NS_TIME_INFINITY),
+    m_selfInputDelay (NS_TIME_INFINITY)
 {
 }
 
@@ -104,6 +126,208 @@ RemoteChannelBundle::GetSize (void) const
   return m_channels.size ();
 }
 
+Time
+RemoteChannelBundle::GetSentGuaranteeTime (void) const
+{
+  return m_sentGuaranteeTime;
+}
+
+Time
+RemoteChannelBundle::GetDemand (void) const
+{
+  return m_demand;
+}
+
+Time
+RemoteChannelBundle::GetDemandOutputTime (void) const
+{
+  if (m_demand.IsZero () || m_demandReceived != m_packetMessagesSent)
+    {
+      return Time (0);
+    }
+  return m_demandOutput;
+}
+
+Time
+RemoteChannelBundle::GetRequestTime (void) const
+{
+  return m_requestTime;
+}
+
+void
+RemoteChannelBundle::NotifySent (bool hasPackets, Time guarantee, Time request)
+{
+  NS_ASSERT (guarantee >= m_sentGuaranteeTime);
+
+  if (hasPackets)
+    {
+      ++m_packetMessagesSent;
+    }
+  else
+    {
+      ++m_nullMessagesSent;
+    }
+  m_sentGuaranteeTime = guarantee;
+  // The request of the remote task stands until it is answered
+  if (guarantee >= m_demand)
+    {
+      m_demand = Time (0);
+    }
+  if (request.IsStrictlyPositive ())
+    {
+      m_requestTime = request;
+    }
+}
+
+void
+RemoteChannelBundle::NotifyReceived (bool hasPackets, Time guarantee, Time request, Time output, uint64_t received)
+{
+  if (hasPackets)
+    {
+      ++m_packetMessagesReceived;
+    }
+  else
+    {
+      ++m_nullMessagesReceived;
+    }
+  SetGuaranteeTime (guarantee);
+  if (guarantee >= m_requestTime)
+    {
+      m_requestTime = Time (0);
+    }
+  // A guarantee already sent, and not yet received by the remote task,
+  // answers the request.
+  if (request > m_sentGuaranteeTime)
+    {
+      m_demand = request;
+    }
+  // The remote task sends its output time with all its messages, so
+  // that it stays up to date while the request stands.
+  if (output.IsStrictlyPositive ())
+    {
+      m_demandOutput = output;
+      m_demandReceived = received;
+    }
+}
+
+uint64_t
+RemoteChannelBundle::GetNullMessagesSent (void) const
+{
+  return m_nullMessagesSent;
+}
+
+uint64_t
+RemoteChannelBundle::GetPacketMessagesSent (void) const
+{
+  return m_packetMessagesSent;
+}
+
+uint64_t
+RemoteChannelBundle::GetNullMessagesReceived (void) const
+{
+  return m_nullMessagesReceived;
+}
+
+uint64_t
+RemoteChannelBundle::GetPacketMessagesReceived (void) const
+{
+  return m_packetMessagesReceived;
+}
+
+void
+RemoteChannelBundle::SetInteriorDelay (Time delay)
+{
+  m_interiorDelay = delay;
+}
+
+Time
+RemoteChannelBundle::GetInteriorDelay (void) const
+{
+  return m_interiorDelay;
+}
+
+void
+RemoteChannelBundle::AddInputDelay (Ptr<RemoteChannelBundle> bundle, Time delay)
+{
+  if (PeekPointer (bundle) == this)
+    {
+      m_selfInputDelay = delay;
+    }
+  else
+    {
+      m_inputDelays.push_back (std::make_pair (PeekPointer (bundle), delay));
+    }
+}
+
+Time
+RemoteChannelBundle::GetInputTime (void) const
+{
+  Time time = NS_TIME_INFINITY;
+  for (std::vector<std::pair<RemoteChannelBundle *, Time> >::const_iterator i = m_inputDelays.begin ();
+       i != m_inputDelays.end ();
+       ++i)
+    {
+      Time guarantee = i->first->GetGuaranteeTime ();
+      if (guarantee < NS_TIME_INFINITY - i->second)
+        {
+          time = Min (time, guarantee + i->second);
+        }
+    }
+  return time;
+}
+
+Time
+RemoteChannelBundle::GetSelfInputDelay (void) const
+{
+  return m_selfInputDelay;
+}
+
+void
+RemoteChannelBundle::AddBoundaryEvent (uint64_t ts)
+{
+  m_boundaryEvents.push (ts);
+}
+
+void
+RemoteChannelBundle::PopBoundaryEvent (uint64_t ts)
+{
+  GetNextBoundaryEvent ();
+  NS_ASSERT (!m_boundaryEvents.empty () && m_boundaryEvents.top () == ts);
+  m_boundaryEvents.pop ();
+}
+
+void
+RemoteChannelBundle::RemoveBoundaryEvent (uint64_t ts)
+{
+  // Removed lazily, when the event reaches the top of the heap
+  m_removedBoundaryEvents.push (ts);
+}
+
+Time
+RemoteChannelBundle::GetNextBoundaryEvent (void)
+{
+  while (!m_removedBoundaryEvents.empty ()
+         && m_boundaryEvents.top () == m_removedBoundaryEvents.top ())
+    {
+      m_boundaryEvents.pop ();
+      m_removedBoundaryEvents.pop ();
+    }
+  if (m_boundaryEvents.empty ())
+    {
+      return NS_TIME_INFINITY;
+    }
+  return TimeStep (m_boundaryEvents.top ());
+}
+
+void
+RemoteChannelBundle::ClearEarliestOutputTime (void)
+{
+  m_inputDelays.clear ();
+  m_selfInputDelay = NS_TIME_INFINITY;
+  m_boundaryEvents = TimeHeap ();
+  m_removedBoundaryEvents = TimeHeap ();
+}
+
 void 
 RemoteChannelBundle::Send(Time time)
 {
@@ -114,7 +338,11 @@ std::ostream& operator<< (std::ostream& out, ns3::RemoteChannelBundle& bundle )
 {
   out << "RemoteChannelBundle Rank = " << bundle.m_remoteSystemId
       << ", GuaranteeTime = "  << bundle.m_guaranteeTime
-      << ", Delay = " << bundle.m_delay << std::endl;
+      << ", Delay = " << bundle.m_delay
+      << ", Null Messages sent/received = " << bundle.m_nullMessagesSent
+      << "/" << bundle.m_nullMessagesReceived
+      << ", Packet messages sent/received = " << bundle.m_packetMessagesSent
+      << "/" << bundle.m_packetMessagesReceived << std::endl;
   
   for (std::map < uint32_t, Ptr < Channel > > ::const_iterator pair = bundle.m_channels.begin ();
        pair != bundle.m_channels.end ();
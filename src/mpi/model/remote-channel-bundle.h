@@ -28,7 +28,11 @@
 #include <ns3/ptr.h>
 #include <ns3/pointer.h>
 
+#include <functional>
 #include <map>
+#include <queue>
+#include <utility>
+#include <vector>
 
 namespace ns3 {
 
@@ -100,6 +104,144 @@ public:
    */
   std::size_t GetSize (void) const;
 
+  /**
+   * \return the last guarantee time sent to the remote task
+   */
+  Time GetSentGuaranteeTime (void) const;
+
+  /**
+   * \return the time up to which the remote task requested a
+   * guarantee, or zero if it did not request any or if the guarantee
+   * was sent
+   */
+  Time GetDemand (void) const;
+
+  /**
+   * \return the earliest output time of the remote task, excluding the
+   * packets sent by this task, given with its last message, or zero if
+   * it is not valid anymore or if there is no request
+   *
+   * The output time is valid if the remote task had received all the
+   * messages holding packets sent by this task when it sent it: the
+   * Null Messages it did not receive yet do not change its output time.
+   */
+  Time GetDemandOutputTime (void) const;
+
+  /**
+   * \return the time up to which a guarantee was requested from the
+   * remote task, or zero if the guarantee was received
+   */
+  Time GetRequestTime (void) const;
+
+  /**
+   * Record a message sent to the remote task.
+   *
+   * \param hasPackets whether the message holds packets
+   * \param guarantee the guarantee time of the message
+   * \param request the time up to which a guarantee is requested from
+   *        the remote task, or zero
+   */
+  void NotifySent (bool hasPackets, Time guarantee, Time request);
+
+  /**
+   * Record a message received from the remote task, and update the
+   * guarantee time of the bundle.
+   *
+   * \param hasPackets whether the message holds packets
+   * \param guarantee the guarantee time of the message
+   * \param request the time up to which the remote task requests a
+   *        guarantee, or zero
+   * \param output the earliest output time of the remote task,
+   *        excluding the packets sent by this task
+   * \param received the number of messages holding packets received
+   *        by the remote task from this task
+   */
+  void NotifyReceived (bool hasPackets, Time guarantee, Time request, Time output, uint64_t received);
+
+  /**
+   * \return number of Null Messages, without packets, sent to the remote task
+   */
+  uint64_t GetNullMessagesSent (void) const;
+
+  /**
+   * \return number of messages holding packets sent to the remote task
+   */
+  uint64_t GetPacketMessagesSent (void) const;
+
+  /**
+   * \return number of Null Messages, without packets, received from the remote task
+   */
+  uint64_t GetNullMessagesReceived (void) const;
+
+  /**
+   * \return number of messages holding packets received from the remote task
+   */
+  uint64_t GetPacketMessagesReceived (void) const;
+
+  /**
+   * \param delay the smallest distance, from the nodes which are not
+   * at the delay of the bundle, to the remote task
+   *
+   * Events on these nodes cannot reach the remote task before this
+   * distance.
+   */
+  void SetInteriorDelay (Time delay);
+
+  /**
+   * \return the smallest distance, from the nodes which are not at the
+   * delay of the bundle, to the remote task
+   */
+  Time GetInteriorDelay (void) const;
+
+  /**
+   * \param bundle another bundle, or this one
+   * \param delay the smallest distance from the nodes receiving the
+   *        packets of the other bundle to the remote task
+   */
+  void AddInputDelay (Ptr<RemoteChannelBundle> bundle, Time delay);
+
+  /**
+   * \return the earliest time at which the packets received from the
+   * other bundles, not from this one, may reach the remote task
+   */
+  Time GetInputTime (void) const;
+
+  /**
+   * \return the smallest distance from the nodes receiving the packets
+   * of this bundle to the remote task, or the maximum simulation time
+   * if the packets cannot reach the remote task
+   */
+  Time GetSelfInputDelay (void) const;
+
+  /**
+   * \param ts the time stamp of an event scheduled on a node at the
+   * delay of the bundle
+   */
+  void AddBoundaryEvent (uint64_t ts);
+
+  /**
+   * \param ts the time stamp of an event processed on a node at the
+   * delay of the bundle
+   */
+  void PopBoundaryEvent (uint64_t ts);
+
+  /**
+   * \param ts the time stamp of an event removed from a node at the
+   * delay of the bundle
+   */
+  void RemoveBoundaryEvent (uint64_t ts);
+
+  /**
+   * \return the time stamp of the next event on the nodes at the
+   * delay of the bundle, or the maximum simulation time if none
+   */
+  Time GetNextBoundaryEvent (void);
+
+  /**
+   * Remove the events and the input delays.
+   */
+  void ClearEarliestOutputTime (void);
+
   /**
    * \param time 
    *
@@ -144,6 +286,63 @@ private:
    */
   EventId m_nullEventId;
 
+  /*
+   * Last guarantee time sent to remote_rank.  The guarantee times
+   * sent never decrease.
+   */
+  Time m_sentGuaranteeTime;
+
+  /*
+   * Time up to which remote_rank requested a guarantee, zero if none,
+   * with the last earliest output time of remote_rank, excluding the
+   * packets from this task, and the number of messages holding packets
+   * it had received from this task.
+   */
+  Time m_demand;
+  Time m_demandOutput;
+  uint64_t m_demandReceived;
+
+  /*
+   * Time up to which a guarantee was requested from remote_rank, zero
+   * if none.
+   */
+  Time m_requestTime;
+
+  /*
+   * Number of messages sent and received, with and without packets.
+   */
+  uint64_t m_nullMessagesSent;
+  uint64_t m_packetMessagesSent;
+  uint64_t m_nullMessagesReceived;
+  uint64_t m_packetMessagesReceived;
+
+  /*
+   * Smallest distance to remote_rank from the nodes which are farther
+   * than the delay of the bundle.
+   */
+  Time m_interiorDelay;
+
+  /*
+   * Bundles whose packets may reach remote_rank, with the smallest
+   * distance from the nodes receiving them.  The bundles are owned by
+   * the RemoteChannelBundleManager.
+   */
+  std::vector<std::pair<RemoteChannelBundle *, Time> > m_inputDelays;
+
+  /*
+   * Smallest distance from the nodes receiving packets from remote_rank
+   * to remote_rank.
+   */
+  Time m_selfInputDelay;
+
+  /*
+   * Time stamps of the pending events on the nodes at the delay of the
+   * bundle, and of the events removed but still in the first heap.
+   */
+  typedef std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t> > TimeHeap;
+  TimeHeap m_boundaryEvents;
+  TimeHeap m_removedBoundaryEvents;
+
 };
 
 }
@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/mpi-partition-helper.h"
+
+using namespace ns3;
+
+/**
+ * Link two nodes with a SimpleChannel.
+ * \param a a node
+ * \param b the other node
+ * \param delay the delay of the channel
+ */
+static void
+Link (Ptr<Node> a, Ptr<Node> b, Time delay)
+{
+  SimpleNetDeviceHelper helper;
+  helper.SetChannelAttribute ("Delay", TimeValue (delay));
+  helper.Install (NodeContainer (a, b));
+}
+
+/**
+ * Count the nodes of each rank.
+ * \param part the rank of each node
+ * \param n the number of ranks
+ * \return the number of nodes of each rank
+ */
+static std::vector<uint32_t>
+CountNodes (const std::vector<uint32_t> &part, uint32_t n)
+{
+  std::vector<uint32_t> count (n, 0);
+  for (uint32_t i = 0; i < part.size (); ++i)
+    {
+      ++count[part[i]];
+    }
+  return count;
+}
+
+/**
+ * Check that two clusters of nodes joined by a long link are split
+ * along the long link.
+ */
+class MpiPartitionClustersTestCase : public TestCase
+{
+public:
+  MpiPartitionClustersTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpiPartitionClustersTestCase::MpiPartitionClustersTestCase ()
+  : TestCase ("Check the partition of two clusters joined by a long link")
+{
+}
+
+void
+MpiPartitionClustersTestCase::DoRun (void)
+{
+  NodeContainer left;
+  left.Create (10);
+  NodeContainer right;
+  right.Create (10);
+  for (uint32_t i = 1; i < 10; ++i)
+    {
+      // a chain, with a few shortcuts
+      Link (left.Get (i - 1), left.Get (i), MilliSeconds (1));
+      Link (right.Get (i - 1), right.Get (i), MilliSeconds (1));
+      if (i % 3 == 0)
+        {
+          Link (left.Get (i - 3), left.Get (i), MilliSeconds (2));
+          Link (right.Get (i - 3), right.Get (i), MilliSeconds (2));
+        }
+    }
+  Link (left.Get (4), right.Get (5), MilliSeconds (10));
+
+  MpiPartitionHelper helper;
+  std::vector<uint32_t> part = helper.Partition (2);
+  NS_TEST_ASSERT_MSG_EQ (part.size (), 20, "wrong number of nodes");
+  for (uint32_t i = 1; i < 10; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (part[left.Get (i)->GetId ()], part[left.Get (0)->GetId ()], "left cluster split");
+      NS_TEST_ASSERT_MSG_EQ (part[right.Get (i)->GetId ()], part[right.Get (0)->GetId ()], "right cluster split");
+    }
+  NS_TEST_ASSERT_MSG_NE (part[left.Get (0)->GetId ()], part[right.Get (0)->GetId ()], "clusters not split");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetCutSize (), 1, "wrong number of links cut");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetLookahead (), MilliSeconds (10), "wrong lookahead");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Check the balance of the partition of a ring, and that the nodes
+ * linked by the channels which cannot be cut stay together.
+ */
+class MpiPartitionBalanceTestCase : public TestCase
+{
+public:
+  MpiPartitionBalanceTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpiPartitionBalanceTestCase::MpiPartitionBalanceTestCase ()
+  : TestCase ("Check the balance of the partition of a ring")
+{
+}
+
+void
+MpiPartitionBalanceTestCase::DoRun (void)
+{
+  NodeContainer ring;
+  ring.Create (64);
+  for (uint32_t i = 0; i < 64; ++i)
+    {
+      Link (ring.Get (i), ring.Get ((i + 1) % 64), MilliSeconds (5));
+    }
+
+  MpiPartitionHelper helper;
+  std::vector<uint32_t> part = helper.Partition (4);
+  std::vector<uint32_t> count = CountNodes (part, 4);
+  for (uint32_t r = 0; r < 4; ++r)
+    {
+      NS_TEST_ASSERT_MSG_GT (count[r], 0, "empty rank " << r);
+    }
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (helper.GetImbalance (), 1.1, "partition not balanced");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (helper.GetCutSize (), 8, "too many links cut");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetLookahead (), MilliSeconds (5), "wrong lookahead");
+
+  // A node linked to all the others by channels without delay, which
+  // cannot be cut: all the nodes stay on the same rank.
+  Ptr<Node> hub = CreateObject<Node> ();
+  for (uint32_t i = 0; i < 64; i += 16)
+    {
+      Link (hub, ring.Get (i), Seconds (0));
+    }
+  part = helper.Partition (4);
+  for (uint32_t i = 0; i < 64; i += 16)
+    {
+      NS_TEST_ASSERT_MSG_EQ (part[ring.Get (i)->GetId ()], part[hub->GetId ()], "nodes linked without delay split");
+    }
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (helper.GetImbalance (), 1.1, "partition not balanced");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that the load of the nodes set explicitly is balanced.
+ */
+class MpiPartitionWeightTestCase : public TestCase
+{
+public:
+  MpiPartitionWeightTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpiPartitionWeightTestCase::MpiPartitionWeightTestCase ()
+  : TestCase ("Check the partition of nodes with different loads")
+{
+}
+
+void
+MpiPartitionWeightTestCase::DoRun (void)
+{
+  NodeContainer chain;
+  chain.Create (20);
+  for (uint32_t i = 1; i < 20; ++i)
+    {
+      Link (chain.Get (i - 1), chain.Get (i), MilliSeconds (1));
+    }
+
+  MpiPartitionHelper helper;
+  helper.SetNodeWeight (chain.Get (0), 56);
+  std::vector<uint32_t> part = helper.Partition (2);
+  std::vector<uint32_t> count = CountNodes (part, 2);
+  // the heavy node has the load of the 19 others: one plus the number
+  // of their devices
+  NS_TEST_ASSERT_MSG_EQ (count[part[chain.Get (0)->GetId ()]], 1, "heavy node not alone");
+  NS_TEST_ASSERT_MSG_EQ (helper.GetCutSize (), 1, "wrong number of links cut");
+  NS_TEST_ASSERT_MSG_EQ_TOL (helper.GetImbalance (), 1.0, 0.01, "partition not balanced");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * MpiPartitionHelper test suite
+ */
+class MpiPartitionHelperTestSuite : public TestSuite
+{
+public:
+  MpiPartitionHelperTestSuite ();
+};
+
+MpiPartitionHelperTestSuite::MpiPartitionHelperTestSuite ()
+  : TestSuite ("mpi-partition-helper", UNIT)
+{
+  // The SimpleChannels may be cut, without being converted
+  MpiPartitionHelper::AddChannelConverter (SimpleChannel::GetTypeId (),
+                                           MakeNullCallback<void, Ptr<Channel>, bool> ());
+  AddTestCase (new MpiPartitionClustersTestCase, TestCase::QUICK);
+  AddTestCase (new MpiPartitionBalanceTestCase, TestCase::QUICK);
+  AddTestCase (new MpiPartitionWeightTestCase, TestCase::QUICK);
+}
+
+static MpiPartitionHelperTestSuite g_mpiPartitionHelperTestSuite; //!< the test suite
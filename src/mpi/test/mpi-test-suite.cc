@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/example-as-test.h"
+#include "ns3/test.h"
+
+#include <sstream>
+#include <unistd.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup mpi
+ * \defgroup mpi-tests MPI module tests
+ */
+
+/**
+ * \ingroup mpi-tests
+ *
+ * Run a distributed example on several MPI ranks, and compare the lines
+ * it prints for the tests, sorted, with a reference file.
+ */
+class MpiTestCase : public ExampleAsTestCase
+{
+public:
+  /**
+   * \copydoc ns3::ExampleAsTestCase::ExampleAsTestCase
+   *
+   * \param [in] ranks The number of MPI ranks.
+   */
+  MpiTestCase (const std::string name,
+               const std::string program,
+               const std::string dataDir,
+               const uint32_t ranks,
+               const std::string args = "");
+
+  virtual std::string GetCommandTemplate (void) const;
+  virtual std::string GetPostProcessingCommand (void) const;
+
+private:
+  uint32_t m_ranks; //!< The number of MPI ranks.
+};
+
+MpiTestCase::MpiTestCase (const std::string name,
+                          const std::string program,
+                          const std::string dataDir,
+                          const uint32_t ranks,
+                          const std::string args)
+  : ExampleAsTestCase (name, program, dataDir, args),
+    m_ranks (ranks)
+{
+}
+
+std::string
+MpiTestCase::GetCommandTemplate (void) const
+{
+  std::stringstream ss;
+  ss << "mpiexec";
+#ifdef NS3_OPENMPI
+  // The tests may run as root, e.g. in a container, and on fewer cores
+  // than ranks
+  ss << " --oversubscribe";
+  if (geteuid () == 0)
+    {
+      ss << " --allow-run-as-root";
+    }
+#endif
+  ss << " -n " << m_ranks << " %s --testing " << m_args;
+  return ss.str ();
+}
+
+std::string
+MpiTestCase::GetPostProcessingCommand (void) const
+{
+  // The lines of the ranks are interleaved in any order
+  return "| grep TEST | sort";
+}
+
+/**
+ * \ingroup mpi-tests
+ *
+ * A distributed example run as a test suite.
+ */
+class MpiTestSuite : public TestSuite
+{
+public:
+  /**
+   * \copydoc MpiTestCase::MpiTestCase
+   */
+  MpiTestSuite (const std::string name,
+                const std::string program,
+                const std::string dataDir,
+                const uint32_t ranks,
+                const std::string args = "")
+    : TestSuite (name, EXAMPLE)
+  {
+    AddTestCase (new MpiTestCase (name, program, dataDir, ranks, args), QUICK);
+  }
+};
+
+/* The synchronizations, with and without a stop time: without it, each
+ * run must end once no rank has events left.  The periodic Null Messages
+ * need a stop time. */
+static MpiTestSuite g_mpiSimpleDistributed ("mpi-example-simple-distributed",
+                                            "simple-distributed", NS_TEST_SOURCEDIR, 2);
+static MpiTestSuite g_mpiSimpleDistributedNoStop ("mpi-example-simple-distributed-nostop",
+                                                  "simple-distributed", NS_TEST_SOURCEDIR, 2,
+                                                  "--stop=false");
+static MpiTestSuite g_mpiSimpleDistributedNullmsg ("mpi-example-simple-distributed-nullmsg",
+                                                   "simple-distributed", NS_TEST_SOURCEDIR, 2,
+                                                   "--nullmsg");
+static MpiTestSuite g_mpiSimpleDistributedNullmsgNoStop ("mpi-example-simple-distributed-nullmsg-nostop",
+                                                         "simple-distributed", NS_TEST_SOURCEDIR, 2,
+                                                         "--nullmsg --stop=false");
+static MpiTestSuite g_mpiSimpleDistributedPeriodic ("mpi-example-simple-distributed-periodic",
+                                                    "simple-distributed", NS_TEST_SOURCEDIR, 2,
+                                                    "--nullmsg --ns3::NullMessageSimulatorImpl::DemandDriven=false");
+static MpiTestSuite g_mpiSimpleDistributedEotNoStop ("mpi-example-simple-distributed-eot-nostop",
+                                                     "simple-distributed", NS_TEST_SOURCEDIR, 2,
+                                                     "--nullmsg --stop=false "
+                                                     "--ns3::NullMessageSimulatorImpl::EarliestOutputTime=true");
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "pool-allocator.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
@@ -169,7 +170,7 @@ Buffer::Allocate (uint32_t reqSize)
     }
   NS_ASSERT (reqSize >= 1);
   uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
-  uint8_t *b = new uint8_t [size];
+  uint8_t *b = static_cast<uint8_t *> (PoolAllocator::Allocate (size));
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
@@ -181,8 +182,8 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  uint8_t *buf = reinterpret_cast<uint8_t *> (data);
-  delete [] buf;
+  uint32_t size = data->m_size - 1 + sizeof (struct Buffer::Data);
+  PoolAllocator::Deallocate (data, size);
 }
 
 Buffer::Buffer ()
@@ -27,8 +27,6 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NixVector");
 
-typedef std::vector<uint32_t> NixBits_t;  //!< typedef for the nixVector
-
 NixVector::NixVector ()
   : m_nixVector (0),
     m_used (0),
@@ -320,7 +318,7 @@ NixVector::DumpNixVector (std::ostream &os) const
 {
   NS_LOG_FUNCTION (this << &os);
   uint32_t i = m_nixVector.size ();
-  std::vector<uint32_t>::const_reverse_iterator rIter;
+  NixBits_t::const_reverse_iterator rIter;
   for (rIter = m_nixVector.rbegin (); rIter != m_nixVector.rend (); rIter++)
     {
       uint32_t numBits = BitCount (*rIter);
@@ -24,6 +24,7 @@
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include "ns3/buffer.h"
+#include "pool-allocator.h"
 
 namespace ns3 {
 
@@ -60,7 +61,7 @@ namespace ns3 {
  * routed.
  */
 
-class NixVector : public SimpleRefCount<NixVector>
+class NixVector : public SimpleRefCount<NixVector, PoolAllocated>
 {
 public:
   NixVector ();
@@ -153,7 +154,7 @@ public:
 
 private:
   /// Typedef: the NixVector bits storage.
-  typedef std::vector<uint32_t> NixBits_t;
+  typedef std::vector<uint32_t, PoolStlAllocator<uint32_t> > NixBits_t;
 
   /**
    * \brief Print the NixVector.
@@ -26,6 +26,7 @@
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
+#include "pool-allocator.h"
 
 namespace ns3 {
 
@@ -624,7 +625,7 @@ PacketMetadata::Allocate (uint32_t n)
       n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
   size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
-  uint8_t *buf = new uint8_t [size];
+  uint8_t *buf = static_cast<uint8_t *> (PoolAllocator::Allocate (size));
   struct PacketMetadata::Data *data = (struct PacketMetadata::Data *)buf;
   data->m_size = n;
   data->m_count = 1;
@@ -635,8 +636,8 @@ void
 PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  uint8_t *buf = (uint8_t *)data;
-  delete [] buf;
+  uint32_t size = sizeof (struct Data) + data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE;
+  PoolAllocator::Deallocate (data, size);
 }
 
 
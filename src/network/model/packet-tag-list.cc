@@ -26,14 +26,104 @@
 #include "packet-tag-list.h"
 #include "tag-buffer.h"
 #include "tag.h"
+#include "pool-allocator.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include <atomic>
 #include <cstring>
+#include <mutex>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
+namespace {
+
+/** The value of g_tagSlots of a tag type not added yet. */
+const uint8_t SLOT_UNKNOWN = 0;
+/** The value of g_tagSlots of a tag type without inline slot. */
+const uint8_t SLOT_NONE = 0xff;
+/**
+ * The names of the tag types stored in the inline slots, by slot: the
+ * tags added to most packets by the sockets, by the wifi MAC and by the
+ * LTE MAC.  The slots do not depend on the order in which the tag types
+ * are first used; the types are matched by name as they are defined in
+ * other modules.
+ */
+const char *const g_slotNames[PacketTagList::INLINE_SLOTS] = {
+  "ns3::SocketPriorityTag",
+  "ns3::FlowIdTag",
+  "ns3::SnrTag",
+  "ns3::LteRadioBearerTag"
+};
+/**
+ * The inline slot of each tag type, by TypeId uid: the slot plus one,
+ * SLOT_UNKNOWN or SLOT_NONE.
+ */
+std::atomic<uint8_t> g_tagSlots[65536];
+/** The tag type of each inline slot. */
+TypeId g_slotTids[PacketTagList::INLINE_SLOTS];
+/** Protects the interning of the tag types. */
+std::mutex g_tagSlotsMutex;
+
+/**
+ * Serialize a tag for PacketTagList::Serialize.
+ *
+ * \param [in,out] p The position in the buffer.
+ * \param [in,out] size The size of the buffer used.
+ * \param [in] maxSize The size of the buffer.
+ * \param [in] tid The tag type.
+ * \param [in] data The serialized tag.
+ * \param [in] dataSize The size of the serialized tag.
+ * \returns \c false if the buffer is too small.
+ */
+bool
+SerializeTag (uint32_t *&p, uint32_t &size, uint32_t maxSize,
+              TypeId tid, const uint8_t *data, uint32_t dataSize)
+{
+  if (size + 4 <= maxSize)
+    {
+      *p++ = dataSize;
+      size += 4;
+    }
+  else
+    {
+      return false;
+    }
+
+  NS_LOG_INFO("Serializing tag id " << tid);
+
+  // ensure size is multiple of 4 bytes for 4 byte boundaries
+  uint32_t hashSize = (sizeof (TypeId::hash_t)+3) & (~3);
+  if (size + hashSize <= maxSize)
+    {
+      TypeId::hash_t hash = tid.GetHash ();
+      memcpy (p, &hash, sizeof (TypeId::hash_t));
+      p += hashSize / 4;
+      size += hashSize;
+    }
+  else
+    {
+      return false;
+    }
+
+  // ensure size is multiple of 4 bytes for 4 byte boundaries
+  uint32_t tagWordSize = (dataSize+3) & (~3);
+  if (size + tagWordSize <= maxSize)
+    {
+      memcpy (p, data, dataSize);
+      size += tagWordSize;
+      p += tagWordSize / 4;
+    }
+  else
+    {
+      return false;
+    }
+  return true;
+}
+
+} // unnamed namespace
+
 PacketTagList::TagData *
 PacketTagList::CreateTagData (size_t dataSize)
 {
@@ -43,14 +133,67 @@ PacketTagList::CreateTagData (size_t dataSize)
                  << " exceeds maximum "
                  << std::numeric_limits<decltype(TagData::size)>::max () );
 
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
+  // The matching deallocation is in FreeTagData
+  void * p = PoolAllocator::Allocate (sizeof (TagData) + dataSize - 1);
 
   TagData * tag = new (p) TagData;
   tag->size = dataSize;
   return tag;
 }
 
+void
+PacketTagList::FreeTagData (TagData *tag)
+{
+  std::size_t size = sizeof (TagData) + tag->size - 1;
+  tag->~TagData ();
+  PoolAllocator::Deallocate (tag, size);
+}
+
+int32_t
+PacketTagList::LookupSlot (TypeId tid)
+{
+  uint8_t slot = g_tagSlots[tid.GetUid ()].load (std::memory_order_acquire);
+  return (slot != SLOT_UNKNOWN && slot != SLOT_NONE) ? slot - 1 : -1;
+}
+
+int32_t
+PacketTagList::InternSlot (TypeId tid, uint32_t size)
+{
+  uint8_t slot = g_tagSlots[tid.GetUid ()].load (std::memory_order_acquire);
+  if (slot == SLOT_UNKNOWN)
+    {
+      std::lock_guard<std::mutex> lock (g_tagSlotsMutex);
+      slot = g_tagSlots[tid.GetUid ()].load (std::memory_order_relaxed);
+      if (slot == SLOT_UNKNOWN)
+        {
+          slot = SLOT_NONE;
+          for (uint32_t i = 0; i < INLINE_SLOTS; ++i)
+            {
+              if (tid.GetName () == g_slotNames[i])
+                {
+                  NS_LOG_LOGIC ("interning " << tid << " in slot " << i);
+                  g_slotTids[i] = tid;
+                  slot = i + 1;
+                  break;
+                }
+            }
+          g_tagSlots[tid.GetUid ()].store (slot, std::memory_order_release);
+        }
+    }
+  if (slot == SLOT_NONE || size > INLINE_TAG_SIZE)
+    {
+      return -1;
+    }
+  return slot - 1;
+}
+
+TypeId
+PacketTagList::GetInlineTagTypeId (uint32_t slot)
+{
+  NS_ASSERT (slot < INLINE_SLOTS);
+  return g_slotTids[slot];
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -175,6 +318,13 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 bool
 PacketTagList::Remove (Tag & tag)
 {
+  int32_t slot = LookupSlot (tag.GetInstanceTypeId ());
+  if (slot >= 0 && HasInlineTag (slot))
+    {
+      tag.Deserialize (TagBuffer (m_inlineData[slot], m_inlineData[slot] + m_inlineSize[slot]));
+      m_inlineMask &= ~(1 << slot);
+      return true;
+    }
   return COWTraverse (tag, &PacketTagList::RemoveWriter);
 }
 
@@ -194,8 +344,7 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   if (preMerge)
     {
       // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
+      FreeTagData (cur);
     }
   else
     {
@@ -214,6 +363,23 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
 bool
 PacketTagList::Replace (Tag & tag)
 {
+  int32_t slot = LookupSlot (tag.GetInstanceTypeId ());
+  if (slot >= 0 && HasInlineTag (slot))
+    {
+      uint32_t size = tag.GetSerializedSize ();
+      if (size <= INLINE_TAG_SIZE)
+        {
+          tag.Serialize (TagBuffer (m_inlineData[slot], m_inlineData[slot] + size));
+          m_inlineSize[slot] = size;
+        }
+      else
+        {
+          // the new value does not fit in the slot
+          m_inlineMask &= ~(1 << slot);
+          Add (tag);
+        }
+      return true;
+    }
   bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
   if (!found)
     {
@@ -259,14 +425,27 @@ PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
 void
 PacketTagList::Add (const Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
   // ensure this id was not yet added
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
+      NS_ASSERT_MSG (cur->tid != tid,
                      "Error: cannot add the same kind of tag twice.");
     }
-  struct TagData * head = CreateTagData (tag.GetSerializedSize ());
+  uint32_t size = tag.GetSerializedSize ();
+  int32_t slot = InternSlot (tid, size);
+  NS_ASSERT_MSG (LookupSlot (tid) < 0 || !HasInlineTag (LookupSlot (tid)),
+                 "Error: cannot add the same kind of tag twice.");
+  if (slot >= 0)
+    {
+      PacketTagList *self = const_cast<PacketTagList *> (this);
+      tag.Serialize (TagBuffer (self->m_inlineData[slot], self->m_inlineData[slot] + size));
+      self->m_inlineSize[slot] = size;
+      self->m_inlineMask |= (1 << slot);
+      return;
+    }
+  struct TagData * head = CreateTagData (size);
   head->count = 1;
   head->next = 0;
   head->tid = tag.GetInstanceTypeId ();
@@ -281,6 +460,13 @@ PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
+  int32_t slot = LookupSlot (tid);
+  if (slot >= 0 && HasInlineTag (slot))
+    {
+      tag.Deserialize (TagBuffer (const_cast<uint8_t *> (m_inlineData[slot]),
+                                  const_cast<uint8_t *> (m_inlineData[slot]) + m_inlineSize[slot]));
+      return true;
+    }
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
       if (cur->tid == tid)
@@ -309,6 +495,15 @@ PacketTagList::GetSerializedSize (void) const
 
   size = 4; // numberOfTags
 
+  uint32_t hashSize = (sizeof (TypeId::hash_t)+3) & (~3);
+  for (uint32_t slot = 0; slot < INLINE_SLOTS; ++slot)
+    {
+      if (HasInlineTag (slot))
+        {
+          size += 4 + hashSize + ((m_inlineSize[slot]+3) & (~3));
+        }
+    }
+
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
       size += 4; // TagData -> size
@@ -346,47 +541,25 @@ PacketTagList::Serialize (uint32_t* buffer, uint32_t maxSize) const
       return 0;
     }
 
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  for (uint32_t slot = 0; slot < INLINE_SLOTS; ++slot)
     {
-      if (size + 4 <= maxSize)
+      if (HasInlineTag (slot))
         {
-          *p++ = cur->size;
-          size += 4;
-        }
-      else
-        {
-          return 0;
-        }
-
-      NS_LOG_INFO("Serializing tag id " << cur->tid);
-
-      // ensure size is multiple of 4 bytes for 4 byte boundaries
-      uint32_t hashSize = (sizeof (TypeId::hash_t)+3) & (~3);
-      if (size + hashSize <= maxSize)
-        {
-          TypeId::hash_t tid = cur->tid.GetHash ();
-          memcpy (p, &tid, sizeof (TypeId::hash_t));
-          p += hashSize / 4;
-          size += hashSize;
-        }
-      else
-        {
-          return 0;
+          if (!SerializeTag (p, size, maxSize, GetInlineTagTypeId (slot),
+                             m_inlineData[slot], m_inlineSize[slot]))
+            {
+              return 0;
+            }
+          (*numberOfTags)++;
         }
+    }
 
-      // ensure size is multiple of 4 bytes for 4 byte boundaries
-      uint32_t tagWordSize = (cur->size+3) & (~3);
-      if (size + tagWordSize <= maxSize)
-        {
-          memcpy (p, cur->data, cur->size);
-          size += tagWordSize;
-          p += tagWordSize / 4;
-        }
-      else
+  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+    {
+      if (!SerializeTag (p, size, maxSize, cur->tid, cur->data, cur->size))
         {
           return 0;
         }
-
       (*numberOfTags)++;
     }
 
@@ -425,30 +598,38 @@ PacketTagList::Deserialize (const uint32_t* buffer, uint32_t size)
 
       NS_LOG_INFO ("Deserializing tag of type " << tid);
 
-      struct TagData * newTag = CreateTagData (tagSize);
-      newTag->count = 1;
-      newTag->next = 0;
-      newTag->tid = tid;
-
       NS_ASSERT (sizeCheck >= tagSize);
-      memcpy (newTag->data, p, tagSize);
-
-      // ensure 4 byte boundary
-      uint32_t tagWordSize = (tagSize+3) & (~3);
-      p += tagWordSize / 4;
-      sizeCheck -= tagWordSize;
-
-      // Set link list pointers.
-      if (i==0)
+      int32_t slot = InternSlot (tid, tagSize);
+      if (slot >= 0)
         {
-          m_next = newTag;
+          memcpy (m_inlineData[slot], p, tagSize);
+          m_inlineSize[slot] = tagSize;
+          m_inlineMask |= (1 << slot);
         }
       else
         {
-          prevTag->next = newTag;
+          struct TagData * newTag = CreateTagData (tagSize);
+          newTag->count = 1;
+          newTag->next = 0;
+          newTag->tid = tid;
+          memcpy (newTag->data, p, tagSize);
+
+          // Set link list pointers.
+          if (prevTag == 0)
+            {
+              m_next = newTag;
+            }
+          else
+            {
+              prevTag->next = newTag;
+            }
+          prevTag = newTag;
         }
 
-      prevTag = newTag;
+      // ensure 4 byte boundary
+      uint32_t tagWordSize = (tagSize+3) & (~3);
+      p += tagWordSize / 4;
+      sizeCheck -= tagWordSize;
     }
 
   NS_ASSERT (sizeCheck == 0);
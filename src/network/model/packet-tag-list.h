@@ -26,6 +26,7 @@
 */
 
 #include <stdint.h>
+#include <cstring>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -119,6 +120,19 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Inline tags </b>
+ *
+ *   - A fixed set of #INLINE_SLOTS common tag types, SocketPriorityTag,
+ *     FlowIdTag, SnrTag and LteRadioBearerTag, are interned when first
+ *     added: each is given its slot, by TypeId uid, in every PacketTagList.
+ *     The tags of these types, with a serialized size of at most
+ *     #INLINE_TAG_SIZE bytes, are stored in their slot, inside the
+ *     PacketTagList, instead of the tree; they are found in constant time,
+ *     and copied with the PacketTagList without any allocation.
+ *
+ *   - The TagData of the other tags are allocated from per-thread free
+ *     lists of a few size classes.
  */
 class PacketTagList 
 {
@@ -214,9 +228,30 @@ public:
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * \returns pointer to head of tag list, without the inline tags
    */
   const struct PacketTagList::TagData *Head (void) const;
+
+  /** The number of inline tag slots. */
+  static const uint32_t INLINE_SLOTS = 4;
+  /** The maximum serialized size of an inline tag. */
+  static const uint32_t INLINE_TAG_SIZE = 16;
+  /**
+   * \param [in] slot The inline tag slot.
+   * \returns \c true if this list has a tag in the slot.
+   */
+  inline bool HasInlineTag (uint32_t slot) const;
+  /**
+   * \param [in] slot The inline tag slot.
+   * \returns The type of the tags of the slot.
+   */
+  static TypeId GetInlineTagTypeId (uint32_t slot);
+  /**
+   * \param [in] slot The inline tag slot, which holds a tag.
+   * \param [out] size The serialized size of the tag.
+   * \returns The serialized tag.
+   */
+  inline const uint8_t * GetInlineTagData (uint32_t slot, uint32_t *size) const;
   /**
    * Returns number of bytes required for packet serialization.
    *
@@ -252,6 +287,29 @@ private:
    */
   static
   TagData * CreateTagData (size_t dataSize);
+  /**
+   * Destroy and free a TagData struct allocated by CreateTagData.
+   *
+   * \param [in] tag The TagData.
+   */
+  static
+  void FreeTagData (TagData *tag);
+  /**
+   * Get the inline slot of a tag type, interning the type when it is
+   * first added, if the size of the tag fits in a slot.
+   *
+   * \param [in] tid The tag type.
+   * \param [in] size The serialized size of the tag.
+   * \returns The slot, or -1 if the tag is stored in the tree.
+   */
+  static
+  int32_t InternSlot (TypeId tid, uint32_t size);
+  /**
+   * \param [in] tid The tag type.
+   * \returns The inline slot of the tag type, or -1 if it has none.
+   */
+  static
+  int32_t LookupSlot (TypeId tid);
   
   /**
    * Typedef of method function pointer for copy-on-write operations
@@ -306,6 +364,18 @@ private:
    * Pointer to first \ref TagData on the list
    */
   struct TagData *m_next;
+  /** The bit mask of the inline slots holding a tag. */
+  uint8_t m_inlineMask;
+  /** The serialized size of the tag of each inline slot. */
+  uint8_t m_inlineSize[INLINE_SLOTS];
+  /** The serialized tag of each inline slot. */
+  uint8_t m_inlineData[INLINE_SLOTS][INLINE_TAG_SIZE];
+  /**
+   * Copy the inline tags of another list.
+   *
+   * \param [in] o The other list.
+   */
+  inline void CopyInline (PacketTagList const &o);
 };
 
 } // namespace ns3
@@ -317,7 +387,8 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_next (),
+    m_inlineMask (0)
 {
 }
 
@@ -328,22 +399,54 @@ PacketTagList::PacketTagList (PacketTagList const &o)
     {
       m_next->count++;
     }
+  CopyInline (o);
+}
+
+void
+PacketTagList::CopyInline (PacketTagList const &o)
+{
+  m_inlineMask = o.m_inlineMask;
+  for (uint32_t mask = m_inlineMask, slot = 0; mask != 0; mask >>= 1, ++slot)
+    {
+      if (mask & 1)
+        {
+          m_inlineSize[slot] = o.m_inlineSize[slot];
+          std::memcpy (m_inlineData[slot], o.m_inlineData[slot], INLINE_TAG_SIZE);
+        }
+    }
+}
+
+bool
+PacketTagList::HasInlineTag (uint32_t slot) const
+{
+  return (m_inlineMask >> slot) & 1;
+}
+
+const uint8_t *
+PacketTagList::GetInlineTagData (uint32_t slot, uint32_t *size) const
+{
+  *size = m_inlineSize[slot];
+  return m_inlineData[slot];
 }
 
 PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o)
     {
       return *this;
     }
-  RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  if (m_next != o.m_next)
     {
-      m_next->count++;
+      RemoveAll ();
+      m_next = o.m_next;
+      if (m_next != 0)
+        {
+          m_next->count++;
+        }
     }
+  CopyInline (o);
   return *this;
 }
 
@@ -365,17 +468,16 @@ PacketTagList::RemoveAll (void)
         }
       if (prev != 0) 
         {
-          prev->~TagData ();
-          std::free (prev);
+          FreeTagData (prev);
         }
       prev = cur;
     }
   if (prev != 0) 
     {
-      prev->~TagData ();
-      std::free (prev);
+      FreeTagData (prev);
     }
   m_next = 0;
+  m_inlineMask = 0;
 }
 
 } // namespace ns3
@@ -81,39 +81,61 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const PacketTagList *list)
+  : m_list (list),
+    m_slot (0),
+    m_current (list->Head ())
 {
+  SkipEmptySlots ();
+}
+void
+PacketTagIterator::SkipEmptySlots (void)
+{
+  while (m_slot < PacketTagList::INLINE_SLOTS && !m_list->HasInlineTag (m_slot))
+    {
+      m_slot++;
+    }
 }
 bool
 PacketTagIterator::HasNext (void) const
 {
-  return m_current != 0;
+  return m_slot < PacketTagList::INLINE_SLOTS || m_current != 0;
 }
 PacketTagIterator::Item
 PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
+  if (m_slot < PacketTagList::INLINE_SLOTS)
+    {
+      uint32_t size;
+      const uint8_t *data = m_list->GetInlineTagData (m_slot, &size);
+      PacketTagIterator::Item item (PacketTagList::GetInlineTagTypeId (m_slot), data, size);
+      m_slot++;
+      SkipEmptySlots ();
+      return item;
+    }
   const struct PacketTagList::TagData *prev = m_current;
   m_current = m_current->next;
-  return PacketTagIterator::Item (prev);
+  return PacketTagIterator::Item (prev->tid, prev->data, prev->size);
 }
 
-PacketTagIterator::Item::Item (const struct PacketTagList::TagData *data)
-  : m_data (data)
+PacketTagIterator::Item::Item (TypeId tid, const uint8_t *data, uint32_t size)
+  : m_tid (tid),
+    m_data (data),
+    m_size (size)
 {
 }
 TypeId
 PacketTagIterator::Item::GetTypeId (void) const
 {
-  return m_data->tid;
+  return m_tid;
 }
 void
 PacketTagIterator::Item::GetTag (Tag &tag) const
 {
-  NS_ASSERT (tag.GetInstanceTypeId () == m_data->tid);
-  tag.Deserialize (TagBuffer ((uint8_t*)m_data->data,
-                              (uint8_t*)m_data->data + m_data->size));
+  NS_ASSERT (tag.GetInstanceTypeId () == m_tid);
+  tag.Deserialize (TagBuffer ((uint8_t*)m_data,
+                              (uint8_t*)m_data + m_size));
 }
 
 
@@ -1013,7 +1035,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (&m_packetTagList);
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
@@ -29,6 +29,7 @@
 #include "byte-tag-list.h"
 #include "packet-tag-list.h"
 #include "nix-vector.h"
+#include "pool-allocator.h"
 #include "ns3/mac48-address.h"
 #include "ns3/callback.h"
 #include "ns3/assert.h"
@@ -155,10 +156,14 @@ private:
     friend class PacketTagIterator;
     /**
      * Constructor
-     * \param data the data to copy.
+     * \param tid the type of the tag.
+     * \param data the serialized tag.
+     * \param size the size of the serialized tag.
      */
-    Item (const struct PacketTagList::TagData *data);
-    const struct PacketTagList::TagData *m_data; //!< the tag data
+    Item (TypeId tid, const uint8_t *data, uint32_t size);
+    TypeId m_tid;             //!< the type of the tag
+    const uint8_t *m_data;    //!< the serialized tag
+    uint32_t m_size;          //!< the size of the serialized tag
   };
   /**
    * \returns true if calling Next is safe, false otherwise.
@@ -173,10 +178,14 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
-   */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
-  const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
+   * \param list the packet tags
+   */
+  PacketTagIterator (const PacketTagList *list);
+  /** Move #m_slot to the next inline slot which holds a tag, if any. */
+  void SkipEmptySlots (void);
+  const PacketTagList *m_list;  //!< the packet tags
+  uint32_t m_slot;              //!< actual position over the inline tags
+  const struct PacketTagList::TagData *m_current;  //!< actual position over the other tags
 };
 
 /**
@@ -228,7 +237,7 @@ private:
  * The performance aspects copy-on-write semantics of the
  * Packet API are discussed in \ref packetperf
  */
-class Packet : public SimpleRefCount<Packet>
+class Packet : public SimpleRefCount<Packet, PoolAllocated>
 {
 public:
 
@@ -0,0 +1,290 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pool-allocator.h"
+#include "ns3/log.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+
+/**
+ * \file
+ * \ingroup packet
+ * ns3::PoolAllocator implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PoolAllocator");
+
+namespace {
+
+/** A released block, linked in a free list. */
+struct Block
+{
+  Block *next; //!< The next block of the free list
+};
+
+/** The maximum number of blocks in a shared free list. */
+const uint32_t SHARED_LIST_SIZE = 16 * PoolAllocator::THREAD_CACHE_SIZE;
+
+/** Whether the released blocks are reused. */
+std::atomic<bool> g_enabled (true);
+
+/**
+ * The free lists shared by all the threads.
+ *
+ * Its members are zero-initialized before any dynamic initialization,
+ * so that the lists can be used by the constructors of the static
+ * objects of other files.
+ */
+struct SharedLists
+{
+  std::mutex mutex;                                //!< Protects the lists
+  Block *heads[PoolAllocator::N_SIZE_CLASSES];     //!< The free lists
+  uint32_t counts[PoolAllocator::N_SIZE_CLASSES];  //!< The sizes of the free lists
+  bool destroyed;                                  //!< Whether the program is exiting
+  /** Release all the blocks. */
+  ~SharedLists ()
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    for (std::size_t i = 0; i < PoolAllocator::N_SIZE_CLASSES; ++i)
+      {
+        while (heads[i] != 0)
+          {
+            Block *block = heads[i];
+            heads[i] = block->next;
+            ::operator delete (block);
+          }
+        counts[i] = 0;
+      }
+    destroyed = true;
+  }
+};
+
+/** The shared free lists. */
+SharedLists g_shared;
+
+/**
+ * Move blocks to the shared free list of a size class, or release them
+ * if it is full.
+ *
+ * \param [in] sizeClass The size class.
+ * \param [in] first The first block of the list to move.
+ * \param [in] n The number of blocks of the list.
+ */
+void
+Spill (std::size_t sizeClass, Block *first, uint32_t n)
+{
+  std::unique_lock<std::mutex> lock (g_shared.mutex);
+  if (g_shared.destroyed || g_shared.counts[sizeClass] >= SHARED_LIST_SIZE)
+    {
+      lock.unlock ();
+      while (first != 0)
+        {
+          Block *block = first;
+          first = block->next;
+          ::operator delete (block);
+        }
+      return;
+    }
+  Block *last = first;
+  while (last->next != 0)
+    {
+      last = last->next;
+    }
+  last->next = g_shared.heads[sizeClass];
+  g_shared.heads[sizeClass] = first;
+  g_shared.counts[sizeClass] += n;
+}
+
+/** Whether the free lists of the thread have been destroyed. */
+thread_local bool t_cacheDestroyed = false;
+
+/** The free lists and the counters of a thread. */
+struct ThreadCache
+{
+  Block *heads[PoolAllocator::N_SIZE_CLASSES];     //!< The free lists
+  uint32_t counts[PoolAllocator::N_SIZE_CLASSES];  //!< The sizes of the free lists
+  PoolAllocator::Stats stats;                      //!< The counters
+  ThreadCache ()
+    : heads (),
+      counts (),
+      stats ()
+  {}
+  /** Move the blocks to the shared lists. */
+  ~ThreadCache ()
+  {
+    for (std::size_t i = 0; i < PoolAllocator::N_SIZE_CLASSES; ++i)
+      {
+        if (heads[i] != 0)
+          {
+            Spill (i, heads[i], counts[i]);
+            heads[i] = 0;
+            counts[i] = 0;
+          }
+      }
+    t_cacheDestroyed = true;
+  }
+  /**
+   * Take a batch of blocks from the shared free list of a size class.
+   * \param [in] sizeClass The size class, whose list is empty.
+   */
+  void Refill (std::size_t sizeClass)
+  {
+    std::lock_guard<std::mutex> lock (g_shared.mutex);
+    Block *first = g_shared.heads[sizeClass];
+    if (first == 0)
+      {
+        return;
+      }
+    Block *last = first;
+    uint32_t n = 1;
+    while (n < PoolAllocator::REFILL_SIZE && last->next != 0)
+      {
+        last = last->next;
+        ++n;
+      }
+    g_shared.heads[sizeClass] = last->next;
+    g_shared.counts[sizeClass] -= n;
+    last->next = 0;
+    heads[sizeClass] = first;
+    counts[sizeClass] = n;
+    ++stats.sharedRefills;
+  }
+};
+
+/** The free lists of the thread. */
+thread_local ThreadCache t_cache;
+
+/**
+ * \param [in] size A block size, at most PoolAllocator::MAX_SIZE.
+ * \returns The size class of the size.
+ */
+inline std::size_t
+GetSizeClass (std::size_t size)
+{
+  return size == 0 ? 0 : (size - 1) / PoolAllocator::GRANULARITY;
+}
+
+} // unnamed namespace
+
+void *
+PoolAllocator::Allocate (std::size_t size)
+{
+  if (size > MAX_SIZE)
+    {
+      return ::operator new (size);
+    }
+  if (t_cacheDestroyed)
+    {
+      // another thread may release the block to its lists
+      return ::operator new ((GetSizeClass (size) + 1) * GRANULARITY);
+    }
+  ThreadCache &cache = t_cache;
+  ++cache.stats.allocations;
+  std::size_t sizeClass = GetSizeClass (size);
+  if (g_enabled.load (std::memory_order_relaxed))
+    {
+      if (cache.heads[sizeClass] == 0)
+        {
+          cache.Refill (sizeClass);
+        }
+      Block *block = cache.heads[sizeClass];
+      if (block != 0)
+        {
+          cache.heads[sizeClass] = block->next;
+          --cache.counts[sizeClass];
+          return block;
+        }
+    }
+  ++cache.stats.systemAllocations;
+  // all the blocks of a size class have its full size, so that they
+  // can be reused whether or not they were allocated from the lists
+  return ::operator new ((sizeClass + 1) * GRANULARITY);
+}
+
+void
+PoolAllocator::Deallocate (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  if (size > MAX_SIZE || t_cacheDestroyed)
+    {
+      ::operator delete (p);
+      return;
+    }
+  ThreadCache &cache = t_cache;
+  ++cache.stats.deallocations;
+  if (!g_enabled.load (std::memory_order_relaxed))
+    {
+      ::operator delete (p);
+      return;
+    }
+  std::size_t sizeClass = GetSizeClass (size);
+  Block *block = static_cast<Block *> (p);
+  block->next = cache.heads[sizeClass];
+  cache.heads[sizeClass] = block;
+  if (++cache.counts[sizeClass] > THREAD_CACHE_SIZE)
+    {
+      // keep the most recently released half, which is likely in the cache
+      uint32_t keep = THREAD_CACHE_SIZE / 2;
+      Block *last = block;
+      for (uint32_t i = 1; i < keep; ++i)
+        {
+          last = last->next;
+        }
+      Spill (sizeClass, last->next, cache.counts[sizeClass] - keep);
+      last->next = 0;
+      cache.counts[sizeClass] = keep;
+    }
+}
+
+void
+PoolAllocator::SetEnabled (bool enabled)
+{
+  NS_LOG_FUNCTION (enabled);
+  g_enabled.store (enabled, std::memory_order_relaxed);
+}
+
+bool
+PoolAllocator::IsEnabled (void)
+{
+  return g_enabled.load (std::memory_order_relaxed);
+}
+
+PoolAllocator::Stats
+PoolAllocator::GetThreadStats (void)
+{
+  if (t_cacheDestroyed)
+    {
+      return Stats ();
+    }
+  return t_cache.stats;
+}
+
+void
+PoolAllocator::ResetThreadStats (void)
+{
+  if (!t_cacheDestroyed)
+    {
+      t_cache.stats = Stats ();
+    }
+}
+
+} // namespace ns3
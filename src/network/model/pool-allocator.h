@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup packet
+ * ns3::PoolAllocator and ns3::PoolAllocated declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ * \brief A size-classed allocator of the small objects which are created
+ * and destroyed for each packet.
+ *
+ * The requested sizes are rounded up to a multiple of GRANULARITY,
+ * which selects one of the size classes.  Each thread keeps a free list
+ * of released blocks per size class, which serves its allocations
+ * without locking.  When the free list of a thread grows beyond
+ * THREAD_CACHE_SIZE blocks, half of them are moved to a free list shared
+ * by all the threads, from which the threads refill their empty lists
+ * in batches; the blocks of the threads which exit go to the shared
+ * lists too.  Thus the blocks allocated by a thread can be released by
+ * another one, as happens with the packets exchanged by the threads of
+ * the parallel simulator implementations.
+ *
+ * The sizes larger than MAX_SIZE are allocated with the global
+ * operator new.
+ *
+ * The types opt in by deriving from PoolAllocated, the others can call
+ * Allocate and Deallocate directly.
+ */
+class PoolAllocator
+{
+public:
+  /** The size granularity of the size classes. */
+  static const std::size_t GRANULARITY = 16;
+  /** The largest size allocated from the size classes. */
+  static const std::size_t MAX_SIZE = 512;
+  /** The number of size classes. */
+  static const std::size_t N_SIZE_CLASSES = MAX_SIZE / GRANULARITY;
+  /** The maximum number of blocks in the free list of a thread, by size class. */
+  static const uint32_t THREAD_CACHE_SIZE = 512;
+  /** The number of blocks moved at once from the shared free lists to a thread. */
+  static const uint32_t REFILL_SIZE = 64;
+
+  /** The allocation counters of a thread. */
+  struct Stats
+  {
+    uint64_t allocations;       //!< The number of calls to Allocate
+    uint64_t deallocations;     //!< The number of calls to Deallocate
+    uint64_t systemAllocations; //!< The number of blocks allocated with operator new
+    uint64_t sharedRefills;     //!< The number of batches taken from the shared free lists
+  };
+
+  /**
+   * Allocate a block.
+   *
+   * \param [in] size The size of the block.
+   * \returns The block, aligned as by operator new.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release a block returned by Allocate.
+   *
+   * \param [in] p The block, or 0.
+   * \param [in] size The size with which the block was allocated.
+   */
+  static void Deallocate (void *p, std::size_t size);
+
+  /**
+   * Enable or disable the reuse of the blocks.
+   *
+   * When disabled, every Allocate and Deallocate calls the global
+   * operator new and delete; the blocks can be released whether or
+   * not the reuse was enabled when they were allocated.  The reuse is
+   * enabled by default.
+   *
+   * \param [in] enabled Whether to reuse the released blocks.
+   */
+  static void SetEnabled (bool enabled);
+  /**
+   * \returns \c true if the released blocks are reused.
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * \returns The allocation counters of the calling thread.
+   */
+  static Stats GetThreadStats (void);
+  /**
+   * Reset the allocation counters of the calling thread.
+   */
+  static void ResetThreadStats (void);
+};
+
+/**
+ * \ingroup packet
+ * \brief A base class whose derived classes are allocated by PoolAllocator.
+ *
+ * The operator delete receives the size of the dynamic type of the
+ * deleted object, so a class hierarchy can opt in with its root, provided
+ * that its destructor is virtual.  The class has no data member, so it
+ * adds nothing to the size of the classes which derive from it,
+ * including through the PARENT template parameter of SimpleRefCount:
+ *
+ * \code
+ *   class MyItem : public SimpleRefCount<MyItem, PoolAllocated>
+ *   {
+ *     ...
+ *   };
+ * \endcode
+ */
+class PoolAllocated
+{
+public:
+  /**
+   * \param [in] size The size of the object.
+   * \returns The memory of the object.
+   */
+  static void * operator new (std::size_t size)
+  {
+    return PoolAllocator::Allocate (size);
+  }
+  /**
+   * \param [in] p The memory of the object.
+   * \param [in] size The size of the object.
+   */
+  static void operator delete (void *p, std::size_t size)
+  {
+    PoolAllocator::Deallocate (p, size);
+  }
+};
+
+/**
+ * \ingroup packet
+ * \brief A standard library allocator which allocates with PoolAllocator,
+ * for the small containers of the per-packet objects.
+ *
+ * \tparam T The type of the allocated objects.
+ */
+template <typename T>
+class PoolStlAllocator
+{
+public:
+  typedef T value_type; //!< The type of the allocated objects
+
+  PoolStlAllocator ()
+  {}
+  /**
+   * Copy from the allocator of another type.
+   * \tparam U \deduced The other type.
+   */
+  template <typename U>
+  PoolStlAllocator (const PoolStlAllocator<U> &)
+  {}
+  /**
+   * \param [in] n The number of objects.
+   * \returns The memory of the objects.
+   */
+  T * allocate (std::size_t n)
+  {
+    return static_cast<T *> (PoolAllocator::Allocate (n * sizeof (T)));
+  }
+  /**
+   * \param [in] p The memory of the objects.
+   * \param [in] n The number of objects.
+   */
+  void deallocate (T *p, std::size_t n)
+  {
+    PoolAllocator::Deallocate (p, n * sizeof (T));
+  }
+};
+
+/**
+ * \returns \c true: all the PoolStlAllocator are interchangeable.
+ */
+template <typename T, typename U>
+bool operator == (const PoolStlAllocator<T> &, const PoolStlAllocator<U> &)
+{
+  return true;
+}
+
+/**
+ * \returns \c false: all the PoolStlAllocator are interchangeable.
+ */
+template <typename T, typename U>
+bool operator != (const PoolStlAllocator<T> &, const PoolStlAllocator<U> &)
+{
+  return false;
+}
+
+} // namespace ns3
+
+#endif /* POOL_ALLOCATOR_H */
@@ -19,6 +19,8 @@
  */
 #include "ns3/packet.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/socket.h"
 #include "ns3/test.h"
 #include "ns3/unused.h"
 #include <limits>     // std:numeric_limits
@@ -1146,6 +1148,224 @@ PacketTagListTest::DoRun (void)
     
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PacketTagList inline tags test
+ *
+ * Tags of the types stored in the inline slots, FlowIdTag and
+ * SocketPriorityTag, and of the others, are added, replaced, copied,
+ * iterated over and serialized together.
+ */
+class PacketTagListInlineTest : public TestCase
+{
+public:
+  PacketTagListInlineTest ();
+private:
+  void DoRun (void);
+  /**
+   * Count the tags of a packet, and check their data.
+   * \param p The packet.
+   * \param data The expected data of all the tags.
+   * \return The number of tags.
+   */
+  uint32_t CountTags (Ptr<const Packet> p, uint8_t data);
+};
+
+PacketTagListInlineTest::PacketTagListInlineTest ()
+  : TestCase ("PacketTagListInlineTest")
+{}
+
+uint32_t
+PacketTagListInlineTest::CountTags (Ptr<const Packet> p, uint8_t data)
+{
+  uint32_t n = 0;
+  PacketTagIterator i = p->GetPacketTagIterator ();
+  while (i.HasNext ())
+    {
+      PacketTagIterator::Item item = i.Next ();
+      if (item.GetTypeId () == FlowIdTag::GetTypeId ())
+        {
+          FlowIdTag flowId;
+          item.GetTag (flowId);
+          NS_TEST_EXPECT_MSG_EQ (flowId.GetFlowId (), data, "Wrong data of " << item.GetTypeId ());
+          ++n;
+          continue;
+        }
+      if (item.GetTypeId () == SocketPriorityTag::GetTypeId ())
+        {
+          SocketPriorityTag priority;
+          item.GetTag (priority);
+          NS_TEST_EXPECT_MSG_EQ (priority.GetPriority (), data, "Wrong data of " << item.GetTypeId ());
+          ++n;
+          continue;
+        }
+      Callback<ObjectBase *> constructor = item.GetTypeId ().GetConstructor ();
+      ATestTagBase *base = dynamic_cast<ATestTagBase *> (constructor ());
+      NS_TEST_EXPECT_MSG_NE (base, 0, "Unknown tag " << item.GetTypeId ());
+      if (base == 0)
+        {
+          continue;
+        }
+      item.GetTag (*base);
+      NS_TEST_EXPECT_MSG_EQ (base->m_error, false, "Corrupt tag " << item.GetTypeId ());
+      NS_TEST_EXPECT_MSG_EQ (base->GetData (), data, "Wrong data of " << item.GetTypeId ());
+      delete base;
+      ++n;
+    }
+  return n;
+}
+
+void
+PacketTagListInlineTest::DoRun (void)
+{
+  // Tags in the inline slots, and others, some too large for a slot.
+  FlowIdTag flowId (2);
+  SocketPriorityTag priority;
+  priority.SetPriority (2);
+  ATestTag<11> t11 (2);
+  ATestTag<12> t12 (2);
+  ATestTag<13> t13 (2);
+  ATestTag<14> t14 (2);
+  ATestTag<15> t15 (2);
+  ATestTag<16> t16 (2);
+  ATestTag<17> t17 (2);
+  ATestTag<40> t40 (2);
+
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddPacketTag (t11);
+  p->AddPacketTag (t12);
+  p->AddPacketTag (t13);
+  p->AddPacketTag (t14);
+  p->AddPacketTag (t15);
+  p->AddPacketTag (t16);
+  p->AddPacketTag (t17);
+  p->AddPacketTag (t40);
+  p->AddPacketTag (flowId);
+  p->AddPacketTag (priority);
+  NS_TEST_EXPECT_MSG_EQ (CountTags (p, 2), 10, "Wrong number of tags");
+
+  // copies share, then diverge
+  Ptr<Packet> copy = p->Copy ();
+  ATestTag<11> r11 (3);
+  ATestTag<16> r16 (3);
+  copy->ReplacePacketTag (r11);
+  copy->ReplacePacketTag (r16);
+  ATestTag<11> peek11;
+  ATestTag<16> peek16;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (peek11), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (peek11.GetData (), 2, "The original packet was modified");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (peek16), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (peek16.GetData (), 2, "The original packet was modified");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (peek11), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (peek11.GetData (), 3, "The copy was not modified");
+  NS_TEST_EXPECT_MSG_EQ (copy->RemovePacketTag (peek16), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (peek16.GetData (), 3, "The copy was not modified");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (peek16), false, "The tag was not removed");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (peek16), true, "The tag was removed from the original");
+  FlowIdTag replacedFlowId (3);
+  copy->ReplacePacketTag (replacedFlowId);
+  FlowIdTag peekFlowId;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (peekFlowId), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (peekFlowId.GetFlowId (), 2, "The original packet was modified");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (peekFlowId), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (peekFlowId.GetFlowId (), 3, "The copy was not modified");
+  SocketPriorityTag peekPriority;
+  NS_TEST_EXPECT_MSG_EQ (copy->RemovePacketTag (peekPriority), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (peekPriority), false, "The tag was not removed");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (peekPriority), true, "The tag was removed from the original");
+  ATestTag<12> peek12;
+  NS_TEST_EXPECT_MSG_EQ (copy->RemovePacketTag (peek12), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (peek12), false, "The tag was not removed");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (peek12), true, "The tag was removed from the original");
+
+  // serialization round trip
+  uint32_t size = p->GetSerializedSize ();
+  std::vector<uint8_t> buffer (size);
+  NS_TEST_ASSERT_MSG_EQ (p->Serialize (buffer.data (), size), 1, "Serialization failed");
+  Ptr<Packet> q = Create<Packet> (buffer.data (), size, true);
+  NS_TEST_EXPECT_MSG_EQ (q->GetSize (), 100, "Wrong deserialized size");
+  NS_TEST_EXPECT_MSG_EQ (CountTags (q, 2), 10, "Wrong number of deserialized tags");
+  ATestTag<40> peek40;
+  NS_TEST_EXPECT_MSG_EQ (q->PeekPacketTag (peek40), true, "Missing large tag");
+  NS_TEST_EXPECT_MSG_EQ (peek40.m_error, false, "Corrupt large tag");
+
+  p->RemoveAllPacketTags ();
+  NS_TEST_EXPECT_MSG_EQ (CountTags (p, 2), 0, "Tags were not removed");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (peek11), true, "The tag was removed from the copy");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PacketTagList inline slots test
+ *
+ * The common tag types get their inline slot even when other small tag
+ * types are added first, and the other types get none.
+ */
+class PacketTagListSlotTest : public TestCase
+{
+public:
+  PacketTagListSlotTest ();
+private:
+  void DoRun (void);
+  /**
+   * Find the inline slot of a tag type in a list.
+   * \param list The tag list.
+   * \param tid The tag type.
+   * \return The slot holding a tag of the type, or -1.
+   */
+  int32_t FindSlot (const PacketTagList &list, TypeId tid);
+};
+
+PacketTagListSlotTest::PacketTagListSlotTest ()
+  : TestCase ("PacketTagListSlotTest")
+{}
+
+int32_t
+PacketTagListSlotTest::FindSlot (const PacketTagList &list, TypeId tid)
+{
+  for (uint32_t slot = 0; slot < PacketTagList::INLINE_SLOTS; ++slot)
+    {
+      if (list.HasInlineTag (slot) && PacketTagList::GetInlineTagTypeId (slot) == tid)
+        {
+          return slot;
+        }
+    }
+  return -1;
+}
+
+void
+PacketTagListSlotTest::DoRun (void)
+{
+  // Tag types small enough for a slot, added first
+  PacketTagList list;
+  list.Add (ATestTag<6> (1));
+  list.Add (ATestTag<7> (1));
+  list.Add (ATestTag<8> (1));
+  list.Add (ATestTag<9> (1));
+  FlowIdTag flowId (1);
+  list.Add (flowId);
+  SocketPriorityTag priority;
+  priority.SetPriority (1);
+  list.Add (priority);
+
+  NS_TEST_EXPECT_MSG_EQ (FindSlot (list, ATestTag<6>::GetTypeId ()), -1, "An uncommon tag has a slot");
+  NS_TEST_EXPECT_MSG_EQ (FindSlot (list, ATestTag<7>::GetTypeId ()), -1, "An uncommon tag has a slot");
+  NS_TEST_EXPECT_MSG_EQ (FindSlot (list, ATestTag<8>::GetTypeId ()), -1, "An uncommon tag has a slot");
+  NS_TEST_EXPECT_MSG_EQ (FindSlot (list, ATestTag<9>::GetTypeId ()), -1, "An uncommon tag has a slot");
+  NS_TEST_EXPECT_MSG_NE (FindSlot (list, FlowIdTag::GetTypeId ()), -1, "FlowIdTag has no slot");
+  NS_TEST_EXPECT_MSG_NE (FindSlot (list, SocketPriorityTag::GetTypeId ()), -1, "SocketPriorityTag has no slot");
+
+  ATestTag<9> peek9;
+  NS_TEST_EXPECT_MSG_EQ (list.Peek (peek9), true, "Missing tag");
+  FlowIdTag peekFlowId;
+  NS_TEST_EXPECT_MSG_EQ (list.Peek (peekFlowId), true, "Missing tag");
+  NS_TEST_EXPECT_MSG_EQ (peekFlowId.GetFlowId (), 1, "Wrong data of FlowIdTag");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1163,6 +1383,8 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketTagListInlineTest, TestCase::QUICK);
+  AddTestCase (new PacketTagListSlotTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/pool-allocator.h"
+#include "ns3/queue-item.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup network-test
+ * \ingroup tests
+ * PoolAllocator test suite.
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * A queue item larger than its base class.
+ */
+class PoolAllocatorTestItem : public QueueItem
+{
+public:
+  /**
+   * Constructor.
+   * \param p The packet.
+   */
+  PoolAllocatorTestItem (Ptr<Packet> p)
+    : QueueItem (p)
+  {}
+  uint8_t m_data[200]; //!< Some data
+};
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the released blocks are reused by the size class of their
+ * size, and not when the reuse is disabled.
+ */
+class PoolAllocatorReuseTestCase : public TestCase
+{
+public:
+  PoolAllocatorReuseTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+PoolAllocatorReuseTestCase::PoolAllocatorReuseTestCase ()
+  : TestCase ("Reuse of the released blocks")
+{}
+
+void
+PoolAllocatorReuseTestCase::DoRun (void)
+{
+  void *p = PoolAllocator::Allocate (40);
+  std::memset (p, 0xab, 40);
+  PoolAllocator::Deallocate (p, 40);
+  // 33 to 48 bytes are the same size class
+  void *q = PoolAllocator::Allocate (48);
+  NS_TEST_EXPECT_MSG_EQ (q, p, "The released block is not reused");
+  std::memset (q, 0xcd, 48);
+  PoolAllocator::Deallocate (q, 48);
+
+  // the packets are pool allocated
+  Ptr<Packet> packet = Create<Packet> (100);
+  Packet *released = PeekPointer (packet);
+  packet = 0;
+  PoolAllocator::ResetThreadStats ();
+  packet = Create<Packet> (200);
+  NS_TEST_EXPECT_MSG_EQ (PeekPointer (packet), released, "The packet is not pool allocated");
+  NS_TEST_EXPECT_MSG_EQ (PoolAllocator::GetThreadStats ().systemAllocations, 0,
+                         "The reused packet allocated memory");
+
+  // a queue item is released with the size of its dynamic type
+  Ptr<QueueItem> item = Create<PoolAllocatorTestItem> (packet);
+  void *releasedItem = PeekPointer (item);
+  item = 0;
+  p = PoolAllocator::Allocate (sizeof (PoolAllocatorTestItem));
+  NS_TEST_EXPECT_MSG_EQ (p, releasedItem, "The queue item is not released with its size");
+  PoolAllocator::Deallocate (p, sizeof (PoolAllocatorTestItem));
+
+  PoolAllocator::SetEnabled (false);
+  PoolAllocator::ResetThreadStats ();
+  p = PoolAllocator::Allocate (40);
+  PoolAllocator::Deallocate (p, 40);
+  p = PoolAllocator::Allocate (40);
+  PoolAllocator::SetEnabled (true);
+  // released while enabled: goes to the free list
+  PoolAllocator::Deallocate (p, 40);
+  PoolAllocator::Stats stats = PoolAllocator::GetThreadStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.allocations, 2, "Wrong number of allocations");
+  NS_TEST_EXPECT_MSG_EQ (stats.systemAllocations, 2, "The blocks are reused while disabled");
+  NS_TEST_EXPECT_MSG_EQ (stats.deallocations, 2, "Wrong number of deallocations");
+  q = PoolAllocator::Allocate (33);
+  NS_TEST_EXPECT_MSG_EQ (q, p, "The block allocated while disabled is not reused");
+  PoolAllocator::Deallocate (q, 33);
+
+  // the large blocks are not pooled
+  p = PoolAllocator::Allocate (PoolAllocator::MAX_SIZE + 1);
+  std::memset (p, 0, PoolAllocator::MAX_SIZE + 1);
+  PoolAllocator::Deallocate (p, PoolAllocator::MAX_SIZE + 1);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check the packets created by a thread and destroyed by another one,
+ * whose blocks pass through the shared free lists.
+ */
+class PoolAllocatorThreadsTestCase : public TestCase
+{
+public:
+  PoolAllocatorThreadsTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Create packets.
+   * \param packets The created packets.
+   * \param n The number of packets.
+   */
+  static void Produce (std::vector<Ptr<Packet> > *packets, uint32_t n);
+};
+
+PoolAllocatorThreadsTestCase::PoolAllocatorThreadsTestCase ()
+  : TestCase ("Blocks released by another thread")
+{}
+
+void
+PoolAllocatorThreadsTestCase::Produce (std::vector<Ptr<Packet> > *packets, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint8_t data[8] = {static_cast<uint8_t> (i), 1, 2, 3, 4, 5, 6, 7};
+      packets->push_back (Create<Packet> (data, sizeof (data)));
+    }
+}
+
+void
+PoolAllocatorThreadsTestCase::DoRun (void)
+{
+  // more than the free lists of a thread can hold
+  const uint32_t n = 4 * PoolAllocator::THREAD_CACHE_SIZE;
+  for (uint32_t round = 0; round < 3; ++round)
+    {
+      std::vector<Ptr<Packet> > packets;
+      std::thread producer (&PoolAllocatorThreadsTestCase::Produce, &packets, n);
+      producer.join ();
+      NS_TEST_ASSERT_MSG_EQ (packets.size (), n, "Packets lost");
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          uint8_t data[8];
+          packets[i]->CopyData (data, sizeof (data));
+          NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (data[0]), i % 256, "Wrong packet content");
+        }
+      // released by this thread
+      packets.clear ();
+    }
+
+  // the blocks spilled by this thread are reused by another one
+  PoolAllocator::Stats stats;
+  std::thread consumer ([&stats] ()
+    {
+      std::vector<Ptr<Packet> > packets;
+      Produce (&packets, 2 * PoolAllocator::REFILL_SIZE);
+      stats = PoolAllocator::GetThreadStats ();
+    });
+  consumer.join ();
+  NS_TEST_EXPECT_MSG_GT (stats.sharedRefills, 0, "The shared free lists are not used");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * PoolAllocator test suite.
+ */
+class PoolAllocatorTestSuite : public TestSuite
+{
+public:
+  PoolAllocatorTestSuite ();
+};
+
+PoolAllocatorTestSuite::PoolAllocatorTestSuite ()
+  : TestSuite ("pool-allocator", UNIT)
+{
+  AddTestCase (new PoolAllocatorReuseTestCase, TestCase::QUICK);
+  AddTestCase (new PoolAllocatorThreadsTestCase, TestCase::QUICK);
+}
+
+static PoolAllocatorTestSuite g_poolAllocatorTestSuite; //!< Static variable for test initialization
@@ -24,6 +24,7 @@
 #include "ns3/simple-ref-count.h"
 #include <ns3/address.h>
 #include "ns3/nstime.h"
+#include "ns3/pool-allocator.h"
 
 namespace ns3 {
 
@@ -43,7 +44,7 @@ class Packet;
  * can be derived from this base class to allow items to contain additional
  * information.
  */
-class QueueItem : public SimpleRefCount<QueueItem>
+class QueueItem : public SimpleRefCount<QueueItem, PoolAllocated>
 {
 public:
   /**
@@ -32,6 +32,7 @@
 #ifdef NS3_MPI
 #include "ns3/mpi-interface.h"
 #include "ns3/mpi-receiver.h"
+#include "ns3/mpi-partition-helper.h"
 #include "ns3/point-to-point-remote-channel.h"
 #endif
 
@@ -42,6 +43,66 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PointToPointHelper");
 
+#ifdef NS3_MPI
+namespace {
+
+/**
+ * Replace a point-to-point channel partitioned by the MpiPartitionHelper
+ * with a remote channel if it is cut between the ranks, or with a local
+ * channel otherwise.
+ * \param channel the channel
+ * \param cut whether the channel is cut between the ranks
+ */
+void
+ConvertChannel (Ptr<Channel> channel, bool cut)
+{
+  Ptr<PointToPointChannel> old = DynamicCast<PointToPointChannel> (channel);
+  if (old == 0 || (DynamicCast<PointToPointRemoteChannel> (channel) != 0) == cut)
+    {
+      return;
+    }
+  NS_LOG_LOGIC ("Convert channel " << channel->GetId () << " to a "
+                << (cut ? "remote" : "local") << " channel");
+  Ptr<PointToPointChannel> converted;
+  if (cut)
+    {
+      converted = CreateObject<PointToPointRemoteChannel> ();
+    }
+  else
+    {
+      converted = CreateObject<PointToPointChannel> ();
+    }
+  TimeValue delay;
+  old->GetAttribute ("Delay", delay);
+  converted->SetAttribute ("Delay", delay);
+  for (std::size_t i = 0; i < old->GetNDevices (); ++i)
+    {
+      Ptr<PointToPointNetDevice> device = old->GetPointToPointDevice (i);
+      if (cut && device->GetObject<MpiReceiver> () == 0)
+        {
+          Ptr<MpiReceiver> mpiRec = CreateObject<MpiReceiver> ();
+          mpiRec->SetReceiveCallback (MakeCallback (&PointToPointNetDevice::Receive, device));
+          device->AggregateObject (mpiRec);
+        }
+      device->Attach (converted);
+    }
+}
+
+/**
+ * Allow the MpiPartitionHelper to cut the point-to-point channels.
+ */
+struct PointToPointChannelConverter
+{
+  PointToPointChannelConverter ()
+  {
+    MpiPartitionHelper::AddChannelConverter (PointToPointChannel::GetTypeId (),
+                                             MakeCallback (&ConvertChannel));
+  }
+} g_pointToPointChannelConverter; //!< the registration of the converter
+
+} // unnamed namespace
+#endif
+
 PointToPointHelper::PointToPointHelper ()
 {
   m_queueFactory.SetTypeId ("ns3::DropTailQueue<Packet>");
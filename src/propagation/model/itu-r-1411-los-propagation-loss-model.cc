@@ -107,4 +107,10 @@ ItuR1411LosPropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
+
+bool
+ItuR1411LosPropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
 } // namespace ns3
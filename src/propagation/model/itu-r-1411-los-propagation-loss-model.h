@@ -90,6 +90,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsDeterministic (void) const;
   
   double m_lambda; //!< wavelength
 };
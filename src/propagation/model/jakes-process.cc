@@ -30,19 +30,6 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("JakesProcess");
 
-/// Represents a single oscillator
-JakesProcess::Oscillator::Oscillator (std::complex<double> amplitude, double initialPhase, double omega) :
-  m_amplitude (amplitude),
-  m_phase (initialPhase),
-  m_omega (omega)
-{}
-
-std::complex<double>
-JakesProcess::Oscillator::GetValueAt (Time at) const
-{
-  return (m_amplitude * std::cos (at.GetSeconds () * m_omega + m_phase));
-}
-
 NS_OBJECT_ENSURE_REGISTERED (JakesProcess);
 
 TypeId
@@ -94,9 +81,17 @@ JakesProcess::ConstructOscillators ()
 {
   NS_ASSERT (m_jakes);
   // Initial phase is common for all oscillators:
-  double phi = m_jakes->GetUniformRandomVariable ()->GetValue ();
+  m_phase = m_jakes->GetUniformRandomVariable ()->GetValue ();
   // Theta is common for all oscillators:
   double theta = m_jakes->GetUniformRandomVariable ()->GetValue ();
+  m_amplitudeRe.resize (m_nOscillators);
+  m_amplitudeIm.resize (m_nOscillators);
+  m_omega.resize (m_nOscillators);
+  m_phasorRe.resize (m_nOscillators);
+  m_phasorIm.resize (m_nOscillators);
+  m_rotationRe.resize (m_nOscillators);
+  m_rotationIm.resize (m_nOscillators);
+  m_updated = false;
   for (unsigned int i = 0; i < m_nOscillators; i++)
     {
       unsigned int n = i + 1;
@@ -107,13 +102,18 @@ JakesProcess::ConstructOscillators ()
       double omega = m_omegaDopplerMax * std::cos (alpha);
       /// 2. Initiate complex amplitude:
       double psi = m_jakes->GetUniformRandomVariable ()->GetValue ();
-      std::complex<double> amplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (m_nOscillators);
       /// 3. Construct oscillator:
-      m_oscillators.push_back (Oscillator (amplitude, phi, omega)); 
+      m_amplitudeRe[i] = std::cos (psi) * 2.0 / std::sqrt (m_nOscillators);
+      m_amplitudeIm[i] = std::sin (psi) * 2.0 / std::sqrt (m_nOscillators);
+      m_omega[i] = omega;
     }
 }
 
 JakesProcess::JakesProcess () :
+  m_phase (0),
+  m_updated (false),
+  m_rotationValid (false),
+  m_rotations (0),
   m_omegaDopplerMax (0),
   m_nOscillators (0)
 {
@@ -121,7 +121,6 @@ JakesProcess::JakesProcess () :
 
 JakesProcess::~JakesProcess()
 {
-  m_oscillators.clear ();
 }
 
 void
@@ -130,15 +129,82 @@ JakesProcess::DoDispose ()
   m_jakes = 0;
 }
 
+void
+JakesProcess::ComputePhasors (Time t) const
+{
+  double seconds = t.GetSeconds ();
+  for (unsigned int i = 0; i < m_omega.size (); i++)
+    {
+      double phase = seconds * m_omega[i] + m_phase;
+      m_phasorRe[i] = std::cos (phase);
+      m_phasorIm[i] = std::sin (phase);
+    }
+  m_rotations = 0;
+}
+
+void
+JakesProcess::Update (Time t) const
+{
+  Time step = t - m_lastUpdate;
+  if (!m_updated || step.IsStrictlyNegative () || m_rotations >= MAX_ROTATIONS)
+    {
+      ComputePhasors (t);
+      m_rotationValid = false;
+    }
+  else if (step != m_step)
+    {
+      // The rotations are computed once the step repeats
+      ComputePhasors (t);
+      m_step = step;
+      m_rotationValid = false;
+    }
+  else
+    {
+      if (!m_rotationValid)
+        {
+          double seconds = step.GetSeconds ();
+          for (unsigned int i = 0; i < m_omega.size (); i++)
+            {
+              m_rotationRe[i] = std::cos (seconds * m_omega[i]);
+              m_rotationIm[i] = std::sin (seconds * m_omega[i]);
+            }
+          m_rotationValid = true;
+        }
+      double *re = m_phasorRe.data ();
+      double *im = m_phasorIm.data ();
+      const double *rotationRe = m_rotationRe.data ();
+      const double *rotationIm = m_rotationIm.data ();
+      for (unsigned int i = 0; i < m_omega.size (); i++)
+        {
+          double r = re[i] * rotationRe[i] - im[i] * rotationIm[i];
+          im[i] = re[i] * rotationIm[i] + im[i] * rotationRe[i];
+          re[i] = r;
+        }
+      ++m_rotations;
+    }
+  m_updated = true;
+  m_lastUpdate = t;
+
+  // X_c(t) + j X_s(t), the oscillators being the real parts of the phasors
+  double gainRe = 0;
+  double gainIm = 0;
+  for (unsigned int i = 0; i < m_omega.size (); i++)
+    {
+      gainRe += m_amplitudeRe[i] * m_phasorRe[i];
+      gainIm += m_amplitudeIm[i] * m_phasorRe[i];
+    }
+  m_gain = std::complex<double> (gainRe, gainIm);
+}
+
 std::complex<double>
 JakesProcess::GetComplexGain () const
 {
-  std::complex<double> sumAplitude = std::complex<double> (0, 0);
-  for (unsigned int i = 0; i < m_oscillators.size (); i++)
+  Time now = Now ();
+  if (!m_updated || now != m_lastUpdate)
     {
-      sumAplitude += m_oscillators[i].GetValueAt (Now ());
+      Update (now);
     }
-  return sumAplitude;
+  return m_gain;
 }
 
 double
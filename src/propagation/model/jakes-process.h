@@ -24,6 +24,7 @@
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 #include <complex>
+#include <vector>
 
 namespace ns3
 {
@@ -47,6 +48,14 @@ class JakesPropagationLossModel;
  * where
  *\f$\theta\f$, \f$\phi\f$, and \f$\psi_n\f$ are statically independent and uniformly distributed over \f$[-\pi, \pi)\f$ for all \f$n\f$.
  *
+ * The process keeps the phasors \f$e^{j(\omega_d t\cos(\alpha_n)+\phi_n)}\f$
+ * of its oscillators at the time of the last evaluation, in arrays of
+ * their real and imaginary parts.  When the time advances by the same
+ * step as at the previous evaluation, e.g. by a frame duration, the
+ * phasors are rotated by the rotations of this step, computed once, so
+ * that the evaluation needs no trigonometric function; otherwise, and
+ * periodically to bound the rounding errors, the phasors are computed
+ * again from the time.  The gain is evaluated once per time step.
  *
  * [1] Y. R. Zheng and C. Xiao, "Simulation Models With Correct
  * Statistical Properties for Rayleigh Fading Channel", IEEE
@@ -81,30 +90,6 @@ public:
    */
   void SetPropagationLossModel (Ptr<const PropagationLossModel> model);
 private:
-  /**
-   * This class Represents a single oscillator
-   */
-  struct Oscillator
-  {
-    /**
-     * Initiate oscillator with complex amplitude, initial phase and rotation speed
-     * \param amplitude initial complex amplitude
-     * \param initialPhase initial phase
-     * \param omega rotation speed
-     */
-    Oscillator (std::complex<double> amplitude, double initialPhase, double omega);
-    /**
-     * Get the complex amplitude at a given moment
-     * \param t time instant
-     * \returns the complex amplitude
-     */
-    std::complex<double> GetValueAt (Time t) const;
-
-    std::complex<double> m_amplitude; //!< Complex number \f$Re=\cos(\psi_n), Im = i\sin(\psi_n)]\f$
-    double m_phase; //!< Phase \f$\phi_n\f$ of the oscillator
-    double m_omega; //!< Rotation speed of the oscillator \f$\omega_d \cos(\alpha_n)\f$
-  };
-private:
 
   /**
    * Set the number of Oscillators to use
@@ -119,11 +104,37 @@ private:
   void SetDopplerFrequencyHz (double dopplerFrequencyHz);
 
   /**
-   *
+   * Draw the random parameters of the oscillators
    */
   void ConstructOscillators ();
-private:
-  std::vector<Oscillator> m_oscillators; //!< Vector of oscillators
+  /**
+   * Update the phasors of the oscillators and the gain to a time
+   * \param t the time
+   */
+  void Update (Time t) const;
+  /**
+   * Compute the phasors of the oscillators from a time
+   * \param t the time
+   */
+  void ComputePhasors (Time t) const;
+
+  /// The number of rotations after which the phasors are computed again
+  static const uint32_t MAX_ROTATIONS = 1024;
+
+  std::vector<double> m_amplitudeRe; //!< \f$\cos(\psi_n)\f$ of the oscillators, scaled
+  std::vector<double> m_amplitudeIm; //!< \f$\sin(\psi_n)\f$ of the oscillators, scaled
+  std::vector<double> m_omega; //!< Rotation speeds of the oscillators \f$\omega_d \cos(\alpha_n)\f$
+  double m_phase; //!< Phase \f$\phi\f$ common to the oscillators
+  mutable std::vector<double> m_phasorRe; //!< Real parts of the phasors at the last update
+  mutable std::vector<double> m_phasorIm; //!< Imaginary parts of the phasors at the last update
+  mutable std::vector<double> m_rotationRe; //!< Real parts of the rotations of the last step
+  mutable std::vector<double> m_rotationIm; //!< Imaginary parts of the rotations of the last step
+  mutable bool m_updated; //!< Whether the phasors were computed
+  mutable bool m_rotationValid; //!< Whether the rotations were computed for the last step
+  mutable Time m_lastUpdate; //!< Time of the last update
+  mutable Time m_step; //!< The last step
+  mutable uint32_t m_rotations; //!< Number of rotations since the phasors were computed
+  mutable std::complex<double> m_gain; //!< The gain at the last update
   double m_omegaDopplerMax; //!< max rotation speed Doppler frequency
   unsigned int m_nOscillators;  //!< number of oscillators
   Ptr<UniformRandomVariable> m_uniformVariable; //!< random stream
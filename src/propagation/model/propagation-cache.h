@@ -21,7 +21,9 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
-#include <map>
+#include <functional>
+#include <list>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -30,12 +32,31 @@ namespace ns3
  * \brief Constructs a cache of objects, where each object is responsible for a single propagation path loss calculations.
  * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
  * a couple of MobilityModels and a spectrum model UID
+ *
+ * The paths are stored in a hash table.  By default the cache keeps all
+ * the paths, as the state of a fading process which evolves in time.
+ * Two options make it suitable for the results computed from the
+ * positions of the nodes:
+ *
+ *  - SetInvalidateOnCourseChange: the data of a path are dropped when one
+ *    of its nodes moved since they were added, that is when the
+ *    MobilityModel::GetCourseChangeEpoch of a node changed or its velocity
+ *    is not zero;
+ *  - SetMaxSize: the least recently used path is dropped when the cache
+ *    is full.
+ *
+ * The number of hits and misses of GetPathData are counted.
  */
 template<class T>
 class PropagationCache
 {
 public:
-  PropagationCache () {};
+  PropagationCache ()
+    : m_maxSize (0),
+      m_invalidateOnCourseChange (false),
+      m_hits (0),
+      m_misses (0)
+  {};
   ~PropagationCache () {};
 
   /**
@@ -43,17 +64,29 @@ public:
    * \param a 1st node mobility model
    * \param b 2nd node mobility model
    * \param modelUid model UID
-   * \return the model
+   * \return the model, or 0 if the path is not in the cache
    */
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
     PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    typename PathCache::iterator it = m_pathCache.find (key);
-    if (it == m_pathCache.end ())
+    typename PathIndex::iterator it = m_pathIndex.find (key);
+    if (it == m_pathIndex.end ())
       {
+        ++m_misses;
         return 0;
       }
-    return it->second;
+    typename PathList::iterator path = it->second;
+    if (m_invalidateOnCourseChange && HasMoved (*path))
+      {
+        m_pathList.erase (path);
+        m_pathIndex.erase (it);
+        ++m_misses;
+        return 0;
+      }
+    // most recently used first
+    m_pathList.splice (m_pathList.begin (), m_pathList, path);
+    ++m_hits;
+    return path->m_data;
   };
 
   /**
@@ -66,13 +99,107 @@ public:
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
     PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    NS_ASSERT (m_pathIndex.find (key) == m_pathIndex.end ());
+    if (m_maxSize != 0 && m_pathList.size () >= m_maxSize)
+      {
+        m_pathIndex.erase (m_pathList.back ().m_key);
+        m_pathList.pop_back ();
+      }
+    Path path;
+    path.m_key = key;
+    path.m_data = data;
+    path.m_first = key.m_first == PeekPointer (a) ? a : b;
+    path.m_second = key.m_first == PeekPointer (a) ? b : a;
+    path.m_firstEpoch = path.m_first->GetCourseChangeEpoch ();
+    path.m_secondEpoch = path.m_second->GetCourseChangeEpoch ();
+    m_pathList.push_front (path);
+    m_pathIndex.insert (std::make_pair (key, m_pathList.begin ()));
+  };
+
+  /**
+   * Set the maximum number of paths.
+   *
+   * \param maxSize the maximum number of paths, or 0 for no limit (the default)
+   */
+  void SetMaxSize (uint32_t maxSize)
+  {
+    m_maxSize = maxSize;
+    while (m_maxSize != 0 && m_pathList.size () > m_maxSize)
+      {
+        m_pathIndex.erase (m_pathList.back ().m_key);
+        m_pathList.pop_back ();
+      }
+  };
+
+  /**
+   * Set whether the data of the paths whose nodes moved are dropped.
+   *
+   * \param invalidate true to drop the data of the paths whose nodes moved,
+   *        false to keep them (the default)
+   */
+  void SetInvalidateOnCourseChange (bool invalidate)
+  {
+    m_invalidateOnCourseChange = invalidate;
+  };
+
+  /**
+   * Remove all the paths.  The statistics are not reset.
+   */
+  void Clear (void)
+  {
+    m_pathIndex.clear ();
+    m_pathList.clear ();
+  };
+
+  /**
+   * \return the number of paths in the cache
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_pathList.size ();
+  };
+
+  /**
+   * \return the number of calls to GetPathData which found the path
+   */
+  uint64_t GetHits (void) const
+  {
+    return m_hits;
   };
+
+  /**
+   * \return the number of calls to GetPathData which did not find the path
+   */
+  uint64_t GetMisses (void) const
+  {
+    return m_misses;
+  };
+
+  /**
+   * \return the ratio of the hits to the calls to GetPathData, or 0 if none
+   */
+  double GetHitRate (void) const
+  {
+    uint64_t lookups = m_hits + m_misses;
+    return lookups == 0 ? 0 : static_cast<double> (m_hits) / lookups;
+  };
+
+  /**
+   * Reset the numbers of hits and misses.
+   */
+  void ResetStats (void)
+  {
+    m_hits = 0;
+    m_misses = 0;
+  };
+
 private:
   /// Each path is identified by
   struct PropagationPathIdentifier
   {
+    PropagationPathIdentifier ()
+      : m_first (0), m_second (0), m_spectrumModelUid (0)
+    {};
     /**
      * Constructor
      * @param a 1st node mobility model
@@ -80,47 +207,81 @@ private:
      * @param modelUid model UID
      */
     PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
-      m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
+      m_first (std::min (PeekPointer (a), PeekPointer (b))),
+      m_second (std::max (PeekPointer (a), PeekPointer (b))),
+      m_spectrumModelUid (modelUid)
     {};
-    Ptr<const MobilityModel> m_srcMobility; //!< 1st node mobility model
-    Ptr<const MobilityModel> m_dstMobility; //!< 2nd node mobility model
+    /// Links are supposed to be symmetrical: the mobility models are ordered
+    const MobilityModel *m_first;  //!< The lower mobility model
+    const MobilityModel *m_second; //!< The higher mobility model
     uint32_t m_spectrumModelUid; //!< model UID
 
     /**
-     * Less-than operator.
-     *
-     * The goal of this operator is just to provide a stable comparison
-     * to be used in containers requiring a order (of any kind).
-     *
-     * If the models are different, the comparison is based on their Uid.
-     * Otherwise, the comparison is based on the pointers of the Mobility models.
-     *
+     * Equality operator.
      * \param other Right value of the operator.
-     * \returns True if the Left value is less than the Right value.
+     * \returns True if the identifiers are the same path.
      */
-    bool operator < (const PropagationPathIdentifier & other) const
+    bool operator == (const PropagationPathIdentifier & other) const
     {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
+      return m_first == other.m_first && m_second == other.m_second
+             && m_spectrumModelUid == other.m_spectrumModelUid;
     }
   };
 
-  /// Typedef: PropagationPathIdentifier, Ptr<T>
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
-private:
-  PathCache m_pathCache; //!< Path cache
+  /// The hash of a PropagationPathIdentifier
+  struct PropagationPathHash
+  {
+    /**
+     * \param key the path
+     * \returns the hash of the path
+     */
+    std::size_t operator () (const PropagationPathIdentifier &key) const
+    {
+      std::hash<const void *> hasher;
+      std::size_t h = hasher (key.m_first);
+      h ^= hasher (key.m_second) + 0x9e3779b9 + (h << 6) + (h >> 2);
+      h ^= key.m_spectrumModelUid + 0x9e3779b9 + (h << 6) + (h >> 2);
+      return h;
+    }
+  };
+
+  /// A path in the cache
+  struct Path
+  {
+    PropagationPathIdentifier m_key;  //!< The path
+    Ptr<T> m_data;                    //!< The data of the path
+    Ptr<const MobilityModel> m_first;   //!< The 1st mobility model of the key, kept alive
+    Ptr<const MobilityModel> m_second;  //!< The 2nd mobility model of the key, kept alive
+    uint64_t m_firstEpoch;            //!< The course change epoch of the 1st model
+    uint64_t m_secondEpoch;           //!< The course change epoch of the 2nd model
+  };
+
+  /**
+   * \param path a path
+   * \return true if one of the nodes of the path moved since it was added
+   */
+  static bool HasMoved (const Path &path)
+  {
+    // a node which did not change course and stands still did not move;
+    // the velocities are read first, which updates the lazy models
+    Vector zero;
+    bool moving = path.m_first->GetVelocity () != zero || path.m_second->GetVelocity () != zero;
+    return moving
+           || path.m_first->GetCourseChangeEpoch () != path.m_firstEpoch
+           || path.m_second->GetCourseChangeEpoch () != path.m_secondEpoch;
+  };
+
+  /// The paths, most recently used first
+  typedef std::list<Path> PathList;
+  /// The paths by identifier
+  typedef std::unordered_map<PropagationPathIdentifier, typename PathList::iterator, PropagationPathHash> PathIndex;
+
+  PathList m_pathList;    //!< Path cache
+  PathIndex m_pathIndex;  //!< The paths by identifier
+  uint32_t m_maxSize;     //!< The maximum number of paths, or 0
+  bool m_invalidateOnCourseChange; //!< Whether the paths whose nodes moved are dropped
+  uint64_t m_hits;        //!< The number of hits
+  uint64_t m_misses;      //!< The number of misses
 };
 } // namespace ns3
 
@@ -28,6 +28,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include <cmath>
 
 namespace ns3 {
@@ -44,13 +45,31 @@ PropagationLossModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::PropagationLossModel")
     .SetParent<Object> ()
     .SetGroupName ("Propagation")
+    .AddAttribute ("CacheSize",
+                   "The maximum number of links whose reception power is cached, "
+                   "if the model is deterministic; 0 disables the cache.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PropagationLossModel::SetCacheSize,
+                                         &PropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
+PropagationLossModel::LinkPower::LinkPower ()
+{
+  m_txPowerDbm[0] = m_txPowerDbm[1] = 0;
+  m_rxPowerDbm[0] = m_rxPowerDbm[1] = 0;
+  m_valid[0] = m_valid[1] = false;
+}
+
 PropagationLossModel::PropagationLossModel ()
-  : m_next (0)
+  : m_next (0),
+    m_cacheSize (0),
+    m_cacheHits (0),
+    m_cacheMisses (0)
 {
+  m_cache.SetInvalidateOnCourseChange (true);
 }
 
 PropagationLossModel::~PropagationLossModel ()
@@ -69,12 +88,101 @@ PropagationLossModel::GetNext ()
   return m_next;
 }
 
+void
+PropagationLossModel::DoDispose (void)
+{
+  m_cache.Clear ();
+  Object::DoDispose ();
+}
+
+bool
+PropagationLossModel::IsDeterministic (void) const
+{
+  return false;
+}
+
+void
+PropagationLossModel::SetCacheSize (uint32_t size)
+{
+  m_cacheSize = size;
+  m_cache.SetMaxSize (size);
+  if (size == 0)
+    {
+      m_cache.Clear ();
+    }
+}
+
+uint32_t
+PropagationLossModel::GetCacheSize (void) const
+{
+  return m_cacheSize;
+}
+
+uint64_t
+PropagationLossModel::GetCacheHits (void) const
+{
+  return m_cacheHits;
+}
+
+uint64_t
+PropagationLossModel::GetCacheMisses (void) const
+{
+  return m_cacheMisses;
+}
+
+double
+PropagationLossModel::GetCacheHitRate (void) const
+{
+  uint64_t calls = m_cacheHits + m_cacheMisses;
+  return calls == 0 ? 0 : static_cast<double> (m_cacheHits) / calls;
+}
+
+void
+PropagationLossModel::ClearCache (void)
+{
+  m_cache.Clear ();
+}
+
+double
+PropagationLossModel::DoCalcRxPowerCached (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  // the links are symmetric in the cache, the models may be not
+  uint32_t direction = PeekPointer (a) < PeekPointer (b) ? 0 : 1;
+  Ptr<LinkPower> link = m_cache.GetPathData (a, b, 0);
+  if (link != 0 && link->m_valid[direction] && link->m_txPowerDbm[direction] == txPowerDbm)
+    {
+      ++m_cacheHits;
+      return link->m_rxPowerDbm[direction];
+    }
+  ++m_cacheMisses;
+  double rxPowerDbm = DoCalcRxPower (txPowerDbm, a, b);
+  if (link == 0)
+    {
+      Vector zero;
+      if (a->GetVelocity () != zero || b->GetVelocity () != zero)
+        {
+          // the entry would be invalid at the next call
+          return rxPowerDbm;
+        }
+      link = Create<LinkPower> ();
+      m_cache.AddPathData (link, a, b, 0);
+    }
+  link->m_txPowerDbm[direction] = txPowerDbm;
+  link->m_rxPowerDbm[direction] = rxPowerDbm;
+  link->m_valid[direction] = true;
+  return rxPowerDbm;
+}
+
 double
 PropagationLossModel::CalcRxPower (double txPowerDbm,
                                    Ptr<MobilityModel> a,
                                    Ptr<MobilityModel> b) const
 {
-  double self = DoCalcRxPower (txPowerDbm, a, b);
+  double self = m_cacheSize != 0 && IsDeterministic ()
+    ? DoCalcRxPowerCached (txPowerDbm, a, b)
+    : DoCalcRxPower (txPowerDbm, a, b);
   if (m_next != 0)
     {
       self = m_next->CalcRxPower (self, a, b);
@@ -277,6 +385,12 @@ FriisPropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+FriisPropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 // -- Two-Ray Ground Model ported from NS-2 -- tomhewer@mac.com -- Nov09 //
 
@@ -451,6 +565,12 @@ TwoRayGroundPropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+TwoRayGroundPropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (LogDistancePropagationLossModel);
@@ -540,6 +660,12 @@ LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+LogDistancePropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (ThreeLogDistancePropagationLossModel);
@@ -642,6 +768,12 @@ ThreeLogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+ThreeLogDistancePropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (NakagamiPropagationLossModel);
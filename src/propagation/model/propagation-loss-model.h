@@ -27,6 +27,7 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "propagation-cache.h"
 #include <map>
 
 namespace ns3 {
@@ -45,6 +46,17 @@ class MobilityModel;
  *
  * Calculate the receive power (dbm) from a transmit power (dbm)
  * and a mobility model for the source and destination positions.
+ *
+ * The models whose reception power is a deterministic function of the
+ * transmission power and of the positions (IsDeterministic) can cache it
+ * per link, for the static nodes: the cache is enabled by the CacheSize
+ * attribute, and an entry is used while both nodes stand still, their
+ * course change counters (MobilityModel::GetCourseChangeEpoch) unchanged,
+ * and the transmission power is the same.  The other models of the chain
+ * are not affected: a random model after a cached one still draws a new
+ * value for each call.  The cached values are those computed with the
+ * attributes of the time: ClearCache must be called after changing the
+ * attributes of a model which already computed some losses.
  */
 class PropagationLossModel : public Object
 {
@@ -106,6 +118,36 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \returns the number of calls to this model (not to the chained ones)
+   *          which used a cached reception power
+   */
+  uint64_t GetCacheHits (void) const;
+  /**
+   * \returns the number of calls to this model (not to the chained ones)
+   *          which computed the reception power with the cache enabled
+   */
+  uint64_t GetCacheMisses (void) const;
+  /**
+   * \returns the ratio of the hits to the calls with the cache enabled, or 0
+   */
+  double GetCacheHitRate (void) const;
+  /**
+   * Remove the cached reception powers of this model.
+   */
+  void ClearCache (void);
+
+protected:
+  virtual void DoDispose (void);
+  /**
+   * The models which compute the same reception power for the same
+   * transmission power and the same positions, without drawing random
+   * values nor keeping a state, override this method to allow the cache.
+   *
+   * \returns true if the reception power of this model can be cached
+   */
+  virtual bool IsDeterministic (void) const;
+
 private:
   /**
    * \brief Copy constructor
@@ -140,7 +182,44 @@ private:
    */
   virtual int64_t DoAssignStreams (int64_t stream) = 0;
 
+  /**
+   * Returns the Rx Power of this model from the cache, or compute and
+   * cache it.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \returns the reception power after adding/multiplying propagation loss (in dBm)
+   */
+  double DoCalcRxPowerCached (double txPowerDbm,
+                              Ptr<MobilityModel> a,
+                              Ptr<MobilityModel> b) const;
+
+  /**
+   * \param size the maximum number of cached links, 0 to disable the cache
+   */
+  void SetCacheSize (uint32_t size);
+  /**
+   * \returns the maximum number of cached links
+   */
+  uint32_t GetCacheSize (void) const;
+
+  /**
+   * The cached reception powers of a link, by direction.
+   */
+  struct LinkPower : public SimpleRefCount<LinkPower>
+  {
+    LinkPower ();
+    double m_txPowerDbm[2];  //!< The transmission powers
+    double m_rxPowerDbm[2];  //!< The reception powers
+    bool m_valid[2];         //!< Whether the powers are set
+  };
+
   Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
+  uint32_t m_cacheSize;                           //!< The maximum number of cached links
+  mutable PropagationCache<LinkPower> m_cache;    //!< The cached reception powers
+  mutable uint64_t m_cacheHits;                   //!< The number of cache hits
+  mutable uint64_t m_cacheMisses;                 //!< The number of cache misses
 };
 
 /**
@@ -322,6 +401,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsDeterministic (void) const;
 
   /**
    * Transforms a Dbm value to Watt
@@ -442,6 +522,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsDeterministic (void) const;
 
   /**
    * Transforms a Dbm value to Watt
@@ -530,6 +611,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsDeterministic (void) const;
 
   /**
    *  Creates a default reference loss model
@@ -613,6 +695,7 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsDeterministic (void) const;
 
   double m_distance0; //!< Beginning of the first (near) distance field
   double m_distance1; //!< Beginning of the second (middle) distance field.
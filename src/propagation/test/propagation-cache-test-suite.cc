@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/propagation-cache.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("PropagationCacheTest");
+
+/**
+ * The data of a path in the test cache.
+ */
+class PropagationCacheTestData : public SimpleRefCount<PropagationCacheTestData>
+{
+public:
+  /**
+   * Constructor
+   * \param value the value of the path
+   */
+  PropagationCacheTestData (double value)
+    : m_value (value)
+  {
+  }
+  double m_value; //!< the value of the path
+};
+
+/**
+ * Check the symmetry, the statistics and the size limit of the
+ * PropagationCache, and the invalidation of the paths whose nodes moved.
+ */
+class PropagationCacheTestCase : public TestCase
+{
+public:
+  PropagationCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationCacheTestCase::PropagationCacheTestCase ()
+  : TestCase ("Check the lookups, the eviction and the invalidation of the PropagationCache")
+{
+}
+
+void
+PropagationCacheTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantVelocityMobilityModel> d = CreateObject<ConstantVelocityMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  b->SetPosition (Vector (10, 0, 0));
+  c->SetPosition (Vector (0, 10, 0));
+  d->SetPosition (Vector (10, 10, 0));
+
+  // symmetric paths, by model uid
+  PropagationCache<PropagationCacheTestData> cache;
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (a, b, 0), 0, "empty cache");
+  cache.AddPathData (Create<PropagationCacheTestData> (1), a, b, 0);
+  cache.AddPathData (Create<PropagationCacheTestData> (2), a, b, 1);
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (b, a, 0)->m_value, 1, "paths are symmetric");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (a, b, 1)->m_value, 2, "paths are by model uid");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (a, c, 0), 0, "unknown path");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetHits (), 2, "wrong number of hits");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetMisses (), 2, "wrong number of misses");
+  NS_TEST_ASSERT_MSG_EQ_TOL (cache.GetHitRate (), 0.5, 1e-12, "wrong hit rate");
+
+  // the paths are kept by default when the nodes move
+  a->SetPosition (Vector (1, 0, 0));
+  NS_TEST_ASSERT_MSG_NE (cache.GetPathData (a, b, 0), 0, "the path is kept by default");
+
+  // the least recently used path is evicted
+  cache.ResetStats ();
+  cache.AddPathData (Create<PropagationCacheTestData> (3), b, c, 0);
+  cache.GetPathData (a, b, 1);
+  cache.SetMaxSize (2);
+  NS_TEST_ASSERT_MSG_EQ (cache.GetSize (), 2, "the cache is not limited");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (a, b, 0), 0, "the least recently used path is kept");
+  NS_TEST_ASSERT_MSG_NE (cache.GetPathData (a, b, 1), 0, "a recently used path is evicted");
+  cache.AddPathData (Create<PropagationCacheTestData> (4), a, c, 0);
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (b, c, 0), 0, "the least recently used path is kept");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetSize (), 2, "the cache exceeds its size");
+
+  // the paths whose nodes moved are invalidated
+  PropagationCache<PropagationCacheTestData> positions;
+  positions.SetInvalidateOnCourseChange (true);
+  positions.AddPathData (Create<PropagationCacheTestData> (5), a, b, 0);
+  positions.AddPathData (Create<PropagationCacheTestData> (6), a, c, 0);
+  positions.AddPathData (Create<PropagationCacheTestData> (7), b, d, 0);
+  NS_TEST_ASSERT_MSG_NE (positions.GetPathData (b, a, 0), 0, "a static path is invalidated");
+  NS_TEST_ASSERT_MSG_NE (positions.GetPathData (b, d, 0), 0, "a static path is invalidated");
+  c->SetPosition (Vector (0, 20, 0));
+  NS_TEST_ASSERT_MSG_EQ (positions.GetPathData (a, c, 0), 0, "a moved path is kept");
+  NS_TEST_ASSERT_MSG_NE (positions.GetPathData (a, b, 0), 0, "a static path is invalidated");
+  d->SetVelocity (Vector (1, 0, 0));
+  NS_TEST_ASSERT_MSG_EQ (positions.GetPathData (b, d, 0), 0, "a moving path is kept");
+  positions.AddPathData (Create<PropagationCacheTestData> (8), b, d, 0);
+  NS_TEST_ASSERT_MSG_EQ (positions.GetPathData (b, d, 0), 0, "a moving path is kept");
+  NS_TEST_ASSERT_MSG_EQ (positions.GetSize (), 1, "the invalid paths are kept");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * PropagationCache test suite
+ */
+class PropagationCacheTestSuite : public TestSuite
+{
+public:
+  PropagationCacheTestSuite ();
+};
+
+PropagationCacheTestSuite::PropagationCacheTestSuite ()
+  : TestSuite ("propagation-cache", UNIT)
+{
+  AddTestCase (new PropagationCacheTestCase, TestCase::QUICK);
+}
+
+static PropagationCacheTestSuite g_propagationCacheTestSuite; //!< the test suite
@@ -23,6 +23,11 @@
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/okumura-hata-propagation-loss-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -436,6 +441,165 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class PropagationLossModelCacheTestCase : public TestCase
+{
+public:
+  PropagationLossModelCacheTestCase ();
+  virtual ~PropagationLossModelCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationLossModelCacheTestCase::PropagationLossModelCacheTestCase ()
+  : TestCase ("Test the cache of the deterministic propagation loss models")
+{
+}
+
+PropagationLossModelCacheTestCase::~PropagationLossModelCacheTestCase ()
+{
+}
+
+void
+PropagationLossModelCacheTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 30));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100, 0, 1.5));
+  Ptr<ConstantVelocityMobilityModel> c = CreateObject<ConstantVelocityMobilityModel> ();
+  c->SetPosition (Vector (0, 200, 1.5));
+  c->SetVelocity (Vector (1, 0, 0));
+
+  // a cached deterministic model followed by a random one
+  Ptr<LogDistancePropagationLossModel> reference = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<LogDistancePropagationLossModel> cached = CreateObject<LogDistancePropagationLossModel> ();
+  cached->SetAttribute ("CacheSize", UintegerValue (16));
+  Ptr<RandomPropagationLossModel> random = CreateObject<RandomPropagationLossModel> ();
+  random->SetAttribute ("Variable", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=10.0]"));
+  cached->SetNext (random);
+  random->SetAttribute ("CacheSize", UintegerValue (16));
+
+  double previous = 0;
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      double rx = cached->CalcRxPower (20, a, b);
+      double loss = 20 - reference->CalcRxPower (20, a, b);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (rx, 20 - loss, "wrong reception power");
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (rx, 20 - loss - 10, "wrong reception power");
+      NS_TEST_ASSERT_MSG_NE (rx, previous, "the random model is cached");
+      previous = rx;
+    }
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheMisses (), 1, "wrong number of cache misses");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheHits (), 9, "wrong number of cache hits");
+  NS_TEST_ASSERT_MSG_EQ (random->GetCacheHits () + random->GetCacheMisses (), 0, "the random model uses the cache");
+
+  // the other direction, for another transmission power
+  cached->SetNext (0);
+  double rx = cached->CalcRxPower (10, b, a);
+  NS_TEST_ASSERT_MSG_EQ (rx, reference->CalcRxPower (10, b, a), "wrong reception power for another power");
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (20, a, b), reference->CalcRxPower (20, a, b), "wrong cached power");
+
+  // a moved node
+  uint64_t misses = cached->GetCacheMisses ();
+  b->SetPosition (Vector (200, 0, 1.5));
+  NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (20, a, b), reference->CalcRxPower (20, a, b), "the path of a moved node is cached");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheMisses (), misses + 1, "the path of a moved node is cached");
+
+  // a moving node
+  misses = cached->GetCacheMisses ();
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (cached->CalcRxPower (20, a, c), reference->CalcRxPower (20, a, c), "wrong power for a moving node");
+    }
+  NS_TEST_ASSERT_MSG_EQ (cached->GetCacheMisses (), misses + 3, "the path of a moving node is cached");
+
+  // an asymmetric model
+  Ptr<OkumuraHataPropagationLossModel> hata = CreateObject<OkumuraHataPropagationLossModel> ();
+  Ptr<OkumuraHataPropagationLossModel> hataCached = CreateObject<OkumuraHataPropagationLossModel> ();
+  hataCached->SetAttribute ("CacheSize", UintegerValue (16));
+  b->SetPosition (Vector (2000, 0, 1.5));
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (hataCached->CalcRxPower (30, a, b), hata->CalcRxPower (30, a, b), "wrong power from a to b");
+      NS_TEST_ASSERT_MSG_EQ (hataCached->CalcRxPower (30, b, a), hata->CalcRxPower (30, b, a), "wrong power from b to a");
+    }
+  NS_TEST_ASSERT_MSG_EQ (hataCached->GetCacheHits (), 2, "wrong number of cache hits");
+  NS_TEST_ASSERT_MSG_EQ_TOL (hataCached->GetCacheHitRate (), 0.5, 1e-12, "wrong hit rate");
+
+  Simulator::Destroy ();
+}
+
+class JakesPropagationLossModelTestCase : public TestCase
+{
+public:
+  JakesPropagationLossModelTestCase ();
+  virtual ~JakesPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Evaluate the losses of the two models
+   * \param check whether to compare the losses
+   */
+  void Evaluate (bool check);
+
+  Ptr<MobilityModel> m_a; //!< the transmitter
+  Ptr<MobilityModel> m_b; //!< the receiver
+  Ptr<JakesPropagationLossModel> m_regular; //!< the model evaluated at a regular step
+  Ptr<JakesPropagationLossModel> m_irregular; //!< the model evaluated at irregular steps
+  uint32_t m_checks; //!< the number of losses compared
+};
+
+JakesPropagationLossModelTestCase::JakesPropagationLossModelTestCase ()
+  : TestCase ("Check that the incremental evaluation of the Jakes fading matches the direct one"),
+    m_checks (0)
+{
+}
+
+JakesPropagationLossModelTestCase::~JakesPropagationLossModelTestCase ()
+{
+}
+
+void
+JakesPropagationLossModelTestCase::Evaluate (bool check)
+{
+  double irregular = m_irregular->CalcRxPower (0, m_a, m_b);
+  if (check)
+    {
+      double regular = m_regular->CalcRxPower (0, m_a, m_b);
+      // a second evaluation at the same time returns the same gain
+      NS_TEST_ASSERT_MSG_EQ (m_regular->CalcRxPower (0, m_a, m_b), regular, "the gain changed at the same time");
+      NS_TEST_ASSERT_MSG_EQ_TOL (regular, irregular, 1e-6, "wrong gain at " << Simulator::Now ().GetSeconds ());
+      ++m_checks;
+    }
+}
+
+void
+JakesPropagationLossModelTestCase::DoRun (void)
+{
+  m_a = CreateObject<ConstantPositionMobilityModel> ();
+  m_b = CreateObject<ConstantPositionMobilityModel> ();
+  m_regular = CreateObject<JakesPropagationLossModel> ();
+  m_regular->AssignStreams (1);
+  m_irregular = CreateObject<JakesPropagationLossModel> ();
+  m_irregular->AssignStreams (1);
+
+  // The regular model is evaluated every ms, and its oscillators are
+  // rotated incrementally, the irregular one is evaluated in between too,
+  // and its oscillators are computed from the time at each evaluation.
+  // 3000 steps span more than the period of the recomputation.
+  for (uint32_t i = 0; i < 3000; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (i), &JakesPropagationLossModelTestCase::Evaluate, this, true);
+      Simulator::Schedule (MilliSeconds (i) + MicroSeconds (300 + (i % 7) * 50),
+                           &JakesPropagationLossModelTestCase::Evaluate, this, false);
+    }
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_checks, 3000, "wrong number of checks");
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +614,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationLossModelCacheTestCase, TestCase::QUICK);
+  AddTestCase (new JakesPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -0,0 +1,300 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Benchmark of the beamforming computations of the
+ * ThreeGppSpectrumPropagationLossModel.
+ *
+ * A number of static links between nodes with uniform planar arrays are
+ * created, and the rx PSD of every link is computed repeatedly, either
+ * changing the beamforming vectors at each iteration (long term component
+ * and beamforming gain) or keeping them fixed (beamforming gain only).
+ * The same computations are then performed by a reference implementation
+ * working on nested std::vector containers, as the channel matrix was
+ * stored before, to measure the speedup of the flat tensor layout.
+ * For instance:
+ *
+ * ./waf --run "three-gpp-channel-benchmark --antennaRows=8 --antennaColumns=8 --iterations=200"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/three-gpp-antenna-array-model.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/spectrum-value.h"
+
+#include <algorithm>
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE ("ThreeGppChannelBenchmark");
+
+using namespace ns3;
+
+/**
+ * Compute the rx PSD of a link with nested vector containers, as done by
+ * ThreeGppSpectrumPropagationLossModel before the channel matrix was
+ * stored as a flat tensor (static nodes, i.e., no Doppler term).
+ *
+ * \param h the channel matrix H[u][s][n]
+ * \param delay the cluster delays
+ * \param txPsd the tx PSD
+ * \param sW the beamforming vector of the s node
+ * \param uW the beamforming vector of the u node
+ * \return the rx PSD
+ */
+static Ptr<SpectrumValue>
+CalcReferenceRxPsd (const MatrixBasedChannelModel::Complex3DVector &h,
+                    const MatrixBasedChannelModel::DoubleVector &delay,
+                    Ptr<const SpectrumValue> txPsd,
+                    const ThreeGppAntennaArrayModel::ComplexVector &sW,
+                    const ThreeGppAntennaArrayModel::ComplexVector &uW)
+{
+  ThreeGppAntennaArrayModel::ComplexVector longTerm;
+  for (size_t cIndex = 0; cIndex < h[0][0].size (); cIndex++)
+    {
+      std::complex<double> txSum (0,0);
+      for (size_t sIndex = 0; sIndex < sW.size (); sIndex++)
+        {
+          std::complex<double> rxSum (0,0);
+          for (size_t uIndex = 0; uIndex < uW.size (); uIndex++)
+            {
+              rxSum = rxSum + uW[uIndex] * h[uIndex][sIndex][cIndex];
+            }
+          txSum = txSum + sW[sIndex] * rxSum;
+        }
+      longTerm.push_back (txSum);
+    }
+
+  Ptr<SpectrumValue> rxPsd = txPsd->Copy ();
+  auto sbit = rxPsd->ConstBandsBegin ();
+  for (auto vit = rxPsd->ValuesBegin (); vit != rxPsd->ValuesEnd (); ++vit, ++sbit)
+    {
+      std::complex<double> subsbandGain (0.0,0.0);
+      for (size_t cIndex = 0; cIndex < longTerm.size (); cIndex++)
+        {
+          double d = -2 * M_PI * sbit->fc * delay[cIndex];
+          subsbandGain = subsbandGain + longTerm[cIndex] * exp (std::complex<double> (0, d));
+        }
+      *vit = (*vit) * (norm (subsbandGain));
+    }
+  return rxPsd;
+}
+
+/**
+ * Random beamforming vector with unit norm
+ *
+ * \param n the number of antenna elements
+ * \param rv the random variable used to draw the phases
+ * \return the beamforming vector
+ */
+static ThreeGppAntennaArrayModel::ComplexVector
+RandomBeamformingVector (uint32_t n, Ptr<UniformRandomVariable> rv)
+{
+  ThreeGppAntennaArrayModel::ComplexVector w (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      w[i] = std::polar (1 / std::sqrt (n), rv->GetValue (-M_PI, M_PI));
+    }
+  return w;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nLinks = 10;
+  uint32_t antennaRows = 8;
+  uint32_t antennaColumns = 8;
+  uint32_t nRbs = 100;
+  uint32_t iterations = 100;
+  std::string scenario = "UMa";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nLinks", "Number of links", nLinks);
+  cmd.AddValue ("antennaRows", "Number of rows of the antenna arrays", antennaRows);
+  cmd.AddValue ("antennaColumns", "Number of columns of the antenna arrays", antennaColumns);
+  cmd.AddValue ("nRbs", "Number of 180 kHz sub-bands of the PSD", nRbs);
+  cmd.AddValue ("iterations", "Number of rx PSD computations per link", iterations);
+  cmd.AddValue ("scenario", "3GPP propagation scenario", scenario);
+  cmd.Parse (argc, argv);
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  // the channel matrices are generated only once
+  Config::SetDefault ("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue (MilliSeconds (0)));
+
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (2.1e9));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue (scenario));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (CreateObject<NeverLosChannelConditionModel> ()));
+
+  // tx PSD with nRbs uniformly spaced sub-bands
+  Bands bands;
+  for (uint32_t i = 0; i < nRbs; i++)
+    {
+      BandInfo band;
+      band.fc = 2.1e9 + (i - nRbs / 2.0) * 180e3;
+      band.fl = band.fc - 90e3;
+      band.fh = band.fc + 90e3;
+      bands.push_back (band);
+    }
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (Create<SpectrumModel> (bands));
+  *txPsd = 1e-9;
+
+  NodeContainer nodes;
+  nodes.Create (2 * nLinks);
+  std::vector<Ptr<MobilityModel> > mobility;
+  std::vector<Ptr<ThreeGppAntennaArrayModel> > antennas;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      nodes.Get (i)->AddDevice (dev);
+      dev->SetNode (nodes.Get (i));
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      // the links are along the x axis, 50 m long and 500 m apart
+      mob->SetPosition (Vector ((i % 2) * 50.0, (i / 2) * 500.0, (i % 2) ? 1.5 : 25.0));
+      nodes.Get (i)->AggregateObject (mob);
+      mobility.push_back (mob);
+      Ptr<ThreeGppAntennaArrayModel> antenna = CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumRows", UintegerValue (antennaRows),
+                                                                                                       "NumColumns", UintegerValue (antennaColumns));
+      lossModel->AddDevice (dev, antenna);
+      antennas.push_back (antenna);
+    }
+  uint32_t nElements = antennaRows * antennaColumns;
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetStream (1);
+
+  // generate the channels and copy them to nested vectors for the reference
+  Ptr<MatrixBasedChannelModel> channelModel = lossModel->GetChannelModel ();
+  std::vector<Ptr<const MatrixBasedChannelModel::ChannelMatrix> > channels;
+  std::vector<MatrixBasedChannelModel::Complex3DVector> nestedChannels;
+  std::vector<MatrixBasedChannelModel::DoubleVector> nestedDelays;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t l = 0; l < nLinks; l++)
+    {
+      channels.push_back (channelModel->GetChannel (mobility[2 * l], mobility[2 * l + 1], antennas[2 * l], antennas[2 * l + 1]));
+    }
+  int64_t generationMs = clock.End ();
+  for (uint32_t l = 0; l < nLinks; l++)
+    {
+      const MatrixBasedChannelModel::ComplexTensor3D &h = channels[l]->m_channel;
+      MatrixBasedChannelModel::Complex3DVector nested (h.GetSize (0), MatrixBasedChannelModel::Complex2DVector (h.GetSize (1), ThreeGppAntennaArrayModel::ComplexVector (h.GetSize (2))));
+      for (size_t u = 0; u < h.GetSize (0); u++)
+        {
+          for (size_t s = 0; s < h.GetSize (1); s++)
+            {
+              for (size_t n = 0; n < h.GetSize (2); n++)
+                {
+                  nested[u][s][n] = h (u, s, n);
+                }
+            }
+        }
+      nestedChannels.push_back (nested);
+      nestedDelays.push_back (MatrixBasedChannelModel::DoubleVector (channels[l]->m_delay.begin (), channels[l]->m_delay.end ()));
+    }
+
+  // beamforming vectors, one set per iteration
+  std::vector<std::vector<ThreeGppAntennaArrayModel::ComplexVector> > weights (iterations);
+  for (uint32_t it = 0; it < iterations; it++)
+    {
+      for (uint32_t i = 0; i < nodes.GetN (); i++)
+        {
+          weights[it].push_back (RandomBeamformingVector (nElements, rv));
+        }
+    }
+
+  double checksum = 0;
+  double maxRelativeError = 0;
+
+  // 1) new beamforming vectors at every iteration: long term and beamforming gain
+  clock.Start ();
+  for (uint32_t it = 0; it < iterations; it++)
+    {
+      for (uint32_t i = 0; i < nodes.GetN (); i++)
+        {
+          antennas[i]->SetBeamformingVector (weights[it][i]);
+        }
+      for (uint32_t l = 0; l < nLinks; l++)
+        {
+          checksum += Sum (*lossModel->CalcRxPowerSpectralDensity (txPsd, mobility[2 * l], mobility[2 * l + 1]));
+        }
+    }
+  int64_t longTermMs = clock.End ();
+
+  // 2) fixed beamforming vectors: beamforming gain only
+  clock.Start ();
+  for (uint32_t it = 0; it < iterations; it++)
+    {
+      for (uint32_t l = 0; l < nLinks; l++)
+        {
+          checksum += Sum (*lossModel->CalcRxPowerSpectralDensity (txPsd, mobility[2 * l], mobility[2 * l + 1]));
+        }
+    }
+  int64_t gainMs = clock.End ();
+
+  // 3) reference implementation, new beamforming vectors at every iteration
+  double referenceChecksum = 0;
+  clock.Start ();
+  for (uint32_t it = 0; it < iterations; it++)
+    {
+      for (uint32_t l = 0; l < nLinks; l++)
+        {
+          uint32_t s = 2 * l;
+          uint32_t u = 2 * l + 1;
+          if (channels[l]->IsReverse (nodes.Get (s)->GetId (), nodes.Get (u)->GetId ()))
+            {
+              std::swap (s, u);
+            }
+          referenceChecksum += Sum (*CalcReferenceRxPsd (nestedChannels[l], nestedDelays[l], txPsd, weights[it][s], weights[it][u]));
+        }
+    }
+  int64_t referenceMs = clock.End ();
+
+  // check the results of the last iteration of 1) against the reference
+  for (uint32_t l = 0; l < nLinks; l++)
+    {
+      uint32_t s = 2 * l;
+      uint32_t u = 2 * l + 1;
+      if (channels[l]->IsReverse (nodes.Get (s)->GetId (), nodes.Get (u)->GetId ()))
+        {
+          std::swap (s, u);
+        }
+      Ptr<SpectrumValue> ref = CalcReferenceRxPsd (nestedChannels[l], nestedDelays[l], txPsd, weights[iterations - 1][s], weights[iterations - 1][u]);
+      Ptr<SpectrumValue> rx = lossModel->CalcRxPowerSpectralDensity (txPsd, mobility[2 * l], mobility[2 * l + 1]);
+      for (uint32_t i = 0; i < nRbs; i++)
+        {
+          maxRelativeError = std::max (maxRelativeError, std::abs ((*rx)[i] - (*ref)[i]) / (*ref)[i]);
+        }
+    }
+
+  std::cout << "links " << nLinks << " elements " << nElements << "x" << nElements
+            << " clusters " << channels[0]->m_channel.GetSize (2) << " sub-bands " << nRbs << std::endl
+            << "channel generation: " << generationMs << " ms" << std::endl
+            << "long term + gain: " << longTermMs << " ms" << std::endl
+            << "gain only: " << gainMs << " ms" << std::endl
+            << "reference long term + gain: " << referenceMs << " ms"
+            << " (speedup " << (longTermMs > 0 ? static_cast<double> (referenceMs) / longTermMs : 0) << ")" << std::endl
+            << "max relative error " << maxRelativeError << " checksum " << checksum + referenceChecksum << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
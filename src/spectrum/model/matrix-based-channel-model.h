@@ -28,6 +28,9 @@
 #include <ns3/vector.h>
 #include <ns3/three-gpp-antenna-array-model.h>
 #include <tuple>
+#include <vector>
+#include <new>
+#include <cstdint>
 
 namespace ns3 {
 
@@ -54,15 +57,276 @@ public:
   typedef std::vector<ThreeGppAntennaArrayModel::ComplexVector> Complex2DVector; //!< type definition for complex matrices
   typedef std::vector<Complex2DVector> Complex3DVector; //!< type definition for complex 3D matrices
 
+  /**
+   * Minimal allocator returning blocks aligned to ALIGNMENT bytes, so that
+   * the rows of the tensors below start on a SIMD register boundary.
+   */
+  template <typename T>
+  struct AlignedAllocator
+  {
+    typedef T value_type; //!< allocated type
+    static const std::size_t ALIGNMENT = 64; //!< alignment in bytes
+
+    AlignedAllocator () = default;
+    /**
+     * Converting constructor
+     */
+    template <typename U>
+    AlignedAllocator (const AlignedAllocator<U> &)
+    {}
+    /**
+     * Allocate an aligned block
+     * \param n the number of elements
+     * \return the block
+     */
+    T * allocate (std::size_t n)
+    {
+      // keep the address returned by operator new just before the block
+      std::size_t bytes = n * sizeof (T) + ALIGNMENT + sizeof (void *);
+      char *raw = static_cast<char *> (::operator new (bytes));
+      std::uintptr_t addr = reinterpret_cast<std::uintptr_t> (raw + sizeof (void *));
+      addr = (addr + ALIGNMENT - 1) & ~(static_cast<std::uintptr_t> (ALIGNMENT) - 1);
+      reinterpret_cast<void **> (addr)[-1] = raw;
+      return reinterpret_cast<T *> (addr);
+    }
+    /**
+     * Free a block returned by allocate
+     * \param p the block
+     */
+    void deallocate (T *p, std::size_t)
+    {
+      ::operator delete (reinterpret_cast<void **> (p)[-1]);
+    }
+    /**
+     * \return true, all the instances are interchangeable
+     */
+    template <typename U>
+    bool operator== (const AlignedAllocator<U> &) const
+    {
+      return true;
+    }
+    /**
+     * \return false, all the instances are interchangeable
+     */
+    template <typename U>
+    bool operator!= (const AlignedAllocator<U> &) const
+    {
+      return false;
+    }
+  };
+
+  typedef std::vector<double, AlignedAllocator<double> > AlignedDoubleVector; //!< type definition for aligned vectors of doubles
+
+  /**
+   * Number of doubles in an alignment block of AlignedAllocator
+   * \param n the number of elements of a row
+   * \return n rounded up to a multiple of the alignment
+   */
+  static constexpr std::size_t GetPaddedSize (std::size_t n)
+  {
+    return (n + AlignedAllocator<double>::ALIGNMENT / sizeof (double) - 1)
+           / (AlignedAllocator<double>::ALIGNMENT / sizeof (double))
+           * (AlignedAllocator<double>::ALIGNMENT / sizeof (double));
+  }
+
+  /**
+   * Dense 3D array of complex values X(i, j, k), stored as two contiguous
+   * planes with the real and the imaginary parts.
+   *
+   * The first index runs fastest: the element (i, j, k) is at offset
+   * i + j * GetStride (1) + k * GetStride (2) of both planes, and every
+   * row X(:, j, k) starts on an alignment boundary. Loops over the first
+   * index, e.g., over the receive antenna elements of a channel matrix,
+   * thus access contiguous memory with no complex arithmetic library calls
+   * and can be vectorized by the compiler.
+   */
+  class ComplexTensor3D
+  {
+  public:
+    ComplexTensor3D ()
+      : m_size {0, 0, 0},
+        m_stride {0, 0, 0}
+    {}
+    /**
+     * Create a tensor of zeros
+     * \param n0 size of the first dimension
+     * \param n1 size of the second dimension
+     * \param n2 size of the third dimension
+     */
+    ComplexTensor3D (std::size_t n0, std::size_t n1, std::size_t n2)
+      : m_size {n0, n1, n2},
+        m_stride {1, GetPaddedSize (n0), GetPaddedSize (n0) * n1},
+        m_real (GetPaddedSize (n0) * n1 * n2, 0.0),
+        m_imag (GetPaddedSize (n0) * n1 * n2, 0.0)
+    {}
+    /**
+     * \param dim the dimension (0, 1 or 2)
+     * \return the size of the dimension
+     */
+    std::size_t GetSize (uint8_t dim) const
+    {
+      return m_size[dim];
+    }
+    /**
+     * \param dim the dimension (0, 1 or 2)
+     * \return the distance, in elements, between two consecutive values of the index of the dimension
+     */
+    std::size_t GetStride (uint8_t dim) const
+    {
+      return m_stride[dim];
+    }
+    /**
+     * \param i first index
+     * \param j second index
+     * \param k third index
+     * \return the element (i, j, k)
+     */
+    std::complex<double> operator() (std::size_t i, std::size_t j, std::size_t k) const
+    {
+      std::size_t o = Offset (i, j, k);
+      return std::complex<double> (m_real[o], m_imag[o]);
+    }
+    /**
+     * Set the element (i, j, k)
+     * \param i first index
+     * \param j second index
+     * \param k third index
+     * \param value the value
+     */
+    void Set (std::size_t i, std::size_t j, std::size_t k, std::complex<double> value)
+    {
+      std::size_t o = Offset (i, j, k);
+      m_real[o] = value.real ();
+      m_imag[o] = value.imag ();
+    }
+    /**
+     * \param j second index
+     * \param k third index
+     * \return the real parts of the row X(:, j, k)
+     */
+    const double * GetRealRow (std::size_t j, std::size_t k) const
+    {
+      return m_real.data () + Offset (0, j, k);
+    }
+    /**
+     * \param j second index
+     * \param k third index
+     * \return the imaginary parts of the row X(:, j, k)
+     */
+    const double * GetImagRow (std::size_t j, std::size_t k) const
+    {
+      return m_imag.data () + Offset (0, j, k);
+    }
+
+  private:
+    /**
+     * \param i first index
+     * \param j second index
+     * \param k third index
+     * \return the offset of the element (i, j, k) in the planes
+     */
+    std::size_t Offset (std::size_t i, std::size_t j, std::size_t k) const
+    {
+      NS_ASSERT (i < m_size[0] && j < m_size[1] && k < m_size[2]);
+      return i + j * m_stride[1] + k * m_stride[2];
+    }
+
+    std::size_t m_size[3]; //!< size of each dimension
+    std::size_t m_stride[3]; //!< stride of each dimension
+    AlignedDoubleVector m_real; //!< real parts
+    AlignedDoubleVector m_imag; //!< imaginary parts
+  };
+
+  /**
+   * Dense 2D array of doubles X(i, j), stored row by row with every row
+   * starting on an alignment boundary, i.e., the element (i, j) is at
+   * offset i * GetStride () + j.
+   */
+  class DoubleTensor2D
+  {
+  public:
+    DoubleTensor2D ()
+      : m_rows (0),
+        m_cols (0),
+        m_stride (0)
+    {}
+    /**
+     * Create a tensor of zeros
+     * \param rows number of rows
+     * \param cols number of columns
+     */
+    DoubleTensor2D (std::size_t rows, std::size_t cols)
+      : m_rows (rows),
+        m_cols (cols),
+        m_stride (GetPaddedSize (cols)),
+        m_data (rows * GetPaddedSize (cols), 0.0)
+    {}
+    /**
+     * \return the number of rows
+     */
+    std::size_t GetNRows () const
+    {
+      return m_rows;
+    }
+    /**
+     * \return the number of columns
+     */
+    std::size_t GetNCols () const
+    {
+      return m_cols;
+    }
+    /**
+     * \return the distance, in elements, between two consecutive rows
+     */
+    std::size_t GetStride () const
+    {
+      return m_stride;
+    }
+    /**
+     * \param i the row
+     * \param j the column
+     * \return the element (i, j)
+     */
+    double operator() (std::size_t i, std::size_t j) const
+    {
+      NS_ASSERT (i < m_rows && j < m_cols);
+      return m_data[i * m_stride + j];
+    }
+    /**
+     * \param i the row
+     * \param j the column
+     * \return a reference to the element (i, j)
+     */
+    double & operator() (std::size_t i, std::size_t j)
+    {
+      NS_ASSERT (i < m_rows && j < m_cols);
+      return m_data[i * m_stride + j];
+    }
+    /**
+     * \param i the row
+     * \return the elements of the row
+     */
+    const double * GetRow (std::size_t i) const
+    {
+      return m_data.data () + i * m_stride;
+    }
+
+  private:
+    std::size_t m_rows; //!< number of rows
+    std::size_t m_cols; //!< number of columns
+    std::size_t m_stride; //!< row stride
+    AlignedDoubleVector m_data; //!< the elements
+  };
+
 
   /**
    * Data structure that stores a channel realization
    */
   struct ChannelMatrix : public SimpleRefCount<ChannelMatrix>
   {
-    Complex3DVector    m_channel; //!< channel matrix H[u][s][n].
-    DoubleVector       m_delay; //!< cluster delay in nanoseconds.
-    Double2DVector     m_angle; //!< cluster angle angle[direction][n], where direction = 0(AOA), 1(ZOA), 2(AOD), 3(ZOD) in degree.
+    ComplexTensor3D    m_channel; //!< channel matrix H(u, s, n).
+    AlignedDoubleVector m_delay; //!< cluster delay in nanoseconds.
+    DoubleTensor2D     m_angle; //!< cluster angle angle(direction, n), where direction = 0(AOA), 1(ZOA), 2(AOD), 3(ZOD) in degree.
     Time               m_generatedTime; //!< generation time
     std::pair<uint32_t, uint32_t> m_nodeIds; //!< the first element is the s-node ID (the transmitter when the channel was generated), the second element is the u-node ID (the receiver when the channel was generated)
 
@@ -126,6 +390,7 @@ public:
   static const uint8_t ZOA_INDEX = 1; //!< index of the ZOA value in the m_angle array
   static const uint8_t AOD_INDEX = 2; //!< index of the AOD value in the m_angle array
   static const uint8_t ZOD_INDEX = 3; //!< index of the ZOD value in the m_angle array
+  static const uint8_t NUM_ANGLES = 4; //!< number of rows of the m_angle array
 
 };
 
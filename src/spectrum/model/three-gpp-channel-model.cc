@@ -33,6 +33,10 @@
 #include <ns3/simulator.h>
 #include "ns3/mobility-model.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/hash.h"
+#include "ns3/rng-seed-manager.h"
 
 namespace ns3 {
 
@@ -161,6 +165,10 @@ static const double sqrtC_office_NLOS[6][6] = {
 };
 
 ThreeGppChannelModel::ThreeGppChannelModel ()
+  : m_maxMemory (0),
+    m_memory (0),
+    m_backgroundUpdate (false),
+    m_updateThreads (0)
 {
   NS_LOG_FUNCTION (this);
   m_uniformRv = CreateObject<UniformRandomVariable> ();
@@ -179,7 +187,13 @@ ThreeGppChannelModel::~ThreeGppChannelModel ()
 void
 ThreeGppChannelModel::DoDispose ()
 {
+  m_updateEvent.Cancel ();
+  m_updateQueue.clear ();
+  m_batch.clear ();
+  m_pool = nullptr;
   m_channelMap.clear ();
+  m_lruList.clear ();
+  m_memory = 0;
   m_channelConditionModel->Dispose ();
   m_channelConditionModel = nullptr;
 }
@@ -236,6 +250,25 @@ ThreeGppChannelModel::GetTypeId (void)
                    DoubleValue (1),
                    MakeDoubleAccessor (&ThreeGppChannelModel::m_blockerSpeed),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("BackgroundUpdate",
+                   "If true, and UpdatePeriod is not zero, the channel matrices of the links used "
+                   "during their coherence time are regenerated in batches when it expires, "
+                   "using per-link random streams",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ThreeGppChannelModel::m_backgroundUpdate),
+                   MakeBooleanChecker ())
+    .AddAttribute ("UpdateThreads",
+                   "Number of worker threads generating the channel matrices of the background "
+                   "updates, in addition to the simulation thread",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::m_updateThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxMemory",
+                   "Memory budget for the stored channel matrices, in bytes; when exceeded, "
+                   "the least recently used ones are discarded (0 means no limit)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::m_maxMemory),
+                   MakeUintegerChecker<uint64_t> ())
     ;
   return tid;
 }
@@ -756,18 +789,20 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   // retrieve the channel condition
   Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (aMob, bMob);
   bool los = (condition->GetLosCondition () == ChannelCondition::LosConditionValue::LOS);
-  bool o2i = false; // TODO include the o2i condition in the channel condition model
 
   // Check if the channel is present in the map and return it, otherwise
   // generate a new channel
   bool update = false;
   bool notFound = false;
   Ptr<ThreeGppChannelMatrix> channelMatrix;
-  if (m_channelMap.find (channelId) != m_channelMap.end ())
+  auto it = m_channelMap.find (channelId);
+  if (it != m_channelMap.end ())
     {
       // channel matrix present in the map
       NS_LOG_DEBUG ("channel matrix present in the map");
-      channelMatrix = m_channelMap[channelId];
+      channelMatrix = it->second.m_channel;
+      it->second.m_lastAccess = Simulator::Now ();
+      m_lruList.splice (m_lruList.begin (), m_lruList, it->second.m_lruIt);
 
       // check if it has to be updated
       update = ChannelMatrixNeedsUpdate (channelMatrix, los);
@@ -783,40 +818,247 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   if (notFound || update)
     {
       // channel matrix not found or has to be updated, generate a new one
-      Angles txAngle (bMob->GetPosition (), aMob->GetPosition ());
-      Angles rxAngle (aMob->GetPosition (), bMob->GetPosition ());
+      ChannelRequest request;
+      request.m_channelId = channelId;
+      request.m_aMob = aMob;
+      request.m_bMob = bMob;
+      request.m_aAntenna = aAntenna;
+      request.m_bAntenna = bAntenna;
+      PrepareChannelRequest (request, los);
+      GenerateChannel (request);
 
-      double x = aMob->GetPosition ().x - bMob->GetPosition ().x;
-      double y = aMob->GetPosition ().y - bMob->GetPosition ().y;
-      double distance2D = sqrt (x * x + y * y);
+      // store or replace the channel matrix in the channel map
+      StoreChannel (request);
+      channelMatrix = request.m_channel;
+  }
 
-      // NOTE we assume hUT = min (height(a), height(b)) and
-      // hBS = max (height (a), height (b))
-      double hUt = std::min (aMob->GetPosition ().z, bMob->GetPosition ().z);
-      double hBs = std::max (aMob->GetPosition ().z, bMob->GetPosition ().z);
+  return channelMatrix;
+}
 
-      // TODO this is not currently used, it is needed for the computation of the
-      // additional blockage in case of spatial consistent update
-      // I do not know who is the UT, I can use the relative distance between
-      // tx and rx instead
-      Vector locUt = Vector (0.0, 0.0, 0.0);
+void
+ThreeGppChannelModel::PrepareChannelRequest (ChannelRequest &request, bool los)
+{
+  NS_LOG_FUNCTION (this << request.m_channelId << los);
 
-      channelMatrix = GetNewChannel (locUt, los, o2i, aAntenna, bAntenna, rxAngle, txAngle, distance2D, hBs, hUt);
-      channelMatrix->m_nodeIds = std::make_pair (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
+  Vector aPos = request.m_aMob->GetPosition ();
+  Vector bPos = request.m_bMob->GetPosition ();
+  request.m_los = los;
+  request.m_txAngle = Angles (bPos, aPos);
+  request.m_rxAngle = Angles (aPos, bPos);
 
-      // store or replace the channel matrix in the channel map
-      m_channelMap[channelId] = channelMatrix;
-  }
+  double x = aPos.x - bPos.x;
+  double y = aPos.y - bPos.y;
+  request.m_distance2D = sqrt (x * x + y * y);
 
-  return channelMatrix;
+  // NOTE we assume hUT = min (height(a), height(b)) and
+  // hBS = max (height (a), height (b))
+  request.m_hUt = std::min (aPos.z, bPos.z);
+  request.m_hBs = std::max (aPos.z, bPos.z);
+
+  if (m_backgroundUpdate)
+    {
+      // draw the values from substreams of the model streams depending
+      // only on the link and on the generation time, so that the channel
+      // matrices do not depend on the order in which they are generated
+      uint64_t key[3] = {RngSeedManager::GetRun (), request.m_channelId,
+                         static_cast<uint64_t> (Simulator::Now ().GetTimeStep ())};
+      uint64_t substream = Hash64 (reinterpret_cast<const char *> (key), sizeof (key)) & ((1ULL << 51) - 1);
+      request.m_rv.m_normal = CreateObject<NormalRandomVariable> ();
+      request.m_rv.m_normal->SetSubstream (m_normalRv, substream);
+      request.m_rv.m_uniform = CreateObject<UniformRandomVariable> ();
+      request.m_rv.m_uniform->SetSubstream (m_uniformRv, substream);
+      request.m_rv.m_shuffle = CreateObject<UniformRandomVariable> ();
+      request.m_rv.m_shuffle->SetSubstream (m_uniformRvShuffle, substream);
+    }
+  else
+    {
+      request.m_rv.m_normal = m_normalRv;
+      request.m_rv.m_uniform = m_uniformRv;
+      request.m_rv.m_shuffle = m_uniformRvShuffle;
+    }
+}
+
+void
+ThreeGppChannelModel::GenerateChannel (ChannelRequest &request) const
+{
+  bool o2i = false; // TODO include the o2i condition in the channel condition model
+
+  // TODO this is not currently used, it is needed for the computation of the
+  // additional blockage in case of spatial consistent update
+  // I do not know who is the UT, I can use the relative distance between
+  // tx and rx instead
+  Vector locUt = Vector (0.0, 0.0, 0.0);
+
+  request.m_channel = GetNewChannel (locUt, request.m_los, o2i, request.m_aAntenna, request.m_bAntenna,
+                                     request.m_rxAngle, request.m_txAngle,
+                                     request.m_distance2D, request.m_hBs, request.m_hUt, request.m_rv);
+}
+
+void
+ThreeGppChannelModel::GenerateBatchChannel (uint32_t i)
+{
+  GenerateChannel (m_batch[i]);
+}
+
+void
+ThreeGppChannelModel::StoreChannel (const ChannelRequest &request)
+{
+  NS_LOG_FUNCTION (this << request.m_channelId);
+
+  Ptr<ThreeGppChannelMatrix> channelMatrix = request.m_channel;
+  channelMatrix->m_nodeIds = std::make_pair (request.m_aMob->GetObject<Node> ()->GetId (), request.m_bMob->GetObject<Node> ()->GetId ());
+
+  auto it = m_channelMap.find (request.m_channelId);
+  if (it == m_channelMap.end ())
+    {
+      ChannelMapEntry entry;
+      entry.m_memory = 0;
+      entry.m_lastAccess = Simulator::Now ();
+      m_lruList.push_front (request.m_channelId);
+      entry.m_lruIt = m_lruList.begin ();
+      it = m_channelMap.insert (std::make_pair (request.m_channelId, entry)).first;
+    }
+  ChannelMapEntry &entry = it->second;
+  entry.m_channel = channelMatrix;
+  entry.m_aMob = request.m_aMob;
+  entry.m_bMob = request.m_bMob;
+  entry.m_aAntenna = request.m_aAntenna;
+  entry.m_bAntenna = request.m_bAntenna;
+  m_memory -= entry.m_memory;
+  entry.m_memory = GetMemorySize (channelMatrix);
+  m_memory += entry.m_memory;
+
+  if (m_backgroundUpdate && !m_updatePeriod.IsZero ())
+    {
+      ScheduleChannelUpdate (request.m_channelId, channelMatrix->m_generatedTime + m_updatePeriod);
+    }
+
+  // discard the least recently used channel matrices, except the new one
+  while (m_maxMemory > 0 && m_memory > m_maxMemory && m_lruList.back () != request.m_channelId)
+    {
+      auto victim = m_channelMap.find (m_lruList.back ());
+      NS_LOG_DEBUG ("discard the channel matrix " << victim->first);
+      m_memory -= victim->second.m_memory;
+      m_channelMap.erase (victim);
+      m_lruList.pop_back ();
+    }
+}
+
+void
+ThreeGppChannelModel::ScheduleChannelUpdate (uint32_t channelId, Time expiry)
+{
+  NS_LOG_FUNCTION (this << channelId << expiry);
+  m_updateQueue[expiry].push_back (channelId);
+  Time first = m_updateQueue.begin ()->first;
+  if (!m_updateEvent.IsRunning () || first < Simulator::Now () + Simulator::GetDelayLeft (m_updateEvent))
+    {
+      m_updateEvent.Cancel ();
+      m_updateEvent = Simulator::Schedule (first - Simulator::Now (), &ThreeGppChannelModel::UpdateChannels, this);
+    }
+}
+
+void
+ThreeGppChannelModel::UpdateChannels (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_updateQueue.empty () && m_updateQueue.begin ()->first == Simulator::Now ());
+  std::vector<uint32_t> channelIds;
+  channelIds.swap (m_updateQueue.begin ()->second);
+  m_updateQueue.erase (m_updateQueue.begin ());
+
+  // select the links used during the coherence time that expires now,
+  // whose channel matrix has been neither regenerated nor discarded
+  NS_ASSERT (m_batch.empty ());
+  for (uint32_t channelId : channelIds)
+    {
+      auto it = m_channelMap.find (channelId);
+      if (it == m_channelMap.end ())
+        {
+          continue;
+        }
+      const ChannelMapEntry &entry = it->second;
+      if (entry.m_channel->m_generatedTime + m_updatePeriod != Simulator::Now ()
+          || entry.m_lastAccess <= entry.m_channel->m_generatedTime)
+        {
+          continue;
+        }
+      ChannelRequest request;
+      request.m_channelId = channelId;
+      request.m_aMob = entry.m_aMob;
+      request.m_bMob = entry.m_bMob;
+      request.m_aAntenna = entry.m_aAntenna;
+      request.m_bAntenna = entry.m_bAntenna;
+      Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (entry.m_aMob, entry.m_bMob);
+      PrepareChannelRequest (request, condition->GetLosCondition () == ChannelCondition::LosConditionValue::LOS);
+      m_batch.push_back (request);
+    }
+  NS_LOG_DEBUG ("update " << m_batch.size () << " of " << channelIds.size () << " channel matrices");
+
+  if (!m_batch.empty ())
+    {
+      if (m_pool == nullptr)
+        {
+          m_pool = Create<WorkerPool> (m_updateThreads);
+        }
+      m_pool->Run (m_batch.size (), MakeCallback (&ThreeGppChannelModel::GenerateBatchChannel, this));
+      for (const ChannelRequest &request : m_batch)
+        {
+          // the channel matrix may have been discarded by StoreChannel
+          if (m_channelMap.find (request.m_channelId) != m_channelMap.end ())
+            {
+              StoreChannel (request);
+            }
+        }
+      m_batch.clear ();
+    }
+
+  if (!m_updateQueue.empty () && !m_updateEvent.IsRunning ())
+    {
+      m_updateEvent = Simulator::Schedule (m_updateQueue.begin ()->first - Simulator::Now (), &ThreeGppChannelModel::UpdateChannels, this);
+    }
+}
+
+uint64_t
+ThreeGppChannelModel::GetMemorySize (Ptr<const ThreeGppChannelMatrix> channel)
+{
+  const ComplexTensor3D &h = channel->m_channel;
+  uint64_t size = sizeof (ThreeGppChannelMatrix) + sizeof (ChannelMapEntry);
+  size += 2 * h.GetStride (2) * h.GetSize (2) * sizeof (double);
+  size += channel->m_delay.capacity () * sizeof (double);
+  size += channel->m_angle.GetNRows () * channel->m_angle.GetStride () * sizeof (double);
+  for (const Double2DVector &cluster : channel->m_clusterPhase)
+    {
+      for (const DoubleVector &ray : cluster)
+        {
+          size += sizeof (ray) + ray.capacity () * sizeof (double);
+        }
+    }
+  for (const DoubleVector &blocker : channel->m_nonSelfBlocking)
+    {
+      size += sizeof (blocker) + blocker.capacity () * sizeof (double);
+    }
+  return size;
+}
+
+std::size_t
+ThreeGppChannelModel::GetNChannels (void) const
+{
+  return m_channelMap.size ();
+}
+
+uint64_t
+ThreeGppChannelModel::GetChannelMemory (void) const
+{
+  return m_memory;
 }
 
 Ptr<ThreeGppChannelModel::ThreeGppChannelMatrix>
 ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
-                                     Ptr<const ThreeGppAntennaArrayModel> sAntenna,
-                                     Ptr<const ThreeGppAntennaArrayModel> uAntenna,
+                                     const Ptr<const ThreeGppAntennaArrayModel> &sAntenna,
+                                     const Ptr<const ThreeGppAntennaArrayModel> &uAntenna,
                                      Angles &uAngle, Angles &sAngle,
-                                     double dis2D, double hBS, double hUT) const
+                                     double dis2D, double hBS, double hUT,
+                                     const ChannelRandomVariables &rv) const
 {
   NS_LOG_FUNCTION (this);
 
@@ -852,7 +1094,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   //Generate paramNum independent LSPs.
   for (uint8_t iter = 0; iter < paramNum; iter++)
     {
-      LSPsIndep.push_back (m_normalRv->GetValue ());
+      LSPsIndep.push_back (rv.m_normal->GetValue ());
     }
   for (uint8_t row = 0; row < paramNum; row++)
     {
@@ -900,7 +1142,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   double minTau = 100.0;
   for (uint8_t cIndex = 0; cIndex < numOfCluster; cIndex++)
     {
-      double tau = -1*table3gpp->m_rTau*DS*log (m_uniformRv->GetValue (0,1)); //(7.5-1)
+      double tau = -1*table3gpp->m_rTau*DS*log (rv.m_uniform->GetValue (0,1)); //(7.5-1)
       if (minTau > tau)
         {
           minTau = tau;
@@ -923,7 +1165,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   for (uint8_t cIndex = 0; cIndex < numOfCluster; cIndex++)
     {
       double power = exp (-1 * clusterDelay[cIndex] * (table3gpp->m_rTau - 1) / table3gpp->m_rTau / DS) *
-        pow (10,-1 * m_normalRv->GetValue () * table3gpp->m_perClusterShadowingStd / 10);                       //(7.5-5)
+        pow (10,-1 * rv.m_normal->GetValue () * table3gpp->m_perClusterShadowingStd / 10);                       //(7.5-5)
       powerSum += power;
       clusterPower.push_back (power);
     }
@@ -1102,21 +1344,21 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   for (uint8_t cIndex = 0; cIndex < numReducedCluster; cIndex++)
     {
       int Xn = 1;
-      if (m_uniformRv->GetValue (0,1) < 0.5)
+      if (rv.m_uniform->GetValue (0,1) < 0.5)
         {
           Xn = -1;
         }
-      clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (m_normalRv->GetValue () * ASA / 7) + uAngle.phi * 180 / M_PI;        //(7.5-11)
-      clusterAod[cIndex] = clusterAod[cIndex] * Xn + (m_normalRv->GetValue () * ASD / 7) + sAngle.phi * 180 / M_PI;
+      clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (rv.m_normal->GetValue () * ASA / 7) + uAngle.phi * 180 / M_PI;        //(7.5-11)
+      clusterAod[cIndex] = clusterAod[cIndex] * Xn + (rv.m_normal->GetValue () * ASD / 7) + sAngle.phi * 180 / M_PI;
       if (o2i)
         {
-          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue () * ZSA / 7) + 90;            //(7.5-16)
+          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (rv.m_normal->GetValue () * ZSA / 7) + 90;            //(7.5-16)
         }
       else
         {
-          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue () * ZSA / 7) + uAngle.theta * 180 / M_PI;            //(7.5-16)
+          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (rv.m_normal->GetValue () * ZSA / 7) + uAngle.theta * 180 / M_PI;            //(7.5-16)
         }
-      clusterZod[cIndex] = clusterZod[cIndex] * Xn + (m_normalRv->GetValue () * ZSD / 7) + sAngle.theta * 180 / M_PI + table3gpp->m_offsetZOD;        //(7.5-19)
+      clusterZod[cIndex] = clusterZod[cIndex] * Xn + (rv.m_normal->GetValue () * ZSD / 7) + sAngle.theta * 180 / M_PI + table3gpp->m_offsetZOD;        //(7.5-19)
 
     }
 
@@ -1278,7 +1520,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   DoubleVector attenuation_dB;
   if (m_blockage)
     {
-      attenuation_dB = CalcAttenuationOfBlockage (channelParams, clusterAoa, clusterZoa);
+      attenuation_dB = CalcAttenuationOfBlockage (channelParams, clusterAoa, clusterZoa, rv);
       for (uint8_t cInd = 0; cInd < numReducedCluster; cInd++)
         {
           clusterPower[cInd] = clusterPower[cInd] / pow (10,attenuation_dB[cInd] / 10);
@@ -1293,10 +1535,10 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
   //shuffle all the arrays to perform random coupling
   for (uint8_t cIndex = 0; cIndex < numReducedCluster; cIndex++)
     {
-      Shuffle (&rayAod_radian[cIndex][0], &rayAod_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayAoa_radian[cIndex][0], &rayAoa_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayZod_radian[cIndex][0], &rayZod_radian[cIndex][raysPerCluster]);
-      Shuffle (&rayZoa_radian[cIndex][0], &rayZoa_radian[cIndex][raysPerCluster]);
+      Shuffle (&rayAod_radian[cIndex][0], &rayAod_radian[cIndex][raysPerCluster], rv);
+      Shuffle (&rayAoa_radian[cIndex][0], &rayAoa_radian[cIndex][raysPerCluster], rv);
+      Shuffle (&rayZod_radian[cIndex][0], &rayZod_radian[cIndex][raysPerCluster], rv);
+      Shuffle (&rayZoa_radian[cIndex][0], &rayZoa_radian[cIndex][raysPerCluster], rv);
     }
 
   //Step 9: Generate the cross polarization power ratios
@@ -1312,11 +1554,11 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
           double uXprLinear = pow (10, table3gpp->m_uXpr / 10); // convert to linear
           double sigXprLinear = pow (10, table3gpp->m_sigXpr / 10); // convert to linear
 
-          temp.push_back (std::pow (10, (m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10));
+          temp.push_back (std::pow (10, (rv.m_normal->GetValue () * sigXprLinear + uXprLinear) / 10));
           DoubleVector temp3; // used to store the PHI valuse
           for (uint8_t pInd = 0; pInd < 4; pInd++)
             {
-              temp3.push_back (m_uniformRv->GetValue (-1 * M_PI, M_PI));
+              temp3.push_back (rv.m_uniform->GetValue (-1 * M_PI, M_PI));
             }
           temp2.push_back (temp3);
         }
@@ -1355,19 +1597,11 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 
   NS_LOG_INFO ("1st strongest cluster:" << (int)cluster1st << ", 2nd strongest cluster:" << (int)cluster2nd);
 
-  Complex3DVector H_usn;  //channel coffecient H_usn[u][s][n];
   // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
   // the total cluster will be numReducedCLuster + 4.
-
-  H_usn.resize (uSize);
-  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
-    {
-      H_usn[uIndex].resize (sSize);
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
-        {
-          H_usn[uIndex][sIndex].resize (numReducedCluster);
-        }
-    }
+  // The sub-clusters are stored after the other clusters, in cluster order.
+  uint8_t numTotalCluster = numReducedCluster + (cluster1st == cluster2nd ? 2 : 4);
+  ComplexTensor3D H_usn (uSize, sSize, numTotalCluster);  //channel coffecient H_usn(u, s, n);
 
   // The following for loops computes the channel coefficients
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
@@ -1379,6 +1613,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 
           Vector sLoc = sAntenna->GetElementLocation (sIndex);
 
+          uint8_t subClusterIndex = numReducedCluster;
           for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
             {
               //Compute the N-2 weakest cluster, only vertical polarization. (7.5-22)
@@ -1411,7 +1646,7 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
                         * exp (std::complex<double> (0, txPhaseDiff));
                     }
                   rays *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = rays;
+                  H_usn.Set (uIndex, sIndex, nIndex, rays);
                 }
               else  //(7.5-28)
                 {
@@ -1476,9 +1711,9 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
                   raysSub1 *= sqrt (clusterPower[nIndex] / raysPerCluster);
                   raysSub2 *= sqrt (clusterPower[nIndex] / raysPerCluster);
                   raysSub3 *= sqrt (clusterPower[nIndex] / raysPerCluster);
-                  H_usn[uIndex][sIndex][nIndex] = raysSub1;
-                  H_usn[uIndex][sIndex].push_back (raysSub2);
-                  H_usn[uIndex][sIndex].push_back (raysSub3);
+                  H_usn.Set (uIndex, sIndex, nIndex, raysSub1);
+                  H_usn.Set (uIndex, sIndex, subClusterIndex++, raysSub2);
+                  H_usn.Set (uIndex, sIndex, subClusterIndex++, raysSub3);
 
                 }
             }
@@ -1505,11 +1740,10 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 
               double K_linear = pow (10,K_factor / 10);
               // the LOS path should be attenuated if blockage is enabled.
-              H_usn[uIndex][sIndex][0] = sqrt (1 / (K_linear + 1)) * H_usn[uIndex][sIndex][0] + sqrt (K_linear / (1 + K_linear)) * ray / pow (10,attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
-              double tempSize = H_usn[uIndex][sIndex].size ();
-              for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
+              H_usn.Set (uIndex, sIndex, 0, sqrt (1 / (K_linear + 1)) * H_usn (uIndex, sIndex, 0) + sqrt (K_linear / (1 + K_linear)) * ray / pow (10,attenuation_dB[0] / 10));           //(7.5-30) for tau = tau1
+              for (uint8_t nIndex = 1; nIndex < numTotalCluster; nIndex++)
                 {
-                  H_usn[uIndex][sIndex][nIndex] *= sqrt (1 / (K_linear + 1)); //(7.5-30) for tau = tau2...taunN
+                  H_usn.Set (uIndex, sIndex, nIndex, H_usn (uIndex, sIndex, nIndex) * sqrt (1 / (K_linear + 1))); //(7.5-30) for tau = tau2...taunN
                 }
 
             }
@@ -1575,16 +1809,20 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 
     }
 
-  NS_LOG_INFO ("size of coefficient matrix =[" << H_usn.size () << "][" << H_usn[0].size () << "][" << H_usn[0][0].size () << "]");
+  NS_LOG_INFO ("size of coefficient matrix =[" << H_usn.GetSize (0) << "][" << H_usn.GetSize (1) << "][" << H_usn.GetSize (2) << "]");
+  NS_ASSERT (clusterDelay.size () == numTotalCluster);
 
-  channelParams->m_channel = H_usn;
-  channelParams->m_delay = clusterDelay;
+  channelParams->m_channel = std::move (H_usn);
+  channelParams->m_delay.assign (clusterDelay.begin (), clusterDelay.end ());
 
-  channelParams->m_angle.clear ();
-  channelParams->m_angle.push_back (clusterAoa);
-  channelParams->m_angle.push_back (clusterZoa);
-  channelParams->m_angle.push_back (clusterAod);
-  channelParams->m_angle.push_back (clusterZod);
+  channelParams->m_angle = DoubleTensor2D (NUM_ANGLES, numTotalCluster);
+  for (uint8_t nIndex = 0; nIndex < numTotalCluster; nIndex++)
+    {
+      channelParams->m_angle (AOA_INDEX, nIndex) = clusterAoa[nIndex];
+      channelParams->m_angle (ZOA_INDEX, nIndex) = clusterZoa[nIndex];
+      channelParams->m_angle (AOD_INDEX, nIndex) = clusterAod[nIndex];
+      channelParams->m_angle (ZOD_INDEX, nIndex) = clusterZod[nIndex];
+    }
 
   return channelParams;
 }
@@ -1592,7 +1830,8 @@ ThreeGppChannelModel::GetNewChannel (Vector locUT, bool los, bool o2i,
 MatrixBasedChannelModel::DoubleVector
 ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::ThreeGppChannelMatrix> params,
                                                  const DoubleVector &clusterAOA,
-                                                 const DoubleVector &clusterZOA) const
+                                                 const DoubleVector &clusterZOA,
+                                                 const ChannelRandomVariables &rv) const
 {
   NS_LOG_FUNCTION (this);
 
@@ -1630,17 +1869,17 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::Three
         {
           //draw value from table 7.6.4.1-2 Blocking region parameters
           DoubleVector table;
-          table.push_back (m_normalRv->GetValue ()); //phi_k: store the normal RV that will be mapped to uniform (0,360) later.
+          table.push_back (rv.m_normal->GetValue ()); //phi_k: store the normal RV that will be mapped to uniform (0,360) later.
           if (m_scenario == "InH-OfficeMixed" || m_scenario == "InH-OfficeOpen")
             {
-              table.push_back (m_uniformRv->GetValue (15, 45)); //x_k
+              table.push_back (rv.m_uniform->GetValue (15, 45)); //x_k
               table.push_back (90);  //Theta_k
-              table.push_back (m_uniformRv->GetValue (5, 15)); //y_k
+              table.push_back (rv.m_uniform->GetValue (5, 15)); //y_k
               table.push_back (2);  //r
             }
           else
             {
-              table.push_back (m_uniformRv->GetValue (5, 15)); //x_k
+              table.push_back (rv.m_uniform->GetValue (5, 15)); //x_k
               table.push_back (90);  //Theta_k
               table.push_back (5);  //y_k
               table.push_back (10);  //r
@@ -1703,7 +1942,7 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::Three
 
               //Generate a new correlated normal RV with the following formula
               params->m_nonSelfBlocking[blockInd][PHI_INDEX] =
-                R * params->m_nonSelfBlocking[blockInd][PHI_INDEX] + sqrt (1 - R * R) * m_normalRv->GetValue ();
+                R * params->m_nonSelfBlocking[blockInd][PHI_INDEX] + sqrt (1 - R * R) * rv.m_normal->GetValue ();
             }
         }
 
@@ -1811,11 +2050,11 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (Ptr<ThreeGppChannelModel::Three
 
 
 void
-ThreeGppChannelModel::Shuffle (double * first, double * last) const
+ThreeGppChannelModel::Shuffle (double * first, double * last, const ChannelRandomVariables &rv) const
 {
   for (auto i = (last-first) - 1 ; i > 0; --i)
     {
-      std::swap (first[i], first[m_uniformRvShuffle->GetInteger (0, i)]);
+      std::swap (first[i], first[rv.m_shuffle->GetInteger (0, i)]);
     }
 }
 
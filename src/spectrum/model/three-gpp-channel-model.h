@@ -28,7 +28,11 @@
 #include <ns3/nstime.h>
 #include <ns3/random-variable-stream.h>
 #include <ns3/boolean.h>
+#include <ns3/event-id.h>
+#include <ns3/worker-pool.h>
 #include <unordered_map>
+#include <list>
+#include <map>
 #include <ns3/channel-condition-model.h>
 #include <ns3/matrix-based-channel-model.h>
 
@@ -43,6 +47,19 @@ class MobilityModel;
  * The class implements the channel matrix generation procedure
  * described in 3GPP TR 38.901.
  *
+ * When the attribute BackgroundUpdate is set (and UpdatePeriod is not
+ * zero), the channel matrices of the links used during their coherence
+ * time are regenerated when it expires, in a single batch for all the
+ * links expiring at the same time, on UpdateThreads worker threads, so
+ * that GetChannel finds them already updated. In this mode each channel
+ * realization draws its random values from a substream of the model
+ * streams derived from the link and the generation time, thus the
+ * results do not depend on the number of threads.
+ *
+ * The attribute MaxMemory sets a budget for the channel matrices stored
+ * by the model: when it is exceeded, the least recently used ones are
+ * discarded, and generated anew if the link is used again.
+ *
  * \see GetChannel
  */
 class ThreeGppChannelModel : public MatrixBasedChannelModel
@@ -128,13 +145,35 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \return the number of channel matrices stored by the model
+   */
+  std::size_t GetNChannels (void) const;
+
+  /**
+   * \return the estimated memory used by the stored channel matrices, in bytes
+   */
+  uint64_t GetChannelMemory (void) const;
+
 private:
+  /**
+   * Random variables used to generate a channel matrix
+   */
+  struct ChannelRandomVariables
+  {
+    Ptr<NormalRandomVariable> m_normal; //!< normal random variable
+    Ptr<UniformRandomVariable> m_uniform; //!< uniform random variable
+    Ptr<UniformRandomVariable> m_shuffle; //!< uniform random variable used to shuffle arrays
+  };
+
+
   /**
    * \brief Shuffle the elements of a simple sequence container of type double
    * \param first Pointer to the first element among the elements to be shuffled
    * \param last Pointer to the last element among the elements to be shuffled
+   * \param rv the random variables to use
    */
-  void Shuffle (double * first, double * last) const;
+  void Shuffle (double * first, double * last, const ChannelRandomVariables &rv) const;
   /**
    * Extends the struct ChannelMatrix by including information that are used 
    * within the class ThreeGppChannelModel
@@ -217,24 +256,31 @@ private:
    * \param dis2D the 2D distance between tx and rx
    * \param hBS the height of the BS
    * \param hUT the height of the UT
+   * \param rv the random variables to use
    * \return the channel realization
+   *
+   * The method can run on a worker thread, hence it must not copy the
+   * Ptr to the antennas, which may be shared with other links.
    */
   Ptr<ThreeGppChannelMatrix> GetNewChannel (Vector locUT, bool los, bool o2i,
-                                            Ptr<const ThreeGppAntennaArrayModel> sAntenna,
-                                            Ptr<const ThreeGppAntennaArrayModel> uAntenna,
+                                            const Ptr<const ThreeGppAntennaArrayModel> &sAntenna,
+                                            const Ptr<const ThreeGppAntennaArrayModel> &uAntenna,
                                             Angles &uAngle, Angles &sAngle,
-                                            double dis2D, double hBS, double hUT) const;
+                                            double dis2D, double hBS, double hUT,
+                                            const ChannelRandomVariables &rv) const;
 
   /**
    * Applies the blockage model A described in 3GPP TR 38.901
    * \param params the channel matrix
    * \param clusterAOA vector containing the azimuth angle of arrival for each cluster
    * \param clusterZOA vector containing the zenith angle of arrival for each cluster
+   * \param rv the random variables to use
    * \return vector containing the power attenuation for each cluster
    */
   DoubleVector CalcAttenuationOfBlockage (Ptr<ThreeGppChannelMatrix> params,
                                           const DoubleVector &clusterAOA,
-                                          const DoubleVector &clusterZOA) const;
+                                          const DoubleVector &clusterZOA,
+                                          const ChannelRandomVariables &rv) const;
 
   /**
    * Check if the channel matrix has to be updated
@@ -244,7 +290,99 @@ private:
    */
   bool ChannelMatrixNeedsUpdate (Ptr<const ThreeGppChannelMatrix> channelMatrix, bool isLos) const;
 
-  std::unordered_map<uint32_t, Ptr<ThreeGppChannelMatrix> > m_channelMap; //!< map containing the channel realizations
+  /**
+   * Inputs of the generation of a channel matrix
+   */
+  struct ChannelRequest
+  {
+    uint32_t m_channelId; //!< the channel key
+    Ptr<const MobilityModel> m_aMob; //!< mobility model of the a device
+    Ptr<const MobilityModel> m_bMob; //!< mobility model of the b device
+    Ptr<const ThreeGppAntennaArrayModel> m_aAntenna; //!< antenna of the a device
+    Ptr<const ThreeGppAntennaArrayModel> m_bAntenna; //!< antenna of the b device
+    bool m_los; //!< the LOS condition
+    Angles m_txAngle; //!< angle of the b device seen from the a device
+    Angles m_rxAngle; //!< angle of the a device seen from the b device
+    double m_distance2D; //!< 2D distance between the devices
+    double m_hBs; //!< height of the BS
+    double m_hUt; //!< height of the UT
+    ChannelRandomVariables m_rv; //!< the random variables to use
+    Ptr<ThreeGppChannelMatrix> m_channel; //!< the generated channel matrix
+  };
+
+  /**
+   * Entry of m_channelMap
+   */
+  struct ChannelMapEntry
+  {
+    Ptr<ThreeGppChannelMatrix> m_channel; //!< the channel matrix
+    uint64_t m_memory; //!< estimated memory used by the channel matrix
+    std::list<uint32_t>::iterator m_lruIt; //!< position in m_lruList
+    Time m_lastAccess; //!< time of the last call to GetChannel for the link
+    Ptr<const MobilityModel> m_aMob; //!< mobility model of the a device
+    Ptr<const MobilityModel> m_bMob; //!< mobility model of the b device
+    Ptr<const ThreeGppAntennaArrayModel> m_aAntenna; //!< antenna of the a device
+    Ptr<const ThreeGppAntennaArrayModel> m_bAntenna; //!< antenna of the b device
+  };
+
+  /**
+   * Fill the inputs of the generation of a channel matrix, on the
+   * simulation thread
+   * \param request the request, with the link fields set
+   * \param los the LOS condition
+   */
+  void PrepareChannelRequest (ChannelRequest &request, bool los);
+
+  /**
+   * Generate the channel matrix of a request
+   * \param request the request
+   */
+  void GenerateChannel (ChannelRequest &request) const;
+
+  /**
+   * Worker pool task: generate the channel matrix of a request of m_batch
+   * \param i the index of the request
+   */
+  void GenerateBatchChannel (uint32_t i);
+
+  /**
+   * Store a new channel matrix in m_channelMap, evicting the least
+   * recently used ones if MaxMemory is exceeded, and schedule its
+   * background update
+   * \param request the request of the channel matrix
+   */
+  void StoreChannel (const ChannelRequest &request);
+
+  /**
+   * Queue a channel matrix for the background update
+   * \param channelId the channel key
+   * \param expiry the time at which the channel matrix expires
+   */
+  void ScheduleChannelUpdate (uint32_t channelId, Time expiry);
+
+  /**
+   * Regenerate the channel matrices of the links used during the
+   * coherence time that expires now
+   */
+  void UpdateChannels (void);
+
+  /**
+   * Estimate the memory used by a channel matrix
+   * \param channel the channel matrix
+   * \return the number of bytes
+   */
+  static uint64_t GetMemorySize (Ptr<const ThreeGppChannelMatrix> channel);
+
+  std::unordered_map<uint32_t, ChannelMapEntry> m_channelMap; //!< map containing the channel realizations
+  std::list<uint32_t> m_lruList; //!< channel keys, from the most to the least recently used
+  uint64_t m_maxMemory; //!< the memory budget for the channel matrices, 0 if unlimited
+  uint64_t m_memory; //!< the estimated memory used by the channel matrices
+  bool m_backgroundUpdate; //!< whether the channel matrices are updated in background
+  uint32_t m_updateThreads; //!< number of worker threads for the background update
+  Ptr<WorkerPool> m_pool; //!< the worker threads, created on first use
+  std::map<Time, std::vector<uint32_t> > m_updateQueue; //!< channel keys by expiration time
+  EventId m_updateEvent; //!< the event of the next background update
+  std::vector<ChannelRequest> m_batch; //!< requests of the background update being executed
   Time m_updatePeriod; //!< the channel update period
   double m_frequency; //!< the operating frequency
   std::string m_scenario; //!< the 3GPP scenario
@@ -31,6 +31,7 @@
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
 #include <map>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -120,28 +121,54 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
 {
   NS_LOG_FUNCTION (this);
 
-  uint16_t sAntenna = static_cast<uint16_t> (sW.size ());
-  uint16_t uAntenna = static_cast<uint16_t> (uW.size ());
+  const MatrixBasedChannelModel::ComplexTensor3D &channel = params->m_channel;
+  std::size_t uAntenna = channel.GetSize (0);
+  std::size_t sAntenna = channel.GetSize (1);
+  std::size_t numCluster = channel.GetSize (2);
+  NS_ASSERT_MSG (uW.size () == uAntenna && sW.size () == sAntenna, "The beamforming vectors do not match the channel matrix");
 
   NS_LOG_DEBUG ("CalcLongTerm with sAntenna " << sAntenna << " uAntenna " << uAntenna);
   //store the long term part to reduce computation load
   //only the small scale fading needs to be updated if the large scale parameters and antenna weights remain unchanged.
-  ThreeGppAntennaArrayModel::ComplexVector longTerm;
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
+  //For each cluster n, longTerm(n) = sum_u uW(u) * (sum_s sW(s) * H(u, s, n)):
+  //the inner sums are computed for all the u elements at once, walking the
+  //contiguous rows H(:, s, n) with separate real and imaginary parts, so
+  //that the compiler can vectorize the loops over the antenna elements.
+  ThreeGppAntennaArrayModel::ComplexVector longTerm (numCluster);
+  std::vector<double> uWRe (uAntenna), uWIm (uAntenna);
+  for (std::size_t uIndex = 0; uIndex < uAntenna; uIndex++)
+    {
+      uWRe[uIndex] = uW[uIndex].real ();
+      uWIm[uIndex] = uW[uIndex].imag ();
+    }
+  std::vector<double> accRe (uAntenna), accIm (uAntenna);
+  double *aRe = accRe.data ();
+  double *aIm = accIm.data ();
 
-  for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+  for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
-      std::complex<double> txSum (0,0);
-      for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
+      std::fill (accRe.begin (), accRe.end (), 0.0);
+      std::fill (accIm.begin (), accIm.end (), 0.0);
+      for (std::size_t sIndex = 0; sIndex < sAntenna; sIndex++)
         {
-          std::complex<double> rxSum (0,0);
-          for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
+          const double wRe = sW[sIndex].real ();
+          const double wIm = sW[sIndex].imag ();
+          const double *hRe = channel.GetRealRow (sIndex, cIndex);
+          const double *hIm = channel.GetImagRow (sIndex, cIndex);
+          for (std::size_t uIndex = 0; uIndex < uAntenna; uIndex++)
             {
-              rxSum = rxSum + uW[uIndex] * params->m_channel[uIndex][sIndex][cIndex];
+              aRe[uIndex] += wRe * hRe[uIndex] - wIm * hIm[uIndex];
+              aIm[uIndex] += wRe * hIm[uIndex] + wIm * hRe[uIndex];
             }
-          txSum = txSum + sW[sIndex] * rxSum;
         }
-      longTerm.push_back (txSum);
+      double sumRe = 0;
+      double sumIm = 0;
+      for (std::size_t uIndex = 0; uIndex < uAntenna; uIndex++)
+        {
+          sumRe += uWRe[uIndex] * aRe[uIndex] - uWIm[uIndex] * aIm[uIndex];
+          sumIm += uWRe[uIndex] * aIm[uIndex] + uWIm[uIndex] * aRe[uIndex];
+        }
+      longTerm[cIndex] = std::complex<double> (sumRe, sumIm);
     }
   return longTerm;
 }
@@ -156,44 +183,118 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
 
   Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
 
-  //channel[rx][tx][cluster]
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
+  //channel(rx, tx, cluster)
+  std::size_t numCluster = params->m_channel.GetSize (2);
+  NS_ASSERT (longTerm.size () == numCluster);
 
   // compute the doppler term
   // NOTE the update of Doppler is simplified by only taking the center angle of
   // each cluster in to consideration.
   double slotTime = Simulator::Now ().GetSeconds ();
-  ThreeGppAntennaArrayModel::ComplexVector doppler;
-  for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+  double frequency = GetFrequency ();
+  const double *aoa = params->m_angle.GetRow (MatrixBasedChannelModel::AOA_INDEX);
+  const double *zoa = params->m_angle.GetRow (MatrixBasedChannelModel::ZOA_INDEX);
+  const double *aod = params->m_angle.GetRow (MatrixBasedChannelModel::AOD_INDEX);
+  const double *zod = params->m_angle.GetRow (MatrixBasedChannelModel::ZOD_INDEX);
+  // long term component times the doppler term, real and imaginary parts
+  std::vector<double> ltRe (numCluster), ltIm (numCluster);
+  for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
       //cluster angle angle[direction][n],where, direction = 0(aoa), 1(zoa).
       // TODO should I include the "alfa" term for the Doppler of delayed paths?
-      double temp_doppler = 2 * M_PI * ((sin (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * cos (params->m_angle[MatrixBasedChannelModel::AOA_INDEX][cIndex] * M_PI / 180) * uSpeed.x
-                                         + sin (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * sin (params->m_angle[MatrixBasedChannelModel::AOA_INDEX][cIndex] * M_PI / 180) * uSpeed.y
-                                         + cos (params->m_angle[MatrixBasedChannelModel::ZOA_INDEX][cIndex] * M_PI / 180) * uSpeed.z)
-                                         + (sin (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * cos (params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180) * sSpeed.x
-                                         + sin (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * sin (params->m_angle[MatrixBasedChannelModel::AOD_INDEX][cIndex] * M_PI / 180) * sSpeed.y
-                                         + cos (params->m_angle[MatrixBasedChannelModel::ZOD_INDEX][cIndex] * M_PI / 180) * sSpeed.z))
-        * slotTime * GetFrequency () / 3e8;
-      doppler.push_back (exp (std::complex<double> (0, temp_doppler)));
+      double temp_doppler = 2 * M_PI * ((sin (zoa[cIndex] * M_PI / 180) * cos (aoa[cIndex] * M_PI / 180) * uSpeed.x
+                                         + sin (zoa[cIndex] * M_PI / 180) * sin (aoa[cIndex] * M_PI / 180) * uSpeed.y
+                                         + cos (zoa[cIndex] * M_PI / 180) * uSpeed.z)
+                                         + (sin (zod[cIndex] * M_PI / 180) * cos (aod[cIndex] * M_PI / 180) * sSpeed.x
+                                         + sin (zod[cIndex] * M_PI / 180) * sin (aod[cIndex] * M_PI / 180) * sSpeed.y
+                                         + cos (zod[cIndex] * M_PI / 180) * sSpeed.z))
+        * slotTime * frequency / 3e8;
+      std::complex<double> lt = longTerm[cIndex] * exp (std::complex<double> (0, temp_doppler));
+      ltRe[cIndex] = lt.real ();
+      ltIm[cIndex] = lt.imag ();
     }
 
   // apply the doppler term and the propagation delay to the long term component
-  // to obtain the beamforming gain
+  // to obtain the beamforming gain.
+  // The delay term exp (-j 2 pi fsb tau_n) of each cluster is evaluated
+  // directly only once every MAX_ROTATIONS sub-bands: in between, as long
+  // as the sub-bands are uniformly spaced, it is advanced from one sub-band
+  // to the next by the rotation exp (-j 2 pi df tau_n), df being the spacing.
+  static const uint32_t MAX_ROTATIONS = 16;
+  static const double SPACING_TOLERANCE = 1e-3; // Hz
+  const double *delay = params->m_delay.data ();
+  std::vector<double> delayRe (numCluster), delayIm (numCluster); // delay term at the current sub-band
+  std::vector<double> rotRe (numCluster), rotIm (numCluster); // delay term rotation between two sub-bands
+  double *dRe = delayRe.data ();
+  double *dIm = delayIm.data ();
+  bool anchored = false; // whether the delay terms were evaluated directly at least once
+  double anchorFc = 0; // frequency of the last direct evaluation
+  bool haveSpacing = false; // whether rotRe and rotIm are valid
+  double spacing = 0; // spacing of the sub-bands
+  uint32_t nRotations = 0; // number of rotations since the last direct evaluation
+
   auto vit = tempPsd->ValuesBegin (); // psd iterator
   auto sbit = tempPsd->ConstBandsBegin(); // band iterator
   while (vit != tempPsd->ValuesEnd ())
     {
-      std::complex<double> subsbandGain (0.0,0.0);
       if ((*vit) != 0.00)
         {
           double fsb = (*sbit).fc; // center frequency of the sub-band
-          for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+          bool rotate = false;
+          if (anchored && nRotations + 1 < MAX_ROTATIONS)
+            {
+              if (!haveSpacing)
+                {
+                  spacing = fsb - anchorFc;
+                  for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
+                    {
+                      double phase = -2 * M_PI * spacing * delay[cIndex];
+                      rotRe[cIndex] = cos (phase);
+                      rotIm[cIndex] = sin (phase);
+                    }
+                  haveSpacing = true;
+                  rotate = true;
+                }
+              else
+                {
+                  rotate = std::abs (fsb - (anchorFc + (nRotations + 1) * spacing)) <= SPACING_TOLERANCE;
+                }
+            }
+          if (rotate)
+            {
+              const double *rRe = rotRe.data ();
+              const double *rIm = rotIm.data ();
+              for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
+                {
+                  double re = dRe[cIndex] * rRe[cIndex] - dIm[cIndex] * rIm[cIndex];
+                  dIm[cIndex] = dRe[cIndex] * rIm[cIndex] + dIm[cIndex] * rRe[cIndex];
+                  dRe[cIndex] = re;
+                }
+              nRotations++;
+            }
+          else
+            {
+              // keep the rotations if the sub-bands are still uniformly spaced
+              haveSpacing = haveSpacing && std::abs (fsb - (anchorFc + (nRotations + 1) * spacing)) <= SPACING_TOLERANCE;
+              for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
+                {
+                  double phase = -2 * M_PI * fsb * delay[cIndex];
+                  dRe[cIndex] = cos (phase);
+                  dIm[cIndex] = sin (phase);
+                }
+              anchored = true;
+              anchorFc = fsb;
+              nRotations = 0;
+            }
+
+          double gainRe = 0;
+          double gainIm = 0;
+          for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
-              double delay = -2 * M_PI * fsb * (params->m_delay[cIndex]);
-              subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] * exp (std::complex<double> (0, delay));
+              gainRe += ltRe[cIndex] * dRe[cIndex] - ltIm[cIndex] * dIm[cIndex];
+              gainIm += ltRe[cIndex] * dIm[cIndex] + ltIm[cIndex] * dRe[cIndex];
             }
-          *vit = (*vit) * (norm (subsbandGain));
+          *vit = (*vit) * (gainRe * gainRe + gainIm * gainIm);
         }
       vit++;
       sbit++;
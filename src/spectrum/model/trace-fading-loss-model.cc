@@ -29,13 +29,188 @@
 #include "ns3/uinteger.h"
 #include <fstream>
 #include <ns3/simulator.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceFadingLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel);
-  
+
+/**
+ * The linear gains of a fading trace, ordered by sample and then by RB.
+ * The traces loaded are registered by file, number of RBs and number of
+ * samples, until the last model using them releases them.
+ */
+class TraceFadingLossModel::FadingTrace : public SimpleRefCount<FadingTrace>
+{
+public:
+  /**
+   * Get the trace of a file, loading it if it is not loaded yet
+   * \param fileName the trace file
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB
+   * \return the trace
+   */
+  static Ptr<const FadingTrace> Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+  ~FadingTrace ();
+
+  /**
+   * \param index the index of a sample
+   * \return the gains of the RBs at this sample
+   */
+  const double * GetGains (uint32_t index) const
+  {
+    return &m_gains[index * m_rbNum];
+  }
+
+private:
+  /// The file, the number of RBs and the number of samples of a trace
+  typedef std::pair<std::string, std::pair<uint32_t, uint32_t> > Key;
+  /// The traces loaded
+  typedef std::map<Key, FadingTrace *> Registry;
+
+  /**
+   * \return the traces loaded
+   */
+  static Registry & GetRegistry (void);
+  /**
+   * Load the trace of the key
+   * \param key the file, the number of RBs and the number of samples
+   */
+  FadingTrace (const Key &key);
+  /**
+   * Parse the samples of a trace, in dB, as written by
+   * fading_trace_generator.m: the samples of each RB in turn
+   * \param begin the start of the text
+   * \param end the end of the text
+   * \param count the number of samples to parse
+   * \param samples the samples parsed
+   */
+  void Parse (const char *begin, const char *end, std::size_t count, std::vector<double> &samples) const;
+
+  Key m_key; ///< the key of the trace in the registry
+  uint32_t m_rbNum; ///< the number of RBs
+  std::vector<double> m_gains; ///< the linear gains of the samples
+};
+
+TraceFadingLossModel::FadingTrace::Registry &
+TraceFadingLossModel::FadingTrace::GetRegistry (void)
+{
+  static Registry registry;
+  return registry;
+}
+
+Ptr<const TraceFadingLossModel::FadingTrace>
+TraceFadingLossModel::FadingTrace::Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  Key key = std::make_pair (fileName, std::make_pair (rbNum, samplesNum));
+  Registry::iterator it = GetRegistry ().find (key);
+  if (it != GetRegistry ().end ())
+    {
+      NS_LOG_LOGIC ("Fading trace " << fileName << " already loaded");
+      return Ptr<const FadingTrace> (it->second);
+    }
+  Ptr<FadingTrace> trace = Ptr<FadingTrace> (new FadingTrace (key), false);
+  GetRegistry ()[key] = PeekPointer (trace);
+  return trace;
+}
+
+TraceFadingLossModel::FadingTrace::FadingTrace (const Key &key)
+  : m_key (key),
+    m_rbNum (key.second.first)
+{
+  std::string fileName = key.first;
+  uint32_t samplesNum = key.second.second;
+  std::size_t count = m_rbNum * samplesNum;
+  std::vector<double> samples;
+  samples.reserve (count);
+
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_INFO (this << " File: " << fileName);
+      NS_ASSERT_MSG (fd >= 0, " Fading trace file not found");
+    }
+  else
+    {
+      struct stat st;
+      void *text = MAP_FAILED;
+      if (fstat (fd, &st) == 0 && st.st_size > 0)
+        {
+          text = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+      if (text != MAP_FAILED)
+        {
+          madvise (text, st.st_size, MADV_SEQUENTIAL);
+          Parse (static_cast<const char *> (text), static_cast<const char *> (text) + st.st_size, count, samples);
+          munmap (text, st.st_size);
+        }
+      else
+        {
+          // Not a regular file, e.g. a pipe
+          NS_LOG_LOGIC ("Fading trace " << fileName << " not mapped, reading it");
+          std::ifstream ifTraceFile (fileName.c_str (), std::ifstream::in);
+          std::string content ((std::istreambuf_iterator<char> (ifTraceFile)), std::istreambuf_iterator<char> ());
+          Parse (content.data (), content.data () + content.size (), count, samples);
+        }
+      close (fd);
+    }
+  // The missing samples are 0 dB, as they are read by an input stream
+  samples.resize (count, 0);
+
+  m_gains.resize (m_rbNum * samplesNum);
+  for (uint32_t i = 0; i < m_rbNum; i++)
+    {
+      for (uint32_t j = 0; j < samplesNum; j++)
+        {
+          m_gains[j * m_rbNum + i] = std::pow (10., samples[i * samplesNum + j] / 10);
+        }
+    }
+}
+
+TraceFadingLossModel::FadingTrace::~FadingTrace ()
+{
+  GetRegistry ().erase (m_key);
+}
+
+void
+TraceFadingLossModel::FadingTrace::Parse (const char *begin, const char *end, std::size_t count, std::vector<double> &samples) const
+{
+  // strtod needs a terminated string, the mapped file is not
+  char token[64];
+  const char *p = begin;
+  while (samples.size () < count)
+    {
+      while (p != end && std::isspace (static_cast<unsigned char> (*p)))
+        {
+          ++p;
+        }
+      if (p == end)
+        {
+          break;
+        }
+      const char *start = p;
+      while (p != end && !std::isspace (static_cast<unsigned char> (*p)))
+        {
+          ++p;
+        }
+      std::size_t length = std::min<std::size_t> (p - start, sizeof (token) - 1);
+      std::memcpy (token, start, length);
+      token[length] = '\0';
+      samples.push_back (std::strtod (token, 0));
+    }
+}
+
 
 
 TraceFadingLossModel::TraceFadingLossModel ()
@@ -48,7 +223,7 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
+  m_fadingTrace = 0;
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -120,28 +295,10 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
-    {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
-    }
+  m_fadingTrace = FadingTrace::Get (m_traceFile, m_rbNum, m_samplesNum);
 
 //   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
 //   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
-    {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
-        {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
-        }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
-    }
   m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
   m_lastWindowUpdate = Simulator::Now ();
 }
@@ -201,32 +358,17 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
-  int subChannel = 0;
-  while (vit != rxPsd->ValuesEnd ())
+  NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index);
+  NS_ASSERT (rxPsd->GetSpectrumModel ()->GetNumBands () <= m_rbNum);
+  // The fading in dB of each RB is a product by its linear gain
+  const double *gains = m_fadingTrace->GetGains (index);
+  for (int subChannel = 0; vit != rxPsd->ValuesEnd (); ++vit, ++subChannel)
     {
-      NS_ASSERT (subChannel < 100);
-      if (*vit != 0.)
-        {
-          double fading = m_fadingTrace.at (subChannel).at (index);
-          NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
-          double power = *vit; // in Watt/Hz
-          power = 10 * std::log10 (180000 * power); // in dB
-
-          NS_LOG_LOGIC (this << subChannel << *vit  << power << fading);
-
-          *vit = std::pow (10., ((power + fading) / 10)) / 180000; // in Watt
-
-          NS_LOG_LOGIC (this << subChannel << *vit);
-
-        }
-
-      ++vit;
-      ++subChannel;
-
+      *vit *= gains[subChannel];
     }
 
   NS_LOG_LOGIC (this << *rxPsd);
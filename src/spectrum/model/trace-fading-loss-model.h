@@ -40,6 +40,12 @@ class MobilityModel;
  * \ingroup spectrum
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace file is mapped in memory and parsed once, into a table of
+ * the linear gains of the samples, ordered by time and then by RB, so
+ * that the fading of a transmission is applied to its RBs by a product
+ * with a contiguous row of the table.  The table is shared by the models
+ * loading the same trace with the same numbers of RBs and of samples.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -106,26 +112,18 @@ private:
   /// Load trace function
   void LoadTrace ();
 
+  /// The linear gains of a trace, shared by the models loading it
+  class FadingTrace;
+
 
    
   mutable std::map <ChannelRealizationId_t, int > m_windowOffsetsMap; ///< windows offsets map
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap; ///< start variable map
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile; ///< the trace file name
   
-  FadingTrace m_fadingTrace; ///< fading trace
+  Ptr<const FadingTrace> m_fadingTrace; ///< fading trace
 
   
   Time m_traceLength; ///< the trace time
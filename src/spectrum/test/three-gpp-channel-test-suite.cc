@@ -22,6 +22,7 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/string.h"
 #include "ns3/angles.h"
 #include "ns3/pointer.h"
@@ -94,7 +95,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   double channelNorm = 0;
-  uint8_t numTotClusters = channelMatrix->m_channel.at (0).at (0).size ();
+  uint8_t numTotClusters = channelMatrix->m_channel.GetSize (2);
   for (uint8_t cIndex = 0; cIndex < numTotClusters; cIndex++)
   {
     double clusterNorm = 0;
@@ -102,7 +103,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
     {
       for (uint32_t uIndex = 0; uIndex < rxAntennaElements; uIndex++)
       {
-        clusterNorm += std::pow (std::abs (channelMatrix->m_channel.at (uIndex).at (sIndex).at (cIndex)), 2);
+        clusterNorm += std::pow (std::abs (channelMatrix->m_channel (uIndex, sIndex, cIndex)), 2);
       }
     }
     channelNorm += clusterNorm;
@@ -160,8 +161,8 @@ ThreeGppChannelMatrixComputationTest::DoRun (void)
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   // check the channel matrix dimensions
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.at (0).size (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.size (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetSize (1), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetSize (0), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
 
   // test if the channel matrix is correctly generated
   uint16_t numIt = 1000;
@@ -340,6 +341,7 @@ ThreeGppChannelMatrixUpdateTest::DoRun (void)
  * 2) checks if the long term component is updated when changing the beamforming
  *    vectors
  * 3) checks if the long term is updated when changing the channel matrix
+ * 4) checks the rx PSD against a direct evaluation of the beamforming gain
  */
 class ThreeGppSpectrumPropagationLossModelTest : public TestCase
 {
@@ -388,6 +390,20 @@ private:
    * \return true if first and second are equal, false otherwise
    */
   static bool ArePsdEqual (Ptr<SpectrumValue> first, Ptr<SpectrumValue> second);
+
+  /**
+   * Computes the rx PSD of a static link directly from the channel matrix,
+   * by summing over all the antenna elements and clusters for every sub-band
+   * \param channelMatrix the channel matrix
+   * \param txPsd the PSD of the transmitted signal
+   * \param sW the beamforming vector of the s node of the channel matrix
+   * \param uW the beamforming vector of the u node of the channel matrix
+   * \return the rx PSD
+   */
+  static Ptr<SpectrumValue> CalcReferenceRxPsd (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                Ptr<const SpectrumValue> txPsd,
+                                                const ThreeGppAntennaArrayModel::ComplexVector &sW,
+                                                const ThreeGppAntennaArrayModel::ComplexVector &uW);
 };
 
 ThreeGppSpectrumPropagationLossModelTest::ThreeGppSpectrumPropagationLossModelTest ()
@@ -447,6 +463,34 @@ ThreeGppSpectrumPropagationLossModelTest::ArePsdEqual (Ptr<SpectrumValue> first,
   return ret;
 }
 
+Ptr<SpectrumValue>
+ThreeGppSpectrumPropagationLossModelTest::CalcReferenceRxPsd (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                                                              Ptr<const SpectrumValue> txPsd,
+                                                              const ThreeGppAntennaArrayModel::ComplexVector &sW,
+                                                              const ThreeGppAntennaArrayModel::ComplexVector &uW)
+{
+  Ptr<SpectrumValue> rxPsd = txPsd->Copy ();
+  auto sbit = rxPsd->ConstBandsBegin ();
+  for (auto vit = rxPsd->ValuesBegin (); vit != rxPsd->ValuesEnd (); ++vit, ++sbit)
+  {
+    std::complex<double> gain (0, 0);
+    for (std::size_t cIndex = 0; cIndex < channelMatrix->m_channel.GetSize (2); cIndex++)
+    {
+      std::complex<double> longTerm (0, 0);
+      for (std::size_t sIndex = 0; sIndex < sW.size (); sIndex++)
+      {
+        for (std::size_t uIndex = 0; uIndex < uW.size (); uIndex++)
+        {
+          longTerm += sW[sIndex] * uW[uIndex] * channelMatrix->m_channel (uIndex, sIndex, cIndex);
+        }
+      }
+      gain += longTerm * std::exp (std::complex<double> (0, -2 * M_PI * sbit->fc * channelMatrix->m_delay[cIndex]));
+    }
+    *vit *= std::norm (gain);
+  }
+  return rxPsd;
+}
+
 void
 ThreeGppSpectrumPropagationLossModelTest::CheckLongTermUpdate (Ptr<ThreeGppSpectrumPropagationLossModel> lossModel, Ptr<SpectrumValue> txPsd, Ptr<MobilityModel> txMob, Ptr<MobilityModel> rxMob, Ptr<SpectrumValue> rxPsdOld)
 {
@@ -523,6 +567,18 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   Ptr<SpectrumValue> rxPsdNew = lossModel->DoCalcRxPowerSpectralDensity (txPsd, rxMob, txMob);
   NS_TEST_ASSERT_MSG_EQ (ArePsdEqual (rxPsdOld, rxPsdNew),  true, "The long term for the direct and the reverse channel are different");
 
+  // 4) check the rx PSD against the direct evaluation of the beamforming gain
+  Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = lossModel->GetChannelModel ()->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
+  uint32_t txId = txDev->GetNode ()->GetId ();
+  uint32_t rxId = rxDev->GetNode ()->GetId ();
+  Ptr<SpectrumValue> rxPsdRef = channelMatrix->IsReverse (txId, rxId) ?
+    CalcReferenceRxPsd (channelMatrix, txPsd, rxAntenna->GetBeamformingVector (), txAntenna->GetBeamformingVector ()) :
+    CalcReferenceRxPsd (channelMatrix, txPsd, txAntenna->GetBeamformingVector (), rxAntenna->GetBeamformingVector ());
+  for (uint32_t i = 0; i < txPsd->GetSpectrumModel ()->GetNumBands (); i++)
+  {
+    NS_TEST_ASSERT_MSG_EQ_TOL ((*rxPsdOld) [i], (*rxPsdRef) [i], 1e-6 * (*rxPsdRef) [i] + 1e-30, "Wrong rx PSD in sub-band " << i);
+  }
+
   // 2) check if the long term is updated when changing the BF vector
   // change the position of the rx device and recompute the beamforming vectors
   rxMob->SetPosition (Vector (10.0, 5.0, 10.0));
@@ -543,6 +599,200 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   Simulator::Destroy ();
 }
 
+/**
+ * Test case for the background update and the memory budget of the
+ * ThreeGppChannelModel class.
+ * 1) checks that the channel matrices of the links used during their
+ *    coherence time are regenerated when it expires, and that the others
+ *    are not
+ * 2) checks that the regenerated channel matrices do not depend on the
+ *    number of update threads
+ * 3) checks that the least recently used channel matrices are discarded
+ *    when the memory budget is exceeded
+ */
+class ThreeGppChannelBackgroundUpdateTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppChannelBackgroundUpdateTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppChannelBackgroundUpdateTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Run the background update scenario
+   * \param nThreads the number of update threads
+   * \return the coefficients of the channel matrices after the update
+   */
+  std::vector<std::complex<double> > RunUpdateScenario (uint32_t nThreads);
+
+  /**
+   * Retrieve the channel matrix of a link and store it
+   * \param channelModel the ThreeGppChannelModel object
+   * \param i index of the link
+   */
+  void DoGetChannel (Ptr<ThreeGppChannelModel> channelModel, uint32_t i);
+
+  std::vector<Ptr<MobilityModel> > m_mob; //!< the mobility models of the nodes
+  std::vector<Ptr<ThreeGppAntennaArrayModel> > m_antenna; //!< the antennas of the nodes
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > m_channel; //!< the last channel matrix of each link
+};
+
+ThreeGppChannelBackgroundUpdateTest::ThreeGppChannelBackgroundUpdateTest ()
+  : TestCase ("Check the background update and the memory budget of the channel matrices")
+{
+}
+
+ThreeGppChannelBackgroundUpdateTest::~ThreeGppChannelBackgroundUpdateTest ()
+{
+}
+
+void
+ThreeGppChannelBackgroundUpdateTest::DoGetChannel (Ptr<ThreeGppChannelModel> channelModel, uint32_t i)
+{
+  // link i is between node 0 and node i + 1
+  m_channel[i] = channelModel->GetChannel (m_mob[0], m_mob[i + 1], m_antenna[0], m_antenna[i + 1]);
+}
+
+std::vector<std::complex<double> >
+ThreeGppChannelBackgroundUpdateTest::RunUpdateScenario (uint32_t nThreads)
+{
+  const uint32_t nLinks = 3;
+
+  Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+  channelModel->SetAttribute ("Frequency", DoubleValue (28.0e9));
+  channelModel->SetAttribute ("Scenario", StringValue ("UMi-StreetCanyon"));
+  channelModel->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+  channelModel->SetAttribute ("UpdatePeriod", TimeValue (MilliSeconds (100)));
+  channelModel->SetAttribute ("BackgroundUpdate", BooleanValue (true));
+  channelModel->SetAttribute ("UpdateThreads", UintegerValue (nThreads));
+  channelModel->AssignStreams (1);
+
+  NodeContainer nodes;
+  nodes.Create (nLinks + 1);
+  m_mob.clear ();
+  m_antenna.clear ();
+  for (uint32_t i = 0; i <= nLinks; ++i)
+    {
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      mob->SetPosition (Vector (50.0 * i, 10.0 * i, i == 0 ? 10.0 : 1.5));
+      nodes.Get (i)->AggregateObject (mob);
+      m_mob.push_back (mob);
+      m_antenna.push_back (CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (2), "NumRows", UintegerValue (2)));
+    }
+  m_channel.assign (nLinks, 0);
+
+  // all the links are used at 1 ms, only the first two during their
+  // coherence time
+  for (uint32_t i = 0; i < nLinks; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (1), &ThreeGppChannelBackgroundUpdateTest::DoGetChannel, this, channelModel, i);
+    }
+  for (uint32_t i = 0; i < nLinks - 1; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (50), &ThreeGppChannelBackgroundUpdateTest::DoGetChannel, this, channelModel, i);
+    }
+  Simulator::Stop (MilliSeconds (150));
+  Simulator::Run ();
+
+  std::vector<std::complex<double> > coefficients;
+  for (uint32_t i = 0; i < nLinks; ++i)
+    {
+      Ptr<const ThreeGppChannelModel::ChannelMatrix> stored = m_channel[i];
+      DoGetChannel (channelModel, i);
+      // the channel matrices of the links used during the coherence time
+      // have been regenerated at its expiry, the other one is regenerated
+      // now, on demand
+      Time expected = (i < nLinks - 1) ? MilliSeconds (101) : MilliSeconds (150);
+      NS_TEST_EXPECT_MSG_EQ ((m_channel[i] != stored), true, "the channel matrix of link " << i << " has not been updated");
+      NS_TEST_EXPECT_MSG_EQ (m_channel[i]->m_generatedTime, expected, "wrong generation time for link " << i);
+      const MatrixBasedChannelModel::ComplexTensor3D &h = m_channel[i]->m_channel;
+      for (uint32_t k = 0; k < h.GetSize (2); ++k)
+        {
+          for (uint32_t s = 0; s < h.GetSize (1); ++s)
+            {
+              for (uint32_t u = 0; u < h.GetSize (0); ++u)
+                {
+                  coefficients.push_back (h (u, s, k));
+                }
+            }
+        }
+    }
+  Simulator::Destroy ();
+  return coefficients;
+}
+
+void
+ThreeGppChannelBackgroundUpdateTest::DoRun (void)
+{
+  // 1) and 2) the channel matrices are regenerated with the same values
+  // with and without update threads
+  std::vector<std::complex<double> > reference = RunUpdateScenario (0);
+  std::vector<std::complex<double> > parallel = RunUpdateScenario (2);
+  NS_TEST_ASSERT_MSG_EQ (parallel.size (), reference.size (), "the channel matrices have different sizes");
+  for (std::size_t i = 0; i < reference.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((parallel[i] == reference[i]), true, "the channel matrices depend on the number of update threads");
+    }
+
+  // 3) with a budget for about two channel matrices, only the two most
+  // recently used ones are kept
+  const uint32_t nLinks = 4;
+  Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+  channelModel->SetAttribute ("Frequency", DoubleValue (28.0e9));
+  channelModel->SetAttribute ("Scenario", StringValue ("UMi-StreetCanyon"));
+  channelModel->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<NeverLosChannelConditionModel> ()));
+
+  NodeContainer nodes;
+  nodes.Create (nLinks + 1);
+  m_mob.clear ();
+  m_antenna.clear ();
+  for (uint32_t i = 0; i <= nLinks; ++i)
+    {
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      mob->SetPosition (Vector (50.0 * i, 0.0, i == 0 ? 10.0 : 1.5));
+      nodes.Get (i)->AggregateObject (mob);
+      m_mob.push_back (mob);
+      m_antenna.push_back (CreateObjectWithAttributes<ThreeGppAntennaArrayModel> ("NumColumns", UintegerValue (2), "NumRows", UintegerValue (2)));
+    }
+  m_channel.assign (nLinks, 0);
+
+  DoGetChannel (channelModel, 0);
+  uint64_t channelMemory = channelModel->GetChannelMemory ();
+  NS_TEST_ASSERT_MSG_GT (channelMemory, 0, "the memory of the channel matrix is not accounted for");
+  channelModel->SetAttribute ("MaxMemory", UintegerValue (channelMemory * 5 / 2));
+  for (uint32_t i = 1; i < nLinks; ++i)
+    {
+      DoGetChannel (channelModel, i);
+      NS_TEST_EXPECT_MSG_LT_OR_EQ (channelModel->GetChannelMemory (), channelMemory * 5 / 2, "the memory budget is exceeded");
+    }
+  NS_TEST_EXPECT_MSG_EQ (channelModel->GetNChannels (), 2, "wrong number of stored channel matrices");
+
+  // the channel matrix of the most recently used link is still stored,
+  // the one of the first link has been discarded and is generated again
+  Ptr<const ThreeGppChannelModel::ChannelMatrix> last = m_channel[nLinks - 1];
+  DoGetChannel (channelModel, nLinks - 1);
+  NS_TEST_EXPECT_MSG_EQ ((m_channel[nLinks - 1] == last), true, "the most recently used channel matrix has been discarded");
+  Ptr<const ThreeGppChannelModel::ChannelMatrix> first = m_channel[0];
+  DoGetChannel (channelModel, 0);
+  NS_TEST_EXPECT_MSG_EQ ((m_channel[0] != first), true, "the least recently used channel matrix has not been discarded");
+
+  m_mob.clear ();
+  m_antenna.clear ();
+  m_channel.clear ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup spectrum
  *
@@ -563,6 +813,7 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite ()
   AddTestCase (new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
   AddTestCase (new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppChannelBackgroundUpdateTest, TestCase::QUICK);
 }
 
 static ThreeGppChannelTestSuite myTestSuite;
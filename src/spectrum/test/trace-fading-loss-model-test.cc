@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/nstime.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/trace-fading-loss-model.h>
+#include <fstream>
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Check the fading applied by the TraceFadingLossModel to the RBs, for a
+ * small trace of 3 RBs and 4 samples of 1 ms.
+ */
+class TraceFadingLossModelTestCase : public TestCase
+{
+public:
+  TraceFadingLossModelTestCase ();
+  virtual ~TraceFadingLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the fading of the models at a sample of the trace
+   * \param index the index of the sample
+   */
+  void Check (uint32_t index);
+
+  Ptr<TraceFadingLossModel> m_model; //!< the model
+  Ptr<TraceFadingLossModel> m_other; //!< another model of the same trace
+  Ptr<MobilityModel> m_a; //!< the transmitter
+  Ptr<MobilityModel> m_b; //!< the receiver
+  Ptr<SpectrumValue> m_txPsd; //!< the transmitted PSD
+  uint32_t m_checks; //!< the number of samples checked
+};
+
+/// The trace, in dB: the 4 samples of each RB in turn
+static const double g_trace[3][4] = {
+  { 0, 10, -10, 3 },
+  { -3, 0, 20, -20 },
+  { 1.5, -1.5, 6, -6 }
+};
+
+TraceFadingLossModelTestCase::TraceFadingLossModelTestCase ()
+  : TestCase ("Check the fading of the RBs of a trace"),
+    m_checks (0)
+{
+}
+
+TraceFadingLossModelTestCase::~TraceFadingLossModelTestCase ()
+{
+}
+
+void
+TraceFadingLossModelTestCase::Check (uint32_t index)
+{
+  Ptr<SpectrumValue> rxPsd = m_model->CalcRxPowerSpectralDensity (m_txPsd, m_a, m_b);
+  Ptr<SpectrumValue> otherRxPsd = m_other->CalcRxPowerSpectralDensity (m_txPsd, m_a, m_b);
+  for (uint32_t rb = 0; rb < 3; rb++)
+    {
+      double expected = (*m_txPsd)[rb] * std::pow (10., g_trace[rb][index] / 10);
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*rxPsd)[rb], expected, expected * 1e-12,
+                                 "wrong fading of the RB " << rb << " at the sample " << index);
+      NS_TEST_ASSERT_MSG_EQ ((*otherRxPsd)[rb], (*rxPsd)[rb], "the traces differ");
+    }
+  NS_TEST_ASSERT_MSG_EQ ((*rxPsd)[3], 0, "an RB without power received some");
+  ++m_checks;
+}
+
+void
+TraceFadingLossModelTestCase::DoRun (void)
+{
+  // Mixed separators, and no end of line at the end of the file
+  std::string fileName = CreateTempDirFilename ("fading-trace.fad");
+  std::ofstream file (fileName.c_str ());
+  file << "0 10 -10 3\n-3\t0  20 -20\n  1.5 -1.5 6 -6";
+  file.close ();
+
+  // The window spans the samples 1 to 3, the offset being drawn in [1, 1] ms
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+      model->SetAttribute ("TraceFilename", StringValue (fileName));
+      model->SetAttribute ("TraceLength", TimeValue (MilliSeconds (4)));
+      model->SetAttribute ("SamplesNum", UintegerValue (4));
+      model->SetAttribute ("WindowSize", TimeValue (MilliSeconds (3)));
+      model->SetAttribute ("RbNum", UintegerValue (4));
+      model->Initialize ();
+      (i == 0 ? m_model : m_other) = model;
+    }
+  m_a = CreateObject<ConstantPositionMobilityModel> ();
+  m_b = CreateObject<ConstantPositionMobilityModel> ();
+
+  // The last RB is not in the trace, and not used
+  std::vector<double> frequencies;
+  for (uint32_t rb = 0; rb < 4; rb++)
+    {
+      frequencies.push_back (2.1e9 + rb * 180e3);
+    }
+  m_txPsd = Create<SpectrumValue> (Create<SpectrumModel> (frequencies));
+  (*m_txPsd)[0] = 1e-16;
+  (*m_txPsd)[1] = 2e-16;
+  (*m_txPsd)[2] = 4e-16;
+  (*m_txPsd)[3] = 0;
+
+  for (uint32_t index = 1; index < 4; index++)
+    {
+      Simulator::Schedule (MilliSeconds (index - 1), &TraceFadingLossModelTestCase::Check, this, index);
+    }
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_checks, 3, "wrong number of checks");
+  m_model = 0;
+  m_other = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * TraceFadingLossModel test suite.
+ */
+class TraceFadingLossModelTestSuite : public TestSuite
+{
+public:
+  TraceFadingLossModelTestSuite ();
+};
+
+TraceFadingLossModelTestSuite::TraceFadingLossModelTestSuite ()
+  : TestSuite ("trace-fading-loss-model", UNIT)
+{
+  AddTestCase (new TraceFadingLossModelTestCase, TestCase::QUICK);
+}
+
+static TraceFadingLossModelTestSuite g_traceFadingLossModelTestSuite; //!< Static variable for test initialization
@@ -25,6 +25,7 @@
 #define WIFI_MAC_QUEUE_ITEM_H
 
 #include "ns3/nstime.h"
+#include "ns3/pool-allocator.h"
 #include "wifi-mac-header.h"
 #include "msdu-aggregator.h"
 #include "amsdu-subframe-header.h"
@@ -40,7 +41,7 @@ class Packet;
  * WifiMacQueueItem stores (const) packets along with their Wifi MAC headers
  * and the time when they were enqueued.
  */
-class WifiMacQueueItem : public SimpleRefCount<WifiMacQueueItem>
+class WifiMacQueueItem : public SimpleRefCount<WifiMacQueueItem, PoolAllocated>
 {
 public:
   /**
@@ -2546,6 +2546,11 @@ WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, WifiPhyBand
 void
 WifiPhy::NotifyTxBegin (Ptr<const WifiPsdu> psdu, double txPowerW)
 {
+  if (m_phyTxBeginTrace.IsEmpty ())
+    {
+      // skip building the MPDU packets
+      return;
+    }
   for (auto& mpdu : *PeekPointer (psdu))
     {
       m_phyTxBeginTrace (mpdu->GetProtocolDataUnit (), txPowerW);
@@ -2555,6 +2560,10 @@ WifiPhy::NotifyTxBegin (Ptr<const WifiPsdu> psdu, double txPowerW)
 void
 WifiPhy::NotifyTxEnd (Ptr<const WifiPsdu> psdu)
 {
+  if (m_phyTxEndTrace.IsEmpty ())
+    {
+      return;
+    }
   for (auto& mpdu : *PeekPointer (psdu))
     {
       m_phyTxEndTrace (mpdu->GetProtocolDataUnit ());
@@ -2564,6 +2573,10 @@ WifiPhy::NotifyTxEnd (Ptr<const WifiPsdu> psdu)
 void
 WifiPhy::NotifyTxDrop (Ptr<const WifiPsdu> psdu)
 {
+  if (m_phyTxDropTrace.IsEmpty ())
+    {
+      return;
+    }
   for (auto& mpdu : *PeekPointer (psdu))
     {
       m_phyTxDropTrace (mpdu->GetProtocolDataUnit ());
@@ -2573,6 +2586,10 @@ WifiPhy::NotifyTxDrop (Ptr<const WifiPsdu> psdu)
 void
 WifiPhy::NotifyRxBegin (Ptr<const WifiPsdu> psdu)
 {
+  if (m_phyRxBeginTrace.IsEmpty ())
+    {
+      return;
+    }
   for (auto& mpdu : *PeekPointer (psdu))
     {
       m_phyRxBeginTrace (mpdu->GetProtocolDataUnit ());
@@ -2582,6 +2599,10 @@ WifiPhy::NotifyRxBegin (Ptr<const WifiPsdu> psdu)
 void
 WifiPhy::NotifyRxEnd (Ptr<const WifiPsdu> psdu)
 {
+  if (m_phyRxEndTrace.IsEmpty ())
+    {
+      return;
+    }
   for (auto& mpdu : *PeekPointer (psdu))
     {
       m_phyRxEndTrace (mpdu->GetProtocolDataUnit ());
@@ -2591,6 +2612,10 @@ WifiPhy::NotifyRxEnd (Ptr<const WifiPsdu> psdu)
 void
 WifiPhy::NotifyRxDrop (Ptr<const WifiPsdu> psdu, WifiPhyRxfailureReason reason)
 {
+  if (m_phyRxDropTrace.IsEmpty ())
+    {
+      return;
+    }
   for (auto& mpdu : *PeekPointer (psdu))
     {
       m_phyRxDropTrace (mpdu->GetProtocolDataUnit (), reason);
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+
+using namespace ns3;
+
+/*
+ * Benchmark of the updates of the random mobility models.
+ *
+ * The same models move for the same time twice, their updates being
+ * scheduled with the simulator, then with the MobilityTickScheduler.
+ * The number of course changes per second of wall clock time is
+ * reported, and the final positions of the two runs are checked to be
+ * identical.
+ */
+
+namespace {
+
+/** The number of course changes of the run. */
+uint64_t g_courseChanges = 0;
+
+/**
+ * Count a course change.
+ * \param model The model which changed its course.
+ */
+void
+CourseChange (Ptr<const MobilityModel> model)
+{
+  ++g_courseChanges;
+}
+
+/**
+ * Move the models.
+ * \param model The TypeId name of the models.
+ * \param nodes The number of models.
+ * \param duration The simulated time.
+ * \param tick Whether to use the MobilityTickScheduler.
+ * \param [out] positions The final positions of the models.
+ */
+void
+BenchMobility (std::string model, uint32_t nodes, Time duration, bool tick,
+               std::vector<Vector> &positions)
+{
+  GlobalValue::Bind ("MobilityTickScheduler", BooleanValue (tick));
+
+  Ptr<RandomBoxPositionAllocator> allocator = CreateObject<RandomBoxPositionAllocator> ();
+  allocator->SetAttribute ("X", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1000.0]"));
+  allocator->SetAttribute ("Y", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1000.0]"));
+  allocator->SetAttribute ("Z", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+  allocator->AssignStreams (0);
+
+  ObjectFactory factory (model);
+  if (model == "ns3::RandomWalk2dMobilityModel" || model == "ns3::RandomDirection2dMobilityModel")
+    {
+      factory.Set ("Bounds", RectangleValue (Rectangle (0, 1000, 0, 1000)));
+    }
+  else if (model == "ns3::GaussMarkovMobilityModel")
+    {
+      factory.Set ("Bounds", BoxValue (Box (0, 1000, 0, 1000, 0, 100)));
+    }
+  else if (model == "ns3::RandomWaypointMobilityModel")
+    {
+      factory.Set ("PositionAllocator", PointerValue (allocator));
+    }
+
+  std::vector<Ptr<MobilityModel> > models (nodes);
+  int64_t stream = 10;
+  for (uint32_t i = 0; i < nodes; ++i)
+    {
+      models[i] = factory.Create<MobilityModel> ();
+      Vector position = allocator->GetNext ();
+      if (model != "ns3::GaussMarkovMobilityModel")
+        {
+          position.z = 0;
+        }
+      models[i]->SetPosition (position);
+      stream += models[i]->AssignStreams (stream);
+      models[i]->TraceConnectWithoutContext ("CourseChange", MakeCallback (&CourseChange));
+      models[i]->Initialize ();
+    }
+
+  g_courseChanges = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+
+  positions.resize (nodes);
+  for (uint32_t i = 0; i < nodes; ++i)
+    {
+      positions[i] = models[i]->GetPosition ();
+    }
+  uint64_t ticks = tick ? MobilityTickScheduler::Get ()->GetTicks () : 0;
+  Simulator::Destroy ();
+
+  std::cout << std::left << std::setw (12) << (tick ? "tick" : "simulator") << std::right
+            << std::setw (12) << g_courseChanges << " changes "
+            << std::setw (8) << ms << " ms "
+            << std::setw (12) << std::fixed << std::setprecision (0)
+            << g_courseChanges * 1000.0 / std::max<int64_t> (ms, 1) << " changes/s";
+  if (tick)
+    {
+      std::cout << std::setw (12) << ticks << " ticks";
+    }
+  std::cout << std::endl;
+}
+
+} // unnamed namespace
+
+int main (int argc, char *argv[])
+{
+  std::string model = "ns3::RandomWalk2dMobilityModel";
+  uint32_t nodes = 50000;
+  Time duration = Seconds (100);
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the updates of the random mobility models, with and without the MobilityTickScheduler.");
+  cmd.AddValue ("model", "TypeId name of the mobility model", model);
+  cmd.AddValue ("nodes", "number of mobility models", nodes);
+  cmd.AddValue ("duration", "simulated time", duration);
+  cmd.Parse (argc, argv);
+
+  std::cout << model << ", " << nodes << " nodes, " << duration.As (Time::S) << std::endl;
+  std::vector<Vector> reference;
+  std::vector<Vector> positions;
+  BenchMobility (model, nodes, duration, false, reference);
+  BenchMobility (model, nodes, duration, true, positions);
+  GlobalValue::Bind ("MobilityTickScheduler", BooleanValue (false));
+
+  bool identical = true;
+  for (uint32_t i = 0; i < nodes; ++i)
+    {
+      identical &= positions[i].x == reference[i].x
+        && positions[i].y == reference[i].y
+        && positions[i].z == reference[i].z;
+    }
+  std::cout << (identical ? "identical" : "DIFFERENT") << " positions" << std::endl;
+  return identical ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/*
+ * Benchmark of Object::CreateObject and Object::GetObject.
+ *
+ * A population of "nodes" is created, each with seven aggregated objects,
+ * as a node with its mobility model, IP stacks and so on. The
+ * GetObject lookups of the first and of the last aggregated type, of a
+ * parent type and of a missing type are then timed.
+ */
+
+namespace {
+
+/// Base class of the aggregated objects
+class BenchBase : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchBase")
+      .SetParent<Object> ()
+      .HideFromDocumentation ()
+      .AddAttribute ("Value", "An attribute set at construction",
+                     UintegerValue (1),
+                     MakeUintegerAccessor (&BenchBase::m_value),
+                     MakeUintegerChecker<uint32_t> ())
+    ;
+    return tid;
+  }
+  uint32_t m_value; ///< the attribute value
+};
+
+/**
+ * Aggregated object type.
+ * \tparam N The type index.
+ */
+template <int N>
+class BenchObject : public BenchBase
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId (("ns3::BenchObject" + std::to_string (N)).c_str ())
+      .SetParent<BenchBase> ()
+      .HideFromDocumentation ()
+      .AddConstructor<BenchObject<N> > ()
+    ;
+    return tid;
+  }
+};
+
+/// Type which is never aggregated
+class BenchMissing : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchMissing")
+      .SetParent<Object> ()
+      .HideFromDocumentation ()
+    ;
+    return tid;
+  }
+};
+
+/// Number of objects of each node
+const uint32_t N_OBJECTS = 8;
+
+/**
+ * Create a node and its aggregated objects.
+ * \return The node.
+ */
+Ptr<Object>
+CreateNode (void)
+{
+  Ptr<Object> node = CreateObject<BenchObject<0> > ();
+  node->AggregateObject (CreateObject<BenchObject<1> > ());
+  node->AggregateObject (CreateObject<BenchObject<2> > ());
+  node->AggregateObject (CreateObject<BenchObject<3> > ());
+  node->AggregateObject (CreateObject<BenchObject<4> > ());
+  node->AggregateObject (CreateObject<BenchObject<5> > ());
+  node->AggregateObject (CreateObject<BenchObject<6> > ());
+  node->AggregateObject (CreateObject<BenchObject<7> > ());
+  return node;
+}
+
+/**
+ * Time the lookups of a type on all the nodes.
+ * \tparam T The type looked up.
+ * \param name The name of the benchmark.
+ * \param nodes The nodes.
+ * \param iterations The number of lookups per node.
+ */
+template <typename T>
+void
+BenchLookup (std::string name, const std::vector<Ptr<Object> > &nodes, uint32_t iterations)
+{
+  SystemWallClockMs clock;
+  uint64_t found = 0;
+  clock.Start ();
+  for (uint32_t it = 0; it < iterations; ++it)
+    {
+      for (const Ptr<Object> &node : nodes)
+        {
+          found += (node->GetObject<T> () != 0);
+        }
+    }
+  int64_t ms = clock.End ();
+  double n = static_cast<double> (nodes.size ()) * iterations;
+  std::cout << std::left << std::setw (12) << name << std::right
+            << std::setw (10) << ms << " ms "
+            << std::setw (10) << std::fixed << std::setprecision (2) << ms * 1e6 / n << " ns/lookup "
+            << "found " << found << std::endl;
+}
+
+} // unnamed namespace
+
+int main (int argc, char *argv[])
+{
+  uint32_t nodes = 10000;
+  uint32_t iterations = 100;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark Object::CreateObject and Object::GetObject.");
+  cmd.AddValue ("nodes", "number of nodes", nodes);
+  cmd.AddValue ("iterations", "number of lookups of each type per node", iterations);
+  cmd.Parse (argc, argv);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  std::vector<Ptr<Object> > population;
+  population.reserve (nodes);
+  for (uint32_t i = 0; i < nodes; ++i)
+    {
+      population.push_back (CreateNode ());
+    }
+  int64_t ms = clock.End ();
+  std::cout << "create      " << std::setw (10) << ms << " ms "
+            << std::setw (10) << std::fixed << std::setprecision (2) << ms * 1e6 / (static_cast<double> (N_OBJECTS) * nodes) << " ns/object" << std::endl;
+
+  BenchLookup<BenchObject<0> > ("first", population, iterations);
+  BenchLookup<BenchObject<7> > ("last", population, iterations);
+  BenchLookup<BenchObject<1> > ("second", population, iterations);
+  BenchLookup<BenchBase> ("parent", population, iterations);
+  BenchLookup<BenchMissing> ("missing", population, iterations);
+
+  for (const Ptr<Object> &node : population)
+    {
+      node->Dispose ();
+    }
+  return 0;
+}
@@ -26,15 +26,50 @@
 #include "ns3/system-wall-clock-ms.h"
 #include "ns3/packet.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/pool-allocator.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/queue-item.h"
 #include <iostream>
 #include <sstream>
 #include <string>
-#include <stdlib.h> // for exit ()
+#include <stdlib.h> // for exit (), malloc ()
 #include <limits>
 #include <algorithm>
+#include <new>
 
 using namespace ns3;
 
+/// The number of calls to the global operator new
+static uint64_t g_allocations = 0;
+
+/**
+ * Count the allocations of the program and of the ns-3 libraries.
+ * \param size The size of the allocation.
+ * 
+eturns The allocated memory.
+ */
+void *
+operator new (std::size_t size)
+{
+  ++g_allocations;
+  void *p = malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+/**
+ * Release the memory allocated by the counting operator new.
+ * \param p The memory.
+ */
+void
+operator delete (void *p) noexcept
+{
+  free (p);
+}
+
 /// BenchHeader class used for benchmarking packet serialization/deserialization
 template <int N>
 class BenchHeader : public Header
@@ -328,6 +363,54 @@ benchByteTags (uint32_t n)
     }
 }
 
+/// BenchQueueItem class, a queue disc item as those of the IP protocols
+class BenchQueueItem : public QueueDiscItem
+{
+public:
+  /**
+   * Constructor.
+   * \param p The packet.
+   * \param header The IP header, added to the packet when dequeued.
+   */
+  BenchQueueItem (Ptr<Packet> p, const BenchHeader<25> &header)
+    : QueueDiscItem (p, Address (), 0),
+      m_header (header)
+  {}
+  virtual void AddHeader (void) {
+    GetPacket ()->AddHeader (m_header);
+  }
+  virtual bool Mark (void) {
+    return false;
+  }
+private:
+  BenchHeader<25> m_header; ///< The IP header
+};
+
+static void
+benchForward (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  BenchTag<8> flowId;
+  // a router forwarding through its device queue
+  Ptr<DropTailQueue<QueueDiscItem> > queue = CreateObject<DropTailQueue<QueueDiscItem> > ();
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (1000);
+    p->AddHeader (udp);
+    p->AddHeader (ipv4);
+    p->AddPacketTag (flowId);
+    p->SetNixVector (Create<NixVector> ());
+
+    Ptr<Packet> o = p->Copy ();
+    o->RemoveHeader (ipv4);
+    queue->Enqueue (Create<BenchQueueItem> (o, ipv4));
+    Ptr<QueueDiscItem> item = queue->Dequeue ();
+    item->AddHeader ();
+    item->GetPacket ()->RemoveHeader (ipv4);
+  }
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -343,6 +426,7 @@ static void
 runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
 {
   uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+  uint64_t allocations = g_allocations;
   for (uint32_t i = 0; i < minIterations; i++)
     {
       uint64_t delay = runBenchOneIteration(bench, n);
@@ -351,8 +435,12 @@ runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char con
   double ps = n;
   ps *= 1000;
   ps /= minDelay;
+  double perPacket = g_allocations - allocations;
+  perPacket /= n;
+  perPacket /= minIterations;
   std::cout << ps << " packets/s"
-            << " (" << minDelay << " ms elapsed)\t"
+            << " (" << minDelay << " ms elapsed, "
+            << perPacket << " allocations/packet)\t"
             << name
             << std::endl;
 }
@@ -386,5 +474,10 @@ int main (int argc, char *argv[])
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
 
+  PoolAllocator::SetEnabled (false);
+  runBench (&benchForward, n, minIterations, "Forward packets, without the pool allocator");
+  PoolAllocator::SetEnabled (true);
+  runBench (&benchForward, n, minIterations, "Forward packets, with the pool allocator");
+
   return 0;
 }
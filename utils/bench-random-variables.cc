@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/*
+ * Benchmark of RandomVariableStream::GetValue and
+ * RandomVariableStream::GetValues.
+ *
+ * For each distribution, the same number of values is drawn from two
+ * random variables of the same stream, one value at a time and in
+ * blocks, and the two sequences are checked to be identical.
+ */
+
+namespace {
+
+/**
+ * Time the generation of values of a distribution.
+ * \param name The name of the benchmark.
+ * \param factory The factory of the random variables.
+ * \param count The number of values.
+ * \param block The number of values of each GetValues call.
+ * \return \c true if the two sequences are identical.
+ */
+bool
+BenchDistribution (std::string name, const ObjectFactory &factory,
+                   uint32_t count, uint32_t block)
+{
+  Ptr<RandomVariableStream> single = factory.Create<RandomVariableStream> ();
+  Ptr<RandomVariableStream> bulk = factory.Create<RandomVariableStream> ();
+  single->SetStream (1);
+  bulk->SetStream (1);
+
+  std::vector<double> singleValues (count);
+  std::vector<double> bulkValues (count);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      singleValues[i] = single->GetValue ();
+    }
+  int64_t singleMs = clock.End ();
+
+  clock.Start ();
+  for (uint32_t i = 0; i < count; i += block)
+    {
+      bulk->GetValues (&bulkValues[i], std::min (block, count - i));
+    }
+  int64_t bulkMs = clock.End ();
+
+  bool identical = singleValues == bulkValues;
+  std::cout << std::left << std::setw (12) << name << std::right
+            << std::setw (8) << singleMs << " ms "
+            << std::setw (8) << std::fixed << std::setprecision (2) << singleMs * 1e6 / count << " ns/value "
+            << std::setw (8) << bulkMs << " ms "
+            << std::setw (8) << bulkMs * 1e6 / count << " ns/value "
+            << (identical ? "identical" : "DIFFERENT") << std::endl;
+  return identical;
+}
+
+} // unnamed namespace
+
+int main (int argc, char *argv[])
+{
+  uint32_t count = 10000000;
+  uint32_t block = 1024;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark RandomVariableStream::GetValue and RandomVariableStream::GetValues.");
+  cmd.AddValue ("count", "number of values of each distribution", count);
+  cmd.AddValue ("block", "number of values of each GetValues call", block);
+  cmd.Parse (argc, argv);
+  NS_ABORT_MSG_IF (block == 0, "The block size must be positive");
+
+  std::cout << "distribution    GetValue                 GetValues" << std::endl;
+  bool identical = true;
+  identical &= BenchDistribution ("uniform", ObjectFactory ("ns3::UniformRandomVariable"),
+                                  count, block);
+  identical &= BenchDistribution ("exponential", ObjectFactory ("ns3::ExponentialRandomVariable"),
+                                  count, block);
+  identical &= BenchDistribution ("pareto", ObjectFactory ("ns3::ParetoRandomVariable"),
+                                  count, block);
+  identical &= BenchDistribution ("weibull", ObjectFactory ("ns3::WeibullRandomVariable"),
+                                  count, block);
+  identical &= BenchDistribution ("normal", ObjectFactory ("ns3::NormalRandomVariable"),
+                                  count, block);
+  identical &= BenchDistribution ("gamma", ObjectFactory ("ns3::GammaRandomVariable"),
+                                  count, block);
+  return identical ? 0 : 1;
+}
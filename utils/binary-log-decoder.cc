@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/*
+ * Decode a binary log written with BinaryLog and NS_BINLOG, one
+ * message per line: the simulation time in seconds, the thread,
+ * the log component and the formatted message.
+ *
+ * ./waf --run "binary-log-decoder --input=run.blog --output=run.txt"
+ */
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Decode a binary log written with NS_BINLOG.");
+  cmd.AddValue ("input", "the binary log file", input);
+  cmd.AddValue ("output", "the text file (default: the standard output)", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "No input file, see --help" << std::endl;
+      return 1;
+    }
+  bool ok;
+  if (output.empty ())
+    {
+      ok = BinaryLog::Decode (input, std::cout);
+    }
+  else
+    {
+      std::ofstream os (output.c_str ());
+      ok = BinaryLog::Decode (input, os);
+    }
+  if (!ok)
+    {
+      std::cerr << "Could not decode " << input << std::endl;
+      return 1;
+    }
+  return 0;
+}